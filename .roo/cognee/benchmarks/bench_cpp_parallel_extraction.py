@@ -0,0 +1,75 @@
+# .roo/cognee/benchmarks/bench_cpp_parallel_extraction.py
+"""
+Sequential vs. parallel CppParser extraction on a synthetic large translation unit.
+
+Usage (from .roo/cognee):
+    python -m benchmarks.bench_cpp_parallel_extraction --lines 200000
+"""
+import argparse
+import asyncio
+import time
+from typing import List, Tuple
+from unittest.mock import patch
+
+from src.parser.entities import CodeEntity, RawSymbolReference
+from src.parser.parsers import cpp_parser as cpp_parser_module
+from src.parser.parsers.cpp_parser import CppParser
+
+def generate_translation_unit(target_lines: int) -> str:
+    """Builds a file shaped like generated/amalgamated code: namespaces of classes, free functions and tables."""
+    out: List[str] = ['#include <vector>', '#include "common/defs.h"', '']
+    ns_index = 0
+    while len(out) < target_lines:
+        out.append(f"namespace gen{ns_index} {{")
+        for i in range(40):
+            out.extend([
+                f"class Widget{i} : public BaseWidget {{",
+                "public:",
+                f"    int compute{i}(int x) {{ return helper{i}(x) + x; }}",
+                "};",
+                f"static int helper{i}(int v) {{",
+                f"    Widget{i} w;",
+                f"    return w.compute{i}(v - 1) + table{i}[v % 4];",
+                "}",
+                f"int table{i}[4] = {{ {i}, {i + 1}, {i + 2}, {i + 3} }};",
+                "",
+            ])
+        out.append(f"}} // namespace gen{ns_index}")
+        out.append("")
+        ns_index += 1
+    return "\n".join(out) + "\n"
+
+async def collect(parser: CppParser, source_id: str, content: str) -> Tuple[float, list]:
+    start = time.perf_counter()
+    items = []
+    async for item in parser.parse(source_id, content):
+        items.append(item.model_dump() if isinstance(item, (CodeEntity, RawSymbolReference)) else item)
+    return time.perf_counter() - start, items
+
+async def main(lines: int, workers: int):
+    content = generate_translation_unit(lines)
+    line_count = content.count("\n")
+    parser = CppParser()
+    source_id = "bench_repo@main|gen/amalgamated.cpp@0000000"
+
+    with patch.object(cpp_parser_module, "PARALLEL_EXTRACTION_MIN_LINES", line_count + 1):
+        seq_time, seq_items = await collect(parser, source_id, content)
+    with patch.object(cpp_parser_module, "PARALLEL_EXTRACTION_MIN_LINES", 1), \
+         patch.object(cpp_parser_module, "PARALLEL_EXTRACTION_MAX_WORKERS", workers):
+        # The first parallel run pays for spawning the pool; time the second one.
+        await collect(parser, source_id, content)
+        par_time, par_items = await collect(parser, source_id, content)
+
+    print(f"lines:      {line_count}")
+    print(f"items:      {len(seq_items)}")
+    print(f"sequential: {seq_time:.2f}s ({line_count / seq_time:,.0f} lines/s)")
+    print(f"parallel:   {par_time:.2f}s ({line_count / par_time:,.0f} lines/s, {workers} workers)")
+    print(f"speedup:    {seq_time / par_time:.2f}x")
+    print(f"identical:  {seq_items == par_items}")
+
+if __name__ == "__main__":
+    arg_parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    arg_parser.add_argument("--lines", type=int, default=200_000)
+    arg_parser.add_argument("--workers", type=int, default=cpp_parser_module.PARALLEL_EXTRACTION_MAX_WORKERS)
+    args = arg_parser.parse_args()
+    asyncio.run(main(args.lines, args.workers))
@@ -0,0 +1,292 @@
+# .roo/cognee/benchmarks/bench_parser_suite.py
+"""
+Parser benchmark suite over a seeded synthetic C++ corpus (benchmarks/cpp_corpus.py).
+Reports lines/s, entities/s, peak traced allocations and peak RSS for:
+
+  cpp_parser    CppParser.parse on every file (entities = CodeEntities yielded)
+  chunker       generate_intelligent_chunks with the corpus' slice lines (entities = chunks)
+  orchestrator  process_files_bulk into the embedded local graph backend (entities = CodeEntity nodes saved)
+
+Each case runs in a fresh process so peak RSS is its own. Results are compared with
+benchmarks/baseline.json; --check exits non-zero on a regression beyond --tolerance, or
+when a case recorded in the baseline for this corpus config did not run. A selected case
+with no baseline entry is not checked at all and is reported as NOT GUARDED.
+
+The committed baseline was recorded without the tree-sitter C++ grammar, so it covers only
+the chunker (--ext cpp) and the chunker and generic-path orchestrator (--ext txt). cpp_parser
+and the C++ orchestrator case stay NOT GUARDED until someone with the grammar installed runs
+--update-baseline (which keeps the other recorded cases).
+
+The baseline keeps one run per corpus config (ext, files, scale, seed) plus a machine
+profile: the time of a fixed pure-Python calibration workload. Throughput is compared
+after scaling the baseline by calibration time, so a slower or faster machine does not
+read as a regression; the memory metrics are compared as recorded.
+
+Usage (from .roo/cognee):
+    python -m benchmarks.bench_parser_suite --files 2000 --scale 2
+    python -m benchmarks.bench_parser_suite --update-baseline
+    python -m benchmarks.bench_parser_suite --ext txt --update-baseline
+"""
+import argparse
+import asyncio
+import json
+import multiprocessing
+import os
+import platform
+import resource
+import shutil
+import sys
+import tempfile
+import time
+import tracemalloc
+from concurrent.futures import ProcessPoolExecutor
+from pathlib import Path
+from typing import Awaitable, Callable, Dict, List, Optional, Tuple
+
+from benchmarks.cpp_corpus import CorpusFile, generate_cpp_corpus, write_corpus
+
+CASES = ("cpp_parser", "chunker", "orchestrator")
+BASELINE_PATH = Path(__file__).with_name("baseline.json")
+# Metric -> True when higher is better.
+COMPARED_METRICS = {"lines_per_sec": True, "entities_per_sec": True, "alloc_peak_mb": False, "peak_rss_mb": False}
+# Metrics that scale with CPU speed and are normalized by the machine profile.
+THROUGHPUT_METRICS = ("lines_per_sec", "entities_per_sec")
+
+class CaseSkipped(Exception):
+    """The case cannot run in this environment (e.g. no C++ grammar)."""
+
+def _cpp_grammar_available() -> bool:
+    from src.parser.parsers.treesitter_setup import get_language
+    return get_language("cpp") is not None
+
+async def _measure(run_once: Callable[[], Awaitable[int]], lines: int, repeat: int) -> Dict[str, float]:
+    """Best of `repeat` untraced passes for throughput, then one pass under tracemalloc for the allocation peak."""
+    seconds = float("inf")
+    for _ in range(repeat):
+        start = time.perf_counter()
+        entities = await run_once()
+        seconds = min(seconds, time.perf_counter() - start)
+    tracemalloc.start()
+    try:
+        await run_once()
+        _, alloc_peak = tracemalloc.get_traced_memory()
+    finally:
+        tracemalloc.stop()
+    return {
+        "seconds": round(seconds, 4),
+        "lines": lines,
+        "entities": entities,
+        "lines_per_sec": round(lines / seconds, 1),
+        "entities_per_sec": round(entities / seconds, 1),
+        "alloc_peak_mb": round(alloc_peak / 2**20, 3),
+    }
+
+async def _bench_cpp_parser(corpus: List[CorpusFile], root: Path, ext: str, repeat: int) -> Dict[str, float]:
+    from src.parser.entities import CodeEntity
+    from src.parser.parsers.cpp_parser import CppParser
+    if ext != "cpp" or not _cpp_grammar_available():
+        raise CaseSkipped("needs the tree-sitter C++ grammar and --ext cpp")
+    parser = CppParser()
+
+    async def run_once() -> int:
+        entities = 0
+        for item in corpus:
+            async for out in parser.parse(f"bench/repo@main|{item.relative_path}@1-1", item.content):
+                entities += isinstance(out, CodeEntity)
+        return entities
+    return await _measure(run_once, sum(f.line_count for f in corpus), repeat)
+
+async def _bench_chunker(corpus: List[CorpusFile], root: Path, ext: str, repeat: int) -> Dict[str, float]:
+    from src.parser.chunking import generate_intelligent_chunks
+
+    async def run_once() -> int:
+        return sum(len(generate_intelligent_chunks(f"bench/repo@main|{f.relative_path}@1-1", f.content, f.slice_lines)) for f in corpus)
+    return await _measure(run_once, sum(f.line_count for f in corpus), repeat)
+
+class _NullDispatcher:
+    """Enhancement is not part of ingest throughput; drop the quiescence timers."""
+    async def notify_ingestion_activity(self, *args, **kwargs):
+        pass
+
+async def _bench_orchestrator(corpus: List[CorpusFile], root: Path, ext: str, repeat: int) -> Dict[str, float]:
+    if ext == "cpp" and not _cpp_grammar_available():
+        raise CaseSkipped("needs the tree-sitter C++ grammar (or --ext txt for the generic path)")
+    from src.parser import graph_utils, local_graph_backend, orchestrator
+    from src.parser.entities import FileProcessingRequest
+    from src.parser.local_graph_backend import LocalGraphBackend
+    graph_utils.GRAPH_BACKEND = "local"
+    orchestrator.get_dispatcher = _NullDispatcher
+    repo_root = root / "repo"
+    files = write_corpus(repo_root, corpus, "" if ext == "cpp" else ext)
+    requests = [FileProcessingRequest(absolute_path=abs_path, repo_path=str(repo_root), repo_id="bench/repo", branch="main", commit_index=1, is_delete=False) for abs_path, _ in files]
+    runs = 0
+
+    async def run_once() -> int:
+        nonlocal runs
+        runs += 1
+        # A fresh database per pass; the second pass would otherwise be all no-op content-hash hits.
+        backend = LocalGraphBackend(str(root / f"graph_{runs}.db"))
+        local_graph_backend._instance = backend
+        try:
+            await orchestrator.process_files_bulk(requests)
+            return len(await backend.find_nodes({"type": "CodeEntity"}))
+        finally:
+            backend.close()
+    return await _measure(run_once, sum(f.line_count for f in corpus), repeat)
+
+_CASE_FUNCS = {"cpp_parser": _bench_cpp_parser, "chunker": _bench_chunker, "orchestrator": _bench_orchestrator}
+
+def _run_case(case: str, files: int, seed: int, scale: int, ext: str, repeat: int) -> Tuple[str, Optional[Dict[str, float]], Optional[str]]:
+    """Process pool entry point: (case, metrics, skip reason)."""
+    import logging
+    logging.disable(logging.WARNING)  # Per-file INFO/WARNING logs would dominate the timings.
+    corpus = generate_cpp_corpus(files, seed, scale)
+    root = Path(tempfile.mkdtemp(prefix=f"bench_{case}_"))
+    try:
+        metrics = asyncio.run(_CASE_FUNCS[case](corpus, root, ext, repeat))
+    except CaseSkipped as e:
+        return case, None, str(e)
+    finally:
+        shutil.rmtree(root, ignore_errors=True)
+    metrics["peak_rss_mb"] = round(resource.getrusage(resource.RUSAGE_SELF).ru_maxrss / 1024, 1)
+    return case, metrics, None
+
+def expected_metrics(reference: Dict[str, float], speed: float) -> Dict[str, float]:
+    """The baseline metrics as they would read on this machine: throughput scaled by `speed`."""
+    return {metric: value * speed if metric in THROUGHPUT_METRICS else value for metric, value in reference.items()}
+
+def compare(results: Dict[str, Dict[str, float]], reference_cases: Dict[str, Dict[str, float]], tolerance: float, speed: float = 1.0) -> List[str]:
+    """
+    Returns one line per metric that is worse than the baseline by more than `tolerance`,
+    and one per baseline case that produced no result (skipped or not selected is not a pass).
+    """
+    regressions = [f"{case}: in the baseline but did not run" for case in reference_cases if case not in results]
+    for case, metrics in results.items():
+        reference = reference_cases.get(case)
+        if not reference:
+            continue
+        reference = expected_metrics(reference, speed)
+        for metric, higher_is_better in COMPARED_METRICS.items():
+            old, new = reference.get(metric), metrics.get(metric)
+            if not old or new is None:
+                continue
+            change = (new - old) / old
+            if (-change if higher_is_better else change) > tolerance:
+                regressions.append(f"{case}.{metric}: {old:,.1f} -> {new:,} ({change:+.1%})")
+    return regressions
+
+def unguarded(selected: List[str], reference_cases: Dict[str, Dict[str, float]]) -> List[str]:
+    """Selected cases the baseline has no entry for: --check cannot catch their regressions."""
+    return [case for case in selected if case not in reference_cases]
+
+def _config_key(config: Dict) -> str:
+    return " ".join(f"{k}={config[k]}" for k in sorted(config))
+
+def _calibrate(repeat: int = 5) -> float:
+    """Best-of time of a fixed string/dict/regex workload, roughly the mix the parser and chunker do."""
+    import re
+    pattern = re.compile(r"(\w+)::(\w+)\(")
+    text = "\n".join(f"int ns{i}::fn{i}(int a) {{ return a + {i}; }}" for i in range(2000))
+    best = float("inf")
+    for _ in range(repeat):
+        start = time.perf_counter()
+        counts: Dict[str, int] = {}
+        for _ in range(10):
+            for line in text.splitlines():
+                for ns, fn in pattern.findall(line):
+                    counts[ns + fn] = counts.get(ns + fn, 0) + len(line.split())
+        sorted(counts.items())
+        best = min(best, time.perf_counter() - start)
+    return round(best, 4)
+
+def machine_profile() -> Dict:
+    return {"calibration_seconds": _calibrate(), "cpu_count": os.cpu_count(), "machine": platform.machine(), "python": platform.python_version()}
+
+def _speed_ratio(baseline: Dict, machine: Dict) -> float:
+    """How fast this machine is relative to the one that recorded the baseline (>1 is faster)."""
+    recorded = baseline.get("machine", {}).get("calibration_seconds")
+    return recorded / machine["calibration_seconds"] if recorded and machine.get("calibration_seconds") else 1.0
+
+def _format_row(case: str, metrics: Dict[str, float], reference: Optional[Dict[str, float]]) -> str:
+    def _delta(metric: str) -> str:
+        if not reference or not reference.get(metric):
+            return ""
+        return f" ({(metrics[metric] - reference[metric]) / reference[metric]:+.0%})"
+    return (f"{case:13s} {metrics['lines_per_sec']:12,.0f} lines/s{_delta('lines_per_sec'):7s}"
+            f" {metrics['entities_per_sec']:10,.0f} entities/s{_delta('entities_per_sec'):7s}"
+            f" alloc peak {metrics['alloc_peak_mb']:8.2f} MB{_delta('alloc_peak_mb'):7s}"
+            f" rss {metrics['peak_rss_mb']:7.1f} MB{_delta('peak_rss_mb')}")
+
+def main(argv: Optional[List[str]] = None) -> int:
+    arg_parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    arg_parser.add_argument("--files", type=int, default=400)
+    arg_parser.add_argument("--seed", type=int, default=1)
+    arg_parser.add_argument("--scale", type=int, default=1, help="Grows nesting depth, enum sizes and members per file.")
+    arg_parser.add_argument("--cases", default=",".join(CASES))
+    arg_parser.add_argument("--repeat", type=int, default=5, help="Timed passes per case; the fastest is reported.")
+    arg_parser.add_argument("--ext", default="cpp", help="Use 'txt' to run the orchestrator through the generic parser.")
+    arg_parser.add_argument("--baseline", default=str(BASELINE_PATH))
+    arg_parser.add_argument("--tolerance", type=float, default=0.25, help="Allowed relative regression per metric.")
+    arg_parser.add_argument("--check", action="store_true", help="Exit 1 when a baselined metric regresses beyond the tolerance; cases without a baseline are reported NOT GUARDED.")
+    arg_parser.add_argument("--update-baseline", action="store_true", help="Write these results into the baseline file.")
+    arg_parser.add_argument("--json", dest="json_out", help="Also write the results to this file.")
+    args = arg_parser.parse_args(argv)
+
+    config = {"files": args.files, "seed": args.seed, "scale": args.scale, "ext": args.ext}
+    baseline: Dict = {}
+    if os.path.exists(args.baseline):
+        with open(args.baseline, "r", encoding="utf-8") as f:
+            baseline = json.load(f)
+    machine = machine_profile()
+    speed = _speed_ratio(baseline, machine)
+    reference_cases: Dict[str, Dict[str, float]] = baseline.get("runs", {}).get(_config_key(config), {}).get("cases", {})
+    if baseline and not reference_cases:
+        print(f"No baseline run for {_config_key(config)}; recorded: {sorted(baseline.get('runs', {}))}.")
+    elif reference_cases:
+        print(f"Machine speed vs baseline: {speed:.2f}x (calibration {machine['calibration_seconds']}s)")
+    selected = args.cases.split(",")
+    reference_cases = {case: metrics for case, metrics in reference_cases.items() if case in selected}
+
+    results: Dict[str, Dict[str, float]] = {}
+    context = multiprocessing.get_context("spawn")
+    for case in selected:
+        with ProcessPoolExecutor(max_workers=1, mp_context=context) as executor:
+            name, metrics, skipped = executor.submit(_run_case, case, args.files, args.seed, args.scale, args.ext, args.repeat).result()
+        if skipped:
+            print(f"{name:13s} skipped: {skipped}")
+            continue
+        results[name] = metrics
+        reference = reference_cases.get(name)
+        print(_format_row(name, metrics, expected_metrics(reference, speed) if reference else None))
+
+    if not args.update_baseline:
+        for case in unguarded(selected, reference_cases):
+            how = "run --update-baseline to record it" if case in results else "record it where the case can run"
+            print(f"NOT GUARDED {case}: no baseline for {_config_key(config)}; {how}.")
+    if args.json_out:
+        with open(args.json_out, "w", encoding="utf-8") as f:
+            json.dump({"machine": machine, "config": config, "cases": results}, f, indent=2, sort_keys=True)
+    if args.update_baseline:
+        # Other configs' runs were timed against the old calibration; keep them comparable.
+        runs = {key: {"config": run["config"], "cases": {case: expected_metrics(m, speed) for case, m in run["cases"].items()}}
+                for key, run in baseline.get("runs", {}).items()}
+        run = runs.setdefault(_config_key(config), {"config": config, "cases": {}})
+        run["cases"].update(results)
+        for run in runs.values():
+            run["cases"] = {case: {k: round(v, 1) if k in THROUGHPUT_METRICS else v for k, v in m.items()} for case, m in run["cases"].items()}
+        with open(args.baseline, "w", encoding="utf-8") as f:
+            json.dump({"machine": machine, "runs": runs}, f, indent=2, sort_keys=True)
+            f.write("\n")
+        print(f"Baseline updated: {args.baseline}")
+        return 0
+
+    regressions = compare(results, reference_cases, args.tolerance, speed)
+    for line in regressions:
+        print(f"REGRESSION {line}")
+    if args.check:
+        guarded = [case for case in selected if case in reference_cases]
+        print(f"Checked against the baseline: {', '.join(guarded) or 'nothing'}; not guarded: {', '.join(unguarded(selected, reference_cases)) or 'none'}.")
+    return 1 if regressions and args.check else 0
+
+if __name__ == "__main__":
+    sys.exit(main())
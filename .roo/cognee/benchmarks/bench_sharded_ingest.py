@@ -0,0 +1,61 @@
+# .roo/cognee/benchmarks/bench_sharded_ingest.py
+"""
+Sharded ingestion throughput vs. worker count. Commits go to an in-memory sink that
+charges a fixed cost per transaction and per file, standing in for the graph's write limit.
+
+Usage (from .roo/cognee):
+    python -m benchmarks.bench_sharded_ingest --files 4000 --workers 1,2,4,8
+"""
+import argparse
+import asyncio
+import os
+import shutil
+import tempfile
+from pathlib import Path
+from typing import Iterable, List
+
+from src.parser.extract_cli import select_files
+from src.parser.extraction import FileIsland
+from src.parser.sharded_ingest import ShardedIngestCoordinator
+
+class TimedSink:
+    def __init__(self, per_commit_ms: float, per_file_ms: float):
+        self.per_commit = per_commit_ms / 1000
+        self.per_file = per_file_ms / 1000
+
+    async def commit(self, islands: List[FileIsland], redo: Iterable[str] = ()) -> None:
+        await asyncio.sleep(self.per_commit + self.per_file * len(islands))
+
+def build_corpus(root: Path, count: int, ext: str):
+    for i in range(count):
+        path = root / f"mod{i % 50:02d}" / f"unit_{i}.{ext}"
+        path.parent.mkdir(parents=True, exist_ok=True)
+        body = "".join(
+            f"namespace m{i} {{ class C{j} {{ public: int f{j}(int x) {{ return g{j}(x) + {j}; }} }}; }}\n"
+            for j in range(60)
+        )
+        path.write_text(body)
+
+async def main(file_count: int, worker_counts: List[int], ext: str, per_commit_ms: float, per_file_ms: float):
+    root = Path(tempfile.mkdtemp(prefix="bench_sharded_"))
+    build_corpus(root, file_count, ext)
+    files = select_files(str(root), "all")
+    baseline = None
+    try:
+        for workers in worker_counts:
+            coordinator = ShardedIngestCoordinator(TimedSink(per_commit_ms, per_file_ms), num_workers=workers)
+            report = await coordinator.run(files, "bench/repo", "main", 1, progress_interval=3600)
+            baseline = baseline or report.files_per_second
+            print(f"workers={workers:3d} {report.files_per_second:10,.0f} files/s  speedup {report.files_per_second / baseline:5.2f}x  groups={report.commit_groups} failures={len(report.failures)}")
+    finally:
+        shutil.rmtree(root, ignore_errors=True)
+
+if __name__ == "__main__":
+    arg_parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    arg_parser.add_argument("--files", type=int, default=4000)
+    arg_parser.add_argument("--workers", default=",".join(str(w) for w in (1, 2, 4, 8) if w <= (os.cpu_count() or 1)))
+    arg_parser.add_argument("--ext", default="cpp", help="Use 'txt' to exercise the generic chunker only.")
+    arg_parser.add_argument("--per-commit-ms", type=float, default=2.0)
+    arg_parser.add_argument("--per-file-ms", type=float, default=0.05)
+    args = arg_parser.parse_args()
+    asyncio.run(main(args.files, [int(w) for w in args.workers.split(",")], args.ext, args.per_commit_ms, args.per_file_ms))
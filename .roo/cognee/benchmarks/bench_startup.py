@@ -0,0 +1,147 @@
+# .roo/cognee/benchmarks/bench_startup.py
+"""
+Startup-time benchmark. Each probe runs in a fresh interpreter so module caches start cold:
+
+  import_orchestrator  import src.parser.orchestrator (parsers and grammars must stay unloaded)
+  import_extract_cli   import src.parser.extract_cli
+  first_cpp_parse      import, then parse one C++ file to completion (the lazy grammar load included)
+  ready_to_serve       import, create the dispatcher and pre-warm the PARSER_PREWARM languages (default cpp)
+  process_wall         interpreter start to exit for the first_cpp_parse probe
+
+Reports the median of --repeat runs per probe. The target is first_cpp_parse under --budget-ms;
+--check exits non-zero when it is missed, and also when the C++ grammar is unavailable (the probe
+then times the GenericParser fallback). --importtime prints the slowest modules from
+`python -X importtime` for the orchestrator import.
+
+Usage (from .roo/cognee):
+    python -m benchmarks.bench_startup --repeat 7
+    PARSER_PREWARM=cpp,c python -m benchmarks.bench_startup --check --budget-ms 300
+"""
+import argparse
+import json
+import os
+import statistics
+import subprocess
+import sys
+import time
+from pathlib import Path
+from typing import Dict, List
+
+ROOT = Path(__file__).resolve().parent.parent
+SAMPLE_CPP = """#include <vector>
+namespace app {
+class Widget {
+public:
+    int size() const { return items_.size(); }
+private:
+    std::vector<int> items_;
+};
+int run() { Widget w; return w.size(); }
+}
+"""
+
+# Runs inside the probe interpreter; prints one JSON object of millisecond timings.
+PROBE = r"""
+import asyncio, json, sys, tempfile, time
+from pathlib import Path
+mode, sample = sys.argv[1], sys.argv[2]
+timings = {}
+start = time.perf_counter()
+if mode == "import_extract_cli":
+    import src.parser.extract_cli
+    timings["import_extract_cli"] = (time.perf_counter() - start) * 1000
+else:
+    import src.parser.orchestrator
+    timings["import_orchestrator"] = (time.perf_counter() - start) * 1000
+    timings["grammars_loaded_at_import"] = sorted(m for m in sys.modules if m.startswith("tree_sitter_"))
+if mode == "first_cpp_parse":
+    from src.parser.parser_registry import FALLBACK_PARSER_MODULE, _load_parser_module, get_parser_for_file
+    from src.parser.parsers.treesitter_setup import get_language
+    async def parse(path):
+        # Without the C++ grammar (CppParser cannot be built) time the generic fallback path instead.
+        parser = get_parser_for_file(path) if get_language("cpp") is not None else _load_parser_module(FALLBACK_PARSER_MODULE)()
+        count = 0
+        async for item in parser.parse(f"org/repo@main|{path.name}", path.read_text()):
+            count += 1
+        return type(parser).__name__, count
+    with tempfile.TemporaryDirectory() as tmp:
+        path = Path(tmp) / "widget.cpp"
+        path.write_text(sample)
+        parser_name, items = asyncio.run(parse(path))
+    timings["first_cpp_parse"] = (time.perf_counter() - start) * 1000
+    timings["parser"], timings["items"], timings["cpp_grammar"] = parser_name, items, get_language("cpp") is not None
+elif mode == "ready_to_serve":
+    import os
+    from src.parser.dispatcher import get_dispatcher
+    from src.parser.parser_registry import prewarm
+    get_dispatcher()
+    prewarm(l.strip() for l in (os.environ.get("PARSER_PREWARM") or "cpp").split(",") if l.strip())
+    timings["ready_to_serve"] = (time.perf_counter() - start) * 1000
+print(json.dumps(timings))
+"""
+
+def _run_probe(mode: str) -> Dict:
+    start = time.perf_counter()
+    result = subprocess.run([sys.executable, "-c", PROBE, mode, SAMPLE_CPP], cwd=ROOT, capture_output=True, text=True)
+    wall_ms = (time.perf_counter() - start) * 1000
+    if result.returncode != 0:
+        raise RuntimeError(f"Probe '{mode}' failed:\n{result.stderr[-2000:]}")
+    timings = json.loads(result.stdout.strip().splitlines()[-1])
+    timings["process_wall"] = wall_ms
+    return timings
+
+def run(repeat: int) -> Dict:
+    samples: Dict[str, List[float]] = {}
+    details: Dict = {}
+    for mode in ("import_orchestrator", "import_extract_cli", "first_cpp_parse", "ready_to_serve"):
+        for _ in range(repeat):
+            timings = _run_probe(mode)
+            samples.setdefault(mode, []).append(timings[mode])
+            if mode == "first_cpp_parse":
+                samples.setdefault("process_wall", []).append(timings["process_wall"])
+                details.update({k: timings[k] for k in ("parser", "items", "cpp_grammar")})
+            if mode == "import_orchestrator":
+                details["grammars_loaded_at_import"] = timings["grammars_loaded_at_import"]
+    results = {name: round(statistics.median(values), 2) for name, values in samples.items()}
+    return {"median_ms": results, "repeat": repeat, **details}
+
+def import_time_report(top: int) -> List[str]:
+    """Slowest modules (cumulative microseconds) under `python -X importtime`."""
+    result = subprocess.run([sys.executable, "-X", "importtime", "-c", "import src.parser.orchestrator"], cwd=ROOT, capture_output=True, text=True)
+    rows = []
+    for line in result.stderr.splitlines():
+        if not line.startswith("import time:") or "cumulative" in line:
+            continue
+        _, cumulative, module = (part.strip() for part in line[len("import time:"):].split("|"))
+        rows.append((int(cumulative), module))
+    return [f"{cumulative / 1000:9.1f} ms  {module}" for cumulative, module in sorted(rows, reverse=True)[:top]]
+
+def main(argv=None) -> int:
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--repeat", type=int, default=5, help="Fresh processes per probe (median reported).")
+    parser.add_argument("--budget-ms", type=float, default=300.0, help="Target for first_cpp_parse.")
+    parser.add_argument("--check", action="store_true", help="Exit non-zero when first_cpp_parse exceeds --budget-ms.")
+    parser.add_argument("--json", action="store_true", help="Print results as JSON.")
+    parser.add_argument("--importtime", type=int, default=0, metavar="N", help="Also show the N slowest imports.")
+    args = parser.parse_args(argv)
+
+    report = run(args.repeat)
+    # Without the C++ grammar first_cpp_parse timed GenericParser, which says nothing about the budget.
+    within_budget = report["cpp_grammar"] and report["median_ms"]["first_cpp_parse"] <= args.budget_ms
+    report.update({"budget_ms": args.budget_ms, "within_budget": within_budget})
+    if args.json:
+        print(json.dumps(report, indent=2))
+    else:
+        for name, value in report["median_ms"].items():
+            print(f"{name:<22}{value:>10.1f} ms")
+        print(f"first parse by {report['parser']} ({report['items']} items, C++ grammar {'loaded' if report['cpp_grammar'] else 'unavailable'})")
+        if report["grammars_loaded_at_import"]:
+            print(f"WARNING: grammars imported eagerly: {', '.join(report['grammars_loaded_at_import'])}")
+        verdict = "OK" if within_budget else "EXCEEDED" if report["cpp_grammar"] else "NOT MEASURED (no C++ grammar)"
+        print(f"budget {args.budget_ms:.0f} ms: {verdict}")
+    if args.importtime:
+        print("\n".join(import_time_report(args.importtime)))
+    return 1 if args.check and not within_budget else 0
+
+if __name__ == "__main__":
+    sys.exit(main())
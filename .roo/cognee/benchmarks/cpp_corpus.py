@@ -0,0 +1,195 @@
+# .roo/cognee/benchmarks/cpp_corpus.py
+"""
+Seeded synthetic C++ corpus shaped like the tests/parser/test_data/cpp fixtures, scaled up:
+nested namespaces, inheritance across files, templates, calls, includes, lambdas, large enums,
+macro-generated definitions and deeply nested blocks. The same (files, seed, scale) always
+produces byte-identical output, so benchmark runs are comparable.
+"""
+import random
+from dataclasses import dataclass, field
+from pathlib import Path
+from typing import List, Tuple
+
+@dataclass
+class CorpusFile:
+    relative_path: str
+    content: str
+    # 1-based first lines of the top-level declarations, the parser contract's slice_lines.
+    slice_lines: List[int] = field(default_factory=list)
+
+    @property
+    def line_count(self) -> int:
+        return self.content.count("\n")
+
+class _Writer:
+    def __init__(self):
+        self.lines: List[str] = []
+        self.slice_lines: List[int] = []
+        self.depth = 0
+
+    def top_level(self):
+        """Marks the next line as the start of a top-level declaration."""
+        self.slice_lines.append(len(self.lines) + 1)
+
+    def emit(self, text: str = ""):
+        self.lines.append(("    " * self.depth + text) if text else "")
+
+    def open(self, text: str):
+        self.emit(text + " {")
+        self.depth += 1
+
+    def close(self, suffix: str = ""):
+        self.depth -= 1
+        self.emit("}" + suffix)
+
+def _module(index: int) -> str:
+    return f"mod{index % 16:02d}"
+
+def _class_name(file_index: int, class_index: int) -> str:
+    return f"Unit{file_index}Class{class_index}"
+
+def _namespaces(seed: int, file_index: int, scale: int) -> List[str]:
+    """A unit's namespace path; shared by its header, its source and every file that derives from it."""
+    depth = 1 + random.Random(f"{seed}:{file_index}:ns").randrange(3 * scale)
+    return ["corpus", _module(file_index)] + [f"n{file_index}_{d}" for d in range(depth - 1)]
+
+def _emit_header(w: _Writer, seed: int, file_index: int, rng: random.Random, scale: int, classes: int):
+    w.top_level(); w.emit("#pragma once")
+    w.emit("#include <string>")
+    w.emit("#include <vector>")
+    for dep in sorted({rng.randrange(file_index) for _ in range(min(file_index, 3))}):
+        w.emit(f'#include "{_module(dep)}/unit_{dep}.hpp"')
+    w.emit()
+
+    w.top_level(); w.emit(f"#define UNIT{file_index}_ACCESSOR(name, type) type get_##name() const {{ return name##_; }} void set_##name(type v) {{ name##_ = v; }}")
+    w.emit()
+
+    namespaces = _namespaces(seed, file_index, scale)
+    w.top_level()
+    for ns in namespaces:
+        w.open(f"namespace {ns}")
+
+    enum_size = rng.randrange(10, 40 * scale + 11)
+    w.open(f"enum class Unit{file_index}Kind : int")
+    for e in range(enum_size):
+        w.emit(f"Kind{e} = {e},")
+    w.close(";")
+    w.emit()
+
+    w.emit("template<typename T>")
+    w.open(f"class Unit{file_index}Box")
+    w.emit("public:")
+    w.emit(f"explicit Unit{file_index}Box(T value) : value_(value) {{}}")
+    w.emit("T get() const { return value_; }")
+    w.emit("private:")
+    w.emit("T value_;")
+    w.close(";")
+    w.emit()
+
+    for c in range(classes):
+        bases = []
+        if c > 0:
+            bases.append(f"public {_class_name(file_index, c - 1)}")
+        elif file_index > 0 and rng.random() < 0.5:
+            dep = rng.randrange(file_index)
+            bases.append(f"public ::{'::'.join(_namespaces(seed, dep, scale))}::{_class_name(dep, 0)}")
+        if rng.random() < 0.3:
+            bases.append(f"protected Unit{file_index}Box<int>")
+        inherit = f" : {', '.join(bases)}" if bases else ""
+        w.open(f"class {_class_name(file_index, c)}{inherit}")
+        w.emit("public:")
+        w.emit(f"virtual ~{_class_name(file_index, c)}() = default;")
+        for m in range(2 * scale):
+            w.emit(f"virtual int method{m}(int x) const;")
+        w.emit(f"UNIT{file_index}_ACCESSOR(count, int)")
+        w.emit("private:")
+        w.emit("int count_ = 0;")
+        w.close(";")
+        w.emit()
+
+    for ns in reversed(namespaces):
+        w.close(f" // namespace {ns}")
+
+def _emit_nested_block(w: _Writer, rng: random.Random, depth: int, call_target: str):
+    if depth == 0:
+        w.emit(f"acc += {call_target}(acc);")
+        return
+    kind = rng.randrange(3)
+    if kind == 0:
+        w.open(f"for (int i{depth} = 0; i{depth} < {depth + 1}; ++i{depth})")
+    elif kind == 1:
+        w.open(f"if (acc % {depth + 2} == 0)")
+    else:
+        w.open(f"while (acc > {depth * 100})")
+        w.emit("acc /= 2;")
+    _emit_nested_block(w, rng, depth - 1, call_target)
+    w.close()
+
+def _emit_source(w: _Writer, seed: int, file_index: int, rng: random.Random, scale: int, classes: int):
+    w.top_level(); w.emit(f'#include "{_module(file_index)}/unit_{file_index}.hpp"')
+    w.emit("#include <algorithm>")
+    w.emit("#include <functional>")
+    w.emit()
+
+    namespaces = _namespaces(seed, file_index, scale)
+    w.top_level()
+    w.open(f"namespace {'::'.join(namespaces)}")
+
+    w.open("namespace")
+    w.open(f"int helper{file_index}(int v)")
+    w.emit("return v * 3 + 1;")
+    w.close()
+    w.close(" // namespace")
+    w.emit()
+
+    for c in range(classes):
+        for m in range(2 * scale):
+            w.open(f"int {_class_name(file_index, c)}::method{m}(int x) const")
+            w.emit(f"int acc = helper{file_index}(x);")
+            if c > 0:
+                w.emit(f"acc += {_class_name(file_index, c - 1)}::method{m}(acc);")
+            w.emit("std::vector<int> values(4, acc);")
+            w.emit("std::transform(values.begin(), values.end(), values.begin(), [&](int v) { return v + get_count(); });")
+            w.emit("auto reducer = [acc](int total, int v) -> int { return total + v - acc; };")
+            _emit_nested_block(w, rng, 1 + rng.randrange(4 * scale), f"helper{file_index}")
+            w.emit("return acc;")
+            w.close()
+            w.emit()
+
+    w.top_level()
+    w.open(f"int run_unit{file_index}()")
+    w.emit(f"{_class_name(file_index, classes - 1)} instance;")
+    w.emit(f"Unit{file_index}Box<std::string> label(\"unit{file_index}\");")
+    w.emit(f"std::function<int(int)> fn = [&instance](int x) {{ return instance.method0(x); }};")
+    w.emit(f"return fn(static_cast<int>(Unit{file_index}Kind::Kind0));")
+    w.close()
+    w.close(f" // namespace {'::'.join(namespaces)}")
+
+def generate_cpp_corpus(files: int, seed: int = 0, scale: int = 1) -> List[CorpusFile]:
+    """Generates `files` files (alternating .hpp/.cpp pairs); `scale` grows nesting, enum size and members per file."""
+    corpus: List[CorpusFile] = []
+    for i in range(files):
+        unit, is_source = divmod(i, 2)
+        # Each unit draws from its own stream so adding files never changes the earlier ones.
+        rng = random.Random(f"{seed}:{unit}:{is_source}")
+        classes = 2 + random.Random(f"{seed}:{unit}").randrange(4 * scale)
+        w = _Writer()
+        if is_source:
+            _emit_source(w, seed, unit, rng, scale, classes)
+            relative_path = f"{_module(unit)}/unit_{unit}.cpp"
+        else:
+            _emit_header(w, seed, unit, rng, scale, classes)
+            relative_path = f"{_module(unit)}/unit_{unit}.hpp"
+        corpus.append(CorpusFile(relative_path, "\n".join(w.lines) + "\n", w.slice_lines))
+    return corpus
+
+def write_corpus(root: Path, corpus: List[CorpusFile], ext: str = "") -> List[Tuple[str, str]]:
+    """Writes the corpus under `root`; `ext` replaces the extensions (e.g. 'txt' for the generic path)."""
+    files: List[Tuple[str, str]] = []
+    for item in corpus:
+        relative_path = item.relative_path if not ext else f"{item.relative_path.rsplit('.', 1)[0]}_{item.relative_path.rsplit('.', 1)[1]}.{ext}"
+        path = root / relative_path
+        path.parent.mkdir(parents=True, exist_ok=True)
+        path.write_text(item.content)
+        files.append((str(path), relative_path))
+    return files
@@ -0,0 +1,187 @@
+# .roo/cognee/src/context_packer.py
+"""
+Token-budgeted context packing for DevCodeRetriever's LLM prompts.
+
+Triplets often carry the same source text more than once. A method appears as its own entity and
+inside its class's chunk, and a node that is the end of several triplets carries its text on each.
+The packer keeps each node's text at most once. Text is emitted as line-numbered source blocks:
+    - a node whose lines fall inside an emitted block of the same file only references that block;
+    - a node whose lines overlap or adjoin blocks of the file merges them with its lines into one
+      block, so a file's blocks never overlap or touch; references to a merged-away block are
+      pointed at the block that absorbed it;
+    - a node without a location is de-duplicated by ID and by exact text.
+Triplets are packed in score order until the token budget is spent. Later triplets that do not fit
+are dropped, and triplets keep their original index, so the planner's relevant_triplet_indices still
+point into the caller's list. Token counts are estimated at four characters per token. Each pack
+reports what the unpacked formatting would have cost.
+"""
+import json
+from dataclasses import dataclass, field
+from typing import Any, Callable, Dict, List, Optional, Tuple
+
+from src.parser.interval_index import span_of
+from src.parser.metrics import increment, CONTEXT_PACKER_TOKENS
+from src.parser.symbol_index import locate
+
+def estimate_tokens(text: str) -> int:
+    return (len(text) + 3) // 4
+
+@dataclass
+class _Block:
+    path: str
+    start_line: int
+    lines: List[str]
+
+    @property
+    def end_line(self) -> int:
+        return self.start_line + len(self.lines) - 1
+
+    def touches(self, path: str, start: int, end: int) -> bool:
+        return self.path == path and start <= self.end_line + 1 and end >= self.start_line - 1
+
+@dataclass
+class PackedContext:
+    triplets: List[Dict]
+    sources: List[Dict]
+    stats: Dict[str, int] = field(default_factory=dict)
+
+    def to_json(self) -> str:
+        return _render(self.triplets, self.sources)
+
+def _render(triplets: List[Dict], sources: List[Dict]) -> str:
+    return json.dumps({"triplets": triplets, "sources": sources}, indent=1)
+
+class ContextPacker:
+    def __init__(self, token_budget: int, snippet_lines: int = 5, node_id_prop: str = "id", node_text_prop: str = "text",
+                 node_type_prop: str = "type", edge_type_prop: str = "type"):
+        self.token_budget = token_budget
+        self.snippet_lines = snippet_lines
+        self.node_id_prop = node_id_prop
+        self.node_text_prop = node_text_prop
+        self.node_type_prop = node_type_prop
+        self.edge_type_prop = edge_type_prop
+
+    def _text(self, attributes: Dict) -> List[str]:
+        text = attributes.get(self.node_text_prop) or attributes.get("snippet_content")
+        return text.splitlines()[:self.snippet_lines] if isinstance(text, str) else []
+
+    def _location(self, node_id: Any, attributes: Dict) -> Optional[Tuple[str, int]]:
+        """(path, first line) of a node's text, when known."""
+        if not isinstance(node_id, str) or "|" not in node_id:
+            return None
+        span = span_of(node_id, attributes)
+        path = locate(node_id)[1]
+        return (path, span.start_line) if span and path else None
+
+    def naive_tokens(self, triplets: List[Dict], format_triplets: Callable[[List[Dict]], List[Dict]]) -> int:
+        """The estimated cost of `format_triplets`' unpacked output, for the savings report."""
+        return estimate_tokens(json.dumps(format_triplets(triplets), indent=2))
+
+    def pack(self, triplets: List[Dict], naive_tokens: Optional[int] = None) -> PackedContext:
+        state = _State()
+        packed, dropped = [], 0
+        for i in sorted(range(len(triplets)), key=lambda i: triplets[i].get("score", 0), reverse=True):
+            triplet = triplets[i]
+            edge_type = ((triplet.get("edge") or {}).get("attributes") or {}).get(self.edge_type_prop)
+            ends = [triplet.get("source_node") or {}, triplet.get("target_node") or {}]
+            if not edge_type or not all(end.get(self.node_id_prop) for end in ends):
+                continue
+            before = state.copy()
+            entry = {"index": i, "score": round(triplet.get("score", 0), 3), "source": self._place(ends[0], state),
+                     "edge": {"type": edge_type}, "target": self._place(ends[1], state)}
+            # Contexts are a few dozen triplets, so measuring the whole rendering each time is cheap and exact.
+            if packed and estimate_tokens(_render(packed + [entry], state.sources())) > self.token_budget:
+                state = before  # The first triplet is always kept; later ones must fit.
+                dropped += 1
+                continue
+            packed.append(entry)
+
+        for entry in packed:
+            for end in (entry["source"], entry["target"]):
+                if "block" in end:
+                    end["block"] = state.resolve(end["block"])
+        result = PackedContext(sorted(packed, key=lambda e: e["index"]), state.sources())
+        packed_tokens = estimate_tokens(result.to_json())
+        result.stats = {"triplets_in": len(triplets), "triplets_packed": len(packed), "triplets_dropped": dropped,
+                        "deduplicated_nodes": state.deduplicated, "merged_spans": state.merged, "packed_tokens": packed_tokens}
+        if naive_tokens is not None:
+            result.stats.update(naive_tokens=naive_tokens, saved_tokens=naive_tokens - packed_tokens)
+            increment(CONTEXT_PACKER_TOKENS, naive_tokens, kind="naive")
+        increment(CONTEXT_PACKER_TOKENS, packed_tokens, kind="packed")
+        return result
+
+    def _place(self, node: Dict, state: "_State") -> Dict:
+        """The node's prompt entry, with its text placed into `state` at most once."""
+        attributes = node.get("attributes") or {}
+        node_id = node.get(self.node_id_prop)
+        entry = {k: v for k, v in (("id", node_id), ("type", attributes.get(self.node_type_prop)), ("name", attributes.get("name"))) if v is not None}
+        lines = self._text(attributes)
+        if not lines:
+            return entry
+        location = self._location(node_id, attributes)
+        if location is None:
+            text = "\n".join(lines)
+            if (same := state.inline_ids.get(node_id) or state.inline_texts.get(text)) is not None:
+                entry["same_text_as"] = same
+                state.deduplicated += 1
+                return entry
+            state.inline_ids[node_id] = state.inline_texts[text] = node_id
+            entry["text_snippet"] = text
+            return entry
+
+        path, start = location
+        end = start + len(lines) - 1
+        entry["lines"] = f"{start}-{end}"
+        touching = sorted(k for k, block in state.blocks.items() if block.touches(path, start, end))
+        if not touching:
+            entry["block"] = state.add(_Block(path, start, lines))
+            return entry
+        # Lines by number; text already emitted wins over the node's copy of the same line.
+        by_line = dict(zip(range(start, end + 1), lines))
+        covered = set()
+        for k in touching:
+            block = state.blocks[k]
+            by_line.update(zip(range(block.start_line, block.end_line + 1), block.lines))
+            covered.update(range(block.start_line, block.end_line + 1))
+        extends = any(n not in covered for n in range(start, end + 1))
+        entry["block"] = survivor = touching[0]
+        if not extends and len(touching) == 1:
+            state.deduplicated += 1
+            return entry
+        first, last = min(by_line), max(by_line)  # Contiguous: every block touches the node's lines.
+        state.blocks[survivor] = _Block(path, first, [by_line[n] for n in range(first, last + 1)])
+        for k in touching[1:]:
+            del state.blocks[k]
+            state.alias[k] = survivor
+        state.merged += len(touching) - 1 + extends
+        if not extends:
+            state.deduplicated += 1
+        return entry
+
+@dataclass
+class _State:
+    blocks: Dict[int, _Block] = field(default_factory=dict)  # Block numbers are never reused.
+    alias: Dict[int, int] = field(default_factory=dict)      # merged-away block -> the block that absorbed it
+    inline_ids: Dict[Any, Any] = field(default_factory=dict)
+    inline_texts: Dict[str, Any] = field(default_factory=dict)
+    deduplicated: int = 0
+    merged: int = 0
+    next_block: int = 0
+
+    def add(self, block: _Block) -> int:
+        k, self.next_block = self.next_block, self.next_block + 1
+        self.blocks[k] = block
+        return k
+
+    def resolve(self, k: int) -> int:
+        while k in self.alias:
+            k = self.alias[k]
+        return k
+
+    def sources(self) -> List[Dict]:
+        return [{"block": k, "path": b.path, "start_line": b.start_line, "end_line": b.end_line, "text": "\n".join(b.lines)}
+                for k, b in sorted(self.blocks.items())]
+
+    def copy(self) -> "_State":
+        return _State(dict(self.blocks), dict(self.alias), dict(self.inline_ids), dict(self.inline_texts),
+                      self.deduplicated, self.merged, self.next_block)
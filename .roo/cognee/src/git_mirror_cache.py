@@ -0,0 +1,290 @@
+# .roo/cognee/src/git_mirror_cache.py
+"""
+Persistent cache of bare git mirrors for codify, keyed by remote URL.
+
+A remote is cloned once (`git clone --mirror`) and afterwards only fetched; a fetch younger than
+fetch_ttl_seconds is reused. Each requested ref gets a detached worktree checked out at the
+commit the ref resolved to, so codifying the same ref again at the same commit reuses it and a
+moved ref replaces it. Concurrent checkouts of one remote share a single in-flight clone or fetch.
+When the cache outgrows max_bytes, the least recently used mirrors go first, together with their
+worktrees; mirrors with a checkout in use are never evicted. A mirror's size is re-measured (off
+the event loop) only after a clone, fetch or new worktree changed it.
+
+URLs and refs come from MCP clients and end up on git command lines, so both are validated first:
+neither may start with '-', a ref must be a commit SHA or pass `git check-ref-format
+--allow-onelevel`, and file:// remotes need allow_file_urls.
+
+Usage state (last use, last fetch, size) is kept in index.json under the cache root. Coordination
+is per process: two processes sharing a root may fetch the same mirror twice, but never clone it twice.
+"""
+import asyncio
+import hashlib
+import json
+import os
+import re
+import shutil
+import time
+from collections import Counter
+from contextlib import asynccontextmanager
+from dataclasses import asdict, dataclass, field
+from typing import AsyncIterator, Dict, List, Optional, Set, Tuple
+
+from src.parser.configs import GIT_MIRROR_ALLOW_FILE_URLS, GIT_MIRROR_CACHE_DIR, GIT_MIRROR_CACHE_MAX_BYTES, GIT_MIRROR_FETCH_TTL_SECONDS
+from src.parser.metrics import increment, GIT_MIRROR_OPERATIONS
+from src.parser.utils import logger
+
+class GitMirrorError(RuntimeError):
+    """A git command run by the mirror cache failed, or a URL or ref was refused."""
+
+COMMIT_SHA_PATTERN = re.compile(r"^[0-9a-fA-F]{7,64}$")
+
+@dataclass
+class _Worktree:
+    path: str
+    commit: str
+    last_used: float
+
+@dataclass
+class _Mirror:
+    url: str
+    key: str
+    last_used: float = 0.0
+    fetched_at: float = 0.0
+    size_bytes: int = 0
+    worktrees: Dict[str, _Worktree] = field(default_factory=dict)
+
+def mirror_key(url: str) -> str:
+    """'https://github.com/org/repo.git' -> 'repo-<hash of the URL>': readable and collision-free."""
+    name = re.sub(r"[^A-Za-z0-9._-]", "_", url.rstrip("/").rsplit("/", 1)[-1].removesuffix(".git")) or "repo"
+    return f"{name}-{hashlib.sha1(url.encode('utf-8')).hexdigest()[:12]}"
+
+def _disk_usage(path: str) -> int:
+    total = 0
+    for root, _, files in os.walk(path):
+        for name in files:
+            try:
+                total += os.lstat(os.path.join(root, name)).st_size
+            except OSError:
+                pass
+    return total
+
+class GitMirrorCache:
+    def __init__(self, root: str = GIT_MIRROR_CACHE_DIR, max_bytes: int = GIT_MIRROR_CACHE_MAX_BYTES, fetch_ttl_seconds: float = GIT_MIRROR_FETCH_TTL_SECONDS,
+                 allow_file_urls: bool = GIT_MIRROR_ALLOW_FILE_URLS):
+        self.root = os.path.abspath(root)
+        self.max_bytes = max_bytes
+        self.fetch_ttl_seconds = fetch_ttl_seconds
+        self.allow_file_urls = allow_file_urls
+        self._index_path = os.path.join(self.root, "index.json")
+        self._mirrors: Dict[str, _Mirror] = {}
+        self._inflight: Dict[str, asyncio.Future] = {}
+        self._locks: Dict[str, asyncio.Lock] = {}
+        self._leases: Counter = Counter()  # Checkouts in use, by URL and by worktree path.
+        self._retired: Set[str] = set()
+        # Per-operation counts for this instance: clone, fetch, fresh, shared, worktree, evict.
+        self.ops: Counter = Counter()
+        os.makedirs(os.path.join(self.root, "mirrors"), exist_ok=True)
+        os.makedirs(os.path.join(self.root, "worktrees"), exist_ok=True)
+        self._load_index()
+
+    # --- Index ---
+
+    def _load_index(self):
+        try:
+            with open(self._index_path, encoding="utf-8") as f:
+                stored = json.load(f)
+        except FileNotFoundError:
+            return
+        except (OSError, ValueError) as e:
+            logger.warning(f"GIT_MIRROR: Ignoring unreadable {self._index_path}: {e}")
+            return
+        for data in stored.get("mirrors", []):
+            mirror = _Mirror(**{**data, "worktrees": {ref: _Worktree(**w) for ref, w in data.get("worktrees", {}).items()}})
+            if os.path.isdir(self._mirror_path(mirror.key)):
+                mirror.worktrees = {ref: w for ref, w in mirror.worktrees.items() if os.path.isdir(w.path)}
+                self._mirrors[mirror.url] = mirror
+
+    def _save_index(self):
+        with open(self._index_path + ".tmp", "w", encoding="utf-8") as f:
+            json.dump({"mirrors": [asdict(m) for m in self._mirrors.values()]}, f, indent=2)
+        os.replace(self._index_path + ".tmp", self._index_path)
+
+    def _mirror_path(self, key: str) -> str:
+        return os.path.join(self.root, "mirrors", key + ".git")
+
+    # --- Git ---
+
+    async def _git(self, *args: str, git_dir: Optional[str] = None) -> str:
+        command = ["git"] + (["--git-dir", git_dir] if git_dir else []) + list(args)
+        process = await asyncio.create_subprocess_exec(
+            *command, stdout=asyncio.subprocess.PIPE, stderr=asyncio.subprocess.PIPE,
+            env={**os.environ, "GIT_TERMINAL_PROMPT": "0"},
+        )
+        stdout, stderr = await process.communicate()
+        if process.returncode != 0:
+            raise GitMirrorError(f"{' '.join(command)} failed: {stderr.decode(errors='replace').strip()}")
+        return stdout.decode(errors="replace").strip()
+
+    def _check_url(self, url: str):
+        if not url or url.startswith("-"):
+            raise GitMirrorError(f"Refusing remote URL {url!r}")
+        if url.lower().startswith("file:") and not self.allow_file_urls:
+            raise GitMirrorError(f"file:// remotes are disabled (GIT_MIRROR_ALLOW_FILE_URLS): {url!r}")
+
+    async def _check_ref(self, ref: str):
+        if ref.startswith("-"):
+            raise GitMirrorError(f"Refusing ref {ref!r}")
+        if COMMIT_SHA_PATTERN.match(ref):
+            return
+        try:
+            await self._git("check-ref-format", "--allow-onelevel", ref)
+        except GitMirrorError:
+            raise GitMirrorError(f"Invalid ref {ref!r}") from None
+
+    async def _clone_or_fetch(self, mirror: _Mirror):
+        path = self._mirror_path(mirror.key)
+        start = time.perf_counter()
+        if os.path.isdir(path):
+            await self._git("fetch", "--prune", "origin", git_dir=path)
+            op = "fetch"
+        else:
+            partial = path + ".partial"
+            shutil.rmtree(partial, ignore_errors=True)
+            await self._git("clone", "--mirror", "--quiet", "--", mirror.url, partial)
+            os.replace(partial, path)
+            op = "clone"
+        mirror.fetched_at = time.time()
+        self.ops[op] += 1
+        increment(GIT_MIRROR_OPERATIONS, op=op)
+        logger.info(f"GIT_MIRROR({mirror.key}): {op} of {mirror.url} took {time.perf_counter() - start:.2f}s.")
+
+    async def _update(self, mirror: _Mirror, refresh: bool) -> bool:
+        """
+        Clones or fetches the mirror, joining an in-flight update of the same remote instead of starting
+        another. True when this call ran the clone or fetch (its caller re-measures the mirror).
+        """
+        future = self._inflight.get(mirror.url)
+        if future is not None:
+            self.ops["shared"] += 1
+            increment(GIT_MIRROR_OPERATIONS, op="shared")
+            await asyncio.shield(future)
+            return False
+        if not refresh and os.path.isdir(self._mirror_path(mirror.key)) and time.time() - mirror.fetched_at < self.fetch_ttl_seconds:
+            self.ops["fresh"] += 1
+            increment(GIT_MIRROR_OPERATIONS, op="fresh")
+            return False
+        future = asyncio.ensure_future(self._clone_or_fetch(mirror))
+        self._inflight[mirror.url] = future
+        try:
+            await asyncio.shield(future)
+            return True
+        finally:
+            if self._inflight.get(mirror.url) is future:
+                del self._inflight[mirror.url]
+
+    # --- Checkouts ---
+
+    @asynccontextmanager
+    async def checkout(self, url: str, ref: Optional[str] = None, refresh: bool = False) -> AsyncIterator[str]:
+        """
+        A worktree of `url` at `ref` (default: the remote's HEAD), valid until the block exits.
+        Callers must not modify it; the next checkout of the same ref may reuse it.
+        """
+        self._check_url(url)
+        if ref is not None:
+            await self._check_ref(ref)
+        mirror = self._mirrors.get(url)
+        if mirror is None:
+            mirror = self._mirrors[url] = _Mirror(url, mirror_key(url))
+        self._leases[url] += 1
+        try:
+            updated = await self._update(mirror, refresh)
+            async with self._locks.setdefault(url, asyncio.Lock()):
+                path, created = await self._worktree(mirror, ref or "HEAD")
+                mirror.last_used = mirror.worktrees[ref or "HEAD"].last_used = time.time()
+                if updated or created:
+                    paths = [self._mirror_path(mirror.key)] + [w.path for w in mirror.worktrees.values()]
+                    mirror.size_bytes = await asyncio.to_thread(lambda: sum(_disk_usage(p) for p in paths))
+                self._save_index()
+            await self.evict()
+            self._leases[path] += 1
+            try:
+                yield path
+            finally:
+                self._leases[path] -= 1
+                if not self._leases[path] and path in self._retired:
+                    self._retired.discard(path)
+                    await self._remove_worktree(self._mirror_path(mirror.key), path)
+        finally:
+            self._leases[url] -= 1
+
+    async def _worktree(self, mirror: _Mirror, ref: str) -> Tuple[str, bool]:
+        """The worktree path for `ref`, and whether it was just added."""
+        git_dir = self._mirror_path(mirror.key)
+        try:
+            commit = await self._git("rev-parse", "--verify", "--quiet", "--end-of-options", f"{ref}^{{commit}}", git_dir=git_dir)
+        except GitMirrorError:
+            raise GitMirrorError(f"Unknown ref {ref!r} in {mirror.url}") from None
+        existing = mirror.worktrees.get(ref)
+        if existing is not None and existing.commit == commit and os.path.isdir(existing.path):
+            return existing.path, False
+        if existing is not None:
+            # The ref moved. A worktree still being read is removed when its last reader is done.
+            if self._leases[existing.path]:
+                self._retired.add(existing.path)
+            else:
+                await self._remove_worktree(git_dir, existing.path)
+        safe_ref = re.sub(r"[^A-Za-z0-9._-]", "_", ref)
+        path = os.path.join(self.root, "worktrees", mirror.key, f"{safe_ref}@{commit[:12]}")
+        if os.path.isdir(path):
+            await self._remove_worktree(git_dir, path)
+        await self._git("worktree", "add", "--detach", "--quiet", path, commit, git_dir=git_dir)
+        mirror.worktrees[ref] = _Worktree(path, commit, time.time())
+        self.ops["worktree"] += 1
+        increment(GIT_MIRROR_OPERATIONS, op="worktree")
+        return path, True
+
+    async def _remove_worktree(self, git_dir: str, path: str):
+        shutil.rmtree(path, ignore_errors=True)
+        await self._git("worktree", "prune", git_dir=git_dir)
+
+    # --- Eviction ---
+
+    def size_bytes(self) -> int:
+        return sum(m.size_bytes for m in self._mirrors.values())
+
+    async def evict(self) -> List[str]:
+        """Drops least recently used mirrors not in use until the cache fits max_bytes; returns their URLs."""
+        evicted = []
+        for mirror in sorted(self._mirrors.values(), key=lambda m: m.last_used):
+            if self.size_bytes() <= self.max_bytes:
+                break
+            if self._leases[mirror.url] or mirror.url in self._inflight:
+                continue
+            shutil.rmtree(os.path.join(self.root, "worktrees", mirror.key), ignore_errors=True)
+            shutil.rmtree(self._mirror_path(mirror.key), ignore_errors=True)
+            del self._mirrors[mirror.url]
+            evicted.append(mirror.url)
+            self.ops["evict"] += 1
+            increment(GIT_MIRROR_OPERATIONS, op="evict")
+            logger.info(f"GIT_MIRROR({mirror.key}): Evicted {mirror.url} ({mirror.size_bytes} bytes).")
+        if evicted:
+            self._save_index()
+        return evicted
+
+    def stats(self) -> dict:
+        return {
+            "mirrors": len(self._mirrors),
+            "worktrees": sum(len(m.worktrees) for m in self._mirrors.values()),
+            "size_bytes": self.size_bytes(),
+            "max_bytes": self.max_bytes,
+            "ops": dict(self.ops),
+        }
+
+_cache: Optional[GitMirrorCache] = None
+
+def get_git_mirror_cache() -> GitMirrorCache:
+    global _cache
+    if _cache is None:
+        _cache = GitMirrorCache()
+    return _cache
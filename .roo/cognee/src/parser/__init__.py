@@ -1,6 +1,3 @@
-from .orchestrator import process_single_file
-from .cognee_adapter import adapt_parser_entities_to_graph_elements
-
 from .entities import (
     FileProcessingRequest,
     Repository,
@@ -18,8 +15,23 @@ from .entities import (
     ResolutionMethod,
 )
 
+# The orchestrator and adapter pull in cognee and the graph database. They are loaded on
+# first access so cognee-free tools (e.g. extract_cli) can import this package.
+_LAZY_EXPORTS = {
+    "process_single_file": ".orchestrator",
+    "process_files_bulk": ".orchestrator",
+    "adapt_parser_entities_to_graph_elements": ".cognee_adapter",
+}
+
+def __getattr__(name):
+    if name in _LAZY_EXPORTS:
+        import importlib
+        return getattr(importlib.import_module(_LAZY_EXPORTS[name], __name__), name)
+    raise AttributeError(f"module {__name__!r} has no attribute {name!r}")
+
 __all__ = [
     "process_single_file",
+    "process_files_bulk",
     "adapt_parser_entities_to_graph_elements",
     "FileProcessingRequest",
     "Repository",
@@ -0,0 +1,358 @@
+# .roo/cognee/src/parser/call_graph.py
+"""
+Maintained reachability over resolved FUNCTION_CALL edges, per repo@branch, so transitive caller
+("what can reach `utility_printer`") and callee ("what does `main` call") queries do not need
+multi-hop graph traversals.
+
+Each repository's call graph is kept condensed into strongly connected components (mutually
+recursive functions) with a topological order of the components:
+  * Adding an edge that agrees with the order is O(1). Otherwise only the components between
+    its endpoints are searched and reordered (Pearce-Kelly), merging them if a cycle closed.
+  * Removing edges or nodes (a file re-ingest or delete) re-splits only the components that
+    lost an internal edge.
+Reachability between two functions is answered in O(1) when their components are out of order
+or identical, otherwise by a search pruned to the components between them. Transitive
+caller/callee sets walk the condensed DAG.
+
+save_graph_data reports new edges and graph_utils path deletes remove a file's functions, both
+through code_indexes. A repository is loaded from the graph in bulk on first query, and again
+when another process has written to it since (see graph_versions.SeedStamps).
+"""
+from typing import Dict, Iterable, List, Optional, Set, Tuple
+
+from .graph_versions import SeedStamps, get_graph_versions
+from .symbol_index import locate, get_symbol_index
+from .utils import logger
+
+CALL_EDGE = "FUNCTION_CALL"
+
+def _tarjan(nodes: Iterable[str], succ: Dict[str, Set[str]]) -> List[List[str]]:
+    """Strongly connected components of the subgraph induced by `nodes`, in topological order."""
+    within = set(nodes)
+    index: Dict[str, int] = {}
+    low: Dict[str, int] = {}
+    stack: List[str] = []
+    on_stack: Set[str] = set()
+    components: List[List[str]] = []
+    for root in sorted(within):
+        if root in index:
+            continue
+        work = [(root, iter(sorted(succ.get(root, ()))))]
+        index[root] = low[root] = len(index)
+        stack.append(root); on_stack.add(root)
+        while work:
+            node, children = work[-1]
+            for child in children:
+                if child not in within:
+                    continue
+                if child not in index:
+                    index[child] = low[child] = len(index)
+                    stack.append(child); on_stack.add(child)
+                    work.append((child, iter(sorted(succ.get(child, ())))))
+                    break
+                if child in on_stack:
+                    low[node] = min(low[node], index[child])
+            else:
+                work.pop()
+                if work:
+                    parent = work[-1][0]
+                    low[parent] = min(low[parent], low[node])
+                if low[node] == index[node]:
+                    component = []
+                    while True:
+                        member = stack.pop(); on_stack.discard(member)
+                        component.append(member)
+                        if member == node: break
+                    components.append(component)
+    components.reverse()  # Tarjan emits a component after everything it reaches.
+    return components
+
+class RepoCallGraph:
+    def __init__(self, repo: str):
+        self.repo = repo
+        self.succ: Dict[str, Set[str]] = {}
+        self.pred: Dict[str, Set[str]] = {}
+        self.comp: Dict[str, int] = {}
+        self.members: Dict[int, Set[str]] = {}
+        self.order: List[int] = []
+        self.pos: Dict[int, int] = {}
+        self.by_path: Dict[str, Set[str]] = {}
+        self._next_comp = 0
+
+    def __len__(self) -> int:
+        return len(self.comp)
+
+    def _new_comp(self, members: Iterable[str]) -> int:
+        cid = self._next_comp
+        self._next_comp += 1
+        self.members[cid] = set(members)
+        for node in self.members[cid]:
+            self.comp[node] = cid
+        return cid
+
+    def _add_node(self, node: str):
+        if node in self.comp:
+            return
+        self.succ[node], self.pred[node] = set(), set()
+        cid = self._new_comp([node])
+        self.pos[cid] = len(self.order)
+        self.order.append(cid)
+        self.by_path.setdefault(locate(node)[1], set()).add(node)
+
+    def _renumber(self):
+        self.order = [c for c in self.order if c is not None]
+        self.pos = {c: i for i, c in enumerate(self.order)}
+
+    def load(self, edges: Iterable[Tuple[str, str]]):
+        """Replaces the graph with `edges`, condensing it in one pass."""
+        self.__init__(self.repo)
+        for source, target in edges:
+            for node in (source, target):
+                if node not in self.succ:
+                    self.succ[node], self.pred[node] = set(), set()
+                    self.by_path.setdefault(locate(node)[1], set()).add(node)
+            self.succ[source].add(target)
+            self.pred[target].add(source)
+        self.order = [self._new_comp(members) for members in _tarjan(self.succ, self.succ)]
+        self._renumber()
+
+    # --- Maintenance ---
+
+    def _comp_neighbours(self, cid: int, forward: bool) -> Set[int]:
+        adjacency = self.succ if forward else self.pred
+        return {self.comp[n] for m in self.members[cid] for n in adjacency[m]} - {cid}
+
+    def _search(self, start: int, forward: bool, within) -> Set[int]:
+        seen, stack = {start}, [start]
+        while stack:
+            for cid in self._comp_neighbours(stack.pop(), forward):
+                if cid not in seen and within(cid):
+                    seen.add(cid); stack.append(cid)
+        return seen
+
+    def add_edge(self, source: str, target: str) -> bool:
+        self._add_node(source)
+        self._add_node(target)
+        if target in self.succ[source]:
+            return False
+        self.succ[source].add(target)
+        self.pred[target].add(source)
+        cs, ct = self.comp[source], self.comp[target]
+        if cs == ct or self.pos[cs] < self.pos[ct]:
+            return True
+        # The new edge runs against the order: reorder the components between its endpoints.
+        lower, upper = self.pos[ct], self.pos[cs]
+        forward = self._search(ct, True, lambda c: self.pos[c] <= upper)
+        backward = self._search(cs, False, lambda c: self.pos[c] >= lower)
+        slots = sorted(self.pos[c] for c in forward | backward)
+        by_pos = lambda c: self.pos[c]
+        if cs in forward:
+            # A cycle closed: everything on a path from target back to source is one component now.
+            cycle = forward & backward
+            keep = min(cycle)
+            for cid in cycle - {keep}:
+                for node in self.members.pop(cid):
+                    self.comp[node] = keep
+                    self.members[keep].add(node)
+            head, tail = sorted(backward - cycle, key=by_pos) + [keep], sorted(forward - cycle, key=by_pos)
+        else:
+            head, tail = sorted(backward, key=by_pos), sorted(forward, key=by_pos)
+        # The backward set keeps the lowest slots and the forward set the highest, so neither moves
+        # past an unaffected component it is connected to; slots freed by a merge sit between them.
+        for slot in slots:
+            self.order[slot] = None
+        for slot, cid in list(zip(slots, head)) + list(zip(slots[len(slots) - len(tail):], tail)):
+            self.order[slot] = cid
+            self.pos[cid] = slot
+        if len(head) + len(tail) < len(slots):
+            self._renumber()
+        return True
+
+    def _resplit(self, cids: Set[int]):
+        """Recomputes the components in `cids` after they lost members or internal edges."""
+        order: List[int] = []
+        for cid in self.order:
+            if cid not in cids:
+                order.append(cid)
+                continue
+            remaining = self.members.pop(cid)
+            if len(remaining) == 1:
+                self.members[cid] = remaining
+                order.append(cid)
+                continue
+            for members in _tarjan(remaining, self.succ):
+                order.append(self._new_comp(members))
+        self.order = order
+        self._renumber()
+
+    def _isolated(self, nodes: Iterable[str]) -> List[str]:
+        return [n for n in nodes if n in self.comp and not self.succ[n] and not self.pred[n]]
+
+    def remove_edge(self, source: str, target: str):
+        if target not in self.succ.get(source, ()):
+            return
+        self.succ[source].discard(target)
+        self.pred[target].discard(source)
+        if self.comp[source] == self.comp[target]:
+            self._resplit({self.comp[source]})
+        self.remove_nodes(self._isolated({source, target}))
+
+    def remove_nodes(self, nodes: Iterable[str]):
+        """Drops functions with their calls, and any function left without calls either way."""
+        affected: Set[int] = set()
+        queue = [n for n in nodes if n in self.comp]
+        while queue:
+            node = queue.pop()
+            if node not in self.comp:
+                continue
+            cid = self.comp.pop(node)
+            affected.add(cid)
+            self.members[cid].discard(node)
+            neighbours = (self.succ.pop(node) | self.pred.pop(node)) - {node}
+            for other in neighbours:
+                self.pred[other].discard(node)
+                self.succ[other].discard(node)
+            queue.extend(self._isolated(neighbours))
+            path_nodes = self.by_path.get(locate(node)[1])
+            if path_nodes is not None:
+                path_nodes.discard(node)
+                if not path_nodes: del self.by_path[locate(node)[1]]
+        if not affected:
+            return
+        for cid in [c for c in affected if not self.members[c]]:
+            del self.members[cid]
+            self.order[self.pos.pop(cid)] = None
+            affected.discard(cid)
+        self._renumber()
+        if affected:
+            self._resplit(affected)
+
+    def remove_path(self, relative_path: str):
+        self.remove_nodes(list(self.by_path.get(relative_path, ())))
+
+    # --- Queries ---
+
+    def recursive(self, node: str) -> bool:
+        return len(self.members[self.comp[node]]) > 1 or node in self.succ[node]
+
+    def reaches(self, source: str, target: str) -> bool:
+        """Whether `target` is reachable from `source` through one or more calls."""
+        if source not in self.comp or target not in self.comp:
+            return False
+        cs, ct = self.comp[source], self.comp[target]
+        if cs == ct:
+            return source != target or self.recursive(source)
+        if self.pos[cs] > self.pos[ct]:
+            return False
+        upper = self.pos[ct]
+        seen, stack = {cs}, [cs]
+        while stack:
+            for cid in self._comp_neighbours(stack.pop(), True):
+                if cid == ct:
+                    return True
+                if cid not in seen and self.pos[cid] < upper:
+                    seen.add(cid); stack.append(cid)
+        return False
+
+    def closure(self, node: str, forward: bool = True) -> Set[str]:
+        """Every function `node` transitively calls (forward) or is called by (backward)."""
+        if node not in self.comp:
+            return set()
+        start = self.comp[node]
+        reached: Set[str] = set()
+        for cid in self._search(start, forward, lambda c: True) - {start}:
+            reached |= self.members[cid]
+        if self.recursive(node):
+            reached |= self.members[start]
+        return reached
+
+    def callees(self, node: str) -> Set[str]:
+        return self.closure(node, True)
+
+    def callers(self, node: str) -> Set[str]:
+        return self.closure(node, False)
+
+    def stats(self) -> dict:
+        return {
+            "functions": len(self.comp),
+            "calls": sum(len(targets) for targets in self.succ.values()),
+            "components": len(self.members),
+            "largest_component": max((len(m) for m in self.members.values()), default=0),
+        }
+
+class CallGraphIndex:
+    """The per-repository call graphs of this process."""
+    def __init__(self):
+        self._repos: Dict[str, RepoCallGraph] = {}
+        self._seeded = SeedStamps()
+
+    def get(self, repo: str) -> RepoCallGraph:
+        if repo not in self._repos:
+            self._repos[repo] = RepoCallGraph(repo)
+        return self._repos[repo]
+
+    def on_edges_saved(self, relationships: Iterable[Tuple]):
+        for source, target, rel_type, *_ in relationships:
+            if rel_type == CALL_EDGE:
+                self.get(source.split("|", 1)[0]).add_edge(source, target)
+
+    def on_path_deleted(self, repo: str, relative_path: str):
+        if repo in self._repos:
+            self._repos[repo].remove_path(relative_path)
+
+    async def ensure_seeded(self, repo: str, refresh: bool = False):
+        from .graph_utils import get_repo_edges
+        if (version := await self._seeded.due(repo, refresh)) is None:
+            return
+        edges = [(s, t) for s, t, _ in await get_repo_edges(repo, CALL_EDGE)]
+        self.get(repo).load(edges)
+        self._seeded.stamp(repo, version)
+        logger.info(f"CALL_GRAPH({repo}): Loaded {len(edges)} call edges, {self.get(repo).stats()['components']} components.")
+
+    async def _repos_for(self, scopes: Iterable[str]) -> List[str]:
+        prefixes = [s.strip("/") for s in scopes if s and s.strip("/")]
+        known = await get_graph_versions().known_repos(prefixes)
+        return sorted(set(known) | {r for r in self._repos if any(r == p or r.startswith(p + "@") for p in prefixes)})
+
+    async def query(self, scopes: Iterable[str], function: str, direction: str = "callers", limit: int = 200) -> dict:
+        """
+        Transitive callers (the impact set) or callees of `function`, given as an entity ID or a
+        name resolved through the symbol index. Each result carries its entity ID, FQN and path.
+        """
+        if direction not in ("callers", "callees"):
+            raise ValueError(f"direction must be 'callers' or 'callees', not {direction!r}")
+        repos = await self._repos_for(scopes)
+        for repo in repos:
+            await self.ensure_seeded(repo)
+        if "|" in function:
+            roots = [function]
+        else:
+            symbols = get_symbol_index()
+            await symbols.ensure_seeded(repos)
+            roots = [m["entity_id"] for m in symbols.lookup(function, repos) if m["entity_type"].startswith("Function")] or \
+                    [m["entity_id"] for m in symbols.lookup(function, repos)]
+        reached: Set[str] = set()
+        for root in roots:
+            graph = self.get(root.split("|", 1)[0])
+            reached |= graph.callers(root) if direction == "callers" else graph.callees(root)
+        results = [_describe(node) for node in sorted(reached)]
+        return {"function": function, "roots": roots, "direction": direction, "total": len(results), "results": results[:limit]}
+
+    async def neighbours(self, entity_id: str, direction: str = "callers", limit: int = 200) -> List[dict]:
+        """The direct callers or callees of one entity (its own CALLS edges), shaped like query's results."""
+        repo = entity_id.split("|", 1)[0]
+        await self.ensure_seeded(repo)
+        graph = self.get(repo)
+        adjacency = graph.pred if direction == "callers" else graph.succ
+        return [_describe(node) for node in sorted(adjacency.get(entity_id, ()))[:limit]]
+
+def _describe(node: str) -> dict:
+    return {"entity_id": node, "fqn": node.rsplit("|", 1)[-1].rsplit("@", 1)[0], "path": locate(node)[1]}
+
+_index: Optional[CallGraphIndex] = None
+
+def get_call_graph() -> CallGraphIndex:
+    global _index
+    if _index is None:
+        _index = CallGraphIndex()
+    return _index
@@ -29,7 +29,7 @@ def generate_text_chunks_from_slice_lines(
         logger.warning(f"{log_prefix}: All provided slice_lines were out of bounds for file with {num_total_lines} lines. Creating a single chunk for the whole file.")
         if num_total_lines > 0:
             chunk_content = "".join(lines_in_file)
-            chunk_id = f"{source_file_id}|0"
+            chunk_id = f"{source_file_id}|0@1-{num_total_lines}"
             text_chunks.append(
                 TextChunk(
                     id=chunk_id,
@@ -70,3 +70,13 @@ def generate_text_chunks_from_slice_lines(
 
     logger.info(f"{log_prefix}: Finished. Generated {len(text_chunks)} TextChunk(s).")
     return text_chunks
+
+def generate_intelligent_chunks(
+    source_file_id: str,
+    full_content_string: str,
+    slice_lines: List[int]
+) -> List[TextChunk]:
+    """
+    Generates TextChunk objects from the parser contract's 1-based slice_lines.
+    """
+    return generate_text_chunks_from_slice_lines(source_file_id, full_content_string, [line - 1 for line in slice_lines])
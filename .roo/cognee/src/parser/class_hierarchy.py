@@ -0,0 +1,382 @@
+# .roo/cognee/src/parser/class_hierarchy.py
+"""
+Class hierarchy and override index, per repo@branch. Answers "all overrides of
+`Base1::commonMethod`", "every subclass of `Base1`" and "what does `DerivedMultiple` inherit
+from" with dictionary lookups instead of repeated INHERITANCE traversals and name matching.
+
+The index records, from each saved island (or a graph scan on first use, repeated once another
+process has written to the repository; see graph_versions.SeedStamps):
+  * classes: ClassDefinition/StructDefinition entities (and class templates), keyed by their
+    qualified name without template arguments ('TemplatedBase<int>' -> 'TemplatedBase');
+  * base declarations: INHERITANCE references as written ('public Base1', 'ns::TemplatedBase<int>');
+  * methods: FunctionDefinitions whose qualified name extends a class key, with their normalized
+    signature and whether the definition says virtual/override/final or is pure (`= 0`);
+  * member declarations in a class body that are virtual/override/final or pure, so methods
+    defined out of class (which omit the keyword) and pure virtuals without a body are known.
+On the first query after a change it derives a topologically ordered class table (bases first),
+transitive bases and subclasses, each class's virtual slots (name plus normalized signature,
+declared there or inherited) and the pure ones it leaves unimplemented, and for each virtual
+method the methods in transitive subclasses with the same slot. Same-slot methods under a
+non-virtual one hide it rather than override it and are not listed; a class with unimplemented
+pure slots is abstract.
+"""
+import re
+from collections import deque
+from dataclasses import dataclass
+from typing import Dict, Iterable, List, Optional, Set, Tuple
+
+from .graph_versions import SeedStamps, get_graph_versions
+from .symbol_index import name_segments, locate, normalize_signature, split_signature
+from .utils import logger
+
+CLASS_TYPES = ("ClassDefinition", "StructDefinition")
+INHERITANCE = "INHERITANCE"
+_CLASS_TEMPLATE_RE = re.compile(r"^\s*template\s*<[^{]*>\s*(?:class|struct)\b")
+_VIRTUAL_RE = re.compile(r"\bvirtual\b|\)\s*(?:const\s*)?(?:noexcept\s*)?(?:override|final)\b")
+_PURE_RE = re.compile(r"\)\s*(?:const\s*)?(?:noexcept\s*)?(?:(?:override|final)\s*)*=\s*0\s*;?\s*$")
+# One member function declaration or definition head in a class body: prefix, name, parameters, trailer.
+_MEMBER_RE = re.compile(r"([^;{}()]*?)\b([A-Za-z_]\w*)\s*(\([^()]*\))([^;{}()]*)[;{]")
+_BASE_QUALIFIERS = {"public", "protected", "private", "virtual"}
+
+def class_key(name: str) -> str:
+    """'app::TemplatedBase<int>' -> 'app::TemplatedBase'."""
+    return "::".join(name_segments(name.strip()))
+
+def base_expression(text: str) -> str:
+    """'public virtual ns::Base<int>' -> 'ns::Base<int>'; access specifiers alone -> ''."""
+    words = [w for w in text.split() if w not in _BASE_QUALIFIERS]
+    return " ".join(words)
+
+def _slot_signature(params: str) -> str:
+    return normalize_signature(params or "()").split(" ")[0]
+
+def member_declarations(class_snippet: str) -> Set[Tuple[str, str, bool]]:
+    """(name, normalized signature, pure) of the virtual/override/final members in a class body; destructors are skipped."""
+    body = class_snippet.split("{", 1)[1] if "{" in class_snippet else ""
+    found = set()
+    for prefix, name, params, trailer in _MEMBER_RE.findall(body):
+        if prefix.rstrip().endswith("~"):
+            continue
+        pure = bool(re.search(r"=\s*0\s*$", trailer))
+        if pure or re.search(r"\bvirtual\b", prefix) or re.search(r"\b(?:override|final)\b", trailer):
+            found.add((name, _slot_signature(params), pure))
+    return found
+
+def _fqn(entity_id: str, canonical_fqn: Optional[str]) -> str:
+    return canonical_fqn or entity_id.rsplit("|", 1)[-1].rsplit("@", 1)[0]
+
+@dataclass(frozen=True)
+class ClassInfo:
+    entity_id: str
+    key: str
+    canonical_fqn: str
+    path: str
+    entity_type: str
+
+@dataclass(frozen=True)
+class MethodInfo:
+    entity_id: str
+    class_key: str
+    name: str
+    signature: str
+    virtual: bool
+    canonical_fqn: str
+    path: str
+    pure: bool = False
+
+    def to_dict(self) -> dict:
+        return {"entity_id": self.entity_id, "class": self.class_key, "name": self.name, "signature": self.signature,
+                "canonical_fqn": self.canonical_fqn, "path": self.path}
+
+class RepoHierarchy:
+    def __init__(self, repo: str):
+        self.repo = repo
+        self.classes: Dict[str, ClassInfo] = {}
+        self.methods: Dict[str, MethodInfo] = {}
+        self.base_decls: Dict[str, Set[str]] = {}   # class entity ID -> base expressions
+        self.member_decls: Dict[str, Set[Tuple[str, str, bool]]] = {}  # class entity ID -> member_declarations()
+        self.by_path: Dict[str, Set[str]] = {}
+        self._dirty = True
+        # Derived on demand.
+        self.order: List[str] = []
+        self.bases: Dict[str, Set[str]] = {}
+        self.ancestors: Dict[str, Tuple[str, ...]] = {}
+        self.descendants: Dict[str, Set[str]] = {}
+        self.position: Dict[str, int] = {}
+        self.class_ids: Dict[str, List[str]] = {}
+        self.methods_by_name: Dict[str, Set[str]] = {}
+        self.overriders: Dict[str, List[str]] = {}
+        self.overridden: Dict[str, List[str]] = {}
+        self.virtual: Set[str] = set()
+        self.virtual_slots: Dict[str, Set[Tuple[str, str]]] = {}
+        self.abstract: Dict[str, Set[Tuple[str, str]]] = {}  # class key -> pure slots it leaves unimplemented
+
+    def __len__(self) -> int:
+        return len(self.classes)
+
+    def _track(self, entity_id: str):
+        self.by_path.setdefault(locate(entity_id)[1], set()).add(entity_id)
+        self._dirty = True
+
+    # --- Maintenance ---
+
+    def add_entity(self, entity_id: str, entity_type: str, canonical_fqn: Optional[str], snippet: str = ""):
+        fqn = _fqn(entity_id, canonical_fqn)
+        if entity_type in CLASS_TYPES or (entity_type == "TemplateDefinition" and _CLASS_TEMPLATE_RE.match(snippet or "")):
+            self.classes[entity_id] = ClassInfo(entity_id, class_key(split_signature(fqn)[0]), fqn, locate(entity_id)[1], entity_type)
+            if declarations := member_declarations(snippet or ""):
+                self.member_decls[entity_id] = declarations
+            self._track(entity_id)
+        elif entity_type == "FunctionDefinition":
+            qualified_name, params = split_signature(fqn)
+            segments = name_segments(qualified_name)
+            if len(segments) < 2:
+                return
+            head = (snippet or "").split("{", 1)[0]
+            pure = bool(_PURE_RE.search(head))
+            self.methods[entity_id] = MethodInfo(entity_id, "::".join(segments[:-1]), segments[-1], _slot_signature(params),
+                                                 pure or bool(_VIRTUAL_RE.search(head)), fqn, locate(entity_id)[1], pure)
+            self._track(entity_id)
+
+    def add_base(self, class_entity_id: str, expression: str):
+        if expression := base_expression(expression):
+            self.base_decls.setdefault(class_entity_id, set()).add(expression)
+            self._track(class_entity_id)
+
+    def remove_path(self, relative_path: str):
+        for entity_id in self.by_path.pop(relative_path, ()):
+            self.classes.pop(entity_id, None)
+            self.methods.pop(entity_id, None)
+            self.base_decls.pop(entity_id, None)
+            self.member_decls.pop(entity_id, None)
+            self._dirty = True
+
+    # --- Derivation ---
+
+    def _resolve_base(self, expression: str, keys: Set[str], by_name: Dict[str, Set[str]], derived_key: str) -> Set[str]:
+        """A base expression's class keys: exact, else by trailing segments, preferring the derived class's namespace."""
+        key = class_key(expression)
+        if key in keys and key != derived_key:
+            return {key}
+        name = key.rsplit("::", 1)[-1]
+        candidates = {k for k in by_name.get(name, ()) if k == key or k.endswith("::" + key)} - {derived_key}
+        scope = derived_key.rsplit("::", 1)[0] if "::" in derived_key else ""
+        scoped = {k for k in candidates if scope and k.startswith(scope + "::")}
+        return scoped or candidates
+
+    def _derive(self):
+        keys = {c.key for c in self.classes.values()}
+        self.class_ids = {}
+        for info in sorted(self.classes.values(), key=lambda c: c.entity_id):
+            self.class_ids.setdefault(info.key, []).append(info.entity_id)
+        by_name: Dict[str, Set[str]] = {}
+        for key in keys:
+            by_name.setdefault(key.rsplit("::", 1)[-1], set()).add(key)
+        self.bases = {key: set() for key in keys}
+        for entity_id, expressions in self.base_decls.items():
+            if entity_id in self.classes:
+                derived = self.classes[entity_id].key
+                for expression in expressions:
+                    self.bases[derived] |= self._resolve_base(expression, keys, by_name, derived)
+
+        # Kahn's algorithm: bases before derived classes; classes on a (malformed) cycle go last.
+        children: Dict[str, Set[str]] = {key: set() for key in keys}
+        pending = {key: len(bases) for key, bases in self.bases.items()}
+        for key, bases in self.bases.items():
+            for base in bases:
+                children[base].add(key)
+        ready = deque(sorted(key for key, n in pending.items() if n == 0))
+        order: List[str] = []
+        while ready:
+            key = ready.popleft()
+            order.append(key)
+            for child in sorted(children[key]):
+                pending[child] -= 1
+                if pending[child] == 0:
+                    ready.append(child)
+        cyclic = sorted(keys - set(order))
+        if cyclic:
+            logger.warning(f"CLASS_HIERARCHY({self.repo}): Inheritance cycle among {cyclic[:5]}.")
+        self.order = order + cyclic
+        self.position = {key: i for i, key in enumerate(self.order)}
+
+        self.ancestors = {}
+        for key in self.order:
+            seen: Dict[str, None] = {}
+            for base in sorted(self.bases[key]):
+                for ancestor in (base,) + self.ancestors.get(base, ()):
+                    if ancestor != key: seen[ancestor] = None
+            self.ancestors[key] = tuple(seen)
+        self.descendants = {key: set() for key in keys}
+        for key, ancestors in self.ancestors.items():
+            for ancestor in ancestors:
+                self.descendants[ancestor].add(key)
+
+        by_slot: Dict[Tuple[str, str, str], List[str]] = {}
+        self.methods_by_name = {}
+        for method in self.methods.values():
+            if method.class_key in self.bases:
+                by_slot.setdefault((method.class_key, method.name, method.signature), []).append(method.entity_id)
+                self.methods_by_name.setdefault(method.name, set()).add(method.entity_id)
+
+        # Slots each class declares virtual (True if pure), from its body and its own method definitions.
+        declared: Dict[str, Dict[Tuple[str, str], bool]] = {key: {} for key in keys}
+        for entity_id, declarations in self.member_decls.items():
+            if entity_id in self.classes:
+                slots = declared[self.classes[entity_id].key]
+                for name, signature, pure in declarations:
+                    slots[(name, signature)] = slots.get((name, signature), False) or pure
+        defined: Dict[str, Set[Tuple[str, str]]] = {key: set() for key in keys}
+        for (key, name, signature), method_ids in by_slot.items():
+            methods = [self.methods[m] for m in method_ids]
+            if any(m.virtual for m in methods):
+                declared[key][(name, signature)] = declared[key].get((name, signature), False) or any(m.pure for m in methods)
+            if not all(m.pure for m in methods):
+                defined[key].add((name, signature))
+        # Bases first, so a class inherits its bases' virtual and still-pure slots; a pure virtual
+        # defined out of class stays pure.
+        self.virtual_slots, self.abstract = {}, {}
+        for key in self.order:
+            bases = self.bases[key]
+            self.virtual_slots[key] = set(declared[key]).union(*(self.virtual_slots.get(b, ()) for b in bases))
+            inherited = set().union(*(self.abstract.get(b, ()) for b in bases))
+            self.abstract[key] = (inherited - defined[key]) | {slot for slot, pure in declared[key].items() if pure}
+
+        # Only a virtual base method is overridden; a same-slot method under a non-virtual one hides it.
+        self.overriders, self.overridden = {}, {}
+        for (key, name, signature), method_ids in by_slot.items():
+            for ancestor in self.ancestors[key]:
+                if (name, signature) not in self.virtual_slots[ancestor]:
+                    continue
+                for base_method in by_slot.get((ancestor, name, signature), ()):
+                    for method_id in method_ids:
+                        self.overriders.setdefault(base_method, []).append(method_id)
+                        self.overridden.setdefault(method_id, []).append(base_method)
+        self.virtual = {m.entity_id for m in self.methods.values()
+                        if m.virtual or (m.name, m.signature) in self.virtual_slots.get(m.class_key, ())}
+        self._dirty = False
+
+    def derived(self) -> "RepoHierarchy":
+        if self._dirty:
+            self._derive()
+        return self
+
+    # --- Queries ---
+
+    def match_classes(self, name: str) -> List[str]:
+        key = class_key(name)
+        self.derived()
+        if key in self.bases:
+            return [key]
+        return sorted(k for k in self.bases if k.endswith("::" + key))
+
+    def match_methods(self, name: str) -> List[MethodInfo]:
+        qualified_name, params = split_signature(name.strip().strip("`"))
+        signature = normalize_signature(params).split(" ")[0] if params else ""
+        segments = name_segments(qualified_name)
+        found = []
+        for method_id in self.derived().methods_by_name.get(segments[-1] if segments else "", ()):
+            method = self.methods[method_id]
+            method_segments = name_segments(method.class_key) + [method.name]
+            if method_segments[-len(segments):] == segments and (not signature or method.signature == signature):
+                found.append(method)
+        return sorted(found, key=lambda m: (m.class_key, m.signature, m.entity_id))
+
+    def class_table(self) -> List[dict]:
+        self.derived()
+        return [{"class": key, "bases": sorted(self.bases[key]), "ancestors": list(self.ancestors[key]),
+                 "subclasses": len(self.descendants[key]), "leaf": not self.descendants[key], "abstract": bool(self.abstract[key])}
+                for key in self.order]
+
+class ClassHierarchyIndex:
+    """The per-repository class hierarchies of this process."""
+    def __init__(self):
+        self._repos: Dict[str, RepoHierarchy] = {}
+        self._seeded = SeedStamps()
+
+    def get(self, repo: str) -> RepoHierarchy:
+        if repo not in self._repos:
+            self._repos[repo] = RepoHierarchy(repo)
+        return self._repos[repo]
+
+    def on_island_saved(self, repo: str, island):
+        hierarchy = self.get(repo)
+        for entity in island.code_entities:
+            hierarchy.add_entity(entity.id, entity.type, entity.canonical_fqn, entity.snippet_content)
+        for ref in island.raw_references:
+            if ref.reference_type == INHERITANCE:
+                hierarchy.add_base(ref.source_entity_id, ref.target_expression)
+
+    def on_path_deleted(self, repo: str, relative_path: str):
+        if repo in self._repos:
+            self._repos[repo].remove_path(relative_path)
+
+    async def ensure_seeded(self, repos: Iterable[str], refresh: bool = False):
+        """Scans each repository's entities, resolved INHERITANCE edges and pending ones from the graph unless its seed is current."""
+        from .graph_utils import find_nodes_with_filter, get_repo_edges
+        for repo in repos:
+            if (version := await self._seeded.due(repo, refresh)) is None:
+                continue
+            # Built aside and published whole: readers keep the previous hierarchy while the scan awaits.
+            hierarchy = RepoHierarchy(repo)
+            entity_nodes = await find_nodes_with_filter({"type": "CodeEntity", "repo_id_str": repo})
+            fqns = {}
+            for node in entity_nodes:
+                a = node.attributes
+                hierarchy.add_entity(node.id, a.get("type"), a.get("canonical_fqn"), a.get("snippet_content") or "")
+                fqns[node.id] = _fqn(node.id, a.get("canonical_fqn"))
+            for source, target, _ in await get_repo_edges(repo, INHERITANCE):
+                hierarchy.add_base(source, fqns.get(target) or _fqn(target, None))
+            for node in await find_nodes_with_filter({"type": "PendingLink", "repo_id_str": repo}):
+                ref = node.attributes.get("reference_data") or {}
+                if ref.get("reference_type") == INHERITANCE:
+                    hierarchy.add_base(ref.get("source_entity_id", ""), ref.get("target_expression", ""))
+            self._repos[repo] = hierarchy
+            self._seeded.stamp(repo, version)
+            logger.info(f"CLASS_HIERARCHY({repo}): Seeded {len(hierarchy.classes)} classes and {len(hierarchy.methods)} methods from the graph.")
+
+    async def _repos_for(self, scopes: Iterable[str]) -> List[str]:
+        prefixes = [s.strip("/") for s in scopes if s and s.strip("/")]
+        known = await get_graph_versions().known_repos(prefixes)
+        return sorted(set(known) | {r for r in self._repos if any(r == p or r.startswith(p + "@") for p in prefixes)})
+
+    async def query(self, scopes: Iterable[str], name: str, kind: str = "overrides") -> dict:
+        """
+        kind: 'overrides' (methods overriding `name`), 'overridden' (methods `name` overrides),
+        'subclasses', 'concrete_subclasses' (those leaving no pure virtual unimplemented), 'bases'
+        (transitive; each direct base before its own) or 'classes' (the topologically ordered class
+        table; `name` is ignored).
+        """
+        if kind not in ("overrides", "overridden", "subclasses", "concrete_subclasses", "bases", "classes"):
+            raise ValueError(f"Unknown hierarchy query kind {kind!r}")
+        repos = await self._repos_for(scopes)
+        await self.ensure_seeded(repos)
+        results: List[dict] = []
+        for repo in repos:
+            hierarchy = self.get(repo).derived()
+            if kind == "classes":
+                results.extend({"repo": repo, **row} for row in hierarchy.class_table())
+            elif kind in ("overrides", "overridden"):
+                table = hierarchy.overriders if kind == "overrides" else hierarchy.overridden
+                for method in hierarchy.match_methods(name):
+                    for other in table.get(method.entity_id, ()):
+                        results.append({"repo": repo, "of": method.canonical_fqn, **hierarchy.methods[other].to_dict(),
+                                        "virtual": other in hierarchy.virtual})
+            else:
+                for key in hierarchy.match_classes(name):
+                    if kind == "bases":
+                        related = list(hierarchy.ancestors[key])
+                    else:
+                        related = sorted(hierarchy.descendants[key], key=hierarchy.position.get)
+                        if kind == "concrete_subclasses":
+                            related = [k for k in related if not hierarchy.abstract[k]]
+                    results.extend({"repo": repo, "of": key, "class": k} for k in related)
+        return {"name": name, "kind": kind, "total": len(results), "results": results}
+
+_index: Optional[ClassHierarchyIndex] = None
+
+def get_class_hierarchy() -> ClassHierarchyIndex:
+    global _index
+    if _index is None:
+        _index = ClassHierarchyIndex()
+    return _index
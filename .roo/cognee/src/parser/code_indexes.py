@@ -0,0 +1,37 @@
+# .roo/cognee/src/parser/code_indexes.py
+"""
+Keeps the in-process code indexes in step with the graph. The orchestrator reports each saved
+file island, save_graph_data every batch of edges, and graph_utils each whole-file delete
+(which precedes every re-ingest), both before the nodes go and after. The orchestrator calls
+before_transaction first, so what the delete hook consults is seeded outside the transaction.
+"""
+from .call_graph import get_call_graph
+from .class_hierarchy import get_class_hierarchy
+from .include_graph import get_include_graph
+from .interval_index import get_interval_indexes
+from .symbol_index import get_symbol_index
+from .trigram_index import get_trigram_indexes
+
+def on_island_saved(repo_id_with_branch: str, island):
+    get_symbol_index().add_entities(island.code_entities)
+    get_trigram_indexes().on_island_saved(repo_id_with_branch, island)
+    get_class_hierarchy().on_island_saved(repo_id_with_branch, island)
+    get_include_graph().on_island_saved(repo_id_with_branch, island)
+    get_interval_indexes().on_island_saved(repo_id_with_branch, island)
+
+def on_edges_saved(relationships):
+    get_call_graph().on_edges_saved(relationships)
+
+async def before_transaction(repo_id_with_branch: str):
+    await get_include_graph().ensure_seeded([repo_id_with_branch])
+
+async def before_path_deleted(repo_id_with_branch: str, relative_path: str):
+    await get_include_graph().before_path_deleted(repo_id_with_branch, relative_path)
+
+def on_path_deleted(repo_id_with_branch: str, relative_path: str):
+    get_symbol_index().remove_path(repo_id_with_branch, relative_path)
+    get_trigram_indexes().on_path_deleted(repo_id_with_branch, relative_path)
+    get_call_graph().on_path_deleted(repo_id_with_branch, relative_path)
+    get_class_hierarchy().on_path_deleted(repo_id_with_branch, relative_path)
+    get_include_graph().on_path_deleted(repo_id_with_branch, relative_path)
+    get_interval_indexes().on_path_deleted(repo_id_with_branch, relative_path)
@@ -7,7 +7,13 @@ from .entities import (
     PendingLink, ResolutionCache, AdaptableNode
 )
 
-from cognee.modules.graph.cognee_graph.CogneeGraphElements import Node, Edge
+try:
+    from cognee.modules.graph.cognee_graph.CogneeGraphElements import Node
+except ImportError:
+    # Only the local graph backend works without cognee; it needs nothing beyond .id and .attributes.
+    from .local_graph_backend import LocalNode
+    def Node(node_id: str, attributes: Dict[str, Any]) -> LocalNode:
+        return LocalNode(node_id, attributes)
 
 CogneeEdgeTuple = Tuple[str, str, str, Dict[str, Any]]
 
@@ -30,7 +36,8 @@ def adapt_parser_entities_to_graph_elements(
     for p_node in p_nodes:
         p_slug_id = p_node.id
         attributes = p_node.model_dump()
-        attributes["node_type"] = p_node.type
+        # The label the DAL filters on ('CodeEntity'); `type` keeps the specific kind ('FunctionDefinition').
+        attributes["node_type"] = p_node.__class__.__name__
         attributes["slug_id"] = p_slug_id
         index_fields = ["slug_id", "node_type"]
         if isinstance(p_node, SourceFile):
@@ -50,17 +57,17 @@ def adapt_parser_entities_to_graph_elements(
         )
         cognee_nodes.append(cognee_node_instance)
         slug_id_to_node_map[p_slug_id] = cognee_node_instance
-        edge_tuples_for_cognee: List[CogneeEdgeTuple] = []
-        for p_rel in p_relationships:
-            edge_tuple = (
-                p_rel.source_id,
-                p_rel.target_id,
-                p_rel.type.upper(),
-                p_rel.properties or {}
-            )
-            edge_tuples_for_cognee.append(edge_tuple)
-        else:
-            logger.warning(f"{log_prefix}: Skipping edge because source or target node was not in the same batch: {p_rel.source_id} -> {p_rel.target_id}")
+
+    # Edges may point at nodes saved in earlier batches (e.g. Tier 1 targets), so all are kept.
+    edge_tuples_for_cognee: List[CogneeEdgeTuple] = []
+    for p_rel in p_relationships:
+        edge_tuple = (
+            p_rel.source_id,
+            p_rel.target_id,
+            p_rel.type.upper(),
+            p_rel.properties or {}
+        )
+        edge_tuples_for_cognee.append(edge_tuple)
 
     logger.info(f"{log_prefix}: Finished. Produced {len(cognee_nodes)} nodes and {len(edge_tuples_for_cognee)} edges.")
     return cognee_nodes, edge_tuples_for_cognee
@@ -6,6 +6,79 @@ BATCH_SIZE_LLM_ENHANCEMENT = 20
 GENERIC_CHUNK_SIZE = 1000
 GENERIC_CHUNK_OVERLAP = 100
 
+# Files at or above this many lines have their top-level declarations walked in parallel worker processes.
+PARALLEL_EXTRACTION_MIN_LINES = 50000
+PARALLEL_EXTRACTION_MAX_WORKERS = os.cpu_count() or 1
+# More batches than workers keeps the pool busy when declaration sizes are uneven.
+PARALLEL_EXTRACTION_BATCHES_PER_WORKER = 4
+
+# Bulk ingestion reads files in batches, one thread-pool hop per batch.
+BULK_READ_BATCH_SIZE = 256
+BULK_READ_MAX_INFLIGHT_BATCHES = 4
+BULK_INGEST_CONCURRENCY = 8
+# Files read but not yet picked up by a worker; bounds how much content a bulk ingest holds in memory.
+BULK_INGEST_QUEUE_SIZE = 32
+
+# Sharded ingestion: worker processes, and how many parsed files the coordinator commits per transaction.
+SHARDED_INGEST_WORKERS = os.cpu_count() or 1
+SHARDED_INGEST_GROUP_COMMIT_SIZE = 64
+SHARDED_INGEST_GROUP_COMMIT_MAX_DELAY = 0.25
+SHARDED_INGEST_QUEUE_SIZE = 1024
+
+# Default progress journal for resumable bulk ingestion; empty disables it.
+INGEST_JOURNAL_PATH = os.environ.get("INGEST_JOURNAL_PATH", "")
+
+# Graph store behind graph_utils: "cognee" (the configured graph engine, e.g. Neo4j) or "local" (embedded SQLite).
+GRAPH_BACKEND = os.environ.get("GRAPH_BACKEND", "cognee")
+LOCAL_GRAPH_DB_PATH = os.environ.get("LOCAL_GRAPH_DB_PATH", ".cognee_local/graph.db")
+# Per-repo graph versions are also stored in the graph so in-memory indexes see other processes' writes
+# (src/parser/graph_versions.py); a process re-reads them at most this often.
+GRAPH_VERSION_POLL_SECONDS = float(os.environ.get("GRAPH_VERSION_POLL_SECONDS", "1.0"))
+
+# Appends every FileProcessingRequest to this NDJSON trace for later replay; empty disables recording.
+# Content is stored "inline", or as a git "blob" ID written into the repository's object store.
+INGEST_RECORD_PATH = os.environ.get("INGEST_RECORD_PATH", "")
+INGEST_RECORD_CONTENT = os.environ.get("INGEST_RECORD_CONTENT", "inline")
+
+# Stage histograms, counters and gauges (src/parser/metrics.py). METRICS_PORT > 0 lets long-running CLIs
+# serve /metrics; METRICS_DUMP_PATH writes a JSON snapshot at exit.
+METRICS_ENABLED = os.environ.get("METRICS_ENABLED", "1") != "0"
+METRICS_PORT = int(os.environ.get("METRICS_PORT", "0"))
+METRICS_DUMP_PATH = os.environ.get("METRICS_DUMP_PATH", "")
+
+# Per-file entity interval index (src/parser/interval_index.py); empty keeps it in memory only.
+INTERVAL_INDEX_DIR = os.environ.get("INTERVAL_INDEX_DIR", "")
+
+# CSR graph snapshots for in-process analytics (src/parser/graph_snapshot.py), one memory-mapped file per repo@branch.
+GRAPH_SNAPSHOT_DIR = os.environ.get("GRAPH_SNAPSHOT_DIR", ".cognee_local/snapshots")
+
+# MCP search pagination (src/search_pagination.py): items per page, the server-side cap on a query's results, the
+# JSON size at which a page is cut short, how long a cursor's result list is held, and snippet truncation.
+SEARCH_PAGE_SIZE = int(os.environ.get("SEARCH_PAGE_SIZE", "20"))
+SEARCH_RESULT_LIMIT = int(os.environ.get("SEARCH_RESULT_LIMIT", "500"))
+SEARCH_PAGE_MAX_BYTES = int(os.environ.get("SEARCH_PAGE_MAX_BYTES", str(64 * 1024)))
+SEARCH_CURSOR_TTL_SECONDS = float(os.environ.get("SEARCH_CURSOR_TTL_SECONDS", "300"))
+SEARCH_SNIPPET_MAX_CHARS = int(os.environ.get("SEARCH_SNIPPET_MAX_CHARS", "400"))
+
+# Bare git mirrors reused by codify for remote repositories (src/git_mirror_cache.py), evicted least recently used
+# beyond the byte budget; a mirror fetched less than the TTL ago is not fetched again. file:// remotes read
+# arbitrary paths of the server's filesystem, so they are refused unless enabled (tests use local remotes).
+GIT_MIRROR_CACHE_DIR = os.environ.get("GIT_MIRROR_CACHE_DIR", ".cognee_local/git_mirrors")
+GIT_MIRROR_CACHE_MAX_BYTES = int(os.environ.get("GIT_MIRROR_CACHE_MAX_BYTES", str(5 * 1024 ** 3)))
+GIT_MIRROR_FETCH_TTL_SECONDS = float(os.environ.get("GIT_MIRROR_FETCH_TTL_SECONDS", "30"))
+GIT_MIRROR_ALLOW_FILE_URLS = os.environ.get("GIT_MIRROR_ALLOW_FILE_URLS", "0") != "0"
+
+# Trigram code-search index (src/parser/trigram_index.py). With a directory, each repo@branch's segment is a
+# memory-mapped file that survives restarts; empty keeps segments in anonymous memory maps. The in-memory delta
+# is folded into the segment once it holds this many chunks (or a quarter of the segment, if larger).
+TRIGRAM_INDEX_DIR = os.environ.get("TRIGRAM_INDEX_DIR", "")
+TRIGRAM_COMPACT_THRESHOLD = int(os.environ.get("TRIGRAM_COMPACT_THRESHOLD", "2000"))
+# Regex code searches are matched in a worker thread and abandoned after this many seconds (patterns come from clients).
+TRIGRAM_REGEX_TIMEOUT_SECONDS = float(os.environ.get("TRIGRAM_REGEX_TIMEOUT_SECONDS", "2"))
+
+# Parsers and grammars load on first use; services can pre-warm languages (e.g. "cpp,c") at startup.
+PARSER_PREWARM = os.environ.get("PARSER_PREWARM", "")
+
 IGNORED_DIRS = {
     ".git",
     ".hg",
@@ -0,0 +1,52 @@
+# .roo/cognee/src/parser/discovery.py
+import asyncio
+import os
+from fnmatch import fnmatch
+from pathlib import Path
+from typing import AsyncGenerator, Iterator, Optional, Tuple
+
+from .configs import IGNORED_DIRS, IGNORED_FILES, SUPPORTED_EXTENSIONS
+from .utils import logger
+
+_IGNORED_DIR_PATHS = {d for d in IGNORED_DIRS if "/" in d}
+_IGNORED_DIR_NAMES = IGNORED_DIRS - _IGNORED_DIR_PATHS
+
+def _is_ignored_dir(name: str, rel_path: str) -> bool:
+    if any(fnmatch(name, pattern) for pattern in _IGNORED_DIR_NAMES):
+        return True
+    return any(fnmatch(rel_path, pattern) for pattern in _IGNORED_DIR_PATHS)
+
+def _is_ignored_file(name: str) -> bool:
+    return any(fnmatch(name, pattern) for pattern in IGNORED_FILES)
+
+def get_file_type(file_name: str) -> Optional[str]:
+    """Maps a file name to its language key in SUPPORTED_EXTENSIONS (exact names like 'Dockerfile' win)."""
+    return SUPPORTED_EXTENSIONS.get(file_name) or SUPPORTED_EXTENSIONS.get(Path(file_name).suffix.lower())
+
+def iter_repository_files(root_path: str) -> Iterator[Tuple[str, str, str]]:
+    """
+    Walks a repository applying the ignore rules from configs.py.
+    Yields (absolute_path, relative_path, file_type) for supported files, in sorted order.
+    """
+    if not os.path.isdir(root_path):
+        logger.warning(f"DISCOVERY: Not a directory, nothing to discover: {root_path}")
+        return
+    for dir_path, dir_names, file_names in os.walk(root_path):
+        rel_dir = os.path.relpath(dir_path, root_path)
+        rel_dir = "" if rel_dir == "." else rel_dir
+        dir_names[:] = sorted(
+            d for d in dir_names
+            if not _is_ignored_dir(d, Path(rel_dir, d).as_posix())
+        )
+        for file_name in sorted(file_names):
+            if _is_ignored_file(file_name):
+                continue
+            file_type = get_file_type(file_name)
+            if not file_type:
+                continue
+            yield os.path.join(dir_path, file_name), os.path.join(rel_dir, file_name), file_type
+
+async def discover_files(root_path: str) -> AsyncGenerator[Tuple[str, str, str], None]:
+    """Async wrapper over iter_repository_files; the walk runs off the event loop."""
+    for entry in await asyncio.to_thread(lambda: list(iter_repository_files(root_path))):
+        yield entry
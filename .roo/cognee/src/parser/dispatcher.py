@@ -9,9 +9,12 @@ from .graph_enhancement_engine import (
     run_tier2_enhancement,
     run_tier3_enhancement,
     run_repair_worker,
+    run_header_impact_recheck,
 )
 # Import the new graph utils function for marking failures
 from .graph_utils import find_nodes_with_filter, update_pending_link_status, mark_enhancement_failed
+from .graph_versions import get_graph_versions
+from .metrics import timed, increment, DISPATCHER_TIMERS, DISPATCHER_TIMER_RESETS, ENHANCEMENT_CYCLES, ENHANCEMENT_CYCLE_SECONDS
 
 class IntelligentEnrichmentDispatcher:
     """
@@ -25,6 +28,7 @@ class IntelligentEnrichmentDispatcher:
         # A dictionary to keep track of the "countdown" task for each repository.
         self.watched_repos: Dict[str, asyncio.Task] = {}
         self.log_prefix = "DISPATCHER"
+        DISPATCHER_TIMERS.set_function(lambda: len(self.watched_repos))
         logger.info(f"{self.log_prefix}: Dispatcher initialized.")
 
     async def _run_full_enhancement_cycle(self, repo_id_with_branch: str):
@@ -36,6 +40,9 @@ class IntelligentEnrichmentDispatcher:
         logger.info(f"{log_prefix}: Starting full enhancement cycle.")
 
         try:
+            # 0. Re-point or reopen the links that headers changed since the last cycle affect.
+            await run_header_impact_recheck(repo_id_with_branch)
+
             # 1. Promote all PENDING_RESOLUTION links for this repo to READY_FOR_HEURISTICS.
             links_to_promote = await find_nodes_with_filter({
                 "type": "PendingLink",
@@ -61,16 +68,19 @@ class IntelligentEnrichmentDispatcher:
                     logger.critical(f"{log_prefix}: An enhancement task failed. Marking cycle as FAILED.", exc_info=result)
                     # Mark the repo's heartbeat to prevent retries of the failed cycle.
                     await mark_enhancement_failed(repo_id_with_branch, str(result))
+                    increment(ENHANCEMENT_CYCLES, repo=repo_id_with_branch, outcome="failed")
                     # We break after the first failure to avoid multiple notifications.
                     break
             else:
                  # This 'else' belongs to the 'for' loop, it runs if the loop completed without a break.
                 logger.info(f"{log_prefix}: Full enhancement cycle completed successfully.")
+                increment(ENHANCEMENT_CYCLES, repo=repo_id_with_branch, outcome="ok")
 
         except Exception as e:
             # This outer block catches failures in the promotion step itself.
             logger.error(f"{log_prefix}: A critical error occurred during the enhancement cycle. Error: {e}", exc_info=True)
             await mark_enhancement_failed(repo_id_with_branch, str(e))
+            increment(ENHANCEMENT_CYCLES, repo=repo_id_with_branch, outcome="failed")
 
     async def _watch_for_quiescence(self, repo_id_with_branch: str):
         """
@@ -82,12 +92,18 @@ class IntelligentEnrichmentDispatcher:
             await asyncio.sleep(QUIESCENCE_PERIOD_SECONDS)
 
             logger.info(f"{self.log_prefix}: Quiescence detected for '{repo_id_with_branch}'. Dispatching full enhancement cycle.")
-            await self._run_full_enhancement_cycle(repo_id_with_branch)
+            try:
+                with timed(ENHANCEMENT_CYCLE_SECONDS, repo=repo_id_with_branch):
+                    await self._run_full_enhancement_cycle(repo_id_with_branch)
+            finally:
+                await get_graph_versions().record_write(repo_id_with_branch, source="enhancement")
 
         except asyncio.CancelledError:
             logger.info(f"{self.log_prefix}: Watch cancelled for '{repo_id_with_branch}'. Activity detected, timer reset.")
         finally:
-            self.watched_repos.pop(repo_id_with_branch, None)
+            # A cancelled timer finishes after its replacement is registered; only remove our own entry.
+            if self.watched_repos.get(repo_id_with_branch) is asyncio.current_task():
+                del self.watched_repos[repo_id_with_branch]
 
     async def notify_ingestion_activity(self, repo_id_with_branch: str, newly_created_entities: List[CodeEntity]):
         """
@@ -96,10 +112,12 @@ class IntelligentEnrichmentDispatcher:
         """
         # Immediately run the repair worker. This is fast and has its own error handling.
         await run_repair_worker(newly_created_entities)
+        await get_graph_versions().record_write(repo_id_with_branch, source="repair")
 
         # Reset the quiescence timer for the repository.
         if repo_id_with_branch in self.watched_repos:
             self.watched_repos[repo_id_with_branch].cancel()
+            increment(DISPATCHER_TIMER_RESETS, repo=repo_id_with_branch)
 
         self.watched_repos[repo_id_with_branch] = asyncio.create_task(
             self._watch_for_quiescence(repo_id_with_branch)
@@ -62,14 +62,6 @@ class Relationship(BaseModel):
     type: str = Field(description="Type of relationship (e.g., 'DEFINED_IN', 'IMPORTS', 'EXTENDS', 'IMPLEMENTS', 'PART_OF', 'CONTAINS', 'IMPLEMENTS_TRAIT', 'REFERENCES_SYMBOL').")
     properties: Optional[Dict[str, Any]] = None
 
-AdaptableNode = Union[Repository, SourceFile, TextChunk, CodeEntity, PendingLink, ResolutionCache]
-
-ParserOutput = Union[
-    List[int],
-    CodeEntity,
-    RawSymbolReference
-]
-
 class ImportType(str, Enum):
     """
     Syntactic type of an import, as determined by the parser.
@@ -98,8 +90,8 @@ class ReferenceContext(BaseModel):
     """
     Standardized representation for a reference.
     """
-    type: ImportType
-    path_elements: List[str] = Field(description="Sequence of names in the import path (e.g., ['com', 'google', 'guava']).")
+    import_type: ImportType
+    path_parts: List[str] = Field(description="Sequence of names in the import path (e.g., ['com', 'google', 'guava']).")
     alias: Optional[str] = Field(None, description="Alias given to the import, if any (e.g., 'pd' for 'pandas').")
 
 class RawSymbolReference(BaseModel):
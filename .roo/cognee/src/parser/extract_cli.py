@@ -0,0 +1,176 @@
+# .roo/cognee/src/parser/extract_cli.py
+"""
+Standalone extractor: walks a repository with the configs.py ignore rules, parses files in
+parallel worker processes and writes SourceFile/TextChunk/CodeEntity/RawSymbolReference
+records as NDJSON (or Arrow IPC). Needs neither cognee nor a graph database; the output is
+loaded later with orchestrator.ingest_extraction_output.
+
+Usage (from .roo/cognee):
+    python -m src.parser.extract_cli /path/to/repo --repo-id org/repo --branch main --commit-index 42 -o out.ndjson
+    python -m src.parser.extract_cli ... -o out.ndjson --profile profile.json --profile-stacks
+"""
+import argparse
+import asyncio
+import os
+import sys
+import time
+import json
+from concurrent.futures import ProcessPoolExecutor
+from pathlib import Path
+from typing import Iterator, List, Optional, Sequence, Tuple
+
+from .bulk_reader import read_file_sync
+from .discovery import iter_repository_files
+from .entities import SourceFile
+from .extraction import FileIsland, extract_file_island, island_to_records, write_ndjson
+from .discovery import get_file_type
+from .profiling import IngestProfiler
+from .utils import logger
+
+DEFAULT_LANGUAGES = "c,cpp"
+FILES_PER_TASK = 16
+
+def _source_file_id(repo_id: str, branch: str, relative_path: str, commit_index: int) -> str:
+    # Offline output always claims local_save 1; ingestion re-roots the IDs if the graph disagrees.
+    return f"{repo_id}@{branch}|{relative_path}@{commit_index}-1"
+
+class ExtractionError(Exception):
+    """A single file could not be read or parsed."""
+
+async def extract_file_records(absolute_path: str, relative_path: str, repo_id: str, branch: str, commit_index: int) -> Tuple[List[dict], int, int]:
+    """Reads and parses one file into (records, size, mtime_ns); raises ExtractionError instead of skipping."""
+    from .parser_registry import get_parser_for_file
+    log_prefix = f"EXTRACT ({relative_path})"
+    read = read_file_sync(absolute_path)
+    if read.content is None:
+        raise ExtractionError(f"unreadable: {read.error}")
+    source_file = SourceFile(id=_source_file_id(repo_id, branch, relative_path, commit_index), relative_path=relative_path, commit_index=commit_index, local_save=1, content_hash=read.content_hash)
+    island = FileIsland(source_file=source_file)
+    if read.content.strip():
+        try:
+            parser = get_parser_for_file(Path(absolute_path))
+            if not parser:
+                raise ExtractionError("no suitable parser")
+            island = await extract_file_island(parser, source_file, read.content, log_prefix)
+        except ExtractionError:
+            raise
+        except Exception as e:
+            raise ExtractionError(f"extraction failed: {e}") from e
+    return list(island_to_records(island)), read.size, read.mtime_ns
+
+async def _extract_files(files: Sequence[Tuple[str, str]], repo_id: str, branch: str, commit_index: int, profiler: Optional[IngestProfiler] = None) -> List[dict]:
+    records: List[dict] = []
+    for absolute_path, relative_path in files:
+        try:
+            if profiler:
+                with profiler.profile_file(relative_path, get_file_type(Path(relative_path).name) or "other"):
+                    file_records, _, _ = await extract_file_records(absolute_path, relative_path, repo_id, branch, commit_index)
+            else:
+                file_records, _, _ = await extract_file_records(absolute_path, relative_path, repo_id, branch, commit_index)
+            records.extend(file_records)
+        except ExtractionError as e:
+            logger.error(f"EXTRACT ({relative_path}): Skipping file: {e}", exc_info=e.__cause__ is not None)
+    return records
+
+def _init_worker(jobs: int):
+    from .parsers.cpp_parser import set_extraction_worker_budget
+    set_extraction_worker_budget(jobs)
+
+def _extract_files_in_worker(args: Tuple[Sequence[Tuple[str, str]], str, str, int, Optional[dict]]) -> Tuple[List[dict], Optional[dict]]:
+    """
+    Process pool entry point; one event loop per task of FILES_PER_TASK files.
+    With profiler options the task profiles its own files and ships the results back.
+    """
+    files, repo_id, branch, commit_index, profile_options = args
+    if not profile_options:
+        return asyncio.run(_extract_files(files, repo_id, branch, commit_index)), None
+    profiler = IngestProfiler(**profile_options)
+    with profiler.active():
+        records = asyncio.run(_extract_files(files, repo_id, branch, commit_index, profiler))
+    return records, {"files": [f.to_dict() for f in profiler.files], "stack_samples": dict(profiler.stack_samples)}
+
+def select_files(repo_path: str, languages: str) -> List[Tuple[str, str]]:
+    wanted = None if languages == "all" else set(languages.split(","))
+    return [(abs_path, rel_path) for abs_path, rel_path, file_type in iter_repository_files(repo_path) if wanted is None or file_type in wanted]
+
+def extract_repository(repo_path: str, repo_id: str, branch: str, commit_index: int, languages: str = DEFAULT_LANGUAGES, jobs: Optional[int] = None, profiler: Optional[IngestProfiler] = None) -> Iterator[dict]:
+    """
+    Yields records for every selected file, in discovery order, regardless of worker scheduling.
+    With a profiler, each worker profiles its own files sequentially and the results are merged into it.
+    """
+    files = select_files(repo_path, languages)
+    profile_options = {"trace_allocations": profiler.trace_allocations, "sample_stacks": profiler.sample_stacks, "sample_interval": profiler.sample_interval} if profiler else None
+    tasks = [(files[i:i + FILES_PER_TASK], repo_id, branch, commit_index, profile_options) for i in range(0, len(files), FILES_PER_TASK)]
+    jobs = jobs or os.cpu_count() or 1
+    if jobs == 1:
+        for records, profile in map(_extract_files_in_worker, tasks):
+            if profile: profiler.merge(profile["files"], profile["stack_samples"])
+            yield from records
+        return
+    with ProcessPoolExecutor(max_workers=jobs, initializer=_init_worker, initargs=(jobs,)) as executor:
+        for records, profile in executor.map(_extract_files_in_worker, tasks):
+            if profile: profiler.merge(profile["files"], profile["stack_samples"])
+            yield from records
+
+def _write_arrow(records: Iterator[dict], out_path: str) -> int:
+    try:
+        import pyarrow as pa
+        import pyarrow.ipc as ipc
+    except ImportError:
+        raise SystemExit("Arrow output requires pyarrow; use --format ndjson instead.")
+    schema = pa.schema([("record", pa.string()), ("source_file_id", pa.string()), ("data", pa.string())])
+    count = 0
+    batch: List[dict] = []
+    with open(out_path, "wb") as sink, ipc.new_stream(sink, schema) as writer:
+        for record in records:
+            batch.append({"record": record["record"], "source_file_id": record["source_file_id"], "data": json.dumps(record["data"], ensure_ascii=False)})
+            if len(batch) >= 4096:
+                writer.write_batch(pa.RecordBatch.from_pylist(batch, schema=schema))
+                count += len(batch); batch = []
+        if batch:
+            writer.write_batch(pa.RecordBatch.from_pylist(batch, schema=schema))
+            count += len(batch)
+    return count
+
+def main(argv: Optional[List[str]] = None) -> int:
+    arg_parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    arg_parser.add_argument("repo_path", help="Repository root to extract.")
+    arg_parser.add_argument("--repo-id", required=True, help="Repository identifier (e.g. 'automalar/web').")
+    arg_parser.add_argument("--branch", required=True)
+    arg_parser.add_argument("--commit-index", type=int, required=True)
+    arg_parser.add_argument("-o", "--output", default="-", help="Output file, '-' for stdout (NDJSON only).")
+    arg_parser.add_argument("--format", choices=["ndjson", "arrow"], default="ndjson")
+    arg_parser.add_argument("--languages", default=DEFAULT_LANGUAGES, help="Comma-separated file types from SUPPORTED_EXTENSIONS, or 'all'.")
+    arg_parser.add_argument("-j", "--jobs", type=int, default=None, help="Worker processes (default: CPU count).")
+    arg_parser.add_argument("--profile", default=None, help="Write a per-file cost report (JSON) to this path.")
+    arg_parser.add_argument("--profile-top", type=int, default=20, help="Files and constructs listed per ranking.")
+    arg_parser.add_argument("--profile-alloc", action="store_true", help="Record each file's tracemalloc peak (slower).")
+    arg_parser.add_argument("--profile-stacks", action="store_true", help="Sample the CppParser walk; writes <profile>.folded.")
+    arg_parser.add_argument("--profile-interval", type=float, default=0.001, help="Stack sampling interval in seconds.")
+    args = arg_parser.parse_args(argv)
+
+    if not os.path.isdir(args.repo_path):
+        logger.error(f"EXTRACT: Not a directory: {args.repo_path}")
+        return 2
+
+    start = time.time()
+    profiler = IngestProfiler(args.profile_alloc, args.profile_stacks, args.profile_interval) if args.profile else None
+    records = extract_repository(os.path.abspath(args.repo_path), args.repo_id, args.branch, args.commit_index, args.languages, args.jobs, profiler)
+    if args.format == "arrow":
+        if args.output == "-":
+            logger.error("EXTRACT: Arrow output needs a file path (-o).")
+            return 2
+        count = _write_arrow(records, args.output)
+    elif args.output == "-":
+        count = write_ndjson(records, sys.stdout)
+    else:
+        with open(args.output, "w", encoding="utf-8") as out:
+            count = write_ndjson(records, out)
+    logger.info(f"EXTRACT: Wrote {count} records in {time.time() - start:.2f}s.")
+    if profiler:
+        profiler.write_report(args.profile, args.profile_top)
+        logger.info(f"EXTRACT: {profiler.format_report(min(args.profile_top, 10))}\nFull report: {args.profile}")
+    return 0
+
+if __name__ == "__main__":
+    sys.exit(main())
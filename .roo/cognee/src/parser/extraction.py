@@ -0,0 +1,140 @@
+# .roo/cognee/src/parser/extraction.py
+import json
+from dataclasses import dataclass, field
+from typing import Dict, Iterable, Iterator, List, Optional, TextIO
+
+from .entities import SourceFile, TextChunk, CodeEntity, RawSymbolReference
+from .parsers.base_parser import BaseParser
+from .parsers.generic_parser import GenericParser
+from .chunking import generate_intelligent_chunks
+from .utils import logger, parse_temp_code_entity_id
+from .metrics import stage
+from .profiling import current_file_profile
+
+RECORD_TYPES = {
+    "SourceFile": SourceFile,
+    "TextChunk": TextChunk,
+    "CodeEntity": CodeEntity,
+    "RawSymbolReference": RawSymbolReference,
+}
+
+@dataclass
+class FileIsland:
+    """
+    Everything a single file contributes before it touches the graph: the SourceFile, its chunks,
+    its CodeEntities under final IDs, and its references with source IDs already rewritten.
+    """
+    source_file: SourceFile
+    text_chunks: List[TextChunk] = field(default_factory=list)
+    code_entities: List[CodeEntity] = field(default_factory=list)
+    raw_references: List[RawSymbolReference] = field(default_factory=list)
+    parser_yielded_entities: bool = False
+
+    def with_source_file_id(self, new_source_file_id: str, local_save: int) -> "FileIsland":
+        """Re-roots every ID under a different SourceFile version (all IDs are prefixed by it)."""
+        old_prefix = self.source_file.id
+        if old_prefix == new_source_file_id:
+            return self
+        def _swap(value: str) -> str:
+            return new_source_file_id + value[len(old_prefix):] if value.startswith(old_prefix) else value
+        source_file = self.source_file.model_copy(update={"id": new_source_file_id, "local_save": local_save})
+        chunks = [c.model_copy(update={"id": _swap(c.id)}) for c in self.text_chunks]
+        entities = [e.model_copy(update={"id": _swap(e.id)}) for e in self.code_entities]
+        references = [r.model_copy(update={"source_entity_id": _swap(r.source_entity_id)}) for r in self.raw_references]
+        return FileIsland(source_file, chunks, entities, references, self.parser_yielded_entities)
+
+# --- Island Assembly ---
+
+async def extract_file_island(
+    parser: BaseParser,
+    source_file: SourceFile,
+    content: str,
+    log_prefix: str,
+) -> FileIsland:
+    """Runs the parser, applies the generic chunking fallback and assigns final CodeEntity IDs."""
+    source_file_id = source_file.id
+    slice_lines, code_entities, raw_references = [], [], []
+    with stage("parse"):
+        async for item in parser.parse(source_file_id, content):
+            if isinstance(item, list): slice_lines = item
+            elif isinstance(item, CodeEntity): code_entities.append(item)
+            elif isinstance(item, RawSymbolReference): raw_references.append(item)
+
+    with stage("chunk"):
+        if not slice_lines and content.strip():
+            logger.info(f"{log_prefix}: Parser {parser.__class__.__name__} found no slicing points. Falling back to generic chunking.")
+            generic_parser = GenericParser()
+            # GenericParser reports 0-based lines; the chunker takes the 1-based parser contract.
+            slice_lines = [line + 1 for line in await anext(generic_parser.parse(source_file_id, content), [])]
+
+        island = FileIsland(source_file=source_file, parser_yielded_entities=bool(code_entities or raw_references))
+        island.text_chunks = generate_intelligent_chunks(source_file_id, content, slice_lines)
+
+    temp_id_to_final_id_map: Dict[str, str] = {}
+    for temp_ce in code_entities:
+        parsed_id = parse_temp_code_entity_id(temp_ce.id)
+        if not parsed_id: continue
+        fqn_part, start_line_1 = parsed_id
+        parent_chunk = next((c for c in island.text_chunks if c.start_line <= start_line_1 <= c.end_line), None)
+        if not parent_chunk: continue
+        final_ce_id = f"{parent_chunk.id}|{fqn_part}@{start_line_1}-{temp_ce.end_line}"
+        temp_id_to_final_id_map[temp_ce.id] = final_ce_id
+        island.code_entities.append(CodeEntity(id=final_ce_id, type=temp_ce.type, snippet_content=temp_ce.snippet_content, start_line=start_line_1, end_line=temp_ce.end_line, canonical_fqn=temp_ce.canonical_fqn, metadata=temp_ce.metadata))
+
+    for ref in raw_references:
+        ref.source_entity_id = temp_id_to_final_id_map.get(ref.source_entity_id, ref.source_entity_id)
+        island.raw_references.append(ref)
+
+    if profile := current_file_profile():
+        profile.lines, profile.bytes = content.count("\n") + 1, len(content)
+        profile.entities.update(e.type for e in island.code_entities)
+        profile.references.update(r.reference_type for r in island.raw_references)
+
+    return island
+
+# --- Record Serialization ---
+
+def island_to_records(island: FileIsland) -> Iterator[dict]:
+    """Flattens an island into records tagged with their data contract type and owning SourceFile."""
+    source_file_id = island.source_file.id
+    yield {"record": "SourceFile", "source_file_id": source_file_id, "data": island.source_file.model_dump(mode="json")}
+    for model_name, items in (("TextChunk", island.text_chunks), ("CodeEntity", island.code_entities), ("RawSymbolReference", island.raw_references)):
+        for item in items:
+            yield {"record": model_name, "source_file_id": source_file_id, "data": item.model_dump(mode="json")}
+
+def records_to_islands(records: Iterable[dict]) -> Iterator[FileIsland]:
+    """Regroups a record stream (as written by island_to_records) into islands, one per SourceFile."""
+    current: Optional[FileIsland] = None
+    for record in records:
+        model = RECORD_TYPES[record["record"]].model_validate(record["data"])
+        if isinstance(model, SourceFile):
+            if current: yield current
+            current = FileIsland(source_file=model)
+        elif current is None or record["source_file_id"] != current.source_file.id:
+            raise ValueError(f"Record for {record['source_file_id']} is not preceded by its SourceFile record.")
+        elif isinstance(model, TextChunk): current.text_chunks.append(model)
+        elif isinstance(model, CodeEntity): current.code_entities.append(model)
+        else: current.raw_references.append(model)
+    if current: yield current
+
+def write_ndjson(records: Iterable[dict], out: TextIO) -> int:
+    count = 0
+    for record in records:
+        out.write(json.dumps(record, ensure_ascii=False, separators=(",", ":")))
+        out.write("\n")
+        count += 1
+    return count
+
+def read_records(path: str) -> Iterator[dict]:
+    """Reads records from NDJSON, or from an Arrow IPC stream when the file ends in '.arrow'."""
+    if path.endswith(".arrow"):
+        import pyarrow.ipc as ipc
+        with open(path, "rb") as f:
+            for batch in ipc.open_stream(f):
+                for row in batch.to_pylist():
+                    yield {"record": row["record"], "source_file_id": row["source_file_id"], "data": json.loads(row["data"])}
+        return
+    with open(path, "r", encoding="utf-8") as f:
+        for line in f:
+            if line.strip():
+                yield json.loads(line)
@@ -1,21 +1,27 @@
 # .roo/cognee/src/parser/graph_enhancement_engine.py
 import asyncio
+import uuid
 from typing import List, Any, Optional, Dict
 from pydantic import BaseModel
 from collections import defaultdict
 
 from .utils import logger, read_file_content
-from .entities import LinkStatus, RawSymbolReference, ResolutionMethod, Relationship, CodeEntity
+from .entities import LinkStatus, RawSymbolReference, ResolutionMethod, Relationship, CodeEntity, PendingLink, ReferenceContext, ImportType
 from .configs import BATCH_SIZE_LLM_ENHANCEMENT
 from .graph_utils import (
     find_nodes_with_filter,
     update_pending_link_status,
     save_graph_data,
     delete_nodes_with_filter,
-    execute_cypher_query,
+    find_code_entity_ids_by_fqn_suffix,
     find_code_entity_by_path,
+    get_node_details_batch,
 )
 from .entities import ResolutionCache
+from .cognee_adapter import adapt_parser_entities_to_graph_elements
+from .metrics import timed, increment, ENHANCEMENT_SECONDS, ENHANCEMENT_LINKS
+from .link_stats import get_link_stats
+from .include_graph import ImpactPlan, get_include_graph, reference_name
 
 # --- Pydantic model to enforce structured LLM output ---
 class LLMResolutionAnswer(BaseModel):
@@ -28,7 +34,7 @@ class LLMResolutionAnswer(BaseModel):
 # Private Helper Functions
 #--------------------------------------------------------------------------------#
 
-async def _create_final_link(pending_link_node: Any, target_id: str, method: ResolutionMethod, repo_id_str: str):
+async def _create_final_link(pending_link_node: Any, target_id: str, method: ResolutionMethod, repo_id_str: str, tier: str):
     """Helper to create the final relationship, cache the result, and delete the debt."""
     log_prefix = f"ENHANCEMENT ({repo_id_str})"
     ref_data = RawSymbolReference(**pending_link_node.attributes['reference_data'])
@@ -42,8 +48,11 @@ async def _create_final_link(pending_link_node: Any, target_id: str, method: Res
 
     cache_node = ResolutionCache(id=pending_link_node.id, resolved_target_id=target_id, method=method)
 
-    await save_graph_data(nodes=[cache_node], relationships=[relationship_to_create])
+    nodes, edges = adapt_parser_entities_to_graph_elements([cache_node, relationship_to_create])
+    await save_graph_data(nodes=nodes, relationships=edges)
     await delete_nodes_with_filter({"type": "PendingLink", "slug_id": pending_link_node.id})
+    increment(ENHANCEMENT_LINKS, tier=tier, repo=repo_id_str, outcome="resolved")
+    get_link_stats().on_resolved(pending_link_node.id, tier)
     logger.info(f"{log_prefix}: Successfully resolved link {pending_link_node.id} to {target_id} via {method.value}.")
 
 async def _promote_to_llm(pending_link_node: Any, candidates: List[str], repo_id_str: str):
@@ -59,6 +68,10 @@ async def _promote_to_llm(pending_link_node: Any, candidates: List[str], repo_id
 
 async def run_tier2_enhancement(repo_id_with_branch: str):
     """A one-shot task to run all Tier 2 heuristics for a specific repository."""
+    with timed(ENHANCEMENT_SECONDS, tier="tier2", repo=repo_id_with_branch):
+        await _run_tier2(repo_id_with_branch)
+
+async def _run_tier2(repo_id_with_branch: str):
     log_prefix = f"ENHANCEMENT(Tier2) for {repo_id_with_branch}"
     logger.info(f"{log_prefix}: Starting run.")
 
@@ -77,26 +90,26 @@ async def run_tier2_enhancement(repo_id_with_branch: str):
             # --- Attempt 1: Internal Link by Exact FQN Match ---
             exact_matches = await find_nodes_with_filter({"type": "CodeEntity", "canonical_fqn": ref_data.target_expression, "repo_id_str": repo_id_with_branch})
             if len(exact_matches) == 1:
-                await _create_final_link(link_node, exact_matches[0].id, ResolutionMethod.HEURISTIC_MATCH, repo_id_with_branch)
+                await _create_final_link(link_node, exact_matches[0].id, ResolutionMethod.HEURISTIC_MATCH, repo_id_with_branch, "tier2")
                 continue
 
-            # --- Attempt 2: Verified Suffix Match (using direct Cypher for Neo4j) ---
+            # --- Attempt 2: Verified Suffix Match ---
             suffix_matches = []
             if "::" in ref_data.target_expression or "." in ref_data.target_expression:
-                cypher_query = "MATCH (n:CodeEntity) WHERE n.repo_id_str = $repo_id AND n.canonical_fqn ENDS WITH $suffix RETURN n"
-                params = {"repo_id": repo_id_with_branch, "suffix": ref_data.target_expression}
-                suffix_matches = await execute_cypher_query(cypher_query, params)
+                suffix_matches = await find_code_entity_ids_by_fqn_suffix(repo_id_with_branch, ref_data.target_expression)
                 if len(suffix_matches) == 1:
-                    await _create_final_link(link_node, suffix_matches[0].id, ResolutionMethod.HEURISTIC_MATCH, repo_id_with_branch)
+                    await _create_final_link(link_node, suffix_matches[0], ResolutionMethod.HEURISTIC_MATCH, repo_id_with_branch, "tier2")
                     continue
 
             # --- If all attempts fail or are ambiguous, promote to LLM tier ---
-            all_candidates = [node.id for node in exact_matches] + [node.id for node in suffix_matches]
+            all_candidates = [node.id for node in exact_matches] + suffix_matches
             await _promote_to_llm(link_node, candidates=list(set(all_candidates)), repo_id_str=repo_id_with_branch)
+            increment(ENHANCEMENT_LINKS, tier="tier2", repo=repo_id_with_branch, outcome="promoted")
 
         except Exception as e:
             logger.error(f"{log_prefix}: Failed to process link {link_node.id}. Marking as UNRESOLVABLE. Error: {e}", exc_info=True)
             await update_pending_link_status(link_node.id, LinkStatus.UNRESOLVABLE, {"reason": str(e)})
+            increment(ENHANCEMENT_LINKS, tier="tier2", repo=repo_id_with_branch, outcome="unresolvable")
 
     logger.info(f"{log_prefix}: Run complete.")
 
@@ -106,6 +119,10 @@ async def run_tier2_enhancement(repo_id_with_branch: str):
 
 async def run_tier3_enhancement(repo_id_with_branch: str):
     """A one-shot task to run all Tier 3 LLM resolutions for a specific repository."""
+    with timed(ENHANCEMENT_SECONDS, tier="tier3", repo=repo_id_with_branch):
+        await _run_tier3(repo_id_with_branch)
+
+async def _run_tier3(repo_id_with_branch: str):
     log_prefix = f"ENHANCEMENT(Tier3) for {repo_id_with_branch}"
     logger.info(f"{log_prefix}: Starting run.")
 
@@ -162,21 +179,24 @@ async def run_tier3_enhancement(repo_id_with_branch: str):
                 if not answer.resolved_canonical_fqn:
                     logger.warning(f"{log_prefix}: LLM returned null for link {answer.link_id}. Marking as UNRESOLVABLE.")
                     await update_pending_link_status(answer.link_id, LinkStatus.UNRESOLVABLE, {"reason": "LLM returned null."})
+                    increment(ENHANCEMENT_LINKS, tier="tier3", repo=repo_id_with_branch, outcome="unresolvable")
                     continue
 
                 verified_target_id = await find_code_entity_by_path(repo_id_with_branch, None, answer.resolved_canonical_fqn)
 
                 if verified_target_id:
                     logger.info(f"{log_prefix}: LLM hint for link {answer.link_id} ('{answer.resolved_canonical_fqn}') was VERIFIED.")
-                    await _create_final_link(link_node_to_update, verified_target_id, ResolutionMethod.LLM, repo_id_with_branch)
+                    await _create_final_link(link_node_to_update, verified_target_id, ResolutionMethod.LLM, repo_id_with_branch, "tier3")
                 else:
                     logger.warning(f"{log_prefix}: LLM hint for link {answer.link_id} ('{answer.resolved_canonical_fqn}') COULD NOT BE VERIFIED. Deferring.")
                     await update_pending_link_status(answer.link_id, LinkStatus.AWAITING_TARGET, {"awaits_fqn": answer.resolved_canonical_fqn})
+                    increment(ENHANCEMENT_LINKS, tier="tier3", repo=repo_id_with_branch, outcome="deferred")
 
         except Exception as e:
             logger.error(f"{log_prefix}: Failed to process LLM batch for file {source_file_path}. Marking batch as FAILED. Error: {e}", exc_info=True)
             for link_node in links:
                 await update_pending_link_status(link_node.id, LinkStatus.UNRESOLVABLE, {"reason": "LLM batch processing failed."})
+            increment(ENHANCEMENT_LINKS, len(links), tier="tier3", repo=repo_id_with_branch, outcome="unresolvable")
 
     logger.info(f"{log_prefix}: Run complete.")
 
@@ -187,6 +207,10 @@ async def run_tier3_enhancement(repo_id_with_branch: str):
 async def run_repair_worker(newly_created_entities: List[CodeEntity]):
     """A one-shot task to satisfy any 'AWAITING_TARGET' links."""
     if not newly_created_entities: return
+    with timed(ENHANCEMENT_SECONDS, tier="repair"):
+        await _run_repair(newly_created_entities)
+
+async def _run_repair(newly_created_entities: List[CodeEntity]):
     log_prefix = "ENHANCEMENT(Repair)"
     logger.info(f"{log_prefix}: Checking {len(newly_created_entities)} new entities against awaited links.")
 
@@ -205,4 +229,64 @@ async def run_repair_worker(newly_created_entities: List[CodeEntity]):
             logger.info(f"{log_prefix}: Found {len(awaited_links)} links waiting for FQN '{entity.canonical_fqn}'.")
             for link_node in awaited_links:
                 logger.info(f"{log_prefix}: Satisfying awaited link {link_node.id} with new entity {entity.id}.")
-                await _create_final_link(link_node, entity.id, ResolutionMethod.LLM, repo_id_str)
+                await _create_final_link(link_node, entity.id, ResolutionMethod.LLM, repo_id_str, "repair")
+
+#--------------------------------------------------------------------------------#
+# Public Task: Header Impact Re-check
+#--------------------------------------------------------------------------------#
+
+# PendingLinks past the promotion step; links still PENDING_RESOLUTION or READY_FOR_HEURISTICS are retried anyway.
+_SETTLED_STATUSES = (LinkStatus.READY_FOR_LLM.value, LinkStatus.AWAITING_TARGET.value, LinkStatus.UNRESOLVABLE.value)
+
+async def run_header_impact_recheck(repo_id_with_branch: str) -> Optional[ImpactPlan]:
+    """
+    Applies the include graph's impact plan for the repository (see include_graph.py) so the
+    enhancement cycle that follows re-resolves exactly the links the changed headers affect. The
+    plan's changes stay stored until it has been applied; every step is idempotent, so a failed
+    attempt is simply repeated by the next cycle.
+    """
+    include_graph = get_include_graph()
+    plan = await include_graph.plan(repo_id_with_branch)
+    if plan is None: return None
+    with timed(ENHANCEMENT_SECONDS, tier="impact", repo=repo_id_with_branch):
+        await _run_impact_recheck(repo_id_with_branch, plan)
+    await include_graph.settle(repo_id_with_branch, plan)
+    return plan
+
+async def _run_impact_recheck(repo_id_with_branch: str, plan: ImpactPlan):
+    log_prefix = f"ENHANCEMENT(Impact) for {repo_id_with_branch}"
+    logger.info(f"{log_prefix}: {len(plan.headers)} changed files, {len(plan.files)} dependent files, "
+                f"{len(plan.repoint)} links to re-point, {len(plan.recheck)} to re-check.")
+    # The delete that detached a link may since have taken its source too (the includer was re-ingested).
+    sources = await get_node_details_batch([s for s, *_ in plan.repoint] + [s for s, *_ in plan.recheck], ["slug_id"])
+
+    to_save: List[Any] = []
+    repointed, recheck = 0, [r for r in plan.recheck if r[0] in sources]
+    for source, path, fqn, rel_type in plan.repoint:
+        if source not in sources: continue
+        if target_id := await find_code_entity_by_path(repo_id_with_branch, path, fqn):
+            to_save.append(Relationship(source_id=source, target_id=target_id, type=rel_type))
+            repointed += 1
+        else:
+            recheck.append((source, fqn, rel_type))
+    link_stats = get_link_stats()
+    for source, fqn, rel_type in recheck:
+        ref = RawSymbolReference(source_entity_id=source, target_expression=fqn, reference_type=rel_type,
+                                 context=ReferenceContext(import_type=ImportType.ABSOLUTE, path_parts=fqn.split("::")))
+        link_id = str(uuid.uuid5(uuid.NAMESPACE_DNS, f"{source}|{fqn}|{rel_type}"))
+        to_save.append(PendingLink(id=link_id, reference_data=ref))
+        link_stats.on_created(repo_id_with_branch, link_id, source, fqn)
+    if to_save:
+        nodes, edges = adapt_parser_entities_to_graph_elements(to_save)
+        await save_graph_data(nodes=nodes, relationships=edges)
+
+    reopened = len(recheck)
+    for path, names in plan.files.items():
+        for link_node in await find_nodes_with_filter({"type": "PendingLink", "repo_id_str": repo_id_with_branch, "relative_path_str": path}):
+            if link_node.attributes.get("status") not in _SETTLED_STATUSES: continue
+            if reference_name(link_node.attributes["reference_data"]["target_expression"]) in names:
+                await update_pending_link_status(link_node.id, LinkStatus.PENDING_RESOLUTION)
+                reopened += 1
+    increment(ENHANCEMENT_LINKS, repointed, tier="impact", repo=repo_id_with_branch, outcome="repointed")
+    increment(ENHANCEMENT_LINKS, reopened, tier="impact", repo=repo_id_with_branch, outcome="reopened")
+    logger.info(f"{log_prefix}: Re-pointed {repointed} links and reopened {reopened}.")
@@ -0,0 +1,303 @@
+# .roo/cognee/src/parser/graph_snapshot.py
+"""
+Read-only CSR (compressed sparse row) snapshots of a repo@branch's entity graph for whole-graph
+analytics (fan-in, include cycles, dead-code candidates, centrality) without pulling subgraphs
+through the graph adapter.
+
+A snapshot is built in bulk from the DAL (the repository's nodes of the chosen types plus every
+edge leaving them), written once and memory-mapped. Layout (native byte order, u32 unless noted):
+    header       magic 'CSR1', n_nodes, n_edges
+    out_offsets  n_nodes + 1      out_targets  n_edges      out_types  n_edges (u16), padded to 4
+    in_offsets   n_nodes + 1      in_sources   n_edges      in_types   n_edges (u16), padded to 4
+Node IDs, node types, relationship type names and the stored graph version it was built at (see
+graph_versions) live in a JSON sidecar, so a snapshot left on disk by an earlier process is reused
+while the graph has not moved on. Kernels (BFS, SCC, PageRank) work on node numbers; helpers map
+back to IDs, and analyze() runs them in a worker thread.
+"""
+import array
+import asyncio
+import json
+import mmap
+import os
+import secrets
+import struct
+import time
+from contextlib import contextmanager
+from typing import Dict, Iterable, Iterator, List, Optional, Sequence, Set, Tuple
+
+from .configs import GRAPH_SNAPSHOT_DIR
+from .graph_versions import get_graph_versions
+from .utils import logger
+
+MAGIC = b"CSR1"
+_HEADER = struct.Struct("=4sII")
+DEFAULT_NODE_TYPES = ("SourceFile", "CodeEntity")
+
+def _padded(n_bytes: int) -> int:
+    return (n_bytes + 3) & ~3
+
+def _csr(n: int, edges: Sequence[Tuple[int, int, int]]) -> Tuple[array.array, array.array, array.array]:
+    offsets = array.array("I", [0]) * (n + 1)
+    for source, _, _ in edges:
+        offsets[source + 1] += 1
+    for i in range(n):
+        offsets[i + 1] += offsets[i]
+    targets, types = array.array("I", [0]) * len(edges), array.array("H", [0]) * len(edges)
+    cursor = offsets[:-1]
+    for source, target, rel in sorted(edges):
+        targets[cursor[source]], types[cursor[source]] = target, rel
+        cursor[source] += 1
+    return offsets, targets, types
+
+class CSRSnapshot:
+    def __init__(self, path: str):
+        self.path = path
+        with open(path + ".json", encoding="utf-8") as f:
+            meta = json.load(f)
+        self.repo: str = meta["repo"]
+        self.node_ids: List[str] = meta["node_ids"]
+        self.node_types: List[str] = meta["node_types"]
+        self.rel_types: List[str] = meta["rel_types"]
+        self.version: Optional[int] = meta.get("graph_version")  # None for sidecars predating stored versions.
+        self.built_at: float = meta["built_at"]
+        self._index = {node_id: i for i, node_id in enumerate(self.node_ids)}
+        self._readers, self._closed = 0, False
+        with open(path + ".csr", "rb") as f:
+            self._buf = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+        magic, self.n, self.m = _HEADER.unpack_from(self._buf, 0)
+        if magic != MAGIC or self.n != len(self.node_ids):
+            raise ValueError(f"corrupt graph snapshot {path}.csr")
+        view, at = memoryview(self._buf), _HEADER.size
+        sections = []
+        for count, fmt in ((self.n + 1, "I"), (self.m, "I"), (self.m, "H")) * 2:
+            size = count * (2 if fmt == "H" else 4)
+            sections.append(view[at:at + size].cast(fmt))
+            at += _padded(size)
+        self.out_offsets, self.out_targets, self.out_types, self.in_offsets, self.in_sources, self.in_types = sections
+
+    @classmethod
+    def write(cls, path: str, repo: str, node_ids: List[str], node_types: List[str], edges: Iterable[Tuple[str, str, str]], version: int = 0) -> "CSRSnapshot":
+        index = {node_id: i for i, node_id in enumerate(node_ids)}
+        rel_types: Dict[str, int] = {}
+        numbered = [(index[s], index[t], rel_types.setdefault(r, len(rel_types))) for s, t, r in edges if s in index and t in index]
+        out = bytearray(_HEADER.pack(MAGIC, len(node_ids), len(numbered)))
+        for section in _csr(len(node_ids), numbered) + _csr(len(node_ids), [(t, s, r) for s, t, r in numbered]):
+            data = section.tobytes()
+            out += data + b"\0" * (_padded(len(data)) - len(data))
+        os.makedirs(os.path.dirname(path) or ".", exist_ok=True)
+        meta = {"repo": repo, "node_ids": node_ids, "node_types": node_types, "rel_types": list(rel_types), "graph_version": version, "built_at": time.time()}
+        tmp = f".{os.getpid()}.{secrets.token_hex(4)}.tmp"  # Unique: another process may be writing the same snapshot.
+        try:
+            for suffix, payload in ((".csr", bytes(out)), (".json", json.dumps(meta).encode("utf-8"))):
+                with open(path + suffix + tmp, "wb") as f:
+                    f.write(payload)
+            for suffix in (".csr", ".json"):
+                os.replace(path + suffix + tmp, path + suffix)
+        finally:
+            for suffix in (".csr", ".json"):
+                if os.path.exists(path + suffix + tmp):
+                    os.remove(path + suffix + tmp)
+        return cls(path)
+
+    def close(self):
+        """Unmaps the file, or defers that until the last reading() block using the snapshot ends."""
+        self._closed = True
+        if self._readers:
+            return
+        for section in (self.out_offsets, self.out_targets, self.out_types, self.in_offsets, self.in_sources, self.in_types):
+            section.release()
+        self._buf.close()
+
+    @contextmanager
+    def reading(self):
+        """Keeps the mapping open for a kernel running in another thread while a rebuild replaces it."""
+        self._readers += 1
+        try:
+            yield self
+        finally:
+            self._readers -= 1
+            if self._closed and not self._readers:
+                self.close()
+
+    # --- Addressing ---
+
+    def index(self, node_id: str) -> Optional[int]:
+        return self._index.get(node_id)
+
+    def _type_mask(self, rel_types: Optional[Iterable[str]]) -> Optional[Set[int]]:
+        if rel_types is None:
+            return None
+        wanted = set(rel_types)
+        return {i for i, name in enumerate(self.rel_types) if name in wanted}
+
+    def neighbours(self, node: int, direction: str = "out", rel_mask: Optional[Set[int]] = None) -> Iterator[int]:
+        offsets, others, types = (self.out_offsets, self.out_targets, self.out_types) if direction == "out" else (self.in_offsets, self.in_sources, self.in_types)
+        for k in range(offsets[node], offsets[node + 1]):
+            if rel_mask is None or types[k] in rel_mask:
+                yield others[k]
+
+    def degrees(self, direction: str = "in", rel_types: Optional[Iterable[str]] = None) -> List[int]:
+        mask = self._type_mask(rel_types)
+        if mask is None:
+            offsets = self.in_offsets if direction == "in" else self.out_offsets
+            return [offsets[i + 1] - offsets[i] for i in range(self.n)]
+        return [sum(1 for _ in self.neighbours(i, direction, mask)) for i in range(self.n)]
+
+    # --- Kernels ---
+
+    def bfs(self, sources: Iterable[int], direction: str = "out", rel_types: Optional[Iterable[str]] = None, max_depth: Optional[int] = None) -> Dict[int, int]:
+        """Node number -> hop distance from the nearest source."""
+        mask = self._type_mask(rel_types)
+        depth = {s: 0 for s in sources}
+        frontier = list(depth)
+        level = 0
+        while frontier and (max_depth is None or level < max_depth):
+            level += 1
+            next_frontier = []
+            for node in frontier:
+                for other in self.neighbours(node, direction, mask):
+                    if other not in depth:
+                        depth[other] = level
+                        next_frontier.append(other)
+            frontier = next_frontier
+        return depth
+
+    def scc(self, rel_types: Optional[Iterable[str]] = None) -> List[List[int]]:
+        """Strongly connected components (iterative Tarjan), each a list of node numbers, in reverse topological order."""
+        mask = self._type_mask(rel_types)
+        index, low = [-1] * self.n, [0] * self.n
+        on_stack, stack, components, counter = [False] * self.n, [], [], 0
+        for root in range(self.n):
+            if index[root] != -1:
+                continue
+            work = [(root, self.neighbours(root, "out", mask))]
+            index[root] = low[root] = counter; counter += 1
+            stack.append(root); on_stack[root] = True
+            while work:
+                node, children = work[-1]
+                for child in children:
+                    if index[child] == -1:
+                        index[child] = low[child] = counter; counter += 1
+                        stack.append(child); on_stack[child] = True
+                        work.append((child, self.neighbours(child, "out", mask)))
+                        break
+                    if on_stack[child]:
+                        low[node] = min(low[node], index[child])
+                else:
+                    work.pop()
+                    if work:
+                        parent = work[-1][0]
+                        low[parent] = min(low[parent], low[node])
+                    if low[node] == index[node]:
+                        component = []
+                        while True:
+                            member = stack.pop(); on_stack[member] = False
+                            component.append(member)
+                            if member == node: break
+                        components.append(component)
+        return components
+
+    def pagerank(self, damping: float = 0.85, iterations: int = 50, tolerance: float = 1e-8, rel_types: Optional[Iterable[str]] = None) -> List[float]:
+        """PageRank by power iteration over incoming edges; dangling nodes spread their rank uniformly."""
+        if self.n == 0:
+            return []
+        mask = self._type_mask(rel_types)
+        out_degree = self.degrees("out", rel_types)
+        rank = [1.0 / self.n] * self.n
+        for _ in range(iterations):
+            dangling = sum(rank[i] for i in range(self.n) if out_degree[i] == 0)
+            base = (1.0 - damping) / self.n + damping * dangling / self.n
+            share = [rank[i] / out_degree[i] if out_degree[i] else 0.0 for i in range(self.n)]
+            new_rank = [base + damping * sum(share[u] for u in self.neighbours(v, "in", mask)) for v in range(self.n)]
+            delta = sum(abs(a - b) for a, b in zip(new_rank, rank))
+            rank = new_rank
+            if delta < tolerance:
+                break
+        return rank
+
+    # --- Analytics ---
+
+    def fan_in(self, top: int = 20, rel_types: Optional[Iterable[str]] = None) -> List[Tuple[str, int]]:
+        degrees = self.degrees("in", rel_types)
+        ranked = sorted(range(self.n), key=lambda i: (-degrees[i], self.node_ids[i]))
+        return [(self.node_ids[i], degrees[i]) for i in ranked[:top] if degrees[i]]
+
+    def cycles(self, rel_types: Iterable[str] = ("INCLUDE",)) -> List[List[str]]:
+        """Components of more than one node over `rel_types` edges (e.g. include cycles)."""
+        return [sorted(self.node_ids[i] for i in c) for c in self.scc(rel_types) if len(c) > 1]
+
+    def dead_code_candidates(self, entity_types: Iterable[str] = ("FunctionDefinition",), rel_types: Iterable[str] = ("FUNCTION_CALL",)) -> List[str]:
+        """Entities of `entity_types` that nothing reaches through `rel_types` edges."""
+        wanted = set(entity_types)
+        degrees = self.degrees("in", rel_types)
+        return sorted(self.node_ids[i] for i in range(self.n) if self.node_types[i] in wanted and degrees[i] == 0)
+
+    def ranked(self, scores: Sequence[float], top: int = 20) -> List[Tuple[str, float]]:
+        order = sorted(range(self.n), key=lambda i: -scores[i])
+        return [(self.node_ids[i], scores[i]) for i in order[:top]]
+
+def snapshot_path(repo: str, directory: Optional[str] = None) -> str:
+    return os.path.join(directory or GRAPH_SNAPSHOT_DIR, repo.replace("/", "__"))
+
+async def build_snapshot(repo: str, directory: Optional[str] = None, node_types: Sequence[str] = DEFAULT_NODE_TYPES) -> CSRSnapshot:
+    """Bulk-loads the repository's nodes of `node_types` and their outgoing edges into a new snapshot."""
+    from .graph_utils import find_nodes_with_filter, get_repo_edges
+    start = time.perf_counter()
+    version = await get_graph_versions().stored_version(repo)  # Read before the scan, like SeedStamps.due.
+    node_ids, types = [], []
+    for node_type in node_types:
+        for node in await find_nodes_with_filter({"type": node_type, "repo_id_str": repo}):
+            node_ids.append(node.id)
+            types.append(node.attributes.get("type") or node_type)
+    edges = await get_repo_edges(repo)
+    snapshot = await asyncio.to_thread(CSRSnapshot.write, snapshot_path(repo, directory), repo, node_ids, types, edges, version)
+    logger.info(f"GRAPH_SNAPSHOT({repo}): Built {snapshot.n} nodes / {snapshot.m} edges in {time.perf_counter() - start:.2f}s.")
+    return snapshot
+
+_snapshots: Dict[str, CSRSnapshot] = {}
+_locks: Dict[str, asyncio.Lock] = {}  # Per snapshot path: concurrent requests share one check and build.
+
+async def get_snapshot(repo: str, directory: Optional[str] = None, max_staleness: Optional[int] = 0) -> CSRSnapshot:
+    """
+    The repository's snapshot, rebuilt once it lags the repository's stored graph version by more
+    than `max_staleness` writes (None accepts any age). Stored versions count every process's
+    writes, so a snapshot left on disk by an earlier process is mapped and reused while current.
+    A request arriving while another one builds waits for that build and reuses its snapshot.
+    """
+    path = snapshot_path(repo, directory)
+    async with _locks.setdefault(path, asyncio.Lock()):
+        snapshot = _snapshots.get(path)
+        if snapshot is None and os.path.exists(path + ".csr"):
+            try:
+                snapshot = CSRSnapshot(path)
+            except (OSError, ValueError, KeyError) as e:
+                logger.warning(f"GRAPH_SNAPSHOT({repo}): Rebuilding unreadable snapshot: {e}")
+        if snapshot is not None and max_staleness is not None:
+            stored = await get_graph_versions().stored_version(repo)
+            if snapshot.version is None or stored - snapshot.version > max_staleness:
+                snapshot.close()
+                snapshot = None
+        if snapshot is None:
+            snapshot = await build_snapshot(repo, directory)
+        _snapshots[path] = snapshot
+        return snapshot
+
+ANALYSES = ("fan_in", "include_cycles", "dead_code", "pagerank")
+
+def _run_analysis(snapshot: CSRSnapshot, analysis: str, top: int) -> List[Dict]:
+    if analysis == "fan_in":
+        return [{"id": node_id, "in_degree": degree} for node_id, degree in snapshot.fan_in(top)]
+    if analysis == "include_cycles":
+        return [{"files": cycle} for cycle in snapshot.cycles(("INCLUDE",))[:top]]
+    if analysis == "dead_code":
+        return [{"id": node_id} for node_id in snapshot.dead_code_candidates()[:top]]
+    return [{"id": node_id, "score": round(score, 6)} for node_id, score in snapshot.ranked(snapshot.pagerank(), top)]
+
+async def analyze(repo: str, analysis: str, top: int = 20) -> Dict:
+    """Runs one of ANALYSES against the repository's current snapshot."""
+    if analysis not in ANALYSES:
+        raise ValueError(f"analysis must be one of {ANALYSES}, not {analysis!r}")
+    snapshot = await get_snapshot(repo)
+    with snapshot.reading():
+        results = await asyncio.to_thread(_run_analysis, snapshot, analysis, top)
+    return {"repo": repo, "analysis": analysis, "nodes": snapshot.n, "edges": snapshot.m, "graph_version": snapshot.version, "results": results}
@@ -1,16 +1,23 @@
 # .roo/cognee/src/parser/graph_utils.py
 import asyncio
+import json
+from contextlib import asynccontextmanager
+from contextvars import ContextVar
 from datetime import datetime, timezone
-from typing import List, Tuple, Dict, Any, Optional
+from typing import Callable, List, Tuple, Dict, Any, Optional, TYPE_CHECKING
 import uuid
 import time
 from tenacity import retry, stop_after_attempt, wait_exponential, retry_if_exception, before_sleep_log
 
 from .utils import logger
 from .entities import PendingLink, LinkStatus
+from .configs import GRAPH_BACKEND
+from .local_graph_backend import LocalGraphBackend, get_local_backend
+from .link_stats import get_link_stats
+from . import code_indexes
 
-from cognee.modules.graph.cognee_graph.CogneeGraphElements import Node
-from cognee.infrastructure.databases.graph.get_graph_engine import get_graph_engine
+if TYPE_CHECKING:
+    from cognee.modules.graph.cognee_graph.CogneeGraphElements import Node
 
 # Import Neo4j-specific exceptions for robust error handling
 try:
@@ -30,9 +37,64 @@ async def get_adapter():
     """A robust singleton accessor for the graph engine adapter."""
     global _graph_adapter_instance
     if _graph_adapter_instance is None:
+        from cognee.infrastructure.databases.graph.get_graph_engine import get_graph_engine
         _graph_adapter_instance = await get_graph_engine()
     return _graph_adapter_instance
 
+def _local() -> Optional[LocalGraphBackend]:
+    """The embedded backend when GRAPH_BACKEND is 'local', otherwise None (use the cognee graph engine)."""
+    return get_local_backend() if GRAPH_BACKEND == "local" else None
+
+# The current task's open transaction and the index hooks queued until it commits.
+_pending_hooks: ContextVar[Optional[Tuple[asyncio.Task, List[Tuple[Callable, tuple]]]]] = ContextVar("graph_pending_hooks", default=None)
+
+def after_commit(hook: Callable, *args):
+    """
+    Runs an in-memory index hook (code_indexes, link_stats) once the current task's graph_transaction
+    commits, or right away outside one. A rolled-back transaction drops its hooks, so the indexes never
+    hold data the graph did not store.
+    """
+    pending = _pending_hooks.get()
+    if pending is not None and pending[0] is asyncio.current_task():
+        pending[1].append((hook, args))
+    else:
+        _run_hooks([(hook, args)])
+
+def _run_hooks(hooks: List[Tuple[Callable, tuple]]):
+    for hook, args in hooks:
+        try:
+            hook(*args)
+        except Exception as e:
+            logger.error(f"GRAPH_UTILS: Index hook {getattr(hook, '__qualname__', hook)} failed: {e}", exc_info=True)
+
+@asynccontextmanager
+async def graph_transaction():
+    """
+    Groups the DAL calls made by the current task into one atomic unit. The local backend runs them in a
+    single SQLite transaction; the cognee adapter has no cross-call transactions, so each call commits on its own.
+    Index hooks queued with after_commit run after the COMMIT.
+    """
+    pending = _pending_hooks.get()
+    if pending is not None and pending[0] is asyncio.current_task():
+        yield  # Nested: the outermost transaction commits and runs the hooks.
+        return
+    hooks: List[Tuple[Callable, tuple]] = []
+    token = _pending_hooks.set((asyncio.current_task(), hooks))
+    backend = _local()
+    committed = False
+    try:
+        if backend:
+            async with backend.transaction():
+                yield
+        else:
+            yield
+        committed = True
+    finally:
+        _pending_hooks.reset(token)
+        # A cognee call that returned is stored even if a later one failed, so its hooks still apply.
+        if committed or not backend:
+            _run_hooks(hooks)
+
 def is_transient_error(exception: BaseException) -> bool:
     """Predicate for tenacity to retry only on specific, recoverable database/network errors."""
     generic_transient_types = (ConnectionError, TimeoutError, asyncio.TimeoutError)
@@ -41,16 +103,23 @@ def is_transient_error(exception: BaseException) -> bool:
 
 # --- Schema and Index Management ---
 
+# Labels of the nodes the parser writes; each has a unique index on slug_id (the node ID), which
+# the batch lookups below seek on label by label instead of scanning every node.
+NODE_LABELS = ("Repository", "SourceFile", "TextChunk", "CodeEntity", "PendingLink", "ResolutionCache")
+
 async def ensure_all_indexes():
     """Ensures all necessary indexes and constraints exist in Neo4j. This is a safe, idempotent operation."""
     log_prefix = "GRAPH_UTILS(Indexing)"
+    if _local():
+        logger.info(f"{log_prefix}: Local graph backend creates its indexes on open. Nothing to do.")
+        return
     logger.info(f"{log_prefix}: Verifying and creating required database indexes...")
     adapter = await get_adapter()
 
-    unique_id_labels = ["Repository", "SourceFile", "TextChunk", "CodeEntity", "PendingLink", "ResolutionCache"]
+    unique_id_labels = NODE_LABELS
     required_indexes = [
         ("SourceFile", "content_hash"), ("PendingLink", "status"),
-        ("PendingLink", "awaits_fqn"), ("CodeEntity", "canonical_fqn"),
+        ("PendingLink", "awaits_fqn"), ("CodeEntity", "canonical_fqn"), ("GraphVersion", "repo_id"), ("HeaderChange", "repo_id"),
     ]
     required_composite_indexes = [("SourceFile", ("repo_id_str", "relative_path_str", "commit_index"))]
 
@@ -79,41 +148,124 @@ async def ensure_all_indexes():
 @retry(stop=stop_after_attempt(3), wait=wait_exponential(multiplier=1, min=2, max=10), retry=retry_if_exception(is_transient_error), before_sleep=before_sleep_log(logger, "WARNING"))
 async def execute_cypher_query(query: str, params: Dict[str, Any] = None) -> List[Dict]:
     """Executes a raw Cypher query with parameters and returns a list of raw records."""
+    if _local():
+        raise NotImplementedError("Raw Cypher queries need GRAPH_BACKEND=cognee; add a DAL function instead.")
     adapter = await get_adapter()
     return await adapter.execute_query(query, parameters=params or {})
 
 @retry(stop=stop_after_attempt(3), wait=wait_exponential(multiplier=1, min=2, max=10), retry=retry_if_exception(is_transient_error), before_sleep=before_sleep_log(logger, "WARNING"))
-async def find_nodes_with_filter(filter_dict: Dict[str, Any]) -> List[Node]:
+async def find_nodes_with_filter(filter_dict: Dict[str, Any]) -> List["Node"]:
     """Generic function to find nodes matching a metadata filter, with retries."""
     if not filter_dict:
         logger.warning("GRAPH_UTILS(find): Empty filter provided. Returning empty list.")
         return []
+    if backend := _local():
+        return await backend.find_nodes(filter_dict)
     adapter = await get_adapter()
     nodes, _ = await adapter.get_filtered_graph_data([filter_dict])
     return [node for node, data in nodes]
 
+def _cypher_projection(variable: str, properties: List[str]) -> str:
+    """Map projection returning only the listed properties, e.g. n {.`name`, .`type`}."""
+    return f"{variable} {{{', '.join('.`' + p.replace('`', '``') + '`' for p in properties)}}}" if properties else f"properties({variable})"
+
+def _cypher_match_by_slug(variable: str, condition: str, imports: str = "") -> str:
+    """
+    CALL subquery binding `variable` to the nodes whose slug_id meets `condition`, as a UNION of one
+    index-backed MATCH per label in NODE_LABELS, e.g. condition "n.slug_id = node_id" with imports "node_id".
+    """
+    imported = f"WITH {imports} " if imports else ""
+    return "CALL { " + " UNION ".join(f"{imported}MATCH ({variable}:{label}) WHERE {condition} RETURN {variable}" for label in NODE_LABELS) + " }"
+
+@retry(stop=stop_after_attempt(3), wait=wait_exponential(multiplier=1, min=2, max=10), retry=retry_if_exception(is_transient_error), before_sleep=before_sleep_log(logger, "WARNING"))
+async def get_node_details_batch(node_ids: List[str], properties: Optional[List[str]] = None) -> Dict[str, Dict[str, Any]]:
+    """One round trip for many nodes: node ID -> its projected attributes (None values dropped)."""
+    node_ids = list(dict.fromkeys(i for i in node_ids if i))
+    if not node_ids: return {}
+    if backend := _local():
+        found = await backend.get_nodes_by_ids(node_ids, properties)
+    else:
+        query = (f"UNWIND $ids AS node_id {_cypher_match_by_slug('n', 'n.slug_id = node_id', 'node_id')} "
+                 f"RETURN n.slug_id AS id, {_cypher_projection('n', properties)} AS attributes")
+        found = {record["id"]: record["attributes"] or {} for record in await execute_cypher_query(query, {"ids": node_ids})}
+    return {node_id: {k: v for k, v in attributes.items() if v is not None} for node_id, attributes in found.items()}
+
+@retry(stop=stop_after_attempt(3), wait=wait_exponential(multiplier=1, min=2, max=10), retry=retry_if_exception(is_transient_error), before_sleep=before_sleep_log(logger, "WARNING"))
+async def get_edge_details_batch(pairs: List[Tuple[str, str]], properties: Optional[List[str]] = None) -> List[Tuple[str, str, str, Dict[str, Any]]]:
+    """One round trip for the edges between many (source, target) pairs, with projected attributes."""
+    pairs = list(dict.fromkeys(p for p in pairs if all(p)))
+    if not pairs: return []
+    if backend := _local():
+        edges = await backend.get_edges_between(pairs, properties)
+    else:
+        query = (f"UNWIND $pairs AS pair {_cypher_match_by_slug('s', 's.slug_id = pair.source', 'pair')} "
+                 f"{_cypher_match_by_slug('t', 't.slug_id = pair.target', 'pair')} MATCH (s)-[r]->(t) "
+                 f"RETURN s.slug_id AS source, t.slug_id AS target, type(r) AS rel_type, {_cypher_projection('r', properties)} AS attributes")
+        records = await execute_cypher_query(query, {"pairs": [{"source": s, "target": t} for s, t in pairs]})
+        edges = [(r["source"], r["target"], r["rel_type"], r["attributes"] or {}) for r in records]
+    return [(s, t, r, {k: v for k, v in attributes.items() if v is not None}) for s, t, r, attributes in edges]
+
+@retry(stop=stop_after_attempt(3), wait=wait_exponential(multiplier=1, min=2, max=10), retry=retry_if_exception(is_transient_error), before_sleep=before_sleep_log(logger, "WARNING"))
+async def get_repo_edges(repo_id_with_branch: str, rel_type: Optional[str] = None) -> List[Tuple[str, str, str]]:
+    """(source, target, type) of every edge (of `rel_type`, if given) leaving a node of the repository, for bulk index builds."""
+    prefix = f"{repo_id_with_branch}|"
+    if backend := _local():
+        return await backend.get_edges_by_prefix(prefix, rel_type)
+    # STARTS WITH on slug_id is a range seek on each label's unique index.
+    query = (f"{_cypher_match_by_slug('s', 's.slug_id STARTS WITH $prefix')} "
+             "MATCH (s)-[r]->(t) WHERE $rel_type IS NULL OR type(r) = $rel_type "
+             "RETURN s.slug_id AS source, t.slug_id AS target, type(r) AS rel_type")
+    return [(r["source"], r["target"], r["rel_type"]) for r in await execute_cypher_query(query, {"rel_type": rel_type, "prefix": prefix})]
+
+@retry(stop=stop_after_attempt(3), wait=wait_exponential(multiplier=1, min=2, max=10), retry=retry_if_exception(is_transient_error), before_sleep=before_sleep_log(logger, "WARNING"))
+async def get_edges_into_path(repo_id_with_branch: str, relative_path: str) -> List[Tuple[str, str, str]]:
+    """(source, target, type) of every edge from another file into a node of this file, i.e. what deleting the file detaches."""
+    prefix = f"{repo_id_with_branch}|{relative_path}@"
+    if backend := _local():
+        return await backend.get_edges_into_prefix(prefix)
+    query = (f"{_cypher_match_by_slug('t', 't.slug_id STARTS WITH $prefix')} "
+             "MATCH (s)-[r]->(t) WHERE NOT s.slug_id STARTS WITH $prefix "
+             "RETURN s.slug_id AS source, t.slug_id AS target, type(r) AS rel_type")
+    return [(r["source"], r["target"], r["rel_type"]) for r in await execute_cypher_query(query, {"prefix": prefix})]
+
 @retry(stop=stop_after_attempt(3), wait=wait_exponential(multiplier=1, min=2, max=10), retry=retry_if_exception(is_transient_error), before_sleep=before_sleep_log(logger, "WARNING"))
 async def delete_nodes_with_filter(filter_dict: Dict[str, Any]):
     """Generic function to delete nodes matching a metadata filter, with retries."""
     if not filter_dict: return
-    adapter = await get_adapter()
-    nodes_to_delete, _ = await adapter.get_filtered_graph_data([filter_dict])
-    if node_ids_to_delete := [node.id for node, data in nodes_to_delete]:
-        logger.info(f"GRAPH_UTILS(delete): Deleting {len(node_ids_to_delete)} nodes.")
-        await adapter.delete_nodes(node_ids_to_delete)
+    if filter_dict.keys() == {"repo_id_str", "relative_path_str"}:
+        await code_indexes.before_path_deleted(filter_dict["repo_id_str"], filter_dict["relative_path_str"])
+    if backend := _local():
+        if deleted := await backend.delete_nodes(filter_dict):
+            logger.info(f"GRAPH_UTILS(delete): Deleting {deleted} nodes.")
+    else:
+        adapter = await get_adapter()
+        nodes_to_delete, _ = await adapter.get_filtered_graph_data([filter_dict])
+        if node_ids_to_delete := [node.id for node, data in nodes_to_delete]:
+            logger.info(f"GRAPH_UTILS(delete): Deleting {len(node_ids_to_delete)} nodes.")
+            await adapter.delete_nodes(node_ids_to_delete)
+    if filter_dict.keys() == {"repo_id_str", "relative_path_str"}:
+        # A whole file is gone (re-ingest or delete); so are the PendingLinks its entities made.
+        after_commit(get_link_stats().on_path_deleted, filter_dict["repo_id_str"], filter_dict["relative_path_str"])
+        after_commit(code_indexes.on_path_deleted, filter_dict["repo_id_str"], filter_dict["relative_path_str"])
 
 @retry(stop=stop_after_attempt(3), wait=wait_exponential(multiplier=1, min=2, max=10), retry=retry_if_exception(is_transient_error), before_sleep=before_sleep_log(logger, "WARNING"))
-async def save_graph_data(nodes: List[Node], relationships: List[Tuple[str, str, str, Dict[str, Any]]]):
+async def save_graph_data(nodes: List["Node"], relationships: List[Tuple[str, str, str, Dict[str, Any]]]):
     """Saves a batch of nodes and edges to the graph, with retries."""
     if not nodes and not relationships: return
-    adapter = await get_adapter()
     logger.info(f"GRAPH_UTILS(save): Saving {len(nodes)} nodes and {len(relationships)} relationships.")
-    if nodes: await adapter.add_nodes(nodes)
-    if relationships: await adapter.add_edges(relationships)
+    if backend := _local():
+        await backend.save(nodes, relationships)
+    else:
+        adapter = await get_adapter()
+        if nodes: await adapter.add_nodes(nodes)
+        if relationships: await adapter.add_edges(relationships)
+    after_commit(code_indexes.on_edges_saved, relationships)
 
 @retry(stop=stop_after_attempt(3), wait=wait_exponential(multiplier=1, min=2, max=10), retry=retry_if_exception(is_transient_error), before_sleep=before_sleep_log(logger, "WARNING"))
 async def atomic_get_and_increment_local_save(repo_id_with_branch: str, relative_path: str, commit_index: int) -> int:
     """Atomically finds or creates a file's version counter and increments it, returning the new value."""
+    if backend := _local():
+        return await backend.increment_version_counter(repo_id_with_branch, relative_path, commit_index)
     # This query atomically finds a counter node or creates it, then increments and returns the new value.
     cypher_query = """
     MERGE (v:VersionCounter { repo_id: $repo_id, path: $path, commit: $commit })
@@ -128,6 +280,58 @@ async def atomic_get_and_increment_local_save(repo_id_with_branch: str, relative
     logger.error("GRAPH_UTILS(atomic_counter): Atomic increment failed. Returning default of 1.")
     return 1 # Fallback
 
+@retry(stop=stop_after_attempt(3), wait=wait_exponential(multiplier=1, min=2, max=10), retry=retry_if_exception(is_transient_error), before_sleep=before_sleep_log(logger, "WARNING"))
+async def increment_stored_graph_version(repo_id_with_branch: str) -> int:
+    """Atomically creates (at 1) or increments the repository's stored graph version and returns it."""
+    if backend := _local():
+        return await backend.increment_graph_version(repo_id_with_branch)
+    cypher_query = """
+    MERGE (v:GraphVersion { repo_id: $repo_id })
+    ON CREATE SET v.version = 1
+    ON MATCH SET v.version = COALESCE(v.version, 0) + 1
+    RETURN v.version as version
+    """
+    result = await execute_cypher_query(cypher_query, {"repo_id": repo_id_with_branch})
+    return result[0].get("version")
+
+@retry(stop=stop_after_attempt(3), wait=wait_exponential(multiplier=1, min=2, max=10), retry=retry_if_exception(is_transient_error), before_sleep=before_sleep_log(logger, "WARNING"))
+async def get_stored_graph_versions() -> Dict[str, int]:
+    """repo@branch -> stored graph version, for every repository written since versions were stored."""
+    if backend := _local():
+        return await backend.get_graph_versions()
+    records = await execute_cypher_query("MATCH (v:GraphVersion) RETURN v.repo_id AS repo_id, v.version AS version")
+    return {r["repo_id"]: r["version"] for r in records}
+
+@retry(stop=stop_after_attempt(3), wait=wait_exponential(multiplier=1, min=2, max=10), retry=retry_if_exception(is_transient_error), before_sleep=before_sleep_log(logger, "WARNING"))
+async def get_header_changes(repo_id_with_branch: str, relative_path: Optional[str] = None) -> Dict[str, Tuple[int, Dict[str, Any]]]:
+    """Path -> (revision, change) of the repository's pending header changes (include_graph.HeaderChange), or of one path."""
+    if backend := _local():
+        return await backend.get_header_changes(repo_id_with_branch, relative_path)
+    records = await execute_cypher_query(
+        "MATCH (c:HeaderChange { repo_id: $repo_id }) WHERE $path IS NULL OR c.path = $path "
+        "RETURN c.path AS path, c.revision AS revision, c.change AS change",
+        {"repo_id": repo_id_with_branch, "path": relative_path})
+    return {r["path"]: (r["revision"], json.loads(r["change"])) for r in records}
+
+@retry(stop=stop_after_attempt(3), wait=wait_exponential(multiplier=1, min=2, max=10), retry=retry_if_exception(is_transient_error), before_sleep=before_sleep_log(logger, "WARNING"))
+async def save_header_change(repo_id_with_branch: str, relative_path: str, revision: int, change: Dict[str, Any]):
+    if backend := _local():
+        return await backend.save_header_change(repo_id_with_branch, relative_path, revision, change)
+    await execute_cypher_query(
+        "MERGE (c:HeaderChange { repo_id: $repo_id, path: $path }) SET c.revision = $revision, c.change = $change",
+        {"repo_id": repo_id_with_branch, "path": relative_path, "revision": revision, "change": json.dumps(change)})
+
+@retry(stop=stop_after_attempt(3), wait=wait_exponential(multiplier=1, min=2, max=10), retry=retry_if_exception(is_transient_error), before_sleep=before_sleep_log(logger, "WARNING"))
+async def delete_header_changes(repo_id_with_branch: str, revisions: Dict[str, int]):
+    """Deletes each path's pending header change if it is still at the given revision (nothing recorded since it was planned)."""
+    if not revisions: return
+    if backend := _local():
+        return await backend.delete_header_changes(repo_id_with_branch, revisions)
+    await execute_cypher_query(
+        "UNWIND $changes AS change MATCH (c:HeaderChange { repo_id: $repo_id, path: change.path }) "
+        "WHERE c.revision = change.revision DELETE c",
+        {"repo_id": repo_id_with_branch, "changes": [{"path": p, "revision": r} for p, r in revisions.items()]})
+
 async def check_content_exists(content_hash: str) -> bool:
     """Checks if a SourceFile node with a specific content hash already exists."""
     nodes = await find_nodes_with_filter({'content_hash': content_hash, 'type': 'SourceFile'})
@@ -135,6 +339,8 @@ async def check_content_exists(content_hash: str) -> bool:
 
 async def find_code_entity_by_path(repo_id_with_branch: str, relative_path: Optional[str], fqn: str) -> Optional[str]:
     """Finds a CodeEntity by path and/or FQN using an optimized Cypher query."""
+    if backend := _local():
+        return await backend.find_code_entity_id(repo_id_with_branch, relative_path, fqn)
     params = {"repo_id": repo_id_with_branch, "fqn": fqn}
     if relative_path:
         query = "MATCH (n:CodeEntity { repo_id_str: $repo_id, relative_path_str: $path, canonical_fqn: $fqn }) RETURN n.id as id LIMIT 1"
@@ -145,12 +351,39 @@ async def find_code_entity_by_path(repo_id_with_branch: str, relative_path: Opti
     records = await execute_cypher_query(query, params)
     return records[0].get("id") if records else None
 
+@retry(stop=stop_after_attempt(3), wait=wait_exponential(multiplier=1, min=2, max=10), retry=retry_if_exception(is_transient_error), before_sleep=before_sleep_log(logger, "WARNING"))
+async def find_code_entity_ids_by_fqn_suffix(repo_id_with_branch: str, suffix: str) -> List[str]:
+    """The IDs of the CodeEntities in a repository whose canonical FQN ends with `suffix`."""
+    if backend := _local():
+        return await backend.find_code_entity_ids_by_fqn_suffix(repo_id_with_branch, suffix)
+    query = "MATCH (n:CodeEntity) WHERE n.repo_id_str = $repo_id AND n.canonical_fqn ENDS WITH $suffix RETURN n.slug_id AS id"
+    records = await execute_cypher_query(query, {"repo_id": repo_id_with_branch, "suffix": suffix})
+    return [record.get("id") for record in records]
+
 @retry(stop=stop_after_attempt(3), wait=wait_exponential(multiplier=1, min=2, max=10), retry=retry_if_exception(is_transient_error), before_sleep=before_sleep_log(logger, "WARNING"))
 async def update_pending_link_status(link_id: str, new_status: LinkStatus, new_metadata: Dict = None):
     """Updates the status and metadata of a single PendingLink node."""
     if not isinstance(new_status, LinkStatus):
         logger.error(f"GRAPH_UTILS(update_pending): Invalid status type: {new_status}. Aborting."); return
-    adapter = await get_adapter()
     update_payload = {"status": new_status.value}
     if new_metadata: update_payload.update(new_metadata)
-    await adapter.update_node(link_id, update_payload)
+    if backend := _local():
+        await backend.update_node(link_id, update_payload)
+    else:
+        adapter = await get_adapter()
+        await adapter.update_node(link_id, update_payload)
+    after_commit(get_link_stats().on_status, link_id, new_status)
+
+@retry(stop=stop_after_attempt(3), wait=wait_exponential(multiplier=1, min=2, max=10), retry=retry_if_exception(is_transient_error), before_sleep=before_sleep_log(logger, "WARNING"))
+async def mark_enhancement_failed(repo_id_with_branch: str, reason: str):
+    """Records a failed enhancement cycle on the Repository node so the failure is visible and not silently retried."""
+    update_payload = {
+        "enhancement_status": "failed",
+        "enhancement_error": reason,
+        "enhancement_failed_at": datetime.now(timezone.utc).isoformat(),
+    }
+    if backend := _local():
+        await backend.update_node(repo_id_with_branch, update_payload)
+        return
+    adapter = await get_adapter()
+    await adapter.update_node(repo_id_with_branch, update_payload)
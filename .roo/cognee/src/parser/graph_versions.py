@@ -0,0 +1,156 @@
+# .roo/cognee/src/parser/graph_versions.py
+"""
+Per-repo@branch graph version counters. The orchestrator records a write after each committed
+file transaction and the dispatcher after repair and enhancement work, so any cache derived from
+the graph (e.g. the retriever's query cache) can tell whether it is stale by comparing the
+versions it was built against.
+
+There are two counters per repository:
+  * the process counter (`bump`, `version`, `snapshot`) counts this process's writes only; the
+    retriever cache, which also has a TTL, keys on it.
+  * the stored version lives in the graph (a GraphVersion node, or the local backend's
+    graph_versions table) and counts every process's writes. `record_write` increments both.
+
+The in-memory code indexes (symbol, trigram, call graph, class hierarchy, include graph, interval
+and link stats) are per process and keep a SeedStamps of the stored version each repository was
+seeded at. Writes made by this process reach them through the after-commit hooks, so
+`record_write` moves their stamps along with the stored version; a write by any other process
+(e.g. a sharded ingest feeding the MCP server's graph) leaves the stamp behind and the next
+lookup reseeds that repository. Stored versions are re-read at most every
+GRAPH_VERSION_POLL_SECONDS, which bounds how stale another process's writes can look.
+"""
+import time
+import weakref
+from typing import Dict, Iterable, List, Optional, Set, Tuple
+
+from .configs import GRAPH_VERSION_POLL_SECONDS
+from .metrics import increment, GRAPH_VERSION_BUMPS
+from .utils import logger
+
+# Every live SeedStamps, so record_write can move them along with this process's own writes.
+_stamp_sets: "weakref.WeakSet[SeedStamps]" = weakref.WeakSet()
+
+class SeedStamps:
+    """
+    The stored graph version each repository of one in-memory index was seeded at. Only for the
+    process-wide indexes the after-commit hooks feed: record_write advances every live instance.
+    """
+    def __init__(self):
+        self._stamps: Dict[str, int] = {}
+        _stamp_sets.add(self)
+
+    def __contains__(self, repo: str) -> bool:
+        return repo in self._stamps
+
+    def get(self, repo: str) -> Optional[int]:
+        return self._stamps.get(repo)
+
+    async def due(self, repo: str, refresh: bool = False) -> Optional[int]:
+        """
+        The stored version to stamp once `repo` is reseeded, or None while its seed is current.
+        Read before the scan, so a write landing during the scan makes the next check reseed.
+        """
+        version = await get_graph_versions().stored_version(repo)
+        return version if refresh or self._stamps.get(repo) != version else None
+
+    def stamp(self, repo: str, version: int):
+        self._stamps[repo] = version
+
+    def discard(self, repo: str):
+        self._stamps.pop(repo, None)
+
+    def advance(self, repo: str, previous: int, version: int):
+        if self._stamps.get(repo) == previous:
+            self._stamps[repo] = version
+
+class GraphVersions:
+    def __init__(self, poll_seconds: float = GRAPH_VERSION_POLL_SECONDS):
+        self._versions: Dict[str, int] = {}
+        self._epoch = 0
+        self.poll_seconds = poll_seconds
+        self._stored: Dict[str, int] = {}
+        self._stored_at = float("-inf")
+        self._repository_nodes: Optional[Set[str]] = None
+
+    def bump(self, repo_id_with_branch: str, source: str = "orchestrator") -> int:
+        self._epoch += 1
+        self._versions[repo_id_with_branch] = self._versions.get(repo_id_with_branch, 0) + 1
+        increment(GRAPH_VERSION_BUMPS, repo=repo_id_with_branch, source=source)
+        return self._versions[repo_id_with_branch]
+
+    def version(self, repo_id_with_branch: str) -> int:
+        return self._versions.get(repo_id_with_branch, 0)
+
+    @property
+    def epoch(self) -> int:
+        """Total number of bumps across all repositories."""
+        return self._epoch
+
+    async def record_write(self, repo_id_with_branch: str, source: str = "orchestrator") -> int:
+        """
+        Bumps the process counter and the stored version after a write this process committed.
+        Its indexes already applied the write through their hooks, so those seeded at the previous
+        stored version move to the new one instead of reseeding.
+        """
+        version = self.bump(repo_id_with_branch, source)
+        from .graph_utils import increment_stored_graph_version
+        try:
+            stored = await increment_stored_graph_version(repo_id_with_branch)
+        except Exception as e:
+            logger.warning(f"GRAPH_VERSIONS({repo_id_with_branch}): Could not bump the stored version: {e}")
+            return version
+        for stamps in list(_stamp_sets):
+            stamps.advance(repo_id_with_branch, stored - 1, stored)
+        self._stored[repo_id_with_branch] = stored
+        return version
+
+    async def stored(self) -> Dict[str, int]:
+        """Every repository's stored version, re-read from the graph at most every `poll_seconds`."""
+        if time.monotonic() - self._stored_at >= self.poll_seconds:
+            from .graph_utils import get_stored_graph_versions
+            try:
+                self._stored = await get_stored_graph_versions()
+            except Exception as e:
+                logger.warning(f"GRAPH_VERSIONS: Could not read the stored versions, keeping the last ones: {e}")
+            self._stored_at = time.monotonic()
+        return self._stored
+
+    async def stored_version(self, repo_id_with_branch: str) -> int:
+        return (await self.stored()).get(repo_id_with_branch, 0)
+
+    async def known_repos(self, scopes: Optional[Iterable[str]] = None) -> List[str]:
+        """
+        The graph's Repository nodes (scanned once per process) plus every repository with a stored
+        or process version, optionally only those whose repo@branch key starts with one of `scopes`.
+        """
+        if self._repository_nodes is None:
+            from .graph_utils import find_nodes_with_filter
+            self._repository_nodes = {node.id for node in await find_nodes_with_filter({"type": "Repository"})}
+        known = self._repository_nodes | set(await self.stored()) | set(self._versions)
+        if scopes is None:
+            return sorted(known)
+        prefixes = [s.strip("/") for s in scopes if s and s.strip("/")]
+        return sorted(r for r in known if any(r == p or r.startswith(p + "@") for p in prefixes))
+
+    def repos_matching(self, scopes: Iterable[str]) -> Tuple[str, ...]:
+        """Known repositories whose repo@branch key starts with one of the scopes (e.g. "org/repo" or "org/repo@main")."""
+        prefixes = [s.strip("/") for s in scopes if s and s.strip("/")]
+        return tuple(sorted(r for r in self._versions if any(r == p or r.startswith(p + "@") or r.startswith(p + "/") for p in prefixes)))
+
+    def snapshot(self, scopes: Optional[Iterable[str]] = None) -> Tuple:
+        """
+        The version vector for the repositories under `scopes`. When no known repository matches,
+        the global epoch stands in, so any write anywhere invalidates.
+        """
+        repos = self.repos_matching(scopes or ())
+        if not repos:
+            return (("*", self._epoch),)
+        return tuple((r, self._versions[r]) for r in repos)
+
+_versions: Optional[GraphVersions] = None
+
+def get_graph_versions() -> GraphVersions:
+    global _versions
+    if _versions is None:
+        _versions = GraphVersions()
+    return _versions
@@ -0,0 +1,283 @@
+# .roo/cognee/src/parser/include_graph.py
+"""
+Reverse transitive include index for header change impact.
+
+Deleting a file's nodes, which precedes every re-ingest, also drops the edges other files had into
+its entities, so a re-ingested header loses every link its includers resolved against it. When a
+file that something includes is about to be deleted, this index records the edges being detached
+and the file's declarations as a HeaderChange, stored in the graph in the same transaction as the
+delete, so a restart or another process's enhancement cycle still sees it. The next enhancement
+cycle diffs the recorded declarations against the file's current ones and applies the
+repository's ImpactPlan:
+  - detached links to unchanged declarations are re-pointed at the new entities;
+  - links to changed or removed declarations become PendingLinks again;
+  - PendingLinks in the header's transitive includers that name a changed declaration are reopened.
+Nothing outside that set is revisited. The stored changes are deleted only once the plan has been
+applied, and only those not recorded again meanwhile.
+
+Include targets are matched without the compiler's search paths: a quoted include resolves
+relative to the including file when that file exists, otherwise any file whose path ends with the
+include's path matches. The include closure is therefore a superset, never an undercount.
+
+The include table is seeded from the graph on first use and reseeded once another process has
+written to the repository (see graph_versions.SeedStamps). Ingestion seeds it before opening a
+file's transaction (code_indexes.before_transaction), so the delete hook never scans the graph
+while holding it; a delete in a repository that is not seeded records its incoming edges as changed.
+"""
+import posixpath
+from dataclasses import dataclass, field
+from typing import Dict, Iterable, List, Optional, Set, Tuple
+
+from .entities import ImportType
+from .graph_versions import SeedStamps
+from .symbol_index import locate, name_segments, split_signature
+from .utils import logger, resolve_import_path
+
+INCLUDE = "INCLUDE"
+
+def declaration_signature(snippet: str) -> str:
+    """The declaration part of an entity's snippet (everything before its body), whitespace-normalized."""
+    return " ".join((snippet or "").split("{", 1)[0].split())
+
+def reference_name(expression: str) -> str:
+    """'ns::Box<int>::get(int)' -> 'get'; 'obj.method' and 'ptr->method' -> 'method'."""
+    qualified, _ = split_signature(expression.replace("->", "::").replace(".", "::"))
+    segments = name_segments(qualified)
+    return segments[-1] if segments else ""
+
+def _fqn(entity_id: str, canonical_fqn: Optional[str]) -> str:
+    return canonical_fqn or entity_id.rsplit("|", 1)[-1].rsplit("@", 1)[0]
+
+def _include_tail(expression: str) -> str:
+    return "/".join(p for p in expression.split("/") if p not in ("", ".", ".."))
+
+@dataclass
+class HeaderChange:
+    """A file's declarations before its first change since the last plan and the links its deletes detached."""
+    path: str
+    baseline: Dict[str, Tuple[str, str]]
+    detached: List[Tuple[str, str, str]] = field(default_factory=list)  # (source, target fqn, type)
+    revision: int = 0  # Bumped on every record, so a plan only settles the changes it saw.
+
+    def changed_fqns(self, current: Dict[str, Tuple[str, str]]) -> Set[str]:
+        return {fqn for fqn, _ in set(self.baseline.values()) ^ set(current.values())}
+
+    def to_dict(self) -> dict:
+        return {"baseline": {e: list(d) for e, d in self.baseline.items()}, "detached": [list(d) for d in self.detached]}
+
+    @classmethod
+    def from_dict(cls, path: str, revision: int, data: dict) -> "HeaderChange":
+        return cls(path, {e: tuple(d) for e, d in data["baseline"].items()}, [tuple(d) for d in data["detached"]], revision)
+
+@dataclass
+class ImpactPlan:
+    repo: str
+    headers: Dict[str, Set[str]]                  # changed file -> its added, removed or re-declared FQNs
+    files: Dict[str, Set[str]]                    # transitive includer -> names its PendingLinks are re-checked against
+    repoint: List[Tuple[str, str, str, str]]      # (source, header path, fqn, type): target re-declared unchanged
+    recheck: List[Tuple[str, str, str]]           # (source, fqn, type): target changed or removed
+    revisions: Dict[str, int] = field(default_factory=dict)  # changed file -> revision of its change planned
+
+    def to_dict(self) -> dict:
+        return {"repo": self.repo, "headers": {p: sorted(f) for p, f in self.headers.items()},
+                "files": {p: sorted(n) for p, n in self.files.items()},
+                "repoint": [list(r) for r in self.repoint], "recheck": [list(r) for r in self.recheck]}
+
+class RepoIncludeGraph:
+    def __init__(self, repo: str):
+        self.repo = repo
+        self.paths: Set[str] = set()
+        self.includes: Dict[str, Set[Tuple[str, bool]]] = {}        # path -> {(expression, quoted)}
+        self.declarations: Dict[str, Dict[str, Tuple[str, str]]] = {}  # path -> entity id -> (fqn, signature)
+        self.changes: Dict[str, HeaderChange] = {}
+        # Includers keyed by the basename they include, so a header's direct includers are one lookup.
+        self._by_name: Dict[str, Set[Tuple[str, str, bool]]] = {}
+
+    # --- Maintenance ---
+
+    def set_file(self, path: str, includes: Iterable[Tuple[str, bool]], declarations: Dict[str, Tuple[str, str]]):
+        self._drop_includes(path)
+        self.paths.add(path)
+        self.includes[path] = set(includes)
+        for expression, quoted in self.includes[path]:
+            self._by_name.setdefault(posixpath.basename(expression), set()).add((path, expression, quoted))
+        self.declarations[path] = dict(declarations)
+
+    def add_include(self, path: str, expression: str, quoted: bool):
+        self.paths.add(path)
+        self.includes.setdefault(path, set()).add((expression, quoted))
+        self._by_name.setdefault(posixpath.basename(expression), set()).add((path, expression, quoted))
+
+    def add_declaration(self, path: str, entity_id: str, fqn: str, signature: str):
+        self.paths.add(path)
+        self.declarations.setdefault(path, {})[entity_id] = (fqn, signature)
+
+    def remove_path(self, path: str):
+        self._drop_includes(path)
+        self.paths.discard(path)
+        self.declarations.pop(path, None)
+
+    def _drop_includes(self, path: str):
+        for expression, quoted in self.includes.pop(path, ()):
+            includers = self._by_name.get(posixpath.basename(expression))
+            if includers is not None:
+                includers.discard((path, expression, quoted))
+                if not includers:
+                    del self._by_name[posixpath.basename(expression)]
+
+    # --- Include closure ---
+
+    def _includes(self, path: str, expression: str, quoted: bool, header: str) -> bool:
+        if quoted and (local := resolve_import_path(path, expression)) in self.paths:
+            return local == header
+        tail = _include_tail(expression)
+        return bool(tail) and (header == tail or header.endswith("/" + tail))
+
+    def includers(self, header: str) -> Set[str]:
+        return {path for path, expression, quoted in self._by_name.get(posixpath.basename(header), ())
+                if path != header and self._includes(path, expression, quoted, header)}
+
+    def dependents(self, header: str) -> Set[str]:
+        """Every file that includes `header`, directly or through other headers."""
+        seen, stack = set(), [header]
+        while stack:
+            for path in self.includers(stack.pop()):
+                if path not in seen and path != header:
+                    seen.add(path)
+                    stack.append(path)
+        return seen
+
+    # --- Change tracking ---
+
+    def record_delete(self, path: str, detached: Iterable[Tuple[str, str, str]], declarations: Optional[Dict[str, Tuple[str, str]]] = None) -> HeaderChange:
+        """
+        Before `path`'s nodes go: keeps its declarations (the index's unless given) as the baseline
+        and the incoming edges by target FQN.
+        """
+        if declarations is None:
+            declarations = self.declarations.get(path, {})
+        change = self.changes.setdefault(path, HeaderChange(path, dict(declarations)))
+        for source, target, rel_type in detached:
+            if target in declarations:
+                change.detached.append((source, declarations[target][0], rel_type))
+        change.revision += 1
+        return change
+
+    def plan(self) -> ImpactPlan:
+        """Diffs each change's baseline against the file's declarations now (none once it is deleted)."""
+        headers, files, repoint, recheck = {}, {}, [], []
+        for path, change in sorted(self.changes.items()):
+            current = self.declarations.get(path, {})
+            changed = change.changed_fqns(current)
+            headers[path] = changed
+            if changed:
+                names = {reference_name(fqn) for fqn in changed} - {""}
+                for dependent in self.dependents(path):
+                    files.setdefault(dependent, set()).update(names)
+            redeclared = {fqn for fqn, _ in current.values()} - changed
+            for source, fqn, rel_type in dict.fromkeys(change.detached):
+                if fqn in redeclared:
+                    repoint.append((source, path, fqn, rel_type))
+                else:
+                    recheck.append((source, fqn, rel_type))
+        return ImpactPlan(self.repo, headers, files, repoint, recheck, {p: c.revision for p, c in self.changes.items()})
+
+class IncludeGraphIndex:
+    """The per-repository include graphs and pending header changes of this process."""
+    def __init__(self):
+        self._repos: Dict[str, RepoIncludeGraph] = {}
+        self._seeded = SeedStamps()
+
+    def get(self, repo: str) -> RepoIncludeGraph:
+        if repo not in self._repos:
+            self._repos[repo] = RepoIncludeGraph(repo)
+        return self._repos[repo]
+
+    async def before_path_deleted(self, repo: str, relative_path: str):
+        """
+        Captures what deleting a file that others include detaches and stores the file's change,
+        inside the delete's transaction; in a seeded repository, files nothing includes cost no query.
+        """
+        from .graph_utils import get_edges_into_path, get_header_changes, save_header_change
+        graph = self.get(repo)
+        seeded = repo in self._seeded
+        if seeded and relative_path not in graph.changes and not graph.includers(relative_path):
+            return
+        detached = await get_edges_into_path(repo, relative_path)
+        declarations = None
+        if not seeded:
+            if not detached:
+                return
+            # Without the file's declarations their signatures are unknown: every linked entity counts as changed.
+            declarations = {t: (_fqn(t, None), "") for _, t, _ in detached if t.count("|") == 3}
+        stored = await get_header_changes(repo, relative_path)
+        if relative_path in stored:
+            graph.changes[relative_path] = HeaderChange.from_dict(relative_path, *stored[relative_path])
+        change = graph.record_delete(relative_path, detached, declarations)
+        await save_header_change(repo, relative_path, change.revision, change.to_dict())
+
+    def on_path_deleted(self, repo: str, relative_path: str):
+        if repo in self._repos:
+            self._repos[repo].remove_path(relative_path)
+
+    def on_island_saved(self, repo: str, island):
+        graph = self.get(repo)
+        path = island.source_file.relative_path
+        includes = [(ref.target_expression, ref.context.import_type == ImportType.RELATIVE)
+                    for ref in island.raw_references if ref.reference_type == INCLUDE]
+        declarations = {e.id: (_fqn(e.id, e.canonical_fqn), declaration_signature(e.snippet_content)) for e in island.code_entities}
+        graph.set_file(path, includes, declarations)
+
+    async def ensure_seeded(self, repos: Iterable[str], refresh: bool = False):
+        """Scans each repository's files, entities and resolved and pending INCLUDE references from the graph unless its seed is current."""
+        from .graph_utils import find_nodes_with_filter, get_repo_edges
+        for repo in repos:
+            if (version := await self._seeded.due(repo, refresh)) is None:
+                continue
+            graph = self.get(repo)
+            changes, graph = graph.changes, RepoIncludeGraph(repo)
+            graph.changes = changes
+            self._repos[repo] = graph
+            for node in await find_nodes_with_filter({"type": "SourceFile", "repo_id_str": repo}):
+                graph.paths.add(locate(node.id)[1])
+            for node in await find_nodes_with_filter({"type": "CodeEntity", "repo_id_str": repo}):
+                a = node.attributes
+                graph.add_declaration(locate(node.id)[1], node.id, _fqn(node.id, a.get("canonical_fqn")), declaration_signature(a.get("snippet_content")))
+            for source, target, _ in await get_repo_edges(repo, INCLUDE):
+                # A resolved include lost its expression; the target's own path matches it exactly.
+                graph.add_include(locate(source)[1], locate(target)[1], False)
+            for node in await find_nodes_with_filter({"type": "PendingLink", "repo_id_str": repo}):
+                ref = node.attributes.get("reference_data") or {}
+                if ref.get("reference_type") == INCLUDE:
+                    quoted = (ref.get("context") or {}).get("import_type") == ImportType.RELATIVE.value
+                    graph.add_include(locate(ref.get("source_entity_id", ""))[1], ref.get("target_expression", ""), quoted)
+            self._seeded.stamp(repo, version)
+            logger.info(f"INCLUDE_GRAPH({repo}): Seeded {len(graph.paths)} files and {sum(map(len, graph.includes.values()))} includes from the graph.")
+
+    async def plan(self, repo: str) -> Optional[ImpactPlan]:
+        """The impact of the repository's stored header changes, whichever process recorded them, or None when there is none."""
+        from .graph_utils import get_header_changes
+        stored = await get_header_changes(repo)
+        if not stored:
+            return None
+        await self.ensure_seeded([repo])
+        graph = self.get(repo)
+        graph.changes = {path: HeaderChange.from_dict(path, revision, data) for path, (revision, data) in stored.items()}
+        return graph.plan()
+
+    async def settle(self, repo: str, plan: ImpactPlan):
+        """Drops the changes `plan` covered once it has been applied; a change recorded again since stays for the next plan."""
+        from .graph_utils import delete_header_changes
+        await delete_header_changes(repo, plan.revisions)
+        graph = self._repos.get(repo)
+        for path, revision in plan.revisions.items():
+            if graph is not None and path in graph.changes and graph.changes[path].revision == revision:
+                del graph.changes[path]
+
+_index: Optional[IncludeGraphIndex] = None
+
+def get_include_graph() -> IncludeGraphIndex:
+    global _index
+    if _index is None:
+        _index = IncludeGraphIndex()
+    return _index
@@ -0,0 +1,130 @@
+# .roo/cognee/src/parser/ingest_journal.py
+import os
+import sqlite3
+import time
+from enum import Enum
+from typing import Dict, Iterable, List, NamedTuple, Optional, Sequence, Set, Tuple
+
+from .utils import logger
+
+class FileState(str, Enum):
+    """Progress of one file through a bulk ingest run."""
+    READ = "read"
+    PARSED = "parsed"
+    COMMITTED = "committed"
+    FAILED = "failed"
+
+class JournalEntry(NamedTuple):
+    relative_path: str
+    state: FileState
+    size: Optional[int] = None
+    mtime_ns: Optional[int] = None
+    content_hash: Optional[str] = None
+    error: Optional[str] = None
+
+_SCHEMA = """
+CREATE TABLE IF NOT EXISTS file_progress (
+    repo_key      TEXT    NOT NULL,
+    commit_index  INTEGER NOT NULL,
+    relative_path TEXT    NOT NULL,
+    state         TEXT    NOT NULL,
+    size          INTEGER,
+    mtime_ns      INTEGER,
+    content_hash  TEXT,
+    error         TEXT,
+    updated_at    REAL    NOT NULL,
+    PRIMARY KEY (repo_key, commit_index, relative_path)
+) WITHOUT ROWID;
+"""
+
+class IngestJournal:
+    """
+    Durable per-file progress for bulk ingestion, kept in a local SQLite database in WAL mode.
+    A file recorded as COMMITTED whose size and mtime are unchanged is skipped on the next run
+    without being read, hashed or looked up in the graph.
+    """
+    def __init__(self, path: str, repo_key: str, commit_index: int):
+        self.path = path
+        self.repo_key = repo_key
+        self.commit_index = commit_index
+        os.makedirs(os.path.dirname(os.path.abspath(path)), exist_ok=True)
+        self._conn = sqlite3.connect(path, isolation_level=None)
+        self._conn.execute("PRAGMA journal_mode=WAL")
+        # NORMAL keeps commits durable across process crashes; only an OS crash can lose the last few.
+        self._conn.execute("PRAGMA synchronous=NORMAL")
+        self._conn.executescript(_SCHEMA)
+
+    def close(self):
+        self._conn.close()
+
+    def record(self, entries: Iterable[JournalEntry]):
+        """Writes a batch of state changes in one transaction. A later state never loses a known size/mtime/hash."""
+        now = time.time()
+        rows = [(self.repo_key, self.commit_index, e.relative_path, e.state.value, e.size, e.mtime_ns, e.content_hash, e.error, now) for e in entries]
+        if not rows:
+            return
+        with self._conn:
+            self._conn.execute("BEGIN")
+            self._conn.executemany(
+                """
+                INSERT INTO file_progress (repo_key, commit_index, relative_path, state, size, mtime_ns, content_hash, error, updated_at)
+                VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?)
+                ON CONFLICT (repo_key, commit_index, relative_path) DO UPDATE SET
+                    state = excluded.state,
+                    size = COALESCE(excluded.size, size),
+                    mtime_ns = COALESCE(excluded.mtime_ns, mtime_ns),
+                    content_hash = COALESCE(excluded.content_hash, content_hash),
+                    error = excluded.error,
+                    updated_at = excluded.updated_at
+                """,
+                rows,
+            )
+
+    def committed_files(self) -> Dict[str, Tuple[Optional[int], Optional[int]]]:
+        cursor = self._conn.execute(
+            "SELECT relative_path, size, mtime_ns FROM file_progress WHERE repo_key = ? AND commit_index = ? AND state = ?",
+            (self.repo_key, self.commit_index, FileState.COMMITTED.value),
+        )
+        return {rel: (size, mtime_ns) for rel, size, mtime_ns in cursor}
+
+    def incomplete_files(self) -> Set[str]:
+        """
+        Files a run started but did not commit. Their earlier transaction may have been cut short,
+        and the cognee backend cannot roll a partial write back, so they are re-ingested without
+        trusting the graph's content check.
+        """
+        cursor = self._conn.execute(
+            "SELECT relative_path FROM file_progress WHERE repo_key = ? AND commit_index = ? AND state != ?",
+            (self.repo_key, self.commit_index, FileState.COMMITTED.value),
+        )
+        return {rel for (rel,) in cursor}
+
+    def state_counts(self) -> Dict[str, int]:
+        cursor = self._conn.execute(
+            "SELECT state, COUNT(*) FROM file_progress WHERE repo_key = ? AND commit_index = ? GROUP BY state",
+            (self.repo_key, self.commit_index),
+        )
+        return dict(cursor.fetchall())
+
+    def filter_pending(self, files: Sequence[Tuple[str, str]]) -> Tuple[List[Tuple[str, str]], int]:
+        """
+        Splits (absolute_path, relative_path) pairs into those still to ingest and a count of those
+        already committed with an unchanged size and mtime. Only a stat is done per file.
+        """
+        committed = self.committed_files()
+        pending: List[Tuple[str, str]] = []
+        skipped = 0
+        for absolute_path, relative_path in files:
+            known = committed.get(relative_path)
+            if known and known[0] is not None:
+                try:
+                    st = os.stat(absolute_path)
+                    if (st.st_size, st.st_mtime_ns) == known:
+                        skipped += 1
+                        continue
+                except OSError:
+                    pass
+            pending.append((absolute_path, relative_path))
+        if skipped:
+            logger.info(f"INGEST_JOURNAL: Resuming {self.repo_key}@{self.commit_index}: {skipped} files already committed, {len(pending)} to go.")
+        return pending, skipped
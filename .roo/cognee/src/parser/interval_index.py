@@ -0,0 +1,227 @@
+# .roo/cognee/src/parser/interval_index.py
+"""
+Per-file source-location index over CodeEntity line spans, for entity-at-position queries
+(hover, go-to-enclosing-symbol) that would otherwise be range-filtered graph queries.
+
+Each file's spans are cut into elementary segments: maximal line ranges over which the innermost
+containing entity does not change. The innermost entity at a line is one bisect over the segment
+starts, and the enclosing scopes follow parent links from there. Parser entities nest, so the
+innermost entity is the most recently opened one still open; a file is rebuilt whenever it is
+re-ingested, never patched.
+
+Spans come from the parser's start_line/end_line via the ingest hooks (code_indexes.py) and are
+seeded from the graph's CodeEntity nodes on first use, and again once another process has written
+to the repository (see graph_versions.SeedStamps). With INTERVAL_INDEX_DIR set, each repository's
+spans are saved there at exit, with the stored graph version they correspond to, and loaded in
+place of the graph scan while that is still the repository's stored version.
+"""
+import json
+import os
+import secrets
+from bisect import bisect_right
+from typing import Dict, Iterable, List, NamedTuple, Optional, Set
+
+from .configs import INTERVAL_INDEX_DIR
+from .graph_versions import SeedStamps, get_graph_versions
+from .utils import logger
+
+class EntitySpan(NamedTuple):
+    entity_id: str
+    start_line: int
+    end_line: int
+    type: str
+    canonical_fqn: str
+
+    def to_dict(self) -> dict:
+        return self._asdict()
+
+def span_of(entity_id: str, attributes: dict) -> Optional[EntitySpan]:
+    """A span from a CodeEntity node; IDs end in 'fqn@start-end', which covers entities saved without line attributes."""
+    start, end = attributes.get("start_line"), attributes.get("end_line")
+    if not start or not end:
+        try:
+            start, end = (int(x) for x in entity_id.rsplit("@", 1)[1].split("-", 1))
+        except (IndexError, ValueError):
+            return None
+    return EntitySpan(entity_id, start, max(start, end), attributes.get("type") or "", attributes.get("canonical_fqn") or "")
+
+class FileIntervals:
+    def __init__(self, spans: Iterable[EntitySpan]):
+        # Outer before inner at a shared start; the stable sort keeps the parser's (pre-order) order for equal spans.
+        self.spans: List[EntitySpan] = sorted(spans, key=lambda s: (s.start_line, -s.end_line))
+        self.parent: List[int] = []
+        stack: List[int] = []
+        for i, span in enumerate(self.spans):
+            while stack and self.spans[stack[-1]].end_line < span.end_line:
+                stack.pop()
+            self.parent.append(stack[-1] if stack else -1)
+            stack.append(i)
+
+        # Segment k covers lines [starts[k], starts[k + 1]) and belongs to span owner[k] (-1: none).
+        self.starts: List[int] = []
+        self.owner: List[int] = []
+        points = sorted({s.start_line for s in self.spans} | {s.end_line + 1 for s in self.spans})
+        stack, next_span = [], 0
+        for point in points:
+            while stack and self.spans[stack[-1]].end_line < point:
+                stack.pop()
+            while next_span < len(self.spans) and self.spans[next_span].start_line <= point:
+                stack.append(next_span)
+                next_span += 1
+            owner = stack[-1] if stack else -1
+            if not self.owner or self.owner[-1] != owner:
+                self.starts.append(point)
+                self.owner.append(owner)
+
+    def __len__(self) -> int:
+        return len(self.spans)
+
+    def _innermost(self, line: int) -> int:
+        k = bisect_right(self.starts, line) - 1
+        return self.owner[k] if k >= 0 else -1
+
+    def innermost(self, line: int) -> Optional[EntitySpan]:
+        i = self._innermost(line)
+        return self.spans[i] if i >= 0 else None
+
+    def enclosing(self, line: int) -> List[EntitySpan]:
+        """Every entity containing `line`, innermost first."""
+        chain, i = [], self._innermost(line)
+        while i >= 0:
+            if self.spans[i].start_line <= line <= self.spans[i].end_line:
+                chain.append(self.spans[i])
+            i = self.parent[i]
+        return chain
+
+class RepoIntervalIndex:
+    def __init__(self, repo: str, directory: Optional[str] = None):
+        self.repo = repo
+        self._path = os.path.join(directory, repo.replace("/", "__") + ".intervals.json") if directory else None
+        self._spans: Dict[str, List[EntitySpan]] = {}
+        self._files: Dict[str, FileIntervals] = {}
+        self.dirty = False
+        self.persisted = False
+        self.graph_version: Optional[int] = None  # Stored graph version of the saved spans, if known.
+        if self._path and os.path.exists(self._path):
+            try:
+                with open(self._path, encoding="utf-8") as f:
+                    stored = json.load(f)
+                self._spans = {path: [EntitySpan(*row) for row in rows] for path, rows in stored["files"].items()}
+                self.graph_version = stored.get("graph_version")
+                self.persisted = True
+            except (OSError, ValueError, KeyError, TypeError) as e:
+                logger.warning(f"INTERVAL_INDEX({repo}): Ignoring unreadable {self._path}: {e}")
+
+    def set_file(self, relative_path: str, spans: Iterable[EntitySpan]):
+        self._spans[relative_path] = list(spans)
+        self._files.pop(relative_path, None)
+        self.dirty = True
+
+    def remove_path(self, relative_path: str):
+        if self._spans.pop(relative_path, None) is not None:
+            self._files.pop(relative_path, None)
+            self.dirty = True
+
+    def file(self, relative_path: str) -> Optional[FileIntervals]:
+        """The file's intervals, built on first use after each change."""
+        if relative_path not in self._files:
+            if relative_path not in self._spans:
+                return None
+            self._files[relative_path] = FileIntervals(self._spans[relative_path])
+        return self._files[relative_path]
+
+    def paths(self) -> List[str]:
+        return sorted(self._spans)
+
+    def save(self, graph_version: Optional[int] = None):
+        if not self._path:
+            return
+        os.makedirs(os.path.dirname(self._path), exist_ok=True)
+        tmp = f"{self._path}.{os.getpid()}.{secrets.token_hex(4)}.tmp"  # Unique: another process may be saving the same repository.
+        try:
+            with open(tmp, "w", encoding="utf-8") as f:
+                json.dump({"repo": self.repo, "graph_version": graph_version, "files": {p: [list(s) for s in spans] for p, spans in self._spans.items()}}, f)
+            os.replace(tmp, self._path)
+        finally:
+            if os.path.exists(tmp):
+                os.remove(tmp)
+        self.graph_version = graph_version
+        self.dirty = False
+
+class IntervalIndexes:
+    """The per-repository interval indexes of this process."""
+    def __init__(self, directory: Optional[str] = INTERVAL_INDEX_DIR):
+        self.directory = directory or None
+        self._repos: Dict[str, RepoIntervalIndex] = {}
+        self._seeded = SeedStamps()
+
+    def get(self, repo: str) -> RepoIntervalIndex:
+        if repo not in self._repos:
+            self._repos[repo] = RepoIntervalIndex(repo, self.directory)
+        return self._repos[repo]
+
+    def on_island_saved(self, repo: str, island):
+        spans = [EntitySpan(e.id, e.start_line, max(e.start_line, e.end_line), e.type, e.canonical_fqn or "") for e in island.code_entities]
+        self.get(repo).set_file(island.source_file.relative_path, spans)
+
+    def on_path_deleted(self, repo: str, relative_path: str):
+        if repo in self._repos:
+            self._repos[repo].remove_path(relative_path)
+
+    async def ensure_seeded(self, repo: str, refresh: bool = False):
+        """
+        Loads a repository's spans from its CodeEntity nodes, unless the spans loaded from disk were
+        saved at the repository's current stored graph version.
+        """
+        from .graph_utils import find_nodes_with_filter
+        from .symbol_index import locate
+        index = self.get(repo)
+        if repo not in self._seeded and index.persisted and index.graph_version is not None and not refresh:
+            stored = await get_graph_versions().stored_version(repo)
+            if index.graph_version == stored:
+                self._seeded.stamp(repo, stored)
+                return
+        if (version := await self._seeded.due(repo, refresh)) is None:
+            return
+        by_path: Dict[str, List[EntitySpan]] = {}
+        for node in await find_nodes_with_filter({"type": "CodeEntity", "repo_id_str": repo}):
+            if span := span_of(node.id, node.attributes):
+                by_path.setdefault(locate(node.id)[1], []).append(span)
+        for path in index.paths():
+            index.remove_path(path)
+        for path, spans in by_path.items():
+            index.set_file(path, spans)
+        self._seeded.stamp(repo, version)
+        logger.info(f"INTERVAL_INDEX({repo}): Seeded {sum(map(len, by_path.values()))} entities in {len(by_path)} files from the graph.")
+
+    async def entity_at(self, repo: str, relative_path: str, line: int) -> dict:
+        """The innermost entity at (path, line) and every scope enclosing it, innermost first."""
+        await self.ensure_seeded(repo)
+        intervals = self.get(repo).file(relative_path)
+        chain = intervals.enclosing(line) if intervals is not None else []
+        return {"repo": repo, "path": relative_path, "line": line,
+                "innermost": chain[0].to_dict() if chain else None, "enclosing": [s.to_dict() for s in chain[1:]]}
+
+    def flush(self):
+        """
+        Saves every seeded repository with unsaved changes (persistent directories only). Ingest-only
+        processes never seed, and would replace the server's file with one recording no graph version.
+        """
+        if not self.directory:
+            return
+        for index in self._repos.values():
+            if index.dirty and index.repo in self._seeded:
+                try:
+                    index.save(self._seeded.get(index.repo))
+                except OSError as e:
+                    logger.warning(f"INTERVAL_INDEX({index.repo}): Flush failed: {e}")
+
+_indexes: Optional[IntervalIndexes] = None
+
+def get_interval_indexes() -> IntervalIndexes:
+    global _indexes
+    if _indexes is None:
+        import atexit
+        _indexes = IntervalIndexes()
+        atexit.register(_indexes.flush)
+    return _indexes
@@ -0,0 +1,224 @@
+# .roo/cognee/src/parser/link_stats.py
+"""
+Observability for the PendingLink backlog, per repo@branch: counts by LinkStatus, age buckets,
+per-tier resolution and escalation rates, top unresolved target expressions and enhancement
+cycle durations.
+
+The tracker is updated incrementally at the points that change a link: creation during Tier 1
+(orchestrator), status updates and path deletes (graph_utils) and resolution (enhancement engine).
+A repository is scanned from the graph on its first stats request in this process, and again
+whenever its stored graph version shows a write by another process (see graph_versions), so an
+MCP server reports the backlog a separate ingest process is building. Tier outcomes, resolution
+times and cycle timings come from this process's metrics registry: "enhancement_observed" tells
+whether this process ran any enhancement cycle for the repository, i.e. whether those are
+meaningful or merely empty.
+"""
+import time
+from collections import Counter
+from datetime import datetime
+from typing import Dict, List, Optional, Set
+
+from .entities import LinkStatus
+from .graph_versions import SeedStamps, get_graph_versions
+from .metrics import ENHANCEMENT_CYCLES, ENHANCEMENT_CYCLE_SECONDS, ENHANCEMENT_LINKS
+from .utils import logger
+
+# Upper bounds in seconds for the age histogram; anything older lands in the last bucket.
+AGE_BUCKETS = ((60, "<1m"), (600, "<10m"), (3600, "<1h"), (86400, "<1d"), (604800, "<1w"))
+OLDEST_BUCKET = ">=1w"
+
+class _Link:
+    __slots__ = ("repo", "path", "target", "status", "created")
+
+    def __init__(self, repo: str, path: str, target: str, status: LinkStatus, created: float):
+        self.repo, self.path, self.target, self.status, self.created = repo, path, target, status, created
+
+class _RepoLinks:
+    def __init__(self):
+        self.by_status: Counter = Counter()
+        self.targets: Counter = Counter()
+        self.by_path: Dict[str, Set[str]] = {}
+        self.resolved: Counter = Counter()
+        self.resolution_seconds: float = 0.0
+
+def _path_of(source_entity_id: str) -> str:
+    parts = source_entity_id.split("|", 2)
+    return parts[1].rsplit("@", 1)[0] if len(parts) > 1 else ""
+
+class LinkStatsTracker:
+    def __init__(self):
+        self._links: Dict[str, _Link] = {}
+        self._repos: Dict[str, _RepoLinks] = {}
+        self._seeded = SeedStamps()
+
+    def _repo(self, repo: str) -> _RepoLinks:
+        if repo not in self._repos:
+            self._repos[repo] = _RepoLinks()
+        return self._repos[repo]
+
+    def _add(self, link_id: str, link: _Link):
+        self._remove(link_id)
+        self._links[link_id] = link
+        counters = self._repo(link.repo)
+        counters.by_status[link.status] += 1
+        counters.targets[link.target] += 1
+        counters.by_path.setdefault(link.path, set()).add(link_id)
+
+    def _remove(self, link_id: str) -> Optional[_Link]:
+        link = self._links.pop(link_id, None)
+        if link is None:
+            return None
+        counters = self._repos[link.repo]
+        counters.by_status[link.status] -= 1
+        counters.targets[link.target] -= 1
+        if counters.targets[link.target] <= 0:
+            del counters.targets[link.target]
+        path_links = counters.by_path.get(link.path)
+        if path_links is not None:
+            path_links.discard(link_id)
+            if not path_links:
+                del counters.by_path[link.path]
+        return link
+
+    # --- Incremental Updates ---
+
+    def on_created(self, repo: str, link_id: str, source_entity_id: str, target_expression: str):
+        """A PendingLink was saved in PENDING_RESOLUTION (a re-save of the same ID restarts it)."""
+        self._add(link_id, _Link(repo, _path_of(source_entity_id), target_expression, LinkStatus.PENDING_RESOLUTION, time.time()))
+
+    def on_status(self, link_id: str, status: LinkStatus):
+        link = self._links.get(link_id)
+        if link is None or link.status == status:
+            return
+        counters = self._repos[link.repo]
+        counters.by_status[link.status] -= 1
+        counters.by_status[status] += 1
+        link.status = status
+
+    def on_resolved(self, link_id: str, tier: str):
+        """The link became a relationship and its PendingLink node was deleted."""
+        link = self._remove(link_id)
+        if link is None:
+            return
+        counters = self._repos[link.repo]
+        counters.resolved[tier] += 1
+        counters.resolution_seconds += time.time() - link.created
+
+    def on_path_deleted(self, repo: str, relative_path: str):
+        """A file's nodes were detach-deleted (re-ingest or delete), including its PendingLinks."""
+        counters = self._repos.get(repo)
+        if counters is None:
+            return
+        for link_id in list(counters.by_path.get(relative_path, ())):
+            self._remove(link_id)
+
+    # --- Seeding ---
+
+    def _link_ids(self, repo: str) -> List[str]:
+        counters = self._repos.get(repo)
+        return [link_id for link_ids in counters.by_path.values() for link_id in link_ids] if counters else []
+
+    def seed(self, repo: str, link_nodes: List) -> int:
+        """Replaces a repository's tracked links with a scan of its PendingLink nodes."""
+        for link_id in self._link_ids(repo):
+            self._remove(link_id)
+        for node in link_nodes:
+            attributes = node.attributes
+            reference = attributes.get("reference_data") or {}
+            created = attributes.get("created_at")
+            try:
+                created_ts = datetime.fromisoformat(str(created)).timestamp() if created else time.time()
+            except ValueError:
+                created_ts = time.time()
+            status = LinkStatus(getattr(attributes.get("status"), "value", attributes.get("status")) or LinkStatus.PENDING_RESOLUTION.value)
+            self._add(node.id, _Link(repo, _path_of(reference.get("source_entity_id", "")), reference.get("target_expression", ""), status, created_ts))
+        return len(link_nodes)
+
+    async def ensure_seeded(self, repo: str, refresh: bool = False):
+        if (version := await self._seeded.due(repo, refresh)) is None:
+            return
+        from .graph_utils import find_nodes_with_filter
+        link_nodes = await find_nodes_with_filter({"type": "PendingLink", "repo_id_str": repo})
+        self._seeded.stamp(repo, version)
+        logger.info(f"LINK_STATS({repo}): Seeded {self.seed(repo, link_nodes)} pending links from the graph.")
+
+    # --- Reporting ---
+
+    def repos(self) -> List[str]:
+        tracked = set(self._repos)
+        tracked.update(dict(key).get("repo") for key in ENHANCEMENT_CYCLES.values)
+        return sorted(r for r in tracked if r)
+
+    def _age_histogram(self, repo: str, now: float) -> dict:
+        buckets = {label: 0 for _, label in AGE_BUCKETS}
+        buckets[OLDEST_BUCKET] = 0
+        oldest = 0.0
+        for link_id in self._link_ids(repo):
+            age = now - self._links[link_id].created
+            oldest = max(oldest, age)
+            buckets[next((label for bound, label in AGE_BUCKETS if age < bound), OLDEST_BUCKET)] += 1
+        return {"buckets": buckets, "oldest_seconds": round(oldest, 3)}
+
+    def _tiers(self, repo: str) -> Dict[str, dict]:
+        tiers: Dict[str, Counter] = {}
+        for key, value in ENHANCEMENT_LINKS.values.items():
+            labels = dict(key)
+            if labels.get("repo") == repo:
+                tiers.setdefault(labels["tier"], Counter())[labels["outcome"]] += value
+        report = {}
+        for tier, outcomes in sorted(tiers.items()):
+            total = sum(outcomes.values())
+            report[tier] = {
+                **{outcome: int(count) for outcome, count in outcomes.items()},
+                "total": int(total),
+                "resolution_rate": round(outcomes["resolved"] / total, 4) if total else 0.0,
+                "escalation_rate": round((outcomes["promoted"] + outcomes["deferred"]) / total, 4) if total else 0.0,
+            }
+        return report
+
+    def _cycles(self, repo: str) -> dict:
+        count = ENHANCEMENT_CYCLE_SECONDS.count(repo=repo)
+        total = ENHANCEMENT_CYCLE_SECONDS.total(repo=repo)
+        return {
+            "count": count,
+            "failed": int(ENHANCEMENT_CYCLES.get(repo=repo, outcome="failed")),
+            "mean_seconds": round(total / count, 4) if count else 0.0,
+            "total_seconds": round(total, 4),
+        }
+
+    def stats(self, repo: str, top: int = 10) -> dict:
+        counters = self._repos.get(repo) or _RepoLinks()
+        by_status = {status.value: counters.by_status.get(status, 0) for status in LinkStatus}
+        resolved = sum(counters.resolved.values())
+        return {
+            "repo": repo,
+            "outstanding": sum(by_status.values()),
+            "by_status": by_status,
+            "age": self._age_histogram(repo, time.time()),
+            "tiers": self._tiers(repo),
+            "resolved_by_tier": dict(counters.resolved),
+            "mean_time_to_resolve_seconds": round(counters.resolution_seconds / resolved, 3) if resolved else 0.0,
+            "top_unresolved_targets": [{"target_expression": t, "count": c} for t, c in counters.targets.most_common(top)],
+            "cycles": self._cycles(repo),
+            "enhancement_observed": bool(ENHANCEMENT_CYCLE_SECONDS.count(repo=repo)),
+            "seeded_at_version": self._seeded.get(repo),
+        }
+
+_tracker: Optional[LinkStatsTracker] = None
+
+def get_link_stats() -> LinkStatsTracker:
+    global _tracker
+    if _tracker is None:
+        _tracker = LinkStatsTracker()
+    return _tracker
+
+async def get_link_backlog_stats(repo: Optional[str] = None, top: int = 10, refresh: bool = False) -> List[dict]:
+    """
+    Stats for one repo@branch, or for every repository in the graph or tracked here, each reseeded
+    from the graph first if another process wrote to it.
+    """
+    tracker = get_link_stats()
+    repos = [repo] if repo else sorted(set(await get_graph_versions().known_repos()) | set(tracker.repos()))
+    for r in repos:
+        await tracker.ensure_seeded(r, refresh)
+    return [tracker.stats(r, top) for r in repos]
@@ -0,0 +1,388 @@
+# .roo/cognee/src/parser/local_graph_backend.py
+import asyncio
+import json
+import os
+import sqlite3
+from contextlib import asynccontextmanager
+from collections import Counter
+from typing import Any, Callable, Dict, Iterable, List, NamedTuple, Optional, Tuple
+
+from .configs import LOCAL_GRAPH_DB_PATH
+from .utils import logger
+
+class LocalNode(NamedTuple):
+    """The slice of cognee's Node that graph_utils callers use: a slug ID and its attribute dict."""
+    id: str
+    attributes: Dict[str, Any]
+
+# Attributes promoted to real columns so the filters graph_utils issues hit an index, as on Neo4j.
+INDEXED_COLUMNS = ("node_type", "repo_id_str", "relative_path_str", "content_hash", "canonical_fqn", "status", "awaits_fqn")
+
+_SCHEMA = """
+CREATE TABLE IF NOT EXISTS nodes (
+    slug_id           TEXT PRIMARY KEY,
+    node_type         TEXT,
+    repo_id_str       TEXT,
+    relative_path_str TEXT,
+    content_hash      TEXT,
+    canonical_fqn     TEXT,
+    reversed_fqn      TEXT,
+    status            TEXT,
+    awaits_fqn        TEXT,
+    attributes        TEXT NOT NULL
+) WITHOUT ROWID;
+CREATE INDEX IF NOT EXISTS idx_nodes_type ON nodes (node_type);
+CREATE INDEX IF NOT EXISTS idx_nodes_repo_path ON nodes (repo_id_str, relative_path_str);
+CREATE INDEX IF NOT EXISTS idx_nodes_content_hash ON nodes (content_hash);
+CREATE INDEX IF NOT EXISTS idx_nodes_repo_fqn ON nodes (repo_id_str, canonical_fqn);
+CREATE INDEX IF NOT EXISTS idx_nodes_repo_reversed_fqn ON nodes (repo_id_str, reversed_fqn);
+CREATE INDEX IF NOT EXISTS idx_nodes_status ON nodes (repo_id_str, status);
+CREATE INDEX IF NOT EXISTS idx_nodes_awaits_fqn ON nodes (awaits_fqn);
+
+CREATE TABLE IF NOT EXISTS edges (
+    source_id  TEXT NOT NULL,
+    target_id  TEXT NOT NULL,
+    rel_type   TEXT NOT NULL,
+    properties TEXT NOT NULL,
+    PRIMARY KEY (source_id, rel_type, target_id)
+) WITHOUT ROWID;
+CREATE INDEX IF NOT EXISTS idx_edges_target ON edges (target_id);
+
+CREATE TABLE IF NOT EXISTS version_counters (
+    repo_id      TEXT    NOT NULL,
+    path         TEXT    NOT NULL,
+    commit_index INTEGER NOT NULL,
+    count        INTEGER NOT NULL,
+    PRIMARY KEY (repo_id, path, commit_index)
+) WITHOUT ROWID;
+
+CREATE TABLE IF NOT EXISTS graph_versions (
+    repo_id TEXT    PRIMARY KEY,
+    version INTEGER NOT NULL
+) WITHOUT ROWID;
+
+CREATE TABLE IF NOT EXISTS header_changes (
+    repo_id  TEXT    NOT NULL,
+    path     TEXT    NOT NULL,
+    revision INTEGER NOT NULL,
+    change   TEXT    NOT NULL,
+    PRIMARY KEY (repo_id, path)
+) WITHOUT ROWID;
+"""
+
+# Bound parameters per IN (...) batch; stays under SQLite's host-parameter limit.
+ID_BATCH_SIZE = 400
+
+# Sorts after every other code point, so [s, s + _MAX_CHAR) is the range of strings starting with s.
+_MAX_CHAR = "\U0010ffff"
+
+def _locator(node_id: str, attributes: Dict[str, Any]) -> Tuple[Optional[str], Optional[str]]:
+    """
+    Derives (repo_id_str, relative_path_str) from the composite slug ID: 'repo@branch|path@commit-save|...'.
+    PendingLinks are located through the entity that makes the reference.
+    """
+    if attributes.get("node_type") == "Repository":
+        return node_id, None
+    if attributes.get("node_type") == "PendingLink":
+        node_id = (attributes.get("reference_data") or {}).get("source_entity_id", "")
+    parts = node_id.split("|", 2)
+    if len(parts) < 2:
+        return None, None
+    return parts[0], parts[1].rsplit("@", 1)[0]
+
+def _plain(value: Any) -> Any:
+    return getattr(value, "value", value)  # Enums (LinkStatus) are stored by value.
+
+def _row_for(node_id: str, attributes: Dict[str, Any]) -> tuple:
+    repo_id_str, relative_path_str = _locator(node_id, attributes)
+    fqn = attributes.get("canonical_fqn")
+    return (
+        node_id,
+        attributes.get("node_type") or attributes.get("type"),
+        attributes.get("repo_id_str", repo_id_str),
+        attributes.get("relative_path_str", relative_path_str),
+        attributes.get("content_hash"),
+        fqn,
+        fqn[::-1] if fqn else None,
+        _plain(attributes.get("status")),
+        attributes.get("awaits_fqn"),
+        json.dumps(attributes, default=str, separators=(",", ":")),
+    )
+
+class LocalGraphBackend:
+    """
+    Embedded SQLite graph store implementing the graph_utils DAL for offline benchmarks and single-user mode.
+    Statements run on the event loop thread; they are short and local, and this keeps the call order deterministic.
+    Writes are serialized by one lock and run in BEGIN IMMEDIATE transactions. Reads outside the current task's
+    transaction go to a second connection, which takes no lock and sees the last committed state (WAL).
+    """
+    def __init__(self, path: str):
+        self.path = path
+        if path != ":memory:":
+            os.makedirs(os.path.dirname(os.path.abspath(path)), exist_ok=True)
+        self._conn = sqlite3.connect(path, isolation_level=None)
+        self._conn.execute("PRAGMA journal_mode=WAL")
+        self._conn.execute("PRAGMA synchronous=NORMAL")
+        self._conn.executescript(_SCHEMA)
+        # An in-memory database is private to its connection, so there reads share the writer's (and its open transaction).
+        self._read_conn = self._conn if path == ":memory:" else sqlite3.connect(path, isolation_level=None)
+        self._lock = asyncio.Lock()
+        self._tx_task: Optional[asyncio.Task] = None
+        # Calls per DAL operation, for load and replay reports.
+        self.op_counts: Counter = Counter()
+        logger.info(f"LOCAL_GRAPH: Opened {path}.")
+
+    def close(self):
+        if self._read_conn is not self._conn:
+            self._read_conn.close()
+        self._conn.close()
+
+    # --- Transactions ---
+
+    @asynccontextmanager
+    async def transaction(self):
+        """Runs every backend call made by the current task inside one SQLite transaction."""
+        if self._tx_task is asyncio.current_task():
+            yield  # Already inside this task's transaction.
+            return
+        async with self._lock:
+            self._tx_task = asyncio.current_task()
+            self.op_counts["transaction"] += 1
+            self._conn.execute("BEGIN IMMEDIATE")
+            try:
+                yield
+            except BaseException:
+                self._conn.execute("ROLLBACK")
+                raise
+            else:
+                self._conn.execute("COMMIT")
+            finally:
+                self._tx_task = None
+
+    async def _run(self, op: str, fn: Callable, *args):
+        """A write: inside the current task's transaction, or in one of its own."""
+        self.op_counts[op] += 1
+        if self._tx_task is asyncio.current_task():
+            return fn(*args)
+        async with self._lock:
+            self._conn.execute("BEGIN IMMEDIATE")
+            try:
+                result = fn(*args)
+            except BaseException:
+                self._conn.execute("ROLLBACK")
+                raise
+            self._conn.execute("COMMIT")
+            return result
+
+    async def _read(self, op: str, fn: Callable, *args):
+        """A read: `fn(conn, *args)` on the transaction's connection when the current task holds it (to see its own writes), else on the reader."""
+        self.op_counts[op] += 1
+        return fn(self._conn if self._tx_task is asyncio.current_task() else self._read_conn, *args)
+
+    # --- Reads ---
+
+    def _where(self, filter_dict: Dict[str, Any]) -> Tuple[str, list]:
+        clauses, params = [], []
+        for key, value in filter_dict.items():
+            column = "node_type" if key == "type" else key
+            if column == "slug_id" or column in INDEXED_COLUMNS:
+                target = column
+            else:
+                target = "json_extract(attributes, ?)"
+                params.append(f'$."{key}"')
+            if value is None:
+                clauses.append(f"{target} IS NULL")
+            else:
+                clauses.append(f"{target} = ?")
+                params.append(_plain(value))
+        return " AND ".join(clauses) or "1", params
+
+    def _select(self, conn: sqlite3.Connection, where: str, params: Iterable[Any], limit: Optional[int] = None) -> List[LocalNode]:
+        sql = f"SELECT slug_id, attributes FROM nodes WHERE {where}"
+        if limit is not None:
+            sql += f" LIMIT {int(limit)}"
+        return [LocalNode(slug_id, json.loads(attributes)) for slug_id, attributes in conn.execute(sql, list(params))]
+
+    async def find_nodes(self, filter_dict: Dict[str, Any]) -> List[LocalNode]:
+        where, params = self._where(filter_dict)
+        return await self._read("find_nodes", self._select, where, params)
+
+    async def find_code_entity_id(self, repo_id_with_branch: str, relative_path: Optional[str], fqn: str) -> Optional[str]:
+        filter_dict = {"node_type": "CodeEntity", "repo_id_str": repo_id_with_branch, "canonical_fqn": fqn}
+        if relative_path:
+            filter_dict["relative_path_str"] = relative_path
+        where, params = self._where(filter_dict)
+        nodes = await self._read("find_code_entity_id", self._select, where, params, 1)
+        return nodes[0].id if nodes else None
+
+    async def find_code_entity_ids_by_fqn_suffix(self, repo_id_with_branch: str, suffix: str) -> List[str]:
+        """'canonical_fqn ENDS WITH suffix' as a range scan over the reversed FQN index."""
+        prefix = suffix[::-1]
+        sql = "SELECT slug_id FROM nodes WHERE repo_id_str = ? AND node_type = 'CodeEntity' AND reversed_fqn >= ? AND reversed_fqn < ?"
+        return await self._read("find_code_entity_ids_by_fqn_suffix", lambda conn: [row[0] for row in conn.execute(sql, (repo_id_with_branch, prefix, prefix + _MAX_CHAR))])
+
+    async def get_edges(self, source_id: Optional[str] = None, target_id: Optional[str] = None) -> List[Tuple[str, str, str, Dict[str, Any]]]:
+        clauses, params = [], []
+        if source_id is not None:
+            clauses.append("source_id = ?"); params.append(source_id)
+        if target_id is not None:
+            clauses.append("target_id = ?"); params.append(target_id)
+        sql = "SELECT source_id, target_id, rel_type, properties FROM edges WHERE " + (" AND ".join(clauses) or "1")
+        def _query(conn):
+            return [(s, t, r, json.loads(p)) for s, t, r, p in conn.execute(sql, params)]
+        return await self._read("get_edges", _query)
+
+    async def get_edges_by_prefix(self, source_prefix: str, rel_type: Optional[str] = None) -> List[Tuple[str, str, str]]:
+        """(source, target, type) of every edge (of `rel_type`, if given) whose source ID starts with `source_prefix` (a primary-key range scan)."""
+        sql = "SELECT source_id, target_id, rel_type FROM edges WHERE source_id >= ? AND source_id < ?"
+        params = [source_prefix, source_prefix + _MAX_CHAR]
+        if rel_type is not None:
+            sql += " AND rel_type = ?"; params.append(rel_type)
+        def _query(conn):
+            return [(s, t, r) for s, t, r in conn.execute(sql, params)]
+        return await self._read("get_edges_by_prefix", _query)
+
+    async def get_edges_into_prefix(self, target_prefix: str) -> List[Tuple[str, str, str]]:
+        """(source, target, type) of every edge entering a node whose ID starts with `target_prefix` from outside it (a target-index range scan)."""
+        sql = "SELECT source_id, target_id, rel_type FROM edges WHERE target_id >= ? AND target_id < ? AND NOT (source_id >= ? AND source_id < ?)"
+        params = [target_prefix, target_prefix + _MAX_CHAR] * 2
+        def _query(conn):
+            return [(s, t, r) for s, t, r in conn.execute(sql, params)]
+        return await self._read("get_edges_into_prefix", _query)
+
+    async def get_nodes_by_ids(self, node_ids: Iterable[str], properties: Optional[Iterable[str]] = None) -> Dict[str, Dict[str, Any]]:
+        """Node ID -> attributes for every ID that exists, limited to `properties` when given."""
+        ids, wanted = list(dict.fromkeys(node_ids)), set(properties) if properties is not None else None
+        def _query(conn) -> Dict[str, Dict[str, Any]]:
+            found = {}
+            for i in range(0, len(ids), ID_BATCH_SIZE):
+                batch = ids[i:i + ID_BATCH_SIZE]
+                for node in self._select(conn, f"slug_id IN ({','.join('?' * len(batch))})", batch):
+                    found[node.id] = node.attributes if wanted is None else {k: v for k, v in node.attributes.items() if k in wanted}
+            return found
+        return await self._read("get_nodes_by_ids", _query)
+
+    async def get_edges_between(self, pairs: Iterable[Tuple[str, str]], properties: Optional[Iterable[str]] = None) -> List[Tuple[str, str, str, Dict[str, Any]]]:
+        """Every edge from source to target for the given (source, target) pairs, limited to `properties` when given."""
+        unique_pairs, wanted = list(dict.fromkeys(pairs)), set(properties) if properties is not None else None
+        def _query(conn) -> List[Tuple[str, str, str, Dict[str, Any]]]:
+            edges = []
+            for i in range(0, len(unique_pairs), ID_BATCH_SIZE // 2):
+                batch = unique_pairs[i:i + ID_BATCH_SIZE // 2]
+                sql = ("SELECT source_id, target_id, rel_type, properties FROM edges "
+                       f"WHERE (source_id, target_id) IN (VALUES {','.join('(?, ?)' for _ in batch)})")
+                for s, t, r, p in conn.execute(sql, [v for pair in batch for v in pair]):
+                    attributes = json.loads(p)
+                    edges.append((s, t, r, attributes if wanted is None else {k: v for k, v in attributes.items() if k in wanted}))
+            return edges
+        return await self._read("get_edges_between", _query)
+
+    # --- Writes ---
+
+    def _upsert_nodes(self, nodes: Iterable[Any]):
+        self._conn.executemany(
+            """
+            INSERT INTO nodes (slug_id, node_type, repo_id_str, relative_path_str, content_hash, canonical_fqn, reversed_fqn, status, awaits_fqn, attributes)
+            VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
+            ON CONFLICT (slug_id) DO UPDATE SET
+                node_type = excluded.node_type, repo_id_str = excluded.repo_id_str,
+                relative_path_str = excluded.relative_path_str, content_hash = excluded.content_hash,
+                canonical_fqn = excluded.canonical_fqn, reversed_fqn = excluded.reversed_fqn,
+                status = excluded.status, awaits_fqn = excluded.awaits_fqn, attributes = excluded.attributes
+            """,
+            [_row_for(str(node.id), node.attributes) for node in nodes],
+        )
+
+    def _upsert_edges(self, relationships: Iterable[Tuple[str, str, str, Dict[str, Any]]]):
+        self._conn.executemany(
+            "INSERT INTO edges (source_id, target_id, rel_type, properties) VALUES (?, ?, ?, ?) "
+            "ON CONFLICT (source_id, rel_type, target_id) DO UPDATE SET properties = excluded.properties",
+            [(s, t, r, json.dumps(p or {}, default=str, separators=(",", ":"))) for s, t, r, p in relationships],
+        )
+
+    async def save(self, nodes: List[Any], relationships: List[Tuple[str, str, str, Dict[str, Any]]]):
+        def _save():
+            if nodes: self._upsert_nodes(nodes)
+            if relationships: self._upsert_edges(relationships)
+        await self._run("save", _save)
+
+    async def delete_nodes(self, filter_dict: Dict[str, Any]) -> int:
+        """Deletes matching nodes together with their edges (Cypher DETACH DELETE)."""
+        where, params = self._where(filter_dict)
+        def _delete() -> int:
+            self._conn.execute("CREATE TEMP TABLE IF NOT EXISTS doomed (slug_id TEXT PRIMARY KEY)")
+            self._conn.execute("DELETE FROM doomed")
+            self._conn.execute(f"INSERT INTO doomed SELECT slug_id FROM nodes WHERE {where}", params)
+            self._conn.execute("DELETE FROM edges WHERE source_id IN (SELECT slug_id FROM doomed) OR target_id IN (SELECT slug_id FROM doomed)")
+            return self._conn.execute("DELETE FROM nodes WHERE slug_id IN (SELECT slug_id FROM doomed)").rowcount
+        return await self._run("delete_nodes", _delete)
+
+    async def update_node(self, node_id: str, updates: Dict[str, Any]) -> bool:
+        """Merges `updates` into a node's attributes; returns False if the node does not exist."""
+        def _update() -> bool:
+            nodes = self._select(self._conn, "slug_id = ?", (node_id,))
+            if not nodes:
+                return False
+            attributes = nodes[0].attributes
+            attributes.update({k: _plain(v) for k, v in updates.items()})
+            self._upsert_nodes([LocalNode(node_id, attributes)])
+            return True
+        return await self._run("update_node", _update)
+
+    async def increment_version_counter(self, repo_id_with_branch: str, relative_path: str, commit_index: int) -> int:
+        """Same contract as the Cypher MERGE counter: creates at 1, otherwise increments, returns the new count."""
+        def _increment() -> int:
+            row = self._conn.execute(
+                """
+                INSERT INTO version_counters (repo_id, path, commit_index, count) VALUES (?, ?, ?, 1)
+                ON CONFLICT (repo_id, path, commit_index) DO UPDATE SET count = count + 1
+                RETURNING count
+                """,
+                (repo_id_with_branch, relative_path, commit_index),
+            ).fetchone()
+            return row[0]
+        return await self._run("increment_version_counter", _increment)
+
+    async def increment_graph_version(self, repo_id_with_branch: str) -> int:
+        def _increment() -> int:
+            row = self._conn.execute(
+                "INSERT INTO graph_versions (repo_id, version) VALUES (?, 1) "
+                "ON CONFLICT (repo_id) DO UPDATE SET version = version + 1 RETURNING version",
+                (repo_id_with_branch,),
+            ).fetchone()
+            return row[0]
+        return await self._run("increment_graph_version", _increment)
+
+    async def get_graph_versions(self) -> Dict[str, int]:
+        return await self._read("get_graph_versions", lambda conn: dict(conn.execute("SELECT repo_id, version FROM graph_versions").fetchall()))
+
+    async def get_header_changes(self, repo_id_with_branch: str, path: Optional[str] = None) -> Dict[str, Tuple[int, Dict[str, Any]]]:
+        sql, params = "SELECT path, revision, change FROM header_changes WHERE repo_id = ?", [repo_id_with_branch]
+        if path is not None:
+            sql += " AND path = ?"; params.append(path)
+        def _query(conn):
+            return {p: (revision, json.loads(change)) for p, revision, change in conn.execute(sql, params)}
+        return await self._read("get_header_changes", _query)
+
+    async def save_header_change(self, repo_id_with_branch: str, path: str, revision: int, change: Dict[str, Any]):
+        def _save():
+            self._conn.execute(
+                "INSERT INTO header_changes (repo_id, path, revision, change) VALUES (?, ?, ?, ?) "
+                "ON CONFLICT (repo_id, path) DO UPDATE SET revision = excluded.revision, change = excluded.change",
+                (repo_id_with_branch, path, revision, json.dumps(change)),
+            )
+        await self._run("save_header_change", _save)
+
+    async def delete_header_changes(self, repo_id_with_branch: str, revisions: Dict[str, int]):
+        """Deletes each path's change if it is still at the given revision."""
+        def _delete():
+            self._conn.executemany("DELETE FROM header_changes WHERE repo_id = ? AND path = ? AND revision = ?",
+                                   [(repo_id_with_branch, path, revision) for path, revision in revisions.items()])
+        await self._run("delete_header_changes", _delete)
+
+_instance: Optional[LocalGraphBackend] = None
+def get_local_backend() -> LocalGraphBackend:
+    global _instance
+    if _instance is None:
+        _instance = LocalGraphBackend(LOCAL_GRAPH_DB_PATH)
+    return _instance
@@ -0,0 +1,333 @@
+# .roo/cognee/src/parser/metrics.py
+"""
+In-process ingestion and enhancement metrics: histograms, counters and gauges keyed by label
+sets, exposed as OpenMetrics text (GET /metrics) and JSON (GET /metrics.json, or a dump file).
+
+Recording is a dict lookup and a bisect on the event loop thread, so it stays on in production;
+METRICS_ENABLED=0 turns every recording helper below into a no-op. Record through `stage`, `timed`,
+`count`, `increment` and `observe` rather than calling a metric directly, so that switch holds.
+Stage timings pick up the `repo` and `language` labels bound by `labelled()` for the current task.
+
+The registry is per process. The MCP SSE server mounts both routes but never ingests, so it reports
+retrieval metrics only; ingestion and enhancement metrics are served by the process doing the work:
+sharded_ingest and replay take --metrics-port, and METRICS_DUMP_PATH writes the JSON snapshot when
+any process exits.
+"""
+import asyncio
+import atexit
+import bisect
+import json
+import time
+from contextlib import contextmanager
+from contextvars import ContextVar
+from typing import Callable, Dict, Iterator, List, Optional, Tuple
+
+from .configs import METRICS_ENABLED, METRICS_DUMP_PATH
+from .profiling import current_file_profile
+from .utils import logger
+
+LabelKey = Tuple[Tuple[str, str], ...]
+
+# Seconds; spans a hash of a small file up to a slow LLM batch.
+DEFAULT_BUCKETS = (0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0, 30.0, 60.0)
+
+def _key(labels: Dict[str, str]) -> LabelKey:
+    return tuple(sorted((k, str(v)) for k, v in labels.items()))
+
+def _escape(value: str) -> str:
+    return value.replace("\\", "\\\\").replace("\"", "\\\"").replace("\n", "\\n")
+
+def _format_labels(key: LabelKey) -> str:
+    if not key:
+        return ""
+    return "{" + ",".join(f'{k}="{_escape(v)}"' for k, v in key) + "}"
+
+def _format_number(value: float) -> str:
+    return str(int(value)) if float(value).is_integer() else repr(float(value))
+
+# --- Metric Types ---
+
+class Counter:
+    kind = "counter"
+
+    def __init__(self, name: str, help_text: str):
+        self.name, self.help = name, help_text
+        self.values: Dict[LabelKey, float] = {}
+
+    def inc(self, amount: float = 1, **labels):
+        key = _key(labels)
+        self.values[key] = self.values.get(key, 0) + amount
+
+    def get(self, **labels) -> float:
+        return self.values.get(_key(labels), 0)
+
+    def samples(self) -> Iterator[Tuple[str, LabelKey, float]]:
+        for key, value in self.values.items():
+            yield f"{self.name}_total", key, value
+
+    def snapshot(self) -> List[dict]:
+        return [{"labels": dict(key), "value": value} for key, value in self.values.items()]
+
+class Gauge:
+    kind = "gauge"
+
+    def __init__(self, name: str, help_text: str):
+        self.name, self.help = name, help_text
+        self.values: Dict[LabelKey, float] = {}
+        self.functions: Dict[LabelKey, Callable[[], float]] = {}
+
+    def set(self, value: float, **labels):
+        self.values[_key(labels)] = value
+
+    def inc(self, amount: float = 1, **labels):
+        key = _key(labels)
+        self.values[key] = self.values.get(key, 0) + amount
+
+    def dec(self, amount: float = 1, **labels):
+        self.inc(-amount, **labels)
+
+    def set_function(self, fn: Optional[Callable[[], float]], **labels):
+        """Reads the value from `fn` at collection time (e.g. a queue's qsize); None unregisters it."""
+        key = _key(labels)
+        if fn is None:
+            self.functions.pop(key, None)
+        else:
+            self.functions[key] = fn
+
+    def get(self, **labels) -> float:
+        key = _key(labels)
+        return self.functions[key]() if key in self.functions else self.values.get(key, 0)
+
+    def samples(self) -> Iterator[Tuple[str, LabelKey, float]]:
+        for key, value in self.values.items():
+            if key not in self.functions:
+                yield self.name, key, value
+        for key, fn in list(self.functions.items()):
+            yield self.name, key, fn()
+
+    def snapshot(self) -> List[dict]:
+        return [{"labels": dict(key), "value": value} for _, key, value in self.samples()]
+
+class Histogram:
+    kind = "histogram"
+
+    def __init__(self, name: str, help_text: str, buckets: Tuple[float, ...] = DEFAULT_BUCKETS):
+        self.name, self.help = name, help_text
+        self.buckets = tuple(sorted(buckets))
+        # Per label set: [non-cumulative bucket counts (+Inf last), sum, count].
+        self.series: Dict[LabelKey, list] = {}
+
+    def observe(self, value: float, **labels):
+        key = _key(labels)
+        series = self.series.get(key)
+        if series is None:
+            series = self.series[key] = [[0] * (len(self.buckets) + 1), 0.0, 0]
+        series[0][bisect.bisect_left(self.buckets, value)] += 1
+        series[1] += value
+        series[2] += 1
+
+    def count(self, **labels) -> int:
+        series = self.series.get(_key(labels))
+        return series[2] if series else 0
+
+    def total(self, **labels) -> float:
+        series = self.series.get(_key(labels))
+        return series[1] if series else 0.0
+
+    def samples(self) -> Iterator[Tuple[str, LabelKey, float]]:
+        for key, (counts, total, count) in self.series.items():
+            cumulative = 0
+            for bound, bucket_count in zip(self.buckets + (float("inf"),), counts):
+                cumulative += bucket_count
+                yield f"{self.name}_bucket", key + (("le", "+Inf" if bound == float("inf") else repr(bound)),), cumulative
+            yield f"{self.name}_sum", key, total
+            yield f"{self.name}_count", key, count
+
+    def snapshot(self) -> List[dict]:
+        return [
+            {"labels": dict(key), "count": count, "sum": total, "buckets": dict(zip([repr(b) for b in self.buckets] + ["+Inf"], counts))}
+            for key, (counts, total, count) in self.series.items()
+        ]
+
+# --- Registry ---
+
+class MetricsRegistry:
+    def __init__(self):
+        self.metrics: Dict[str, object] = {}
+
+    def _get_or_create(self, cls, name: str, help_text: str, **kwargs):
+        metric = self.metrics.get(name)
+        if metric is None:
+            metric = self.metrics[name] = cls(name, help_text, **kwargs)
+        elif not isinstance(metric, cls):
+            raise ValueError(f"Metric '{name}' is already registered as a {metric.kind}.")
+        return metric
+
+    def counter(self, name: str, help_text: str) -> Counter:
+        return self._get_or_create(Counter, name, help_text)
+
+    def gauge(self, name: str, help_text: str) -> Gauge:
+        return self._get_or_create(Gauge, name, help_text)
+
+    def histogram(self, name: str, help_text: str, buckets: Tuple[float, ...] = DEFAULT_BUCKETS) -> Histogram:
+        return self._get_or_create(Histogram, name, help_text, buckets=buckets)
+
+    def reset(self):
+        """Clears recorded values; registered metrics and gauge functions stay."""
+        for metric in self.metrics.values():
+            if isinstance(metric, Histogram):
+                metric.series.clear()
+            else:
+                metric.values.clear()
+
+    def render_openmetrics(self) -> str:
+        lines: List[str] = []
+        for name in sorted(self.metrics):
+            metric = self.metrics[name]
+            lines.append(f"# TYPE {name} {metric.kind}")
+            lines.append(f"# HELP {name} {metric.help}")
+            for sample_name, key, value in metric.samples():
+                lines.append(f"{sample_name}{_format_labels(key)} {_format_number(value)}")
+        lines.append("# EOF")
+        return "\n".join(lines) + "\n"
+
+    def snapshot(self) -> dict:
+        return {
+            "timestamp": time.time(),
+            "metrics": {name: {"type": m.kind, "help": m.help, "series": m.snapshot()} for name, m in sorted(self.metrics.items())},
+        }
+
+    def dump_json(self, path: str):
+        with open(path, "w", encoding="utf-8") as f:
+            json.dump(self.snapshot(), f, indent=2, sort_keys=True)
+
+REGISTRY = MetricsRegistry()
+
+# --- Ingestion and Enhancement Metrics ---
+
+INGEST_STAGE_SECONDS = REGISTRY.histogram("ingest_stage_seconds", "Time spent per ingestion stage of one file.")
+INGEST_FILE_SECONDS = REGISTRY.histogram("ingest_file_seconds", "End-to-end time to process one file request.")
+INGEST_FILES = REGISTRY.counter("ingest_files", "File requests processed, by outcome.")
+INGEST_ENTITIES = REGISTRY.counter("ingest_entities", "CodeEntities saved.")
+INGEST_REFERENCES = REGISTRY.counter("ingest_references", "Raw symbol references seen during Tier 1 resolution.")
+INGEST_TIER1_LINKS = REGISTRY.counter("ingest_tier1_links", "References resolved to a relationship during ingestion.")
+INGEST_PENDING_LINKS = REGISTRY.counter("ingest_pending_links", "References deferred to the enhancement tiers as PendingLinks.")
+INGEST_RETRIES = REGISTRY.counter("ingest_retries", "Transient-error retries of a file or island-group transaction.")
+INGEST_INFLIGHT = REGISTRY.gauge("ingest_inflight_files", "Bulk file requests queued or running.")
+INGEST_QUEUE_DEPTH = REGISTRY.gauge("ingest_queue_depth", "Items waiting in an ingestion queue.")
+DISPATCHER_TIMERS = REGISTRY.gauge("dispatcher_quiescence_timers", "Repositories with a running quiescence timer.")
+DISPATCHER_TIMER_RESETS = REGISTRY.counter("dispatcher_timer_resets", "Quiescence timers cancelled by new activity.")
+ENHANCEMENT_SECONDS = REGISTRY.histogram("enhancement_tier_seconds", "Time per enhancement tier run.")
+ENHANCEMENT_LINKS = REGISTRY.counter("enhancement_links", "PendingLinks handled by an enhancement tier, by outcome.")
+ENHANCEMENT_CYCLES = REGISTRY.counter("enhancement_cycles", "Full enhancement cycles, by outcome.")
+ENHANCEMENT_CYCLE_SECONDS = REGISTRY.histogram("enhancement_cycle_seconds", "Duration of a full enhancement cycle.")
+
+# --- Retrieval Metrics ---
+
+GRAPH_VERSION_BUMPS = REGISTRY.counter("graph_version_bumps", "Per-repo graph version increments, by source.")
+RETRIEVAL_CACHE_REQUESTS = REGISTRY.counter("retrieval_cache_requests", "Retriever cache lookups, by kind and outcome (hit, miss, stale).")
+RETRIEVAL_CACHE_SAVED_SECONDS = REGISTRY.counter("retrieval_cache_saved_seconds", "Computation time the retriever cache hits avoided.")
+RETRIEVAL_PHASE_SECONDS = REGISTRY.histogram("retrieval_phase_seconds", "Retriever Phase 1 latency: search, detail fetch and total.")
+TRIGRAM_SEARCH_SECONDS = REGISTRY.histogram("trigram_search_seconds", "Trigram code search latency, by mode (substring, regex).")
+CONTEXT_PACKER_TOKENS = REGISTRY.counter("context_packer_tokens", "Estimated LLM context tokens, by kind (naive: unpacked formatting, packed: sent).")
+SPECULATIVE_EXPANSIONS = REGISTRY.counter("speculative_expansions", "Retriever expansions run during LLM planning, by outcome (used by the next loop, unused).")
+SEARCH_PAGES = REGISTRY.counter("search_pages", "Paginated search pages served, by source and whether the result list was cached or computed.")
+SEARCH_PAGE_BYTES = REGISTRY.histogram("search_page_bytes", "Serialized size of a search results page.", buckets=(1024, 4096, 16384, 65536, 262144, 1048576))
+GIT_MIRROR_OPERATIONS = REGISTRY.counter("git_mirror_operations", "Git mirror cache operations, by op (clone, fetch, fresh, shared, worktree, evict).")
+
+_labels: ContextVar[Dict[str, str]] = ContextVar("metrics_labels", default={})
+
+@contextmanager
+def labelled(**labels):
+    """Binds labels (repo, language) for the stage timings recorded by the current task."""
+    token = _labels.set({**_labels.get(), **labels})
+    try:
+        yield
+    finally:
+        _labels.reset(token)
+
+def current_labels() -> Dict[str, str]:
+    return _labels.get()
+
+@contextmanager
+def stage(name: str):
+    """Times a block into ingest_stage_seconds{stage=name} with the bound labels, and into the file's profile."""
+    profile = current_file_profile()
+    if not METRICS_ENABLED and profile is None:
+        yield
+        return
+    start = time.perf_counter()
+    try:
+        yield
+    finally:
+        elapsed = time.perf_counter() - start
+        if METRICS_ENABLED:
+            INGEST_STAGE_SECONDS.observe(elapsed, stage=name, **_labels.get())
+        if profile is not None:
+            profile.add_stage(name, elapsed)
+
+@contextmanager
+def timed(histogram: Histogram, **labels):
+    if not METRICS_ENABLED:
+        yield
+        return
+    start = time.perf_counter()
+    try:
+        yield
+    finally:
+        histogram.observe(time.perf_counter() - start, **labels)
+
+def count(counter: Counter, amount: float = 1, **labels):
+    """Increments `counter` with the bound labels plus `labels`."""
+    if METRICS_ENABLED and amount:
+        counter.inc(amount, **{**_labels.get(), **labels})
+
+def increment(counter: Counter, amount: float = 1, **labels):
+    """Increments `counter` with exactly `labels`; for series read back by key (enhancement cycles, link outcomes)."""
+    if METRICS_ENABLED and amount:
+        counter.inc(amount, **labels)
+
+def observe(histogram: Histogram, value: float, **labels):
+    if METRICS_ENABLED:
+        histogram.observe(value, **labels)
+
+# --- Exposition ---
+
+OPENMETRICS_CONTENT_TYPE = "application/openmetrics-text; version=1.0.0; charset=utf-8"
+
+def render_response(path: str) -> Tuple[int, str, str]:
+    """(status, content type, body) for a metrics request path."""
+    if path in ("/metrics", "/"):
+        return 200, OPENMETRICS_CONTENT_TYPE, REGISTRY.render_openmetrics()
+    if path == "/metrics.json":
+        return 200, "application/json", json.dumps(REGISTRY.snapshot(), sort_keys=True)
+    return 404, "text/plain; charset=utf-8", "not found\n"
+
+async def _handle_http(reader: asyncio.StreamReader, writer: asyncio.StreamWriter):
+    try:
+        request_line = await reader.readline()
+        while (await reader.readline()).strip():
+            pass  # Headers are not needed.
+        parts = request_line.decode("latin-1").split()
+        path = parts[1].split("?", 1)[0] if len(parts) >= 2 else "/"
+        status, content_type, body = render_response(path)
+        payload = body.encode("utf-8")
+        writer.write(f"HTTP/1.1 {status} {'OK' if status == 200 else 'Not Found'}\r\nContent-Type: {content_type}\r\nContent-Length: {len(payload)}\r\nConnection: close\r\n\r\n".encode("latin-1") + payload)
+        await writer.drain()
+    finally:
+        writer.close()
+
+async def start_metrics_server(host: str = "127.0.0.1", port: int = 9464) -> asyncio.AbstractServer:
+    """Serves /metrics and /metrics.json from the running event loop."""
+    server = await asyncio.start_server(_handle_http, host, port)
+    logger.info(f"METRICS: Serving OpenMetrics on http://{host}:{server.sockets[0].getsockname()[1]}/metrics")
+    return server
+
+def _dump_at_exit():
+    try:
+        REGISTRY.dump_json(METRICS_DUMP_PATH)
+    except OSError as e:
+        logger.error(f"METRICS: Could not write metrics dump to {METRICS_DUMP_PATH}: {e}")
+
+if METRICS_DUMP_PATH:
+    atexit.register(_dump_at_exit)
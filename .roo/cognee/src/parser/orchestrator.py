@@ -1,10 +1,7 @@
 # .roo/cognee/src/parser/orchestrator.py
 import asyncio
-import inspect
-import importlib
-import pkgutil
 from pathlib import Path
-from typing import Dict, Type, List, Optional, Tuple, Union
+from typing import Collection, Dict, List, Optional, Tuple, Union
 import uuid
 import hashlib
 import os
@@ -16,220 +13,382 @@ from .entities import (
     RawSymbolReference, ParserOutput, Relationship, PendingLink, LinkStatus,
     ImportType, ReferenceContext, AdaptableNode
 )
-from .parsers.base_parser import BaseParser
-from .parsers.generic_parser import GenericParser
-from .chunking import generate_intelligent_chunks
-from .utils import logger, read_file_content, parse_temp_code_entity_id, resolve_import_path
+from .parser_registry import get_parser_for_file
+from .extraction import FileIsland, extract_file_island, read_records, records_to_islands
+from .utils import logger, read_file_content, resolve_import_path
 from .graph_utils import (
     delete_nodes_with_filter, atomic_get_and_increment_local_save,
     save_graph_data, check_content_exists, find_code_entity_by_path,
-    is_transient_error # <-- IMPORT THE ROBUST ERROR CHECKER
+    graph_transaction, after_commit, is_transient_error # <-- IMPORT THE ROBUST ERROR CHECKER
 )
 from .cognee_adapter import adapt_parser_entities_to_graph_elements
+from .bulk_reader import BulkReadResult, read_files_bulk
+from .ingest_journal import FileState, IngestJournal, JournalEntry
+from .configs import BULK_INGEST_CONCURRENCY, BULK_INGEST_QUEUE_SIZE
 from .dispatcher import get_dispatcher
-from cognee.infrastructure.databases.graph import get_graph_db
-
-# --- Dynamic Loader with Robust Error Handling ---
-def _load_parsers_and_build_map() -> Tuple[Dict[str, Type[BaseParser]], Optional[Type[BaseParser]]]:
-    extension_map: Dict[str, Type[BaseParser]] = {}
-    fallback_parser: Optional[Type[BaseParser]] = None
-    critical_parsers = {'CppParser', 'GenericParser'}
-    loaded_parsers = set()
-
-    import src.parser.parsers as p
-    for _, name, _ in pkgutil.walk_packages(p.__path__, p.__name__ + '.'):
-        try:
-            m = importlib.import_module(name)
-            for _, attr_value in m.__dict__.items():
-                if inspect.isclass(attr_value) and issubclass(attr_value, BaseParser) and attr_value is not BaseParser:
-                    loaded_parsers.add(attr_value.__name__)
-                    if "generic_fallback" in attr_value.SUPPORTED_EXTENSIONS:
-                        fallback_parser = attr_value
-                    for ext in attr_value.SUPPORTED_EXTENSIONS:
-                        if ext != "generic_fallback":
-                            extension_map[ext] = attr_value
-        except Exception as e:
-            logger.error(f"ORCHESTRATOR(LOADER): Failed to load parser module '{name}': {e}", exc_info=True)
-
-    missing_critical = critical_parsers - loaded_parsers
-    if missing_critical:
-        error_message = f"Critical parsers failed to load: {missing_critical}"
-        logger.critical(f"ORCHESTRATOR(LOADER): {error_message}")
-        raise RuntimeError(error_message)
-
-    if not fallback_parser:
-        logger.warning("ORCHESTRATOR(LOADER): No fallback parser loaded; unsupported file types will be skipped.")
-
-    return extension_map, fallback_parser
-
-EXTENSION_PARSER_MAP, FALLBACK_PARSER = _load_parsers_and_build_map()
-
-def _get_parser_for_file(file_path: Path) -> Optional[BaseParser]:
-    """Finds and instantiates a suitable parser, handling case-insensitivity and alternate extensions."""
-    ext = file_path.suffix.lower()
-    ext_alternates = {'.cxx': '.cpp', '.c++': '.cpp', '.hh': '.hpp'}
-    normalized_ext = ext_alternates.get(ext, ext)
+from .replay import get_recorder
+from .profiling import IngestProfiler, current_file_profile, get_profiler
+from .link_stats import get_link_stats
+from .graph_versions import get_graph_versions
+from . import code_indexes
+from .discovery import get_file_type
+from .metrics import (
+    stage, labelled, count, observe, current_labels, INGEST_FILE_SECONDS, INGEST_FILES, INGEST_ENTITIES, INGEST_REFERENCES,
+    INGEST_TIER1_LINKS, INGEST_PENDING_LINKS, INGEST_RETRIES, INGEST_INFLIGHT,
+)
 
-    ParserClass = EXTENSION_PARSER_MAP.get(normalized_ext) or FALLBACK_PARSER
-    return ParserClass() if ParserClass else None
+_log_retry = before_sleep_log(logger, "WARNING")
+
+def _log_and_count_retry(retry_state):
+    count(INGEST_RETRIES)
+    _log_retry(retry_state)
+
+def _language(relative_path: str) -> str:
+    return get_file_type(Path(relative_path).name) or "other"
+
+# --- Island Persistence ---
+
+async def _save_file_island(repository: Repository, island: FileIsland):
+    """Performs Tier 1 resolution for an assembled island and saves it with its structural edges."""
+    repo_id_with_branch = repository.id
+    relative_path = island.source_file.relative_path
+    source_file_id = island.source_file.id
+
+    entities_to_save: List[Union[AdaptableNode, Relationship]] = [repository, island.source_file]
+    entities_to_save.extend(island.text_chunks)
+    for chunk in island.text_chunks:
+        entities_to_save.append(Relationship(source_id=source_file_id, target_id=chunk.id, type="CONTAINS_CHUNK"))
+
+    count(INGEST_ENTITIES, len(island.code_entities))
+    count(INGEST_REFERENCES, len(island.raw_references))
+    for entity in island.code_entities:
+        parent_chunk = next(c for c in island.text_chunks if c.start_line <= entity.start_line <= c.end_line)
+        entities_to_save.append(entity)
+        entities_to_save.append(Relationship(source_id=parent_chunk.id, target_id=entity.id, type="DEFINES_CODE_ENTITY"))
+
+    resolved, pending = 0, 0
+    link_stats = get_link_stats()
+    with stage("tier1"):
+        for ref in island.raw_references:
+            resolved_target_id = None
+            if ref.context.import_type == ImportType.RELATIVE:
+                target_rel_path = resolve_import_path(relative_path, "/".join(ref.context.path_parts))
+                if target_rel_path: resolved_target_id = await find_code_entity_by_path(repo_id_with_branch, target_rel_path, ref.target_expression)
+            elif ref.context.import_type == ImportType.ABSOLUTE:
+                target_fqn = "::".join(ref.context.path_parts) if ref.context.path_parts else ref.target_expression
+                resolved_target_id = await find_code_entity_by_path(repo_id_with_branch, None, target_fqn)
+            if resolved_target_id:
+                resolved += 1
+                entities_to_save.append(Relationship(source_id=ref.source_entity_id, target_id=resolved_target_id, type=ref.reference_type, properties=ref.metadata))
+            else:
+                pending += 1
+                question_str = f"{ref.source_entity_id}|{ref.target_expression}|{ref.reference_type}"
+                pending_link_id = str(uuid.uuid5(uuid.NAMESPACE_DNS, question_str))
+                entities_to_save.append(PendingLink(id=pending_link_id, reference_data=ref))
+                after_commit(link_stats.on_created, repo_id_with_branch, pending_link_id, ref.source_entity_id, ref.target_expression)
+    count(INGEST_TIER1_LINKS, resolved)
+    count(INGEST_PENDING_LINKS, pending)
+    if profile := current_file_profile():
+        profile.pending_links += pending
+
+    with stage("adapt"):
+        nodes_to_add, edges_to_add = adapt_parser_entities_to_graph_elements(entities_to_save)
+    with stage("save"):
+        await save_graph_data(nodes_to_add, edges_to_add)
+    after_commit(code_indexes.on_island_saved, repo_id_with_branch, island)
 
 # --- Main Processing Function with Retry Logic ---
 
+class IngestAborted(Exception):
+    """A file that cannot be ingested. Raised before its previous version is deleted."""
+
 @retry(
     stop=stop_after_attempt(3),
     wait=wait_exponential(multiplier=1, min=2, max=10),
     retry=retry_if_exception(is_transient_error), # <-- USE THE IMPORTED, ROBUST CHECKER
-    before_sleep=before_sleep_log(logger, "WARNING")
+    before_sleep=_log_and_count_retry
 )
-async def _execute_transaction_with_retry(request: FileProcessingRequest, log_prefix: str) -> Tuple[bool, str, List[CodeEntity]]:
-    """Wraps the entire database transaction in a retry block for transient errors."""
-    db = get_graph_db()
-    session = None
+async def _execute_transaction_with_retry(request: FileProcessingRequest, log_prefix: str, preloaded: Optional[BulkReadResult] = None, redo: bool = False) -> Tuple[bool, str, List[CodeEntity]]:
+    """
+    Reads, checks and parses the file, then writes it in one transaction, all in a retry block for transient errors.
+    Only the delete/save writes hold the graph transaction; parsing runs outside it so files ingest concurrently.
+    `redo` skips the content check: the file's last ingest may have stopped after saving its SourceFile.
+    """
     repo_id_with_branch = f"{request.repo_id}@{request.branch}"
-    final_code_entities: List[CodeEntity] = []
-    has_activity = False
-
-    try:
-        session = await db.get_session()
-        async with session.begin() as tx:
-            relative_path = str(Path(request.absolute_path).relative_to(request.repo_path))
-
-            # Step 1: Handle DELETE request
-            if request.is_delete:
-                logger.info(f"{log_prefix}: Request is DELETE. Clearing data for this path.")
-                delete_filter = {"repo_id_str": repo_id_with_branch, "relative_path_str": relative_path}
-                await delete_nodes_with_filter(tx, delete_filter)
-                return False, repo_id_with_branch, []
-
-            # Step 2: Handle empty content
+    relative_path = _relative_path(request)
+    path_filter = {"repo_id_str": repo_id_with_branch, "relative_path_str": relative_path}
+
+    # Step 1: Handle DELETE request
+    if request.is_delete:
+        logger.info(f"{log_prefix}: Request is DELETE. Clearing data for this path.")
+        await code_indexes.before_transaction(repo_id_with_branch)
+        async with graph_transaction():
+            with stage("delete"):
+                await delete_nodes_with_filter(path_filter)
+        return False, repo_id_with_branch, []
+
+    # Step 2: Handle empty content
+    if preloaded:
+        content = preloaded.content
+    else:
+        with stage("read"):
             content = await read_file_content(str(request.absolute_path))
-            if not content or not content.strip():
-                logger.info(f"{log_prefix}: File is empty. Ensuring SourceFile node exists and stopping.")
-                await delete_nodes_with_filter(tx, {"repo_id_str": repo_id_with_branch, "relative_path_str": relative_path})
-                version_id = f"{request.commit_index}-1"
-                source_file_id = f"{repo_id_with_branch}|{relative_path}@{version_id}"
-                empty_file_node = SourceFile(id=source_file_id, relative_path=relative_path, commit_index=request.commit_index, local_save=1, content_hash=hashlib.sha256(b'').hexdigest())
-                nodes, _ = adapt_parser_entities_to_graph_elements([empty_file_node])
-                await save_graph_data(tx, nodes, [])
-                return False, repo_id_with_branch, []
-
-            # Step 3: IDEMPOTENCY & VERSIONING
+    if not content or not content.strip():
+        logger.info(f"{log_prefix}: File is empty. Ensuring SourceFile node exists and stopping.")
+        version_id = f"{request.commit_index}-1"
+        source_file_id = f"{repo_id_with_branch}|{relative_path}@{version_id}"
+        empty_file_node = SourceFile(id=source_file_id, relative_path=relative_path, commit_index=request.commit_index, local_save=1, content_hash=hashlib.sha256(b'').hexdigest())
+        nodes, _ = adapt_parser_entities_to_graph_elements([empty_file_node])
+        await code_indexes.before_transaction(repo_id_with_branch)
+        async with graph_transaction():
+            await delete_nodes_with_filter(path_filter)
+            await save_graph_data(nodes, [])
+        return False, repo_id_with_branch, []
+
+    # Step 3: IDEMPOTENCY
+    if preloaded:
+        content_hash = preloaded.content_hash
+    else:
+        with stage("hash"):
             content_hash = hashlib.sha256(content.encode('utf-8')).hexdigest()
-            if await check_content_exists(tx, content_hash):
-                return False, repo_id_with_branch, []
-
-            await delete_nodes_with_filter(tx, {"repo_id_str": repo_id_with_branch, "relative_path_str": relative_path})
-
-            local_save_count = await atomic_get_and_increment_local_save(tx, repo_id_with_branch, relative_path, request.commit_index)
-            version_id = f"{request.commit_index}-{local_save_count}"
-            source_file_id = f"{repo_id_with_branch}|{relative_path}@{version_id}"
-
-            # Step 4: PARSE & COLLECT
-            parser = _get_parser_for_file(Path(request.absolute_path))
-            if not parser:
-                logger.error(f"{log_prefix}: No suitable parser found. Aborting transaction.")
-                return False, repo_id_with_branch, []
-
-            slice_lines, code_entities, raw_references = [], [], []
-            async for item in parser.parse(source_file_id, content):
-                if isinstance(item, list): slice_lines = item
-                elif isinstance(item, CodeEntity): code_entities.append(item)
-                elif isinstance(item, RawSymbolReference): raw_references.append(item)
-
-            if not slice_lines and content.strip():
-                logger.info(f"{log_prefix}: Parser {parser.__class__.__name__} found no slicing points. Falling back to generic chunking.")
-                generic_parser = GenericParser()
-                slice_lines = await anext(generic_parser.parse(source_file_id, content), [])
-
-            # Step 5: ASSEMBLE FILE'S "ISLAND"
-            final_text_chunks = generate_intelligent_chunks(source_file_id, content, slice_lines)
-
-            if not final_text_chunks and (code_entities or raw_references):
-                logger.warning(f"{log_prefix}: Parser yielded entities/references but no chunks were generated. This is inconsistent.")
-                # Decide if this should be a hard failure or just a warning. For now, we stop.
+    if not redo:
+        with stage("content_check"):
+            if await check_content_exists(content_hash):
                 return False, repo_id_with_branch, []
 
-            if not final_text_chunks:
-                # This path is now only for files that are parsed but result in no chunks (e.g. only preprocessor directives)
-                logger.info(f"{log_prefix}: No chunks were generated. Ending processing for this file.")
-                has_activity = True # Still counts as activity to create the SourceFile node
-            else:
-                has_activity = True
-
-            entities_to_save: List[Union[AdaptableNode, Relationship]] = []
-            temp_id_to_final_id_map: Dict[str, str] = {}
-
-            entities_to_save.append(Repository(id=repo_id_with_branch, path=request.repo_path, repo_id=request.repo_id, branch=request.branch, import_id=request.import_id))
-            entities_to_save.append(SourceFile(id=source_file_id, relative_path=relative_path, commit_index=request.commit_index, local_save=local_save_count, content_hash=content_hash))
-            entities_to_save.extend(final_text_chunks)
-
-            for chunk in final_text_chunks:
-                entities_to_save.append(Relationship(source_id=source_file_id, target_id=chunk.id, type="CONTAINS_CHUNK"))
-
-            for temp_ce in code_entities:
-                parsed_id = parse_temp_code_entity_id(temp_ce.id)
-                if not parsed_id: continue
-                fqn_part, start_line_1 = parsed_id
-                parent_chunk = next((c for c in final_text_chunks if c.start_line <= start_line_1 <= c.end_line), None)
-                if not parent_chunk: continue
-                final_ce_id = f"{parent_chunk.id}|{fqn_part}@{start_line_1}-{temp_ce.end_line}"
-                temp_id_to_final_id_map[temp_ce.id] = final_ce_id
-                final_entity = CodeEntity(id=final_ce_id, type=temp_ce.type, snippet_content=temp_ce.snippet_content, start_line=start_line_1, end_line=temp_ce.end_line, canonical_fqn=temp_ce.canonical_fqn, metadata=temp_ce.metadata)
-                entities_to_save.append(final_entity)
-                entities_to_save.append(Relationship(source_id=parent_chunk.id, target_id=final_ce_id, type="DEFINES_CODE_ENTITY"))
-                final_code_entities.append(final_entity)
-
-            # Step 6: TIER 1 RESOLUTION & PENDING LINK CREATION
-            for ref in raw_references:
-                final_source_id = temp_id_to_final_id_map.get(ref.source_entity_id, ref.source_entity_id)
-                resolved_target_id = None
-                if ref.context.import_type == ImportType.RELATIVE:
-                    target_rel_path = resolve_import_path(relative_path, "/".join(ref.context.path_parts))
-                    if target_rel_path: resolved_target_id = await find_code_entity_by_path(tx, repo_id_with_branch, target_rel_path, ref.target_expression)
-                elif ref.context.import_type == ImportType.ABSOLUTE:
-                    target_fqn = "::".join(ref.context.path_parts) if ref.context.path_parts else ref.target_expression
-                    resolved_target_id = await find_code_entity_by_path(tx, repo_id_with_branch, None, target_fqn)
-                if resolved_target_id:
-                    entities_to_save.append(Relationship(source_id=final_source_id, target_id=resolved_target_id, type=ref.reference_type, properties=ref.metadata))
-                else:
-                    question_str = f"{final_source_id}|{ref.target_expression}|{ref.reference_type}"
-                    pending_link_id = str(uuid.uuid5(uuid.NAMESPACE_DNS, question_str))
-                    ref.source_entity_id = final_source_id
-                    entities_to_save.append(PendingLink(id=pending_link_id, reference_data=ref))
-
-            # Step 7: ADAPT & SAVE
-            nodes_to_add, edges_to_add = adapt_parser_entities_to_graph_elements(entities_to_save)
-            await save_graph_data(tx, nodes_to_add, edges_to_add)
-
-    finally:
-        if session:
-            await session.close()
-
-    return has_activity, repo_id_with_branch, final_code_entities
-
-async def process_single_file(request: FileProcessingRequest):
+    # Step 4: PARSE & COLLECT, under a provisional version; the graph assigns the real one when saving.
+    parser = get_parser_for_file(Path(request.absolute_path))
+    if not parser:
+        raise IngestAborted("No suitable parser found.")
+    provisional = SourceFile(id=f"{repo_id_with_branch}|{relative_path}@{request.commit_index}-0", relative_path=relative_path,
+                             commit_index=request.commit_index, local_save=0, content_hash=content_hash)
+    island = await extract_file_island(parser, provisional, content, log_prefix)
+
+    # Step 5: ASSEMBLE FILE'S "ISLAND"
+    if not island.text_chunks and island.parser_yielded_entities:
+        raise IngestAborted("Parser yielded entities/references but no chunks were generated. This is inconsistent.")
+    if not island.text_chunks:
+        # This path is now only for files that are parsed but result in no chunks (e.g. only preprocessor directives)
+        logger.info(f"{log_prefix}: No chunks were generated. Ending processing for this file.")
+
+    # Steps 6 & 7: VERSIONING, TIER 1 RESOLUTION, PENDING LINKS, ADAPT & SAVE
+    repository = Repository(id=repo_id_with_branch, path=request.repo_path, repo_id=request.repo_id, branch=request.branch, import_id=request.import_id)
+    await code_indexes.before_transaction(repo_id_with_branch)
+    async with graph_transaction():
+        with stage("delete"):
+            await delete_nodes_with_filter(path_filter)
+        with stage("version_counter"):
+            local_save_count = await atomic_get_and_increment_local_save(repo_id_with_branch, relative_path, request.commit_index)
+        island = island.with_source_file_id(f"{repo_id_with_branch}|{relative_path}@{request.commit_index}-{local_save_count}", local_save_count)
+        await _save_file_island(repository, island)
+
+    # Still counts as activity when there are no chunks: the SourceFile node was created.
+    return True, repo_id_with_branch, island.code_entities
+
+async def process_single_file(request: FileProcessingRequest, preloaded: Optional[BulkReadResult] = None, redo: bool = False) -> bool:
+    """
+    Returns True when the file's transaction completed (including no-op and delete outcomes).
+    `redo` re-ingests the file even when the graph already holds its content hash.
+    """
+    language = _language(request.absolute_path)
+    with labelled(repo=f"{request.repo_id}@{request.branch}", language=language):
+        if (profiler := get_profiler()) and (relative_path := _relative_path(request)) is not None:
+            with profiler.profile_file(relative_path, language):
+                return await _process_single_file(request, preloaded, redo)
+        return await _process_single_file(request, preloaded, redo)
+
+async def _process_single_file(request: FileProcessingRequest, preloaded: Optional[BulkReadResult], redo: bool = False) -> bool:
     start_time = time.time()
     log_prefix = f"ORCHESTRATOR ({Path(request.absolute_path).name})"
     logger.info(f"{log_prefix}: Starting processing for {request.repo_id}@{request.branch}|{request.absolute_path}")
 
     if not all([request.repo_id, request.branch]):
-        logger.error(f"{log_prefix}: Invalid request: repo_id or branch missing. Aborting."); return
-    if not os.path.isfile(request.absolute_path):
-        logger.error(f"{log_prefix}: File does not exist: {request.absolute_path}. Aborting."); return
+        logger.error(f"{log_prefix}: Invalid request: repo_id or branch missing. Aborting.")
+        count(INGEST_FILES, outcome="invalid"); return False
+    if _relative_path(request) is None:
+        logger.error(f"{log_prefix}: {request.absolute_path} is outside the repository {request.repo_path}. Aborting.")
+        count(INGEST_FILES, outcome="invalid"); return False
+    if not preloaded and not request.is_delete and not os.path.isfile(request.absolute_path):
+        logger.error(f"{log_prefix}: File does not exist: {request.absolute_path}. Aborting.")
+        count(INGEST_FILES, outcome="invalid"); return False
+    if recorder := get_recorder():
+        await recorder.record(request, preloaded)
 
     has_meaningful_activity = False
     repo_id_with_branch = ""
     final_code_entities_for_dispatcher = []
+    succeeded = False
 
     try:
-        has_meaningful_activity, repo_id_with_branch, final_code_entities_for_dispatcher = await _execute_transaction_with_retry(request, log_prefix)
+        has_meaningful_activity, repo_id_with_branch, final_code_entities_for_dispatcher = await _execute_transaction_with_retry(request, log_prefix, preloaded, redo)
+        succeeded = True
+    except IngestAborted as e:
+        logger.error(f"{log_prefix}: {e} Aborting transaction.")
     except Exception as e:
         logger.critical(f"{log_prefix}: Transaction failed after all retries. Error: {e}", exc_info=True)
 
     total_time = time.time() - start_time
     logger.info(f"{log_prefix}: Finished processing in {total_time:.2f} seconds.")
+    outcome = "failed" if not succeeded else "delete" if request.is_delete else "indexed" if has_meaningful_activity else "unchanged"
+    count(INGEST_FILES, outcome=outcome)
+    observe(INGEST_FILE_SECONDS, total_time, outcome=outcome, **current_labels())
+    if outcome in ("delete", "indexed"):
+        await get_graph_versions().record_write(repo_id_with_branch or f"{request.repo_id}@{request.branch}")
 
     if has_meaningful_activity:
         dispatcher = get_dispatcher()
         await dispatcher.notify_ingestion_activity(repo_id_with_branch, final_code_entities_for_dispatcher)
         logger.info(f"{log_prefix}: Notified dispatcher of activity for repo '{repo_id_with_branch}'.")
+    return succeeded
+
+def _relative_path(request: FileProcessingRequest) -> Optional[str]:
+    """The request's path inside its repository; None when it lies outside."""
+    try:
+        return str(Path(request.absolute_path).relative_to(request.repo_path))
+    except ValueError:
+        return None
+
+async def process_files_bulk(requests: List[FileProcessingRequest], concurrency: int = BULK_INGEST_CONCURRENCY, journal: Optional[IngestJournal] = None, profiler: Optional[IngestProfiler] = None):
+    """
+    Ingests many files, reading upserts through the batched bulk reader so each
+    transaction starts from an in-memory buffer and a precomputed hash.
+    With a journal, upserts already committed at the same size and mtime are skipped unread, and files
+    an earlier run started but did not commit are re-ingested without the content check.
+    With a profiler, every file gets a FileProfile (see profiling.py).
+    """
+    if profiler:
+        with profiler.active():
+            await process_files_bulk(requests, 1 if profiler.sequential else concurrency, journal)
+        logger.info(f"ORCHESTRATOR(BULK): {profiler.format_report()}")
+        return
+
+    # Reads feed a bounded queue, so at most BULK_INGEST_QUEUE_SIZE file contents wait for a worker.
+    queue: "asyncio.Queue[Optional[Tuple[FileProcessingRequest, Optional[BulkReadResult]]]]" = asyncio.Queue(maxsize=max(1, BULK_INGEST_QUEUE_SIZE))
+    processed = 0
+
+    async def _worker():
+        nonlocal processed
+        while (item := await queue.get()) is not None:
+            request, preloaded = item
+            try:
+                succeeded = await process_single_file(request, preloaded, redo=_relative_path(request) in redo)
+            except Exception as e:
+                logger.error(f"ORCHESTRATOR(BULK): Unexpected failure for {request.absolute_path}: {e}", exc_info=True)
+                succeeded = False
+            finally:
+                INGEST_INFLIGHT.dec(queue="bulk")
+            processed += 1
+            if journal and not request.is_delete and _relative_path(request) is not None:
+                state = FileState.COMMITTED if succeeded else FileState.FAILED
+                journal.record([JournalEntry(_relative_path(request), state, error=None if succeeded else "transaction failed")])
+
+    async def _enqueue(request: FileProcessingRequest, preloaded: Optional[BulkReadResult]):
+        INGEST_INFLIGHT.inc(queue="bulk")
+        await queue.put((request, preloaded))
+
+    upserts: Dict[str, FileProcessingRequest] = {}
+    redo = journal.incomplete_files() if journal else set()
+    for request in requests:
+        if request.is_delete or _relative_path(request) is None:
+            continue  # A path outside its repository is rejected by the per-file path.
+        if request.absolute_path in upserts:
+            logger.warning(f"ORCHESTRATOR(BULK): Duplicate request for {request.absolute_path}; the file is read once and ingested with the last request.")
+        upserts[request.absolute_path] = request
+
+    async def _read():
+        try:
+            for request in requests:
+                if request.is_delete or _relative_path(request) is None:
+                    await _enqueue(request, None)
+
+            nonlocal upserts
+            if journal:
+                pending, _ = journal.filter_pending([(path, _relative_path(r)) for path, r in upserts.items()])
+                upserts = {path: upserts[path] for path, _ in pending}
+
+            async for result in read_files_bulk(upserts.keys()):
+                if result.content is None:
+                    # Leave unreadable files to the per-file path, which logs and aborts them.
+                    await _enqueue(upserts[result.path], None)
+                    continue
+                if journal:
+                    journal.record([JournalEntry(_relative_path(upserts[result.path]), FileState.READ, result.size, result.mtime_ns, result.content_hash)])
+                await _enqueue(upserts[result.path], result)
+        finally:
+            for _ in range(concurrency):
+                await queue.put(None)
+
+    await asyncio.gather(_read(), *(_worker() for _ in range(concurrency)))
+    logger.info(f"ORCHESTRATOR(BULK): Processed {processed} requests.")
+
+# --- Bulk Ingestion of Extractor Output ---
+
+async def _ingest_island(repository: Repository, island: FileIsland, redo: bool = False) -> Optional[List[CodeEntity]]:
+    """Saves one pre-extracted island, re-rooting its IDs under the version the graph assigns. None when unchanged."""
+    relative_path = island.source_file.relative_path
+    commit_index = island.source_file.commit_index
+    with labelled(repo=repository.id, language=_language(relative_path)):
+        if not redo:
+            with stage("content_check"):
+                if island.source_file.content_hash and await check_content_exists(island.source_file.content_hash):
+                    return None
+        with stage("delete"):
+            await delete_nodes_with_filter({"repo_id_str": repository.id, "relative_path_str": relative_path})
+        with stage("version_counter"):
+            local_save_count = await atomic_get_and_increment_local_save(repository.id, relative_path, commit_index)
+        source_file_id = f"{repository.id}|{relative_path}@{commit_index}-{local_save_count}"
+        island = island.with_source_file_id(source_file_id, local_save_count)
+        await _save_file_island(repository, island)
+        return island.code_entities
+
+@retry(
+    stop=stop_after_attempt(3),
+    wait=wait_exponential(multiplier=1, min=2, max=10),
+    retry=retry_if_exception(is_transient_error),
+    before_sleep=_log_and_count_retry
+)
+async def commit_island_group(repository: Repository, islands: List[FileIsland], redo: Collection[str] = ()) -> List[CodeEntity]:
+    """Group commit: saves several pre-extracted islands in a single transaction. Paths in `redo` skip the content check."""
+    saved_entities: List[CodeEntity] = []
+    changed = False
+    await code_indexes.before_transaction(repository.id)
+    async with graph_transaction():
+        for island in islands:
+            entities = await _ingest_island(repository, island, island.source_file.relative_path in redo)
+            if entities is not None:
+                changed = True
+                saved_entities.extend(entities)
+    if changed:
+        await get_graph_versions().record_write(repository.id)
+    return saved_entities
+
+async def ingest_extraction_output(records_path: str, repo_path: str, repo_id: str, branch: str, import_id: Optional[str] = None, concurrency: int = BULK_INGEST_CONCURRENCY):
+    """
+    Ingests the NDJSON/Arrow output of extract_cli in bulk. Parsing already happened offline,
+    so each file costs one transaction; the dispatcher is notified once for the whole batch.
+    """
+    log_prefix = f"ORCHESTRATOR(INGEST {Path(records_path).name})"
+    repository = Repository(id=f"{repo_id}@{branch}", path=repo_path, repo_id=repo_id, branch=branch, import_id=import_id)
+    semaphore = asyncio.Semaphore(concurrency)
+    tasks: List[asyncio.Task] = []
+    failures = 0
+
+    async def _run(island: FileIsland) -> List[CodeEntity]:
+        nonlocal failures
+        try:
+            return await commit_island_group(repository, [island])
+        except Exception as e:
+            failures += 1
+            logger.error(f"{log_prefix}: Failed to ingest {island.source_file.relative_path}: {e}", exc_info=True)
+            return []
+        finally:
+            semaphore.release()
+
+    for island in records_to_islands(read_records(records_path)):
+        await semaphore.acquire()
+        tasks.append(asyncio.create_task(_run(island)))
+
+    saved_entities: List[CodeEntity] = [e for entities in await asyncio.gather(*tasks) for e in entities]
+    logger.info(f"{log_prefix}: Ingested {len(tasks) - failures}/{len(tasks)} files, {len(saved_entities)} code entities.")
+    if saved_entities:
+        await get_dispatcher().notify_ingestion_activity(repository.id, saved_entities)
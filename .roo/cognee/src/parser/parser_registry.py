@@ -0,0 +1,88 @@
+# .roo/cognee/src/parser/parser_registry.py
+import importlib
+import inspect
+from pathlib import Path
+from typing import Dict, Iterable, Optional, Type
+
+from .parsers.base_parser import BaseParser
+from .configs import SUPPORTED_EXTENSIONS, PARSER_PREWARM
+from .utils import logger
+
+# --- Lazy Registry ---
+# Extension -> parser module under src/parser/parsers. A module (and through it its tree-sitter
+# grammar) is imported the first time a file with one of its extensions is parsed. Each entry
+# must match the SUPPORTED_EXTENSIONS of the class the module defines.
+PARSER_MODULES: Dict[str, str] = {
+    ".cpp": "cpp_parser", ".hpp": "cpp_parser", ".h": "cpp_parser", ".c": "cpp_parser", ".cc": "cpp_parser",
+    ".txt": "generic_parser", ".md": "generic_parser", ".json": "generic_parser", ".yaml": "generic_parser",
+    ".yml": "generic_parser", ".xml": "generic_parser", ".html": "generic_parser", ".css": "generic_parser",
+    ".sh": "generic_parser",
+}
+FALLBACK_PARSER_MODULE = "generic_parser"
+CRITICAL_PARSER_MODULES = {"cpp_parser", "generic_parser"}
+EXTENSION_ALTERNATES = {'.cxx': '.cpp', '.c++': '.cpp', '.hh': '.hpp'}
+
+_module_parsers: Dict[str, Optional[Type[BaseParser]]] = {}
+# Critical modules that failed to load; every later lookup raises the same error instead of falling back.
+_critical_failures: Dict[str, RuntimeError] = {}
+
+def _load_parser_module(module_name: str) -> Optional[Type[BaseParser]]:
+    """Imports one parser module and returns the BaseParser subclass it defines (cached, including failures)."""
+    if module_name in _critical_failures:
+        raise _critical_failures[module_name]
+    if module_name in _module_parsers:
+        return _module_parsers[module_name]
+    parser_class = None
+    try:
+        module = importlib.import_module(f"{__package__}.parsers.{module_name}")
+        parser_class = next((value for value in vars(module).values()
+                             if inspect.isclass(value) and issubclass(value, BaseParser) and value is not BaseParser and value.__module__ == module.__name__), None)
+        if parser_class is None:
+            logger.error(f"PARSER_REGISTRY: Module '{module_name}' defines no parser class.")
+    except Exception as e:
+        logger.error(f"PARSER_REGISTRY: Failed to load parser module '{module_name}': {e}", exc_info=True)
+    if parser_class is None and module_name in CRITICAL_PARSER_MODULES:
+        error_message = f"Critical parser failed to load: {module_name}"
+        logger.critical(f"PARSER_REGISTRY: {error_message}")
+        _critical_failures[module_name] = RuntimeError(error_message)
+        raise _critical_failures[module_name]
+    _module_parsers[module_name] = parser_class
+    return parser_class
+
+def get_parser_class(ext: str) -> Optional[Type[BaseParser]]:
+    normalized_ext = EXTENSION_ALTERNATES.get(ext.lower(), ext.lower())
+    module_name = PARSER_MODULES.get(normalized_ext)
+    parser_class = _load_parser_module(module_name) if module_name else None
+    if parser_class is None:
+        parser_class = _load_parser_module(FALLBACK_PARSER_MODULE)
+        if parser_class is None:
+            logger.warning("PARSER_REGISTRY: No fallback parser loaded; unsupported file types will be skipped.")
+    return parser_class
+
+def get_parser_for_file(file_path: Path) -> Optional[BaseParser]:
+    """Finds and instantiates a suitable parser, handling case-insensitivity and alternate extensions."""
+    ParserClass = get_parser_class(file_path.suffix)
+    return ParserClass() if ParserClass else None
+
+def prewarm(languages: Iterable[str]):
+    """
+    Imports the parsers (and tree-sitter grammars) for language keys from SUPPORTED_EXTENSIONS,
+    e.g. ["cpp"], so the first file of that language does not pay for loading them. A critical
+    parser module that cannot be imported fails the pre-warm, so a server refuses to start rather
+    than parse that language with GenericParser.
+    """
+    wanted = set(languages)
+    for ext in sorted({ext for ext, language in SUPPORTED_EXTENSIONS.items() if language in wanted}):
+        try:
+            if ParserClass := get_parser_class(ext):
+                ParserClass()  # Parser constructors load their grammar.
+        except Exception as e:
+            if PARSER_MODULES.get(EXTENSION_ALTERNATES.get(ext, ext)) in _critical_failures:
+                raise
+            logger.error(f"PARSER_REGISTRY: Pre-warming '{ext}' failed: {e}")
+    logger.info(f"PARSER_REGISTRY: Pre-warmed parsers for {', '.join(sorted(wanted))}.")
+
+def prewarm_from_config():
+    """Pre-warms the comma-separated PARSER_PREWARM languages, if any."""
+    if PARSER_PREWARM:
+        prewarm(language.strip() for language in PARSER_PREWARM.split(",") if language.strip())
@@ -1,6 +1,13 @@
 # .roo/cognee/src/parser/parsers/cpp_parser.py
 from pydantic import BaseModel
-from typing import AsyncGenerator, Optional, List, Dict, Any, Set, Tuple
+from typing import AsyncGenerator, Optional, List, Dict, Any, Set, Tuple, NamedTuple
+from concurrent.futures import ProcessPoolExecutor
+import multiprocessing
+import tempfile
+import hashlib
+import asyncio
+import atexit
+import os
 import re
 
 from .base_parser import BaseParser
@@ -8,6 +15,8 @@ from .base_parser import BaseParser
 from ..entities import CodeEntity, RawSymbolReference, ParserOutput, ReferenceContext, ImportType
 from ..utils import get_node_text, logger, TSNODE_TYPE, format_node_for_debug
 from .treesitter_setup import get_parser, get_language
+from .. import profiling
+from ..configs import PARALLEL_EXTRACTION_MIN_LINES, PARALLEL_EXTRACTION_MAX_WORKERS, PARALLEL_EXTRACTION_BATCHES_PER_WORKER
 
 # Final Queries: Includes all necessary captures for context and references
 CPP_QUERIES = {
@@ -51,6 +60,82 @@ class FileContext:
         self.local_definitions: Dict[str, str] = {}
         self.local_variable_types: Dict[Tuple[str, str], str] = {}
 
+# --- Parallel Extraction for Very Large Files ---
+
+# Containers whose children are walked exactly as if they were top-level, so they can be split into units.
+TRANSPARENT_CONTAINERS: Set[str] = {
+    "declaration_list", "linkage_specification",
+    "preproc_if", "preproc_ifdef", "preproc_else", "preproc_elif", "preproc_elifdef",
+}
+
+class ExtractionUnit(NamedTuple):
+    """A top-level (or namespace-level) node, located by byte range, and the scope stack it is walked under."""
+    start_byte: int
+    end_byte: int
+    node_type: str
+    scope_stack: List[Tuple[Optional[str], str]]
+
+class ExtractionBatch(NamedTuple):
+    """
+    Everything a worker process needs to walk a contiguous run of units independently. The file content
+    is not pickled into each batch: it is written once to `content_path`, and units carry byte ranges.
+    """
+    source_file_id: str
+    content_path: str
+    content_digest: bytes
+    include_map: Dict[str, str]
+    import_map: Dict[str, str]
+    seeded_variable_types: List[Tuple[str, str, str]]
+    entries: List[Any]
+
+# Extraction workers this process may start, when a pool it belongs to set one (see set_extraction_worker_budget).
+_worker_budget: Optional[int] = None
+
+def set_extraction_worker_budget(pool_size: int):
+    """Pool initializer for one of `pool_size` sibling processes (extract_cli jobs, ingest shards): large files use its share of the cores."""
+    global _worker_budget
+    _worker_budget = max(1, (os.cpu_count() or 1) // max(1, pool_size))
+
+def extraction_workers() -> int:
+    """
+    Worker processes one large file is extracted across. A process started by another pool without a
+    budget extracts serially: its siblings already occupy the cores, and a pool of its own in each
+    would start jobs x cpu_count processes.
+    """
+    if _worker_budget is not None:
+        return min(_worker_budget, PARALLEL_EXTRACTION_MAX_WORKERS)
+    return PARALLEL_EXTRACTION_MAX_WORKERS if multiprocessing.parent_process() is None else 1
+
+_extraction_executor: Optional[ProcessPoolExecutor] = None
+def _get_extraction_executor(workers: int) -> ProcessPoolExecutor:
+    """Lazily creates the shared process pool so the worker start-up cost is paid once per process."""
+    global _extraction_executor
+    if _extraction_executor is None:
+        _extraction_executor = ProcessPoolExecutor(max_workers=workers, mp_context=multiprocessing.get_context("spawn"))
+        atexit.register(shutdown_extraction_executor)
+    return _extraction_executor
+
+def shutdown_extraction_executor():
+    """Stops the worker processes; the next parallel extraction starts a new pool."""
+    global _extraction_executor
+    if _extraction_executor is not None:
+        executor, _extraction_executor = _extraction_executor, None
+        executor.shutdown(wait=True, cancel_futures=True)
+        atexit.unregister(shutdown_extraction_executor)
+
+_worker_parser: Optional["CppParser"] = None
+_worker_tree: Optional[Tuple[bytes, bytes, Any]] = None
+def _extract_batch_in_worker(batch: ExtractionBatch) -> List[ParserOutput]:
+    """Process pool entry point. Each worker keeps its own parser, and the last file and tree so a file is read and parsed once per worker."""
+    global _worker_parser, _worker_tree
+    if _worker_parser is None:
+        _worker_parser = CppParser()
+    if _worker_tree is None or _worker_tree[0] != batch.content_digest:
+        with open(batch.content_path, "rb") as f:
+            content_bytes = f.read()
+        _worker_tree = (batch.content_digest, content_bytes, _worker_parser.parser.parse(content_bytes))
+    return asyncio.run(_worker_parser._extract_batch(batch, _worker_tree[1], _worker_tree[2].root_node))
+
 class CppParser(BaseParser):
     SUPPORTED_EXTENSIONS = [".cpp", ".hpp", ".h", ".c", ".cc"]
     AST_SCOPES_FOR_FQN: Set[str] = {
@@ -95,10 +180,15 @@ class CppParser(BaseParser):
         if node.type == "template_declaration": return "TemplateDefinition"
         return type_map.get(node.type, "UnknownDefinition")
 
-    def _precompute_interest_nodes(self, root_node: TSNODE_TYPE) -> Dict[int, List[Tuple[str, str]]]:
+    def _build_definition_entity(self, node: TSNODE_TYPE, scope_id: str, content_bytes: bytes) -> CodeEntity:
+        return CodeEntity(id=scope_id, type=self._get_type_for_definition(node), snippet_content=get_node_text(node, content_bytes) or "", canonical_fqn=scope_id.split('@')[0],
+                          start_line=node.start_point[0] + 1, end_line=node.end_point[0] + 1)
+
+    def _precompute_interest_nodes(self, root_node: TSNODE_TYPE, query_names: Optional[List[str]] = None) -> Dict[int, List[Tuple[str, str]]]:
         # This helper is complete
         interest_nodes: Dict[int, List[Tuple[str, str]]] = {}
         for query_name, query in self.queries.items():
+            if query_names is not None and query_name not in query_names: continue
             for match in query.matches(root_node):
                 node = match[0]
                 capture_name = self.queries[query_name].captures[match[1].index]
@@ -147,6 +237,8 @@ class CppParser(BaseParser):
 
     async def _walk_and_process(self, node: TSNODE_TYPE, context: FileContext, content_bytes: bytes, interest_nodes: Dict[int, List[Tuple[str, str]]]) -> AsyncGenerator[ParserOutput, None]:
         # This walker is now complete and uses the fully implemented helpers
+        walk_stack = profiling.WALK_STACK
+        if walk_stack is not None: walk_stack.append(node.type)
         node_id = node.id
         is_scope = node.type in self.AST_SCOPES_FOR_FQN
 
@@ -163,11 +255,10 @@ class CppParser(BaseParser):
         if node_id in interest_nodes:
             for query_name, capture_name in interest_nodes[node_id]:
                 if query_name == "definitions":
-                    entity_type = self._get_type_for_definition(node)
                     scope_id = context.scope_stack[-1][1]
-                    fqn = scope_id.split('@')[0]
-                    context.local_definitions[fqn] = scope_id
-                    yield CodeEntity(id=scope_id, type=entity_type, snippet_content=get_node_text(node, content_bytes) or "", canonical_fqn=fqn)
+                    entity = self._build_definition_entity(node, scope_id, content_bytes)
+                    context.local_definitions[entity.canonical_fqn] = scope_id
+                    yield entity
 
                 elif query_name == "variable_declarations" and capture_name == "name":
                     if node.parent and node.parent.type == 'declaration':
@@ -195,6 +286,7 @@ class CppParser(BaseParser):
                 yield item
 
         if is_scope: context.scope_stack.pop()
+        if walk_stack is not None: walk_stack.pop()
 
     async def parse(self, source_file_id: str, file_content: str) -> AsyncGenerator[ParserOutput, None]:
         log_prefix = f"CppParser ({source_file_id})"
@@ -204,10 +296,14 @@ class CppParser(BaseParser):
             content_bytes = bytes(file_content, "utf8")
             tree = self.parser.parse(content_bytes)
             root_node = tree.root_node
+            profiling.record_ast(root_node)
         except Exception as e:
             logger.error(f"{log_prefix}: Failed to parse content into AST: {e}"); return
 
-        interest_nodes = self._precompute_interest_nodes(root_node)
+        # Above the threshold only definitions are needed up front; the workers compute the rest per unit.
+        workers = extraction_workers()
+        use_parallel = root_node.end_point[0] + 1 >= PARALLEL_EXTRACTION_MIN_LINES and workers > 1
+        interest_nodes = self._precompute_interest_nodes(root_node, query_names=["definitions"] if use_parallel else None)
         def_nodes = [node for nid, interests in interest_nodes.items() if "definitions" in [i[0] for i in interests] for node in [root_node.descendant_for_byte_range(nid, nid)] if node]
 
         if def_nodes:
@@ -240,7 +336,116 @@ class CppParser(BaseParser):
                     if scope_node.id not in file_context.active_usings: file_context.active_usings[scope_node.id] = []
                     file_context.active_usings[scope_node.id].append(namespace)
 
-        async for item in self._walk_and_process(root_node, file_context, content_bytes, interest_nodes):
-            yield item
+        if use_parallel and file_context.active_usings:
+            # 'using namespace' resolution depends on every definition seen earlier in the file, so it must stay sequential.
+            logger.info(f"{log_prefix}: File has 'using namespace' directives. Falling back to sequential extraction.")
+            use_parallel = False
+            interest_nodes = self._precompute_interest_nodes(root_node)
+
+        if use_parallel:
+            for item in await self._extract_in_parallel(root_node, file_context, content_bytes, workers):
+                yield item
+        else:
+            async for item in self._walk_and_process(root_node, file_context, content_bytes, interest_nodes):
+                yield item
 
         logger.info(f"{log_prefix}: Finished parsing.")
+
+    # --- Parallel Extraction ---
+
+    def _plan_extraction_units(self, node: TSNODE_TYPE, content_bytes: bytes, scope_stack: List[Tuple[Optional[str], str]], plan: List[Any], variable_types: List[Tuple[int, str, str, str]]):
+        """
+        Flattens the tree into walkable units in document order. Namespaces are opened here so
+        their bodies can be split, and their own CodeEntity is placed in the plan before their children.
+        """
+        for child in node.children:
+            if not child.is_named: continue
+            if child.type in TRANSPARENT_CONTAINERS:
+                self._plan_extraction_units(child, content_bytes, scope_stack, plan, variable_types)
+                continue
+            body = child.child_by_field_name("body") if child.type == "namespace_definition" else None
+            if body is None:
+                plan.append(ExtractionUnit(child.start_byte, child.end_byte, child.type, scope_stack))
+                if child.type == "declaration" and (type_node := child.child_by_field_name("type")):
+                    for declarator in child.children_by_field_name("declarator"):
+                        if declarator.type in ("identifier", "pointer_declarator", "array_declarator"):
+                            variable_types.append((child.start_byte, scope_stack[-1][1], get_node_text(declarator, content_bytes), get_node_text(type_node, content_bytes)))
+                continue
+            name_node = child.child_by_field_name("name")
+            entity_id = f"{self._get_fqn_for_node(name_node, child, content_bytes, scope_stack)}@{child.start_point[0] + 1}"
+            plan.append(self._build_definition_entity(child, entity_id, content_bytes))
+            self._plan_extraction_units(body, content_bytes, scope_stack + [(self._get_node_name_text(name_node, content_bytes), entity_id)], plan, variable_types)
+
+    async def _extract_in_parallel(self, root_node: TSNODE_TYPE, context: FileContext, content_bytes: bytes, workers: int) -> List[ParserOutput]:
+        """Walks independent unit ranges in worker processes and merges their output back in document order."""
+        log_prefix = f"{self.log_prefix} ({context.source_file_id})"
+        plan: List[Any] = []
+        variable_types: List[Tuple[int, str, str, str]] = []
+        self._plan_extraction_units(root_node, content_bytes, list(context.scope_stack), plan, variable_types)
+
+        units = [entry for entry in plan if isinstance(entry, ExtractionUnit)]
+        target_batch_bytes = max(1, sum(u.end_byte - u.start_byte for u in units) // (workers * PARALLEL_EXTRACTION_BATCHES_PER_WORKER))
+
+        # Contiguous runs of the plan, balanced by byte size. Namespace entities travel inside the batch so order is kept.
+        batches: List[List[Any]] = [[]]
+        batch_bytes = 0
+        for entry in plan:
+            batches[-1].append(entry)
+            if isinstance(entry, ExtractionUnit):
+                batch_bytes += entry.end_byte - entry.start_byte
+                if batch_bytes >= target_batch_bytes:
+                    batches.append([])
+                    batch_bytes = 0
+        batches = [batch for batch in batches if batch]
+
+        loop = asyncio.get_running_loop()
+        executor = _get_extraction_executor(workers)
+        with tempfile.NamedTemporaryFile(prefix="cpp_extract_", suffix=".src", delete=False) as f:
+            f.write(content_bytes)
+        try:
+            digest = hashlib.blake2b(content_bytes, digest_size=16).digest()
+            futures = []
+            for entries in batches:
+                first_byte = next((e.start_byte for e in entries if isinstance(e, ExtractionUnit)), len(content_bytes))
+                batch = ExtractionBatch(
+                    source_file_id=context.source_file_id,
+                    content_path=f.name,
+                    content_digest=digest,
+                    include_map=context.include_map,
+                    import_map=context.import_map,
+                    seeded_variable_types=[(scope_id, name, var_type) for start, scope_id, name, var_type in variable_types if start < first_byte],
+                    entries=entries,
+                )
+                futures.append(loop.run_in_executor(executor, _extract_batch_in_worker, batch))
+            logger.info(f"{log_prefix}: Extracting {len(units)} units in {len(futures)} batches across {workers} workers.")
+
+            merged: List[ParserOutput] = []
+            for batch_items in await asyncio.gather(*futures):
+                merged.extend(batch_items)
+            return merged
+        finally:
+            os.unlink(f.name)
+
+    async def _extract_batch(self, batch: ExtractionBatch, content_bytes: bytes, root_node: TSNODE_TYPE) -> List[ParserOutput]:
+        """Worker side: walks only the units of this batch, each under its seeded scope stack."""
+        context = FileContext(batch.source_file_id)
+        context.include_map = dict(batch.include_map)
+        context.import_map = dict(batch.import_map)
+        for scope_id, var_name, var_type in batch.seeded_variable_types:
+            context.local_variable_types[(scope_id, var_name)] = var_type
+
+        items: List[ParserOutput] = []
+        for unit in batch.entries:
+            if isinstance(unit, CodeEntity):
+                items.append(unit); continue
+            node = root_node.descendant_for_byte_range(unit.start_byte, unit.end_byte)
+            while node is not None and not (node.type == unit.node_type and node.start_byte == unit.start_byte and node.end_byte == unit.end_byte):
+                node = node.parent
+            if node is None:
+                logger.warning(f"{self.log_prefix} ({batch.source_file_id}): Could not relocate '{unit.node_type}' unit at bytes [{unit.start_byte}-{unit.end_byte}]. Skipping.")
+                continue
+            context.scope_stack = list(unit.scope_stack)
+            interest_nodes = self._precompute_interest_nodes(node)
+            async for item in self._walk_and_process(node, context, content_bytes, interest_nodes):
+                items.append(item)
+        return items
@@ -0,0 +1,284 @@
+# .roo/cognee/src/parser/profiling.py
+"""
+Per-file cost profiling for the bulk ingest (process_files_bulk) and extractor CLI paths.
+
+Each file gets a FileProfile: stage times (parse, chunk and the graph stages, which add up to
+database time), AST node count, entities and references by type, pending links created, and
+optionally its tracemalloc peak. Stack sampling records the chain of AST node types the
+CppParser walk is inside, so parse time can be charged to constructs. A finished run is
+ranked into a report of the slowest and heaviest files and the cost per construct.
+
+Allocation peaks and samples can only be attributed to one file at a time, so either option
+makes the profiled run process files sequentially.
+"""
+import json
+import sys
+import threading
+import time
+import tracemalloc
+from collections import Counter
+from contextlib import contextmanager
+from contextvars import ContextVar
+from dataclasses import dataclass, field
+from typing import Dict, Iterator, List, Optional
+
+# Stages that are graph database round trips (see the orchestrator's stage() blocks).
+DB_STAGES = ("content_check", "delete", "version_counter", "tier1", "save")
+
+# While stack sampling is on, the CppParser walk keeps the AST node types it is inside here.
+WALK_STACK: Optional[List[str]] = None
+
+@dataclass
+class FileProfile:
+    path: str
+    language: str = "other"
+    lines: int = 0
+    bytes: int = 0
+    total_seconds: float = 0.0
+    stages: Dict[str, float] = field(default_factory=dict)
+    ast_nodes: int = 0
+    entities: Counter = field(default_factory=Counter)
+    references: Counter = field(default_factory=Counter)
+    pending_links: int = 0
+    alloc_peak_bytes: int = 0
+    samples: int = 0
+
+    def add_stage(self, name: str, seconds: float):
+        self.stages[name] = self.stages.get(name, 0.0) + seconds
+
+    @property
+    def parse_seconds(self) -> float:
+        return self.stages.get("parse", 0.0)
+
+    @property
+    def db_seconds(self) -> float:
+        return sum(self.stages.get(name, 0.0) for name in DB_STAGES)
+
+    def to_dict(self) -> dict:
+        return {
+            "path": self.path, "language": self.language, "lines": self.lines, "bytes": self.bytes,
+            "total_seconds": round(self.total_seconds, 6), "parse_seconds": round(self.parse_seconds, 6),
+            "db_seconds": round(self.db_seconds, 6), "stages": {k: round(v, 6) for k, v in sorted(self.stages.items())},
+            "ast_nodes": self.ast_nodes, "entities": dict(self.entities), "references": dict(self.references),
+            "pending_links": self.pending_links, "alloc_peak_bytes": self.alloc_peak_bytes, "samples": self.samples,
+        }
+
+    @classmethod
+    def from_dict(cls, data: dict) -> "FileProfile":
+        return cls(
+            path=data["path"], language=data["language"], lines=data["lines"], bytes=data["bytes"],
+            total_seconds=data["total_seconds"], stages=dict(data["stages"]), ast_nodes=data["ast_nodes"],
+            entities=Counter(data["entities"]), references=Counter(data["references"]),
+            pending_links=data["pending_links"], alloc_peak_bytes=data["alloc_peak_bytes"], samples=data["samples"],
+        )
+
+_current_file: ContextVar[Optional[FileProfile]] = ContextVar("profiling_current_file", default=None)
+
+def current_file_profile() -> Optional[FileProfile]:
+    return _current_file.get()
+
+def record_ast(root_node):
+    """Called by tree-sitter parsers with the parsed root; counts nodes only while profiling."""
+    profile = _current_file.get()
+    if profile is None:
+        return
+    count = getattr(root_node, "descendant_count", None)
+    if count is None:
+        count, cursor = 0, root_node.walk()
+        # Preorder walk over the cursor; no Python recursion on deep trees.
+        while True:
+            count += 1
+            if cursor.goto_first_child() or cursor.goto_next_sibling():
+                continue
+            while cursor.goto_parent():
+                if cursor.goto_next_sibling():
+                    break
+            else:
+                break
+    profile.ast_nodes += count
+
+class IngestProfiler:
+    def __init__(self, trace_allocations: bool = False, sample_stacks: bool = False, sample_interval: float = 0.001):
+        self.trace_allocations = trace_allocations
+        self.sample_stacks = sample_stacks
+        self.sample_interval = sample_interval
+        self.files: List[FileProfile] = []
+        # Collapsed "type;type;type" walk stacks -> samples (flame graph input).
+        self.stack_samples: Counter = Counter()
+        self._sampled_file: Optional[FileProfile] = None
+        self._sampler: Optional[threading.Thread] = None
+        self._stop = threading.Event()
+        self._started_tracemalloc = False
+
+    @property
+    def sequential(self) -> bool:
+        """True when per-file attribution needs files processed one at a time."""
+        return self.trace_allocations or self.sample_stacks
+
+    # --- Lifecycle ---
+
+    def start(self):
+        global WALK_STACK, _active
+        _active = self
+        if self.trace_allocations and not tracemalloc.is_tracing():
+            tracemalloc.start()
+            self._started_tracemalloc = True
+        if self.sample_stacks:
+            WALK_STACK = []
+            self._stop.clear()
+            self._sampler = threading.Thread(target=self._sample_loop, name="walk-sampler", daemon=True)
+            self._sampler.start()
+
+    def stop(self):
+        global WALK_STACK, _active
+        if self._sampler:
+            self._stop.set()
+            self._sampler.join()
+            self._sampler = None
+        WALK_STACK = None
+        if self._started_tracemalloc:
+            tracemalloc.stop()
+            self._started_tracemalloc = False
+        if _active is self:
+            _active = None
+
+    @contextmanager
+    def active(self) -> Iterator["IngestProfiler"]:
+        self.start()
+        try:
+            yield self
+        finally:
+            self.stop()
+
+    def _sample_loop(self):
+        previous_interval = sys.getswitchinterval()
+        # The sampler needs the GIL back within its own interval to see the walk it is sampling.
+        sys.setswitchinterval(min(previous_interval, self.sample_interval / 2))
+        try:
+            while not self._stop.wait(self.sample_interval):
+                stack, profile = WALK_STACK, self._sampled_file
+                if stack and profile is not None:
+                    self.stack_samples[";".join(tuple(stack))] += 1
+                    profile.samples += 1
+        finally:
+            sys.setswitchinterval(previous_interval)
+
+    # --- Per File ---
+
+    @contextmanager
+    def profile_file(self, path: str, language: str = "other") -> Iterator[FileProfile]:
+        profile = FileProfile(path=path, language=language)
+        token = _current_file.set(profile)
+        if self.trace_allocations:
+            tracemalloc.reset_peak()
+        if WALK_STACK is not None:
+            WALK_STACK.clear()
+        self._sampled_file = profile
+        start = time.perf_counter()
+        try:
+            yield profile
+        finally:
+            profile.total_seconds = time.perf_counter() - start
+            if self.trace_allocations:
+                profile.alloc_peak_bytes = tracemalloc.get_traced_memory()[1]
+            self._sampled_file = None
+            _current_file.reset(token)
+            self.files.append(profile)
+
+    def merge(self, files: List[dict], stack_samples: Dict[str, int]):
+        """Adds results shipped back from a worker process (FileProfile.to_dict and stack_samples)."""
+        self.files.extend(FileProfile.from_dict(f) for f in files)
+        self.stack_samples.update(stack_samples)
+
+    # --- Report ---
+
+    def construct_costs(self) -> List[dict]:
+        """Per AST node type: samples with it innermost (self) and anywhere on the stack (inclusive)."""
+        total = sum(self.stack_samples.values())
+        self_samples: Counter = Counter()
+        inclusive: Counter = Counter()
+        for stack, samples in self.stack_samples.items():
+            frames = stack.split(";")
+            self_samples[frames[-1]] += samples
+            for node_type in set(frames):
+                inclusive[node_type] += samples
+        return [
+            {"construct": node_type, "self_samples": self_samples[node_type], "inclusive_samples": samples,
+             "self_share": round(self_samples[node_type] / total, 4) if total else 0.0}
+            for node_type, samples in sorted(inclusive.items(), key=lambda kv: (-self_samples[kv[0]], -kv[1], kv[0]))
+        ]
+
+    def report(self, top: int = 20) -> dict:
+        files = self.files
+        entity_files: Dict[str, List[FileProfile]] = {}
+        for profile in files:
+            for entity_type in profile.entities:
+                entity_files.setdefault(entity_type, []).append(profile)
+        # Parse time of each file is charged to its entity types in proportion to their counts.
+        by_entity_type = []
+        for entity_type, owners in entity_files.items():
+            count = sum(p.entities[entity_type] for p in owners)
+            seconds = sum(p.parse_seconds * p.entities[entity_type] / sum(p.entities.values()) for p in owners)
+            by_entity_type.append({"type": entity_type, "count": count, "files": len(owners), "parse_seconds": round(seconds, 6), "us_per_entity": round(seconds / count * 1e6, 2)})
+        by_entity_type.sort(key=lambda row: -row["parse_seconds"])
+
+        by_language: Dict[str, dict] = {}
+        for profile in files:
+            row = by_language.setdefault(profile.language, {"files": 0, "lines": 0, "total_seconds": 0.0, "parse_seconds": 0.0, "db_seconds": 0.0})
+            row["files"] += 1
+            row["lines"] += profile.lines
+            row["total_seconds"] += profile.total_seconds
+            row["parse_seconds"] += profile.parse_seconds
+            row["db_seconds"] += profile.db_seconds
+
+        def _top(key) -> List[dict]:
+            return [p.to_dict() for p in sorted(files, key=key, reverse=True)[:top]]
+        return {
+            "files": len(files),
+            "total_seconds": round(sum(p.total_seconds for p in files), 6),
+            "parse_seconds": round(sum(p.parse_seconds for p in files), 6),
+            "db_seconds": round(sum(p.db_seconds for p in files), 6),
+            "slowest": _top(lambda p: p.total_seconds),
+            "slowest_parse": _top(lambda p: p.parse_seconds),
+            "slowest_db": _top(lambda p: p.db_seconds),
+            "heaviest_ast": _top(lambda p: p.ast_nodes),
+            "heaviest_alloc": _top(lambda p: p.alloc_peak_bytes) if self.trace_allocations else [],
+            "by_language": by_language,
+            "by_entity_type": by_entity_type,
+            "by_construct": self.construct_costs()[:top] if self.stack_samples else [],
+        }
+
+    def write_report(self, path: str, top: int = 20):
+        """Writes the JSON report; sampled stacks go next to it as '<path>.folded' for flame graph tools."""
+        with open(path, "w", encoding="utf-8") as f:
+            json.dump(self.report(top), f, indent=2)
+        if self.stack_samples:
+            with open(f"{path}.folded", "w", encoding="utf-8") as f:
+                for stack, samples in self.stack_samples.most_common():
+                    f.write(f"{stack} {samples}\n")
+
+    def format_report(self, top: int = 10) -> str:
+        report = self.report(top)
+        lines = [f"PROFILE: {report['files']} files, {report['total_seconds']:.2f}s total, {report['parse_seconds']:.2f}s parse, {report['db_seconds']:.2f}s database"]
+        lines.append(f"Slowest {min(top, report['files'])} files:")
+        for row in report["slowest"]:
+            lines.append(f"  {row['total_seconds'] * 1000:9.1f} ms  parse {row['parse_seconds'] * 1000:8.1f}  db {row['db_seconds'] * 1000:8.1f}  nodes {row['ast_nodes']:8d}  entities {sum(row['entities'].values()):6d}  pending {row['pending_links']:5d}  {row['path']}")
+        if report["heaviest_alloc"]:
+            lines.append("Largest allocation peaks:")
+            for row in report["heaviest_alloc"]:
+                lines.append(f"  {row['alloc_peak_bytes'] / 2**20:9.2f} MB  {row['path']}")
+        if report["by_entity_type"]:
+            lines.append("Parse cost by entity type:")
+            for row in report["by_entity_type"][:top]:
+                lines.append(f"  {row['type']:24s} {row['count']:8d}  {row['us_per_entity']:10.1f} us/entity")
+        if report["by_construct"]:
+            lines.append("Sampled walk cost by construct (self share):")
+            for row in report["by_construct"]:
+                lines.append(f"  {row['construct']:32s} {row['self_share']:7.1%}  ({row['self_samples']} self / {row['inclusive_samples']} incl.)")
+        return "\n".join(lines)
+
+_active: Optional[IngestProfiler] = None
+
+def get_profiler() -> Optional[IngestProfiler]:
+    """The profiler started by IngestProfiler.start(), if any."""
+    return _active
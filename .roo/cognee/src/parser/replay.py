@@ -0,0 +1,330 @@
+# .roo/cognee/src/parser/replay.py
+"""
+Record/replay load harness for ingestion and the enhancement dispatcher.
+
+Recording: set INGEST_RECORD_PATH (and optionally INGEST_RECORD_CONTENT=blob) and every
+FileProcessingRequest reaching process_single_file is appended to an NDJSON trace with its
+timestamp and content (inline, or as a git blob ID written into the repository's object store).
+
+Replay: re-issues the trace at N x speed against a fresh embedded local graph backend, with the
+dispatcher's quiescence period scaled by the same factor, and reports freshness latency
+(save -> entities visible -> links resolved), queue depths and database operation counts.
+
+Usage (from .roo/cognee):
+    INGEST_RECORD_PATH=trace.ndjson <run the watcher / ingestion as usual>
+    python -m src.parser.replay trace.ndjson --speed 20 --json report.json
+"""
+import argparse
+import asyncio
+import hashlib
+import json
+import os
+import shutil
+import sqlite3
+import sys
+import tempfile
+import time
+from dataclasses import asdict, dataclass, field
+from pathlib import Path
+from typing import Dict, List, Optional
+
+from .bulk_reader import BulkReadResult
+from .configs import INGEST_RECORD_CONTENT, INGEST_RECORD_PATH, METRICS_PORT, QUIESCENCE_PERIOD_SECONDS
+from .entities import FileProcessingRequest, LinkStatus
+from .metrics import start_metrics_server
+from .utils import logger, read_file_content
+
+# --- Recording ---
+
+async def _git(repo_path: str, *args: str, stdin: Optional[bytes] = None) -> bytes:
+    proc = await asyncio.create_subprocess_exec(
+        "git", "-C", repo_path, *args,
+        stdin=asyncio.subprocess.PIPE if stdin is not None else None,
+        stdout=asyncio.subprocess.PIPE, stderr=asyncio.subprocess.PIPE,
+    )
+    out, err = await proc.communicate(stdin)
+    if proc.returncode != 0:
+        raise RuntimeError(f"git {' '.join(args)} failed: {err.decode(errors='ignore').strip()}")
+    return out
+
+class RequestRecorder:
+    """Appends FileProcessingRequests, with the content they were ingested with, to an NDJSON trace."""
+    def __init__(self, path: str, content_mode: str = "inline"):
+        if content_mode not in ("inline", "blob"):
+            raise ValueError(f"Unknown record content mode: {content_mode}")
+        self.path = path
+        self.content_mode = content_mode
+        os.makedirs(os.path.dirname(os.path.abspath(path)), exist_ok=True)
+        self._file = open(path, "a", encoding="utf-8", buffering=1)
+
+    async def record(self, request: FileProcessingRequest, preloaded: Optional[BulkReadResult] = None):
+        event = {"ts": time.time(), "request": request.model_dump()}
+        if not request.is_delete:
+            content = preloaded.content if preloaded and preloaded.content is not None else await read_file_content(request.absolute_path)
+            if content is not None and self.content_mode == "blob":
+                try:
+                    event["blob"] = (await _git(request.repo_path, "hash-object", "-w", "--stdin", stdin=content.encode("utf-8"))).decode().strip()
+                except (OSError, RuntimeError) as e:
+                    logger.warning(f"REPLAY(record): Could not store git blob for {request.absolute_path}, recording inline: {e}")
+                    event["content"] = content
+            elif content is not None:
+                event["content"] = content
+        self._file.write(json.dumps(event, ensure_ascii=False, separators=(",", ":")) + "\n")
+
+    def close(self):
+        self._file.close()
+
+_recorder: Optional[RequestRecorder] = None
+def get_recorder() -> Optional[RequestRecorder]:
+    """The process-wide recorder when INGEST_RECORD_PATH is set, otherwise None."""
+    global _recorder
+    if _recorder is None and INGEST_RECORD_PATH:
+        _recorder = RequestRecorder(INGEST_RECORD_PATH, INGEST_RECORD_CONTENT)
+    return _recorder
+
+# --- Trace Loading ---
+
+@dataclass
+class ReplayEvent:
+    offset: float
+    request: FileProcessingRequest
+    content: Optional[str] = None
+    blob: Optional[str] = None
+
+def load_trace(path: str) -> List[ReplayEvent]:
+    """Reads a trace, ordered by timestamp, with offsets relative to the first event."""
+    raw = []
+    with open(path, "r", encoding="utf-8") as f:
+        for line in f:
+            if line.strip():
+                raw.append(json.loads(line))
+    raw.sort(key=lambda e: e["ts"])
+    start = raw[0]["ts"] if raw else 0.0
+    return [ReplayEvent(e["ts"] - start, FileProcessingRequest(**e["request"]), e.get("content"), e.get("blob")) for e in raw]
+
+# --- Replay ---
+
+def _summarize(values: List[float]) -> Dict[str, float]:
+    if not values:
+        return {"count": 0}
+    ordered = sorted(values)
+    def _pct(p: float) -> float:
+        return round(ordered[min(len(ordered) - 1, int(p * len(ordered)))], 4)
+    return {"count": len(ordered), "p50": _pct(0.50), "p95": _pct(0.95), "max": round(ordered[-1], 4)}
+
+@dataclass
+class ReplayReport:
+    events: int
+    speed: float
+    wall_seconds: float = 0.0
+    failures: int = 0
+    ingest_latency: List[float] = field(default_factory=list)
+    link_latency: List[float] = field(default_factory=list)
+    links_created: int = 0
+    links_unresolvable: int = 0
+    links_superseded: int = 0
+    links_outstanding: int = 0
+    max_inflight: int = 0
+    max_timers: int = 0
+    timer_resets: int = 0
+    enhancement_cycles: int = 0
+    db_ops: Dict[str, int] = field(default_factory=dict)
+
+    def summary(self) -> dict:
+        data = asdict(self)
+        data["ingest_latency"] = _summarize(self.ingest_latency)
+        data["link_latency"] = _summarize(self.link_latency)
+        return data
+
+class ReplayHarness:
+    """
+    Replays a trace against a fresh local graph backend. Requests are issued at their (scaled)
+    recorded times without waiting for earlier ones, so bursts overlap as they did live.
+    """
+    def __init__(self, events: List[ReplayEvent], speed: float = 1.0, workdir: Optional[str] = None,
+                 git_dir: Optional[str] = None, quiescence_seconds: float = QUIESCENCE_PERIOD_SECONDS):
+        if speed <= 0:
+            raise ValueError("speed must be positive")
+        self.events = events
+        self.speed = speed
+        self.workdir = Path(workdir or tempfile.mkdtemp(prefix="replay_"))
+        self.git_dir = git_dir
+        self.quiescence_seconds = quiescence_seconds
+        self.report = ReplayReport(events=len(events), speed=speed)
+        self._inflight = 0
+        self._link_saved_at: Dict[str, float] = {}
+        self._reader: Optional[sqlite3.Connection] = None
+
+    async def _content_for(self, event: ReplayEvent) -> Optional[str]:
+        if event.content is not None or not event.blob:
+            return event.content
+        raw = await _git(self.git_dir or event.request.repo_path, "cat-file", "blob", event.blob)
+        return raw.decode("utf-8", errors="ignore")
+
+    def _rewrite(self, request: FileProcessingRequest) -> FileProcessingRequest:
+        """Points the request at the replay workspace; only the relative path matters to the graph."""
+        relative_path = Path(request.absolute_path).relative_to(request.repo_path)
+        repo_root = self.workdir / "repo"
+        return request.model_copy(update={"repo_path": str(repo_root), "absolute_path": str(repo_root / relative_path)})
+
+    def _pending_links(self, repo_id_with_branch: str, relative_path: Optional[str] = None) -> Dict[str, str]:
+        # A separate read connection keeps the harness's own queries out of the backend's op counts.
+        sql = "SELECT slug_id, status FROM nodes WHERE node_type = 'PendingLink' AND repo_id_str = ?"
+        params = [repo_id_with_branch]
+        if relative_path is not None:
+            sql += " AND relative_path_str = ?"
+            params.append(relative_path)
+        return dict(self._reader.execute(sql, params).fetchall())
+
+    def _check_links(self, repo_id_with_branch: str):
+        now = time.perf_counter()
+        pending = self._pending_links(repo_id_with_branch)
+        for link_id, saved_at in list(self._link_saved_at.items()):
+            status = pending.get(link_id)
+            if status is None:
+                resolved = self._reader.execute("SELECT 1 FROM nodes WHERE slug_id = ? AND node_type = 'ResolutionCache'", (link_id,)).fetchone()
+                if resolved:
+                    self.report.link_latency.append(now - saved_at)
+                else:
+                    self.report.links_superseded += 1  # Deleted by a re-save of its file before it resolved.
+            elif status == LinkStatus.UNRESOLVABLE.value:
+                self.report.links_unresolvable += 1
+            else:
+                continue
+            del self._link_saved_at[link_id]
+
+    async def _ingest(self, event: ReplayEvent, saved_at: float):
+        from . import orchestrator
+        request = self._rewrite(event.request)
+        self._inflight += 1
+        self.report.max_inflight = max(self.report.max_inflight, self._inflight)
+        try:
+            preloaded = None
+            if not request.is_delete:
+                content = await self._content_for(event) or ""
+                raw = content.encode("utf-8")
+                preloaded = BulkReadResult(request.absolute_path, content, hashlib.sha256(raw).hexdigest(), len(raw))
+            if not await orchestrator.process_single_file(request, preloaded):
+                self.report.failures += 1
+                return
+        except Exception as e:
+            self.report.failures += 1
+            logger.error(f"REPLAY: Failed to replay {event.request.absolute_path}: {e}", exc_info=True)
+            return
+        finally:
+            self._inflight -= 1
+        self.report.ingest_latency.append(time.perf_counter() - saved_at)
+        repo_id_with_branch = f"{request.repo_id}@{request.branch}"
+        relative_path = str(Path(request.absolute_path).relative_to(request.repo_path))
+        for link_id in self._pending_links(repo_id_with_branch, relative_path):
+            if link_id not in self._link_saved_at:
+                self._link_saved_at[link_id] = saved_at
+                self.report.links_created += 1
+        self._check_links(repo_id_with_branch)
+
+    def _instrument_dispatcher(self, dispatcher):
+        original_notify = dispatcher.notify_ingestion_activity
+        original_cycle = dispatcher._run_full_enhancement_cycle
+
+        async def notify(repo_id_with_branch, entities):
+            if repo_id_with_branch in dispatcher.watched_repos:
+                self.report.timer_resets += 1
+            await original_notify(repo_id_with_branch, entities)
+            self.report.max_timers = max(self.report.max_timers, len(dispatcher.watched_repos))
+
+        async def cycle(repo_id_with_branch):
+            self.report.enhancement_cycles += 1
+            await original_cycle(repo_id_with_branch)
+            self._check_links(repo_id_with_branch)
+
+        dispatcher.notify_ingestion_activity = notify
+        dispatcher._run_full_enhancement_cycle = cycle
+
+    async def run(self) -> ReplayReport:
+        from . import dispatcher as dispatcher_module, graph_utils, local_graph_backend, orchestrator
+        from .local_graph_backend import LocalGraphBackend
+
+        backend = LocalGraphBackend(str(self.workdir / "graph.db"))
+        self._reader = sqlite3.connect(backend.path)
+        saved = (graph_utils.GRAPH_BACKEND, local_graph_backend._instance, dispatcher_module._dispatcher_instance,
+                 dispatcher_module.QUIESCENCE_PERIOD_SECONDS, orchestrator.get_recorder)
+        graph_utils.GRAPH_BACKEND = "local"
+        local_graph_backend._instance = backend
+        dispatcher_module.QUIESCENCE_PERIOD_SECONDS = self.quiescence_seconds / self.speed
+        dispatcher = dispatcher_module._dispatcher_instance = dispatcher_module.IntelligentEnrichmentDispatcher()
+        orchestrator.get_recorder = lambda: None  # Never re-record the replay itself.
+        self._instrument_dispatcher(dispatcher)
+
+        logger.info(f"REPLAY: Replaying {len(self.events)} requests at {self.speed}x (quiescence {self.quiescence_seconds / self.speed:.2f}s).")
+        start = time.perf_counter()
+        tasks: List[asyncio.Task] = []
+        try:
+            for event in self.events:
+                delay = start + event.offset / self.speed - time.perf_counter()
+                if delay > 0:
+                    await asyncio.sleep(delay)
+                tasks.append(asyncio.create_task(self._ingest(event, time.perf_counter())))
+            await asyncio.gather(*tasks)
+            # Let every quiescence timer fire so link resolution is part of the measurement.
+            while dispatcher.watched_repos:
+                await asyncio.gather(*list(dispatcher.watched_repos.values()), return_exceptions=True)
+            for repo_id_with_branch in {f"{e.request.repo_id}@{e.request.branch}" for e in self.events}:
+                self._check_links(repo_id_with_branch)
+        finally:
+            self.report.wall_seconds = round(time.perf_counter() - start, 4)
+            self.report.links_outstanding = len(self._link_saved_at)
+            self.report.db_ops = dict(backend.op_counts)
+            (graph_utils.GRAPH_BACKEND, local_graph_backend._instance, dispatcher_module._dispatcher_instance,
+             dispatcher_module.QUIESCENCE_PERIOD_SECONDS, orchestrator.get_recorder) = saved
+            self._reader.close()
+            backend.close()
+        return self.report
+
+def _print_report(report: ReplayReport):
+    summary = report.summary()
+    print(f"Replayed {report.events} requests at {report.speed}x in {report.wall_seconds:.2f}s ({report.failures} failed)")
+    for name in ("ingest_latency", "link_latency"):
+        stats = summary[name]
+        line = "  ".join(f"{k}={v}" for k, v in stats.items())
+        print(f"  {name:15s} {line}")
+    print(f"  links           created={report.links_created} unresolvable={report.links_unresolvable} superseded={report.links_superseded} outstanding={report.links_outstanding}")
+    print(f"  queues          max_inflight={report.max_inflight} max_timers={report.max_timers} timer_resets={report.timer_resets} enhancement_cycles={report.enhancement_cycles}")
+    print(f"  db_ops          " + "  ".join(f"{k}={v}" for k, v in sorted(report.db_ops.items())))
+
+def main(argv: Optional[List[str]] = None) -> int:
+    arg_parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    arg_parser.add_argument("trace", help="NDJSON trace written with INGEST_RECORD_PATH.")
+    arg_parser.add_argument("--speed", type=float, default=1.0, help="Replay speed factor, e.g. 1 to 100.")
+    arg_parser.add_argument("--workdir", default=None, help="Where the replay graph database goes (default: a temp dir, removed afterwards).")
+    arg_parser.add_argument("--git-dir", default=None, help="Repository holding recorded blobs, if it moved since recording.")
+    arg_parser.add_argument("--quiescence", type=float, default=QUIESCENCE_PERIOD_SECONDS, help="Live quiescence period in seconds (scaled by --speed).")
+    arg_parser.add_argument("--json", dest="json_out", default=None, help="Also write the report as JSON.")
+    arg_parser.add_argument("--metrics-port", type=int, default=METRICS_PORT, help="Serve /metrics and /metrics.json on this port while replaying (0 disables).")
+    args = arg_parser.parse_args(argv)
+
+    events = load_trace(args.trace)
+    if not events:
+        logger.error(f"REPLAY: Trace {args.trace} is empty.")
+        return 2
+    harness = ReplayHarness(events, args.speed, args.workdir, args.git_dir, args.quiescence)
+
+    async def _run() -> ReplayReport:
+        metrics_server = await start_metrics_server(port=args.metrics_port) if args.metrics_port else None
+        try:
+            return await harness.run()
+        finally:
+            if metrics_server:
+                metrics_server.close()
+    try:
+        report = asyncio.run(_run())
+    finally:
+        if args.workdir is None:
+            shutil.rmtree(harness.workdir, ignore_errors=True)
+    _print_report(report)
+    if args.json_out:
+        with open(args.json_out, "w", encoding="utf-8") as f:
+            json.dump(report.summary(), f, indent=2)
+    return 1 if report.failures else 0
+
+if __name__ == "__main__":
+    sys.exit(main())
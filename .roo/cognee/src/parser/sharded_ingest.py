@@ -0,0 +1,375 @@
+# .roo/cognee/src/parser/sharded_ingest.py
+"""
+Multi-process sharded ingestion. A coordinator shards a repository's files by path hash across
+worker processes; workers read and parse their shard and stream islands back over a socket; the
+coordinator group-commits them through an IslandSink and aggregates progress and failures.
+
+Usage (from .roo/cognee):
+    python -m src.parser.sharded_ingest /path/to/repo --repo-id org/repo --branch main --commit-index 42 -w 8
+"""
+import argparse
+import asyncio
+import hashlib
+import json
+import multiprocessing
+import os
+import struct
+import sys
+import tempfile
+import time
+from dataclasses import dataclass, field
+from typing import Collection, Dict, List, Optional, Protocol, Sequence, Set, Tuple
+
+from .configs import (
+    SHARDED_INGEST_WORKERS, SHARDED_INGEST_GROUP_COMMIT_SIZE,
+    SHARDED_INGEST_GROUP_COMMIT_MAX_DELAY, SHARDED_INGEST_QUEUE_SIZE, INGEST_JOURNAL_PATH, METRICS_PORT,
+)
+from .extraction import FileIsland, records_to_islands
+from .ingest_journal import FileState, IngestJournal, JournalEntry
+from .metrics import INGEST_QUEUE_DEPTH, start_metrics_server
+from .utils import logger
+
+# --- Wire Protocol ---
+# Frames are a 4-byte big-endian length followed by a UTF-8 JSON object. Addresses are
+# "unix:/path/to.sock" or "tcp:host:port", so workers can move off-box without protocol changes.
+
+_FRAME_HEADER = struct.Struct(">I")
+
+async def _send_frame(writer: asyncio.StreamWriter, message: dict):
+    payload = json.dumps(message, ensure_ascii=False, separators=(",", ":")).encode("utf-8")
+    writer.write(_FRAME_HEADER.pack(len(payload)) + payload)
+    await writer.drain()
+
+async def _read_frame(reader: asyncio.StreamReader) -> Optional[dict]:
+    try:
+        header = await reader.readexactly(_FRAME_HEADER.size)
+        (length,) = _FRAME_HEADER.unpack(header)
+        return json.loads(await reader.readexactly(length))
+    except asyncio.IncompleteReadError:
+        return None
+
+def _parse_address(address: str) -> Tuple[str, Tuple]:
+    scheme, _, rest = address.partition(":")
+    if scheme == "unix":
+        return "unix", (rest,)
+    if scheme == "tcp":
+        host, _, port = rest.rpartition(":")
+        return "tcp", (host, int(port))
+    raise ValueError(f"Unsupported address '{address}'; expected unix:<path> or tcp:<host>:<port>.")
+
+async def _open_connection(address: str):
+    kind, args = _parse_address(address)
+    if kind == "unix":
+        return await asyncio.open_unix_connection(*args)
+    return await asyncio.open_connection(*args)
+
+async def _start_server(address: str, handler):
+    kind, args = _parse_address(address)
+    if kind == "unix":
+        return await asyncio.start_unix_server(handler, *args)
+    return await asyncio.start_server(handler, *args)
+
+def shard_for_path(relative_path: str, num_shards: int) -> int:
+    """Stable across processes and runs (unlike hash()), so a file always lands on the same shard."""
+    digest = hashlib.blake2b(relative_path.encode("utf-8"), digest_size=8).digest()
+    return int.from_bytes(digest, "big") % num_shards
+
+# --- Sinks ---
+
+class IslandSink(Protocol):
+    async def commit(self, islands: List[FileIsland], redo: Collection[str] = ()) -> None:
+        """Saves `islands` together. Paths in `redo` must be re-ingested even if the graph already holds their content."""
+
+class GraphIslandSink:
+    """Commits each group in one graph transaction via the orchestrator."""
+    def __init__(self, repo_path: str, repo_id: str, branch: str, import_id: Optional[str] = None):
+        from .entities import Repository
+        self.repository = Repository(id=f"{repo_id}@{branch}", path=repo_path, repo_id=repo_id, branch=branch, import_id=import_id)
+        self.saved_entities = []
+
+    async def commit(self, islands: List[FileIsland], redo: Collection[str] = ()) -> None:
+        from .orchestrator import commit_island_group
+        self.saved_entities.extend(await commit_island_group(self.repository, islands, redo))
+
+    async def notify_dispatcher(self):
+        if self.saved_entities:
+            from .dispatcher import get_dispatcher
+            await get_dispatcher().notify_ingestion_activity(self.repository.id, self.saved_entities)
+
+# --- Progress ---
+
+@dataclass
+class ShardProgress:
+    assigned: int = 0
+    extracted: int = 0
+    failed: int = 0
+    finished: bool = False
+
+@dataclass
+class ShardedIngestReport:
+    shards: Dict[int, ShardProgress] = field(default_factory=dict)
+    committed: int = 0
+    commit_groups: int = 0
+    skipped: int = 0
+    failures: List[Tuple[str, str]] = field(default_factory=list)
+    elapsed_seconds: float = 0.0
+
+    @property
+    def files_total(self) -> int:
+        return sum(s.assigned for s in self.shards.values())
+
+    @property
+    def files_per_second(self) -> float:
+        return self.committed / self.elapsed_seconds if self.elapsed_seconds else 0.0
+
+# --- Worker ---
+
+async def _worker_loop(address: str, shard_index: int):
+    from .extract_cli import ExtractionError, extract_file_records
+    from .parser_registry import prewarm_from_config
+    prewarm_from_config()
+    reader, writer = await _open_connection(address)
+    await _send_frame(writer, {"type": "hello", "shard": shard_index})
+    assignment = await _read_frame(reader)
+    if not assignment or assignment.get("type") != "assign":
+        logger.error(f"SHARDED_INGEST(worker {shard_index}): No assignment received; exiting.")
+        return
+    for absolute_path, relative_path in assignment["files"]:
+        try:
+            records, size, mtime_ns = await extract_file_records(absolute_path, relative_path, assignment["repo_id"], assignment["branch"], assignment["commit_index"])
+            await _send_frame(writer, {"type": "island", "records": records, "size": size, "mtime_ns": mtime_ns})
+        except ExtractionError as e:
+            await _send_frame(writer, {"type": "failure", "path": relative_path, "error": str(e)})
+    await _send_frame(writer, {"type": "finished"})
+    writer.close()
+    await writer.wait_closed()
+
+def _worker_main(address: str, shard_index: int, num_workers: int):
+    from .parsers.cpp_parser import set_extraction_worker_budget
+    set_extraction_worker_budget(num_workers)
+    asyncio.run(_worker_loop(address, shard_index))
+
+# --- Coordinator ---
+
+_STOP = object()
+
+class ShardedIngestCoordinator:
+    def __init__(
+        self,
+        sink: IslandSink,
+        num_workers: int = SHARDED_INGEST_WORKERS,
+        address: Optional[str] = None,
+        group_commit_size: int = SHARDED_INGEST_GROUP_COMMIT_SIZE,
+        group_commit_max_delay: float = SHARDED_INGEST_GROUP_COMMIT_MAX_DELAY,
+        journal: Optional[IngestJournal] = None,
+    ):
+        self.sink = sink
+        self.journal = journal
+        self._journal_parsed: List[JournalEntry] = []
+        self._redo: Set[str] = set()
+        self._file_stats: Dict[str, Tuple[int, int]] = {}
+        self.num_workers = max(1, num_workers)
+        self._tmp_dir: Optional[str] = None
+        if address is None:
+            self._tmp_dir = tempfile.mkdtemp(prefix="sharded_ingest_")
+            address = f"unix:{os.path.join(self._tmp_dir, 'coordinator.sock')}"
+        self.address = address
+        self.group_commit_size = group_commit_size
+        self.group_commit_max_delay = group_commit_max_delay
+        self.report = ShardedIngestReport()
+        self._queue: asyncio.Queue = asyncio.Queue(maxsize=SHARDED_INGEST_QUEUE_SIZE)
+        self._assignments: Dict[int, List[Tuple[str, str]]] = {}
+        self._connected: Dict[int, asyncio.Event] = {}
+        self._drained: Dict[int, asyncio.Event] = {}
+        self._job: dict = {}
+
+    def _plan(self, files: Sequence[Tuple[str, str]]):
+        self._assignments = {i: [] for i in range(self.num_workers)}
+        for absolute_path, relative_path in files:
+            self._assignments[shard_for_path(relative_path, self.num_workers)].append((absolute_path, relative_path))
+        self.report.shards = {i: ShardProgress(assigned=len(f)) for i, f in self._assignments.items()}
+        self._connected = {i: asyncio.Event() for i in self._assignments}
+        self._drained = {i: asyncio.Event() for i in self._assignments}
+
+    def _fail_outstanding(self, shard: int, reason: str):
+        """Files are processed in assignment order, so everything past the last report is outstanding."""
+        progress = self.report.shards[shard]
+        reported = progress.extracted + progress.failed
+        outstanding = self._assignments[shard][reported:]
+        if outstanding:
+            logger.error(f"SHARDED_INGEST: Shard {shard}: {reason}; {len(outstanding)} files outstanding.")
+            self.report.failures.extend((relative_path, reason) for _, relative_path in outstanding)
+            self._journal_failures((relative_path, reason) for _, relative_path in outstanding)
+            progress.failed += len(outstanding)
+
+    def _journal_failures(self, failures):
+        if self.journal:
+            self.journal.record(JournalEntry(rel, FileState.FAILED, error=reason) for rel, reason in failures)
+
+    async def _handle_worker(self, reader: asyncio.StreamReader, writer: asyncio.StreamWriter):
+        hello = await _read_frame(reader)
+        if not hello or hello.get("type") != "hello" or hello.get("shard") not in self._assignments:
+            writer.close()
+            return
+        shard = hello["shard"]
+        progress = self.report.shards[shard]
+        self._connected[shard].set()
+        try:
+            await _send_frame(writer, {"type": "assign", "files": self._assignments[shard], **self._job})
+            while True:
+                message = await _read_frame(reader)
+                if message is None:
+                    break
+                if message["type"] == "island":
+                    for island in records_to_islands(message["records"]):
+                        if self.journal:
+                            self._journal_parsed.append(JournalEntry(island.source_file.relative_path, FileState.PARSED, message["size"], message["mtime_ns"], island.source_file.content_hash))
+                        await self._queue.put(island)
+                    progress.extracted += 1
+                elif message["type"] == "failure":
+                    progress.failed += 1
+                    self.report.failures.append((message["path"], message["error"]))
+                    self._journal_failures([(message["path"], message["error"])])
+                elif message["type"] == "finished":
+                    progress.finished = True
+                    break
+            if not progress.finished:
+                self._fail_outstanding(shard, "worker disconnected before finishing")
+        finally:
+            writer.close()
+            self._drained[shard].set()
+
+    async def _group_committer(self):
+        group: List[FileIsland] = []
+        while True:
+            try:
+                timeout = self.group_commit_max_delay if group else None
+                island = await asyncio.wait_for(self._queue.get(), timeout)
+            except asyncio.TimeoutError:
+                island = None
+            if island is not None and island is not _STOP:
+                group.append(island)
+            if group and (island is None or island is _STOP or len(group) >= self.group_commit_size):
+                await self._commit(group)
+                group = []
+            if island is _STOP:
+                return
+
+    async def _commit(self, group: List[FileIsland]):
+        if self.journal and self._journal_parsed:
+            self.journal.record(self._journal_parsed)
+            self._journal_parsed = []
+        try:
+            await self.sink.commit(group, {i.source_file.relative_path for i in group} & self._redo)
+        except Exception as e:
+            if len(group) == 1:
+                logger.error(f"SHARDED_INGEST: Commit of {group[0].source_file.relative_path} failed: {e}", exc_info=True)
+                failures = [(group[0].source_file.relative_path, f"commit failed: {e}")]
+                self.report.failures.extend(failures)
+                self._journal_failures(failures)
+                return
+            # One bad file should not fail its neighbours: retry the group one file per transaction. The failed
+            # group may have been partly written where transactions cannot roll back, so its files are redone.
+            logger.warning(f"SHARDED_INGEST: Group commit of {len(group)} files failed ({e}); retrying them one by one.")
+            self._redo.update(i.source_file.relative_path for i in group)
+            for island in group:
+                await self._commit([island])
+            return
+        self.report.committed += len(group)
+        self.report.commit_groups += 1
+        if self.journal:
+            self.journal.record(JournalEntry(i.source_file.relative_path, FileState.COMMITTED) for i in group)
+
+    async def _log_progress(self, interval: float):
+        while True:
+            await asyncio.sleep(interval)
+            extracted = sum(s.extracted for s in self.report.shards.values())
+            failed = sum(s.failed for s in self.report.shards.values())
+            logger.info(f"SHARDED_INGEST: {extracted + failed}/{self.report.files_total} files extracted ({failed} failed), {self.report.committed} committed.")
+
+    async def run(self, files: Sequence[Tuple[str, str]], repo_id: str, branch: str, commit_index: int, progress_interval: float = 5.0) -> ShardedIngestReport:
+        start = time.time()
+        if self.journal:
+            files, self.report.skipped = self.journal.filter_pending(files)
+            self._redo = self.journal.incomplete_files()
+        self._plan(files)
+        self._job = {"repo_id": repo_id, "branch": branch, "commit_index": commit_index}
+        server = await _start_server(self.address, self._handle_worker)
+        committer = asyncio.create_task(self._group_committer())
+        INGEST_QUEUE_DEPTH.set_function(self._queue.qsize, queue="sharded_commit")
+        progress_logger = asyncio.create_task(self._log_progress(progress_interval))
+        ctx = multiprocessing.get_context("spawn")
+        processes = [ctx.Process(target=_worker_main, args=(self.address, i, self.num_workers), daemon=True) for i in range(self.num_workers)]
+        try:
+            for p in processes:
+                p.start()
+            loop = asyncio.get_running_loop()
+            await asyncio.gather(*(loop.run_in_executor(None, p.join) for p in processes))
+            for shard, process in enumerate(processes):
+                try:
+                    # A worker that exited may still have a connection waiting in the accept backlog.
+                    await asyncio.wait_for(self._connected[shard].wait(), timeout=5.0)
+                except asyncio.TimeoutError:
+                    self._fail_outstanding(shard, f"worker never connected (exit code {process.exitcode})")
+                    continue
+                await self._drained[shard].wait()
+            await self._queue.put(_STOP)
+            await committer
+        finally:
+            progress_logger.cancel()
+            INGEST_QUEUE_DEPTH.set_function(None, queue="sharded_commit")
+            server.close()
+            await server.wait_closed()
+            for p in processes:
+                if p.is_alive():
+                    p.terminate()
+            if self._tmp_dir:
+                try:
+                    os.unlink(os.path.join(self._tmp_dir, "coordinator.sock"))
+                    os.rmdir(self._tmp_dir)
+                except OSError:
+                    pass
+        self.report.elapsed_seconds = time.time() - start
+        logger.info(f"SHARDED_INGEST: Done. {self.report.committed}/{self.report.files_total} files committed in {self.report.commit_groups} groups, {len(self.report.failures)} failures, {self.report.files_per_second:.1f} files/s.")
+        return self.report
+
+
+async def run_sharded_ingest(repo_path: str, repo_id: str, branch: str, commit_index: int, num_workers: int = SHARDED_INGEST_WORKERS, sink: Optional[IslandSink] = None, languages: str = "all", address: Optional[str] = None, journal_path: Optional[str] = None) -> ShardedIngestReport:
+    from .extract_cli import select_files
+    graph_sink = sink or GraphIslandSink(repo_path, repo_id, branch)
+    files = select_files(os.path.abspath(repo_path), languages)
+    journal = IngestJournal(journal_path, f"{repo_id}@{branch}", commit_index) if journal_path else None
+    try:
+        report = await ShardedIngestCoordinator(graph_sink, num_workers, address, journal=journal).run(files, repo_id, branch, commit_index)
+    finally:
+        if journal:
+            journal.close()
+    if isinstance(graph_sink, GraphIslandSink):
+        await graph_sink.notify_dispatcher()
+    return report
+
+def main(argv: Optional[List[str]] = None) -> int:
+    arg_parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    arg_parser.add_argument("repo_path")
+    arg_parser.add_argument("--repo-id", required=True)
+    arg_parser.add_argument("--branch", required=True)
+    arg_parser.add_argument("--commit-index", type=int, required=True)
+    arg_parser.add_argument("-w", "--workers", type=int, default=SHARDED_INGEST_WORKERS)
+    arg_parser.add_argument("--languages", default="all")
+    arg_parser.add_argument("--address", default=None, help="unix:<path> or tcp:<host>:<port> (default: private Unix socket).")
+    arg_parser.add_argument("--journal", default=INGEST_JOURNAL_PATH or None, help="SQLite progress journal; a rerun resumes after the last committed files.")
+    arg_parser.add_argument("--metrics-port", type=int, default=METRICS_PORT, help="Serve /metrics and /metrics.json on this port while ingesting (0 disables).")
+    args = arg_parser.parse_args(argv)
+
+    async def _run() -> ShardedIngestReport:
+        metrics_server = await start_metrics_server(port=args.metrics_port) if args.metrics_port else None
+        try:
+            return await run_sharded_ingest(args.repo_path, args.repo_id, args.branch, args.commit_index, args.workers, languages=args.languages, address=args.address, journal_path=args.journal)
+        finally:
+            if metrics_server:
+                metrics_server.close()
+    report = asyncio.run(_run())
+    return 1 if report.failures else 0
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,280 @@
+# .roo/cognee/src/parser/symbol_index.py
+"""
+In-process exact-identifier index over CodeEntities, per repo@branch. Answers identifier-shaped
+queries ("where is `Widget::resize` defined") without a vector search.
+
+Each entity is indexed by its qualified name (canonical FQN without the parameter list), every
+trailing run of its '::' segments ("resize", "Widget::resize", "app::Widget::resize") and its
+normalized parameter signature. Lookups try, in order: exact, case-insensitive exact,
+segment-suffix, then prefix of the qualified name or of the last segment.
+
+The orchestrator adds a file's entities after saving its island; path deletes (re-ingest or
+delete) remove them. A repository is scanned from the graph on first lookup, so entities saved by
+an earlier process are found too, and rescanned when another process has written to it since
+(see graph_versions.SeedStamps).
+"""
+import bisect
+import re
+from dataclasses import asdict, dataclass
+from typing import Dict, Iterable, List, Optional, Set, Tuple
+
+from .graph_versions import SeedStamps, get_graph_versions
+from .utils import logger
+
+# Identifier-shaped text: 'name', 'ns::Class::method', '~Class', 'Tpl<int>::f(int, char*)'.
+IDENTIFIER_RE = re.compile(r"^~?[A-Za-z_]\w*(?:<[^()]*>)?(?:::~?[A-Za-z_]\w*(?:<[^()]*>)?)*(?:\s*\([^()]*\)(?:\s*const)?)?$")
+_QUALIFIED_IN_TEXT_RE = re.compile(r"~?[A-Za-z_]\w*(?:<[^()\s]*>)?(?:::~?[A-Za-z_]\w*(?:<[^()\s]*>)?)+(?:\([^()]*\))?")
+_BACKTICKED_RE = re.compile(r"`([^`]+)`")
+_TEMPLATE_ARGS_RE = re.compile(r"<[^<>]*>")
+_MATCH_RANK = {"exact": 0, "exact_ci": 1, "segment_suffix": 2, "prefix": 3, "name_prefix": 4}
+
+def split_signature(fqn: str) -> Tuple[str, str]:
+    """'app::f(int a)' -> ('app::f', '(int a)'); operator() and names without parameters are kept whole."""
+    depth = 0
+    for i, ch in enumerate(fqn):
+        if ch == "<": depth += 1
+        elif ch == ">": depth = max(0, depth - 1)
+        elif ch == "(" and depth == 0 and not fqn[:i].endswith("operator"):
+            return fqn[:i].strip(), fqn[i:].strip()
+    return fqn.strip(), ""
+
+def normalize_signature(params: str) -> str:
+    """'(const std::string & name, int n = 3)' -> '(const std::string&,int)': no names, defaults or spacing."""
+    inner = params.strip()
+    if not inner.startswith("("):
+        return ""
+    close = inner.rfind(")")
+    body, suffix = inner[1:close], inner[close + 1:].strip()
+    parts, depth, current = [], 0, ""
+    for ch in body:
+        if ch in "<([": depth += 1
+        elif ch in ">)]": depth -= 1
+        if ch == "," and depth == 0:
+            parts.append(current); current = ""
+        else:
+            current += ch
+    parts.append(current)
+    normalized = []
+    for part in parts:
+        part = part.split("=", 1)[0].strip()
+        part = re.sub(r"\s*([*&<>,:])\s*", r"\1", " ".join(part.split()))
+        words = part.split(" ")
+        # A trailing plain identifier after a type is the parameter name ('int n', 'char* s').
+        if len(words) > 1 and re.fullmatch(r"[A-Za-z_]\w*", words[-1]) and words[-1] not in ("const", "volatile", "int", "long", "short", "char", "double", "unsigned", "signed"):
+            part = " ".join(words[:-1])
+        elif re.search(r"[*&]\w+$", part):
+            part = re.sub(r"(?<=[*&])\w+$", "", part)
+        if part and part != "void":
+            normalized.append(part)
+    return "(" + ",".join(normalized) + ")" + (" " + suffix if suffix else "")
+
+def name_segments(qualified_name: str) -> List[str]:
+    """'app::Box<Vec<int>>::get' -> ['app', 'Box', 'get']."""
+    stripped = None
+    while stripped != qualified_name:
+        stripped, qualified_name = qualified_name, _TEMPLATE_ARGS_RE.sub("", qualified_name)
+    return [s for s in qualified_name.split("::") if s]
+
+def extract_identifiers(text: str) -> List[str]:
+    """Identifier-shaped candidates in a query: backticked spans, then qualified names, then the whole query."""
+    text = (text or "").strip()
+    candidates = [c.strip() for c in _BACKTICKED_RE.findall(text) if IDENTIFIER_RE.match(c.strip())]
+    if not candidates:
+        candidates = _QUALIFIED_IN_TEXT_RE.findall(text)
+    if not candidates and IDENTIFIER_RE.match(text):
+        candidates = [text]
+    return list(dict.fromkeys(candidates))
+
+def locate(entity_id: str) -> Tuple[str, str]:
+    """(repo@branch, relative path) of a composite node ID."""
+    parts = entity_id.split("|", 2)
+    return parts[0], parts[1].rsplit("@", 1)[0] if len(parts) > 1 else ""
+
+@dataclass(frozen=True)
+class Symbol:
+    entity_id: str
+    repo: str
+    path: str
+    canonical_fqn: str
+    qualified_name: str
+    signature: str
+    entity_type: str
+    start_line: int = 0
+    end_line: int = 0
+
+    @property
+    def name(self) -> str:
+        segments = name_segments(self.qualified_name)
+        return segments[-1] if segments else self.qualified_name
+
+    def to_dict(self) -> dict:
+        return {**asdict(self), "name": self.name}
+
+    @classmethod
+    def from_entity(cls, entity_id: str, canonical_fqn: Optional[str], entity_type: str, start_line: int = 0, end_line: int = 0) -> Optional["Symbol"]:
+        fqn = canonical_fqn or entity_id.rsplit("|", 1)[-1].split("@")[0]
+        if not fqn:
+            return None
+        repo, path = locate(entity_id)
+        qualified_name, params = split_signature(fqn)
+        return cls(entity_id, repo, path, fqn, qualified_name, normalize_signature(params), entity_type or "", start_line or 0, end_line or 0)
+
+class _RepoSymbols:
+    def __init__(self):
+        self.exact: Dict[str, Set[str]] = {}
+        self.exact_ci: Dict[str, Set[str]] = {}
+        self.suffix_ci: Dict[str, Set[str]] = {}
+        self.sorted_ci: List[Tuple[str, str]] = []        # (lower qualified name, entity ID), for prefix scans
+        self.sorted_names_ci: List[Tuple[str, str]] = []  # (lower last segment, entity ID)
+        self.by_path: Dict[str, Set[str]] = {}
+
+    def keys_for(self, symbol: Symbol) -> Iterable[Tuple[Dict[str, Set[str]], str]]:
+        yield self.exact, symbol.qualified_name
+        yield self.exact_ci, symbol.qualified_name.lower()
+        segments = [s.lower() for s in name_segments(symbol.qualified_name)]
+        for i in range(len(segments)):
+            yield self.suffix_ci, "::".join(segments[i:])
+
+class SymbolIndex:
+    def __init__(self):
+        self._symbols: Dict[str, Symbol] = {}
+        self._repos: Dict[str, _RepoSymbols] = {}
+        self._seeded = SeedStamps()
+
+    def __len__(self) -> int:
+        return len(self._symbols)
+
+    def _repo(self, repo: str) -> _RepoSymbols:
+        if repo not in self._repos:
+            self._repos[repo] = _RepoSymbols()
+        return self._repos[repo]
+
+    # --- Maintenance ---
+
+    def add(self, symbol: Symbol):
+        self.remove(symbol.entity_id)
+        self._symbols[symbol.entity_id] = symbol
+        repo = self._repo(symbol.repo)
+        for table, key in repo.keys_for(symbol):
+            table.setdefault(key, set()).add(symbol.entity_id)
+        bisect.insort(repo.sorted_ci, (symbol.qualified_name.lower(), symbol.entity_id))
+        bisect.insort(repo.sorted_names_ci, (symbol.name.lower(), symbol.entity_id))
+        repo.by_path.setdefault(symbol.path, set()).add(symbol.entity_id)
+
+    def remove(self, entity_id: str):
+        symbol = self._symbols.pop(entity_id, None)
+        if symbol is None:
+            return
+        repo = self._repos[symbol.repo]
+        for table, key in repo.keys_for(symbol):
+            ids = table.get(key)
+            if ids is not None:
+                ids.discard(entity_id)
+                if not ids: del table[key]
+        for sorted_list, key in ((repo.sorted_ci, symbol.qualified_name.lower()), (repo.sorted_names_ci, symbol.name.lower())):
+            i = bisect.bisect_left(sorted_list, (key, entity_id))
+            if i < len(sorted_list) and sorted_list[i] == (key, entity_id):
+                del sorted_list[i]
+        path_ids = repo.by_path.get(symbol.path)
+        if path_ids is not None:
+            path_ids.discard(entity_id)
+            if not path_ids: del repo.by_path[symbol.path]
+
+    def add_entities(self, entities: Iterable) -> int:
+        """Indexes CodeEntity models (or anything with id/canonical_fqn/type/start_line/end_line)."""
+        added = 0
+        for entity in entities:
+            if symbol := Symbol.from_entity(entity.id, entity.canonical_fqn, entity.type, entity.start_line, entity.end_line):
+                self.add(symbol); added += 1
+        return added
+
+    def remove_path(self, repo: str, relative_path: str):
+        repo_symbols = self._repos.get(repo)
+        if repo_symbols is None:
+            return
+        for entity_id in list(repo_symbols.by_path.get(relative_path, ())):
+            self.remove(entity_id)
+
+    def seed(self, repo: str, entity_nodes: List) -> int:
+        """Replaces a repository's symbols with a scan of its CodeEntity nodes."""
+        for entity_id in [i for i, s in self._symbols.items() if s.repo == repo]:
+            self.remove(entity_id)
+        for node in entity_nodes:
+            a = node.attributes
+            if symbol := Symbol.from_entity(node.id, a.get("canonical_fqn"), a.get("type"), a.get("start_line"), a.get("end_line")):
+                self.add(symbol)
+        return len(entity_nodes)
+
+    async def ensure_seeded(self, repos: Optional[Iterable[str]] = None, refresh: bool = False):
+        """Scans the given repositories (default: every known one) from the graph unless their seed is current."""
+        from .graph_utils import find_nodes_with_filter
+        if repos is None:
+            repos = await get_graph_versions().known_repos()
+        for repo in repos:
+            if (version := await self._seeded.due(repo, refresh)) is None:
+                continue
+            entity_nodes = await find_nodes_with_filter({"type": "CodeEntity", "repo_id_str": repo})
+            logger.info(f"SYMBOL_INDEX({repo}): Seeded {self.seed(repo, entity_nodes)} code entities from the graph.")
+            self._seeded.stamp(repo, version)
+
+    # --- Lookup ---
+
+    def repos(self, scopes: Optional[Iterable[str]] = None) -> List[str]:
+        """Indexed repositories, or those whose repo@branch key starts with one of `scopes`."""
+        if scopes is None:
+            return sorted(self._repos)
+        prefixes = [s.strip("/") for s in scopes if s and s.strip("/")]
+        return sorted(r for r in self._repos if any(r == p or r.startswith(p + "@") for p in prefixes))
+
+    def _match_repo(self, repo: _RepoSymbols, qualified_name: str) -> Tuple[str, Set[str]]:
+        lower = qualified_name.lower()
+        if ids := repo.exact.get(qualified_name):
+            return "exact", ids
+        if ids := repo.exact_ci.get(lower):
+            return "exact_ci", ids
+        suffix_key = "::".join(name_segments(lower))
+        if ids := repo.suffix_ci.get(suffix_key):
+            return "segment_suffix", ids
+        for mode, sorted_list in (("prefix", repo.sorted_ci), ("name_prefix", repo.sorted_names_ci)):
+            i = bisect.bisect_left(sorted_list, (lower, ""))
+            ids = set()
+            while i < len(sorted_list) and sorted_list[i][0].startswith(lower):
+                ids.add(sorted_list[i][1]); i += 1
+            if ids:
+                return mode, ids
+        return "", set()
+
+    def lookup(self, query: str, scopes: Optional[Iterable[str]] = None, limit: int = 20) -> List[dict]:
+        """
+        Matches for one identifier (optionally with a parameter list, which then filters by
+        normalized signature). Results carry their match kind and are ordered by match quality.
+        """
+        qualified_name, params = split_signature(query.strip().strip("`"))
+        signature = normalize_signature(params) if params else ""
+        results: List[Tuple[int, Symbol, str]] = []
+        for repo_key in self.repos(scopes):
+            mode, ids = self._match_repo(self._repos[repo_key], qualified_name)
+            for entity_id in ids:
+                symbol = self._symbols[entity_id]
+                if signature and symbol.signature.split(" ")[0] != signature.split(" ")[0]:
+                    continue
+                results.append((_MATCH_RANK[mode], symbol, mode))
+        results.sort(key=lambda r: (r[0], len(r[1].qualified_name), r[1].repo, r[1].path, r[1].start_line))
+        return [{**symbol.to_dict(), "match": mode} for _, symbol, mode in results[:limit]]
+
+    def search(self, text: str, scopes: Optional[Iterable[str]] = None, limit: int = 20) -> List[dict]:
+        """lookup() for every identifier-shaped candidate in free text; [] when the text names none."""
+        seen, matches = set(), []
+        for candidate in extract_identifiers(text):
+            for match in self.lookup(candidate, scopes, limit):
+                if match["entity_id"] not in seen:
+                    seen.add(match["entity_id"]); matches.append(match)
+        return matches[:limit]
+
+_index: Optional[SymbolIndex] = None
+
+def get_symbol_index() -> SymbolIndex:
+    global _index
+    if _index is None:
+        _index = SymbolIndex()
+    return _index
@@ -0,0 +1,571 @@
+# .roo/cognee/src/parser/trigram_index.py
+"""
+Trigram full-text index over TextChunk content, per repo@branch, for substring and regex code
+search that maps hits back to chunk and CodeEntity IDs.
+
+Each repository has one immutable segment (a memory-mapped file under TRIGRAM_INDEX_DIR, or an
+anonymous map when unset) plus an in-memory delta of chunks saved since the segment was written
+and tombstones for segment chunks that were deleted or replaced. The orchestrator feeds the delta
+per chunk ID through code_indexes; once it grows past TRIGRAM_COMPACT_THRESHOLD the live chunks
+are rewritten into a new segment by a background task, the build and write running in a worker
+thread; chunks changed meanwhile stay in the delta. A repository is built from the graph on first
+search unless its segment on disk records the current stored graph version, and rebuilt once
+another process has written to it (see graph_versions.SeedStamps).
+
+Regex patterns come from clients. The re engine holds the GIL for a whole match, so no thread or
+timeout can interrupt catastrophic backtracking: patterns with its usual causes (a variable
+repeat inside another, backreferences) are refused up front. Accepted patterns are matched in a
+worker thread against a snapshot of the candidate chunks and abandoned, between chunks, after
+TRIGRAM_REGEX_TIMEOUT_SECONDS.
+
+Segment layout (native byte order):
+    header    magic 'TRG1', n_docs (u32), n_trigrams (u32), docs table offset (u32)
+    trigrams  n_trigrams x (key u32, postings offset u32, count u32), sorted by key
+    postings  u32 doc numbers, sorted, one run per trigram
+    docs      n_docs x (content offset u32, content length u32)
+    content   utf-8 chunk text
+The chunk ID, path, start line and entity line ranges of each doc live in a JSON sidecar, with
+the stored graph version the segment's contents correspond to (null when unknown).
+
+Keys are the CRC32 of each lowercased 3-character window, so postings are candidates only;
+every candidate is verified against the content before it is reported.
+"""
+import array
+import asyncio
+import bisect
+import json
+import mmap
+import os
+import re
+import secrets
+import struct
+import time
+import zlib
+from dataclasses import dataclass, field
+from typing import Dict, Iterable, Iterator, List, Optional, Set, Tuple
+
+try:
+    from re import _parser as _sre_parse  # Python 3.11+
+except ImportError:  # pragma: no cover
+    import sre_parse as _sre_parse
+
+from .configs import TRIGRAM_INDEX_DIR, TRIGRAM_COMPACT_THRESHOLD, TRIGRAM_REGEX_TIMEOUT_SECONDS
+from .graph_versions import SeedStamps, get_graph_versions
+from .metrics import TRIGRAM_SEARCH_SECONDS, timed
+from .utils import logger
+
+MAGIC = b"TRG1"
+_HEADER = struct.Struct("=4sIII")
+_TRIGRAM = struct.Struct("=III")
+_DOC = struct.Struct("=II")
+MAX_LINE_CHARS = 300
+
+def trigram_keys(text: str) -> Set[int]:
+    text = text.lower()
+    return {zlib.crc32(text[i:i + 3].encode("utf-8")) for i in range(len(text) - 2)}
+
+def required_literals(pattern: str) -> List[str]:
+    """
+    Literal runs every match of `pattern` must contain ('foo(bar|baz)+qux' -> ['foo', 'qux']).
+    Alternations, classes and optional repeats end a run; [] means no usable literal.
+    """
+    try:
+        parsed = _sre_parse.parse(pattern)
+    except re.error:
+        return []
+    literals: List[str] = []
+
+    def walk(items):
+        run = ""
+        for op, arg in items:
+            if op is _sre_parse.LITERAL:
+                run += chr(arg)
+                continue
+            if run: literals.append(run)
+            run = ""
+            if op is _sre_parse.SUBPATTERN:
+                walk(arg[-1])
+            elif op in (_sre_parse.MAX_REPEAT, _sre_parse.MIN_REPEAT) and arg[0] >= 1:
+                walk(arg[2])
+        if run: literals.append(run)
+
+    walk(parsed)
+    return literals
+
+_REPEATS = tuple(getattr(_sre_parse, name) for name in ("MAX_REPEAT", "MIN_REPEAT", "POSSESSIVE_REPEAT") if hasattr(_sre_parse, name))
+_BACKREFERENCES = (_sre_parse.GROUPREF, _sre_parse.GROUPREF_EXISTS)
+
+def check_regex(pattern: str):
+    """Raises ValueError for patterns that can backtrack exponentially: nested variable repeats, backreferences."""
+    def walk(items, in_repeat: bool):
+        for op, arg in items:
+            if op in _BACKREFERENCES:
+                raise ValueError(f"Backreferences are not supported in code search: {pattern!r}")
+            if op in _REPEATS:
+                variable = arg[0] != arg[1]
+                if variable and in_repeat:
+                    raise ValueError(f"Nested repetition is not supported in code search: {pattern!r}")
+                walk(arg[2], in_repeat or variable)
+            elif op is _sre_parse.SUBPATTERN:
+                walk(arg[-1], in_repeat)
+            elif op is _sre_parse.BRANCH:
+                for branch in arg[1]:
+                    walk(branch, in_repeat)
+            elif op in (_sre_parse.ASSERT, _sre_parse.ASSERT_NOT):
+                walk(arg[1], in_repeat)
+    try:
+        parsed = _sre_parse.parse(pattern)
+    except re.error as e:
+        raise ValueError(f"Invalid regex {pattern!r}: {e}") from None
+    walk(parsed, False)
+
+@dataclass
+class ChunkDoc:
+    chunk_id: str
+    path: str
+    start_line: int
+    content: str
+    entities: List[Tuple[str, int, int]] = field(default_factory=list)  # (entity ID, start line, end line)
+
+    def meta(self) -> dict:
+        return {"chunk_id": self.chunk_id, "path": self.path, "start_line": self.start_line, "entities": self.entities}
+
+class _Keys:
+    """Sequence view over a segment's sorted trigram keys, for bisect."""
+    def __init__(self, buf, n: int):
+        self.buf, self.n = buf, n
+
+    def __len__(self) -> int:
+        return self.n
+
+    def __getitem__(self, i: int) -> int:
+        return _TRIGRAM.unpack_from(self.buf, _HEADER.size + i * _TRIGRAM.size)[0]
+
+class _Segment:
+    def __init__(self, buf: mmap.mmap, metas: List[dict]):
+        self.buf = buf
+        magic, self.n_docs, self.n_trigrams, self._docs_at = _HEADER.unpack_from(buf, 0)
+        if magic != MAGIC or self.n_docs != len(metas):
+            raise ValueError("corrupt trigram segment")
+        self.metas = metas
+        self._keys = _Keys(buf, self.n_trigrams)
+
+    @staticmethod
+    def build(docs: List[ChunkDoc]) -> Tuple[bytes, List[dict]]:
+        postings: Dict[int, List[int]] = {}
+        for doc_num, doc in enumerate(docs):
+            for key in trigram_keys(doc.content):
+                postings.setdefault(key, []).append(doc_num)
+        keys = sorted(postings)
+        offset = _HEADER.size + len(keys) * _TRIGRAM.size
+        docs_at = offset + 4 * sum(len(p) for p in postings.values())
+        out = bytearray(_HEADER.pack(MAGIC, len(docs), len(keys), docs_at))
+        for key in keys:
+            out += _TRIGRAM.pack(key, offset, len(postings[key]))
+            offset += 4 * len(postings[key])
+        for key in keys:
+            out += array.array("I", postings[key]).tobytes()
+        blobs = [doc.content.encode("utf-8") for doc in docs]
+        content_at = len(out) + len(docs) * _DOC.size
+        for blob in blobs:
+            out += _DOC.pack(content_at, len(blob))
+            content_at += len(blob)
+        for blob in blobs:
+            out += blob
+        return bytes(out), [doc.meta() for doc in docs]
+
+    def postings(self, key: int) -> memoryview:
+        i = bisect.bisect_left(self._keys, key)
+        if i == self.n_trigrams or self._keys[i] != key:
+            return memoryview(b"").cast("I")
+        _, offset, n = _TRIGRAM.unpack_from(self.buf, _HEADER.size + i * _TRIGRAM.size)
+        return memoryview(self.buf)[offset:offset + 4 * n].cast("I")
+
+    def content(self, doc_num: int) -> str:
+        offset, length = _DOC.unpack_from(self.buf, self._docs_at + doc_num * _DOC.size)
+        return self.buf[offset:offset + length].decode("utf-8")
+
+    def doc(self, doc_num: int) -> ChunkDoc:
+        meta = self.metas[doc_num]
+        return ChunkDoc(meta["chunk_id"], meta["path"], meta["start_line"], self.content(doc_num), [tuple(e) for e in meta["entities"]])
+
+    def close(self):
+        try:
+            self.buf.close()
+        except BufferError:  # A postings view is still alive; the map goes with it.
+            pass
+
+class RepoTrigramIndex:
+    def __init__(self, repo: str, directory: Optional[str] = None, compact_threshold: int = TRIGRAM_COMPACT_THRESHOLD):
+        self.repo = repo
+        self.compact_threshold = compact_threshold
+        self._base = os.path.join(directory, repo.replace("/", "__")) if directory else None
+        self._segment: Optional[_Segment] = None
+        self._segment_ids: Dict[str, int] = {}
+        self._tombstones: Set[int] = set()
+        self._delta: Dict[str, ChunkDoc] = {}
+        self._delta_postings: Dict[int, Set[str]] = {}
+        self._by_path: Dict[str, Set[str]] = {}
+        self.graph_version: Optional[int] = None  # Stored graph version of the segment's contents, if known.
+        self._generation = 0  # Segments installed; a background compaction started on an older one is dropped.
+        self._touched: Optional[Set[str]] = None  # Chunk IDs changed while a background compaction runs.
+        if self._base and os.path.exists(self._base + ".trg"):
+            try:
+                self._open_segment()
+            except (OSError, ValueError) as e:
+                logger.warning(f"TRIGRAM_INDEX({repo}): Ignoring unreadable segment {self._base}.trg: {e}")
+
+    @property
+    def persisted(self) -> bool:
+        return self._segment is not None and self._base is not None
+
+    def __len__(self) -> int:
+        return len(self._segment_ids) - len(self._tombstones) + len(self._delta)
+
+    def _open_segment(self, buf: Optional[mmap.mmap] = None, metas: Optional[List[dict]] = None, graph_version: Optional[int] = None):
+        if buf is None:
+            with open(self._base + ".json", encoding="utf-8") as f:
+                sidecar = json.load(f)
+            # Sidecars from before graph versions were recorded are a bare list of metas.
+            metas, graph_version = (sidecar, None) if isinstance(sidecar, list) else (sidecar["docs"], sidecar.get("graph_version"))
+            with open(self._base + ".trg", "rb") as f:
+                buf = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+        segment = _Segment(buf, metas)
+        if self._segment is not None:
+            self._segment.close()
+        self._segment = segment
+        self._segment_ids = {meta["chunk_id"]: i for i, meta in enumerate(metas)}
+        self._tombstones = set()
+        self._by_path = {}
+        for meta in metas:
+            self._by_path.setdefault(meta["path"], set()).add(meta["chunk_id"])
+        self.graph_version = graph_version
+        self._generation += 1
+
+    # --- Maintenance ---
+
+    def add(self, doc: ChunkDoc):
+        self.remove(doc.chunk_id)
+        self._add_delta(doc)
+
+    def _add_delta(self, doc: ChunkDoc):
+        self._delta[doc.chunk_id] = doc
+        for key in trigram_keys(doc.content):
+            self._delta_postings.setdefault(key, set()).add(doc.chunk_id)
+        self._by_path.setdefault(doc.path, set()).add(doc.chunk_id)
+
+    @property
+    def needs_compaction(self) -> bool:
+        segment_docs = len(self._segment_ids) - len(self._tombstones)
+        return len(self._delta) >= max(self.compact_threshold, segment_docs // 4)
+
+    def remove(self, chunk_id: str):
+        if self._touched is not None:
+            self._touched.add(chunk_id)
+        doc = self._delta.pop(chunk_id, None)
+        if doc is not None:
+            for key in trigram_keys(doc.content):
+                ids = self._delta_postings.get(key)
+                if ids is not None:
+                    ids.discard(chunk_id)
+                    if not ids: del self._delta_postings[key]
+            path = doc.path
+        elif chunk_id in self._segment_ids and self._segment_ids[chunk_id] not in self._tombstones:
+            doc_num = self._segment_ids[chunk_id]
+            self._tombstones.add(doc_num)
+            path = self._segment.metas[doc_num]["path"]
+        else:
+            return
+        path_ids = self._by_path.get(path)
+        if path_ids is not None:
+            path_ids.discard(chunk_id)
+            if not path_ids: del self._by_path[path]
+
+    def remove_path(self, relative_path: str):
+        for chunk_id in list(self._by_path.get(relative_path, ())):
+            self.remove(chunk_id)
+
+    def _live_docs(self) -> Iterator[ChunkDoc]:
+        if self._segment is not None:
+            for doc_num in range(self._segment.n_docs):
+                if doc_num not in self._tombstones:
+                    yield self._segment.doc(doc_num)
+        yield from self._delta.values()
+
+    def _snapshot(self) -> List[ChunkDoc]:
+        return sorted(self._live_docs(), key=lambda d: (d.path, d.start_line, d.chunk_id))
+
+    def _write(self, docs: List[ChunkDoc], graph_version: Optional[int], tmp: str) -> Tuple[bytes, List[dict]]:
+        """Builds a segment of `docs`; a persistent index also writes it next to the live files, with suffix `tmp`."""
+        data, metas = _Segment.build(docs)
+        if self._base:
+            os.makedirs(os.path.dirname(self._base) or ".", exist_ok=True)
+            sidecar = json.dumps({"graph_version": graph_version, "docs": metas})
+            for suffix, payload, mode in ((".json", sidecar, "w"), (".trg", data, "wb")):
+                with open(self._base + suffix + tmp, mode, **({"encoding": "utf-8"} if mode == "w" else {})) as f:
+                    f.write(payload)
+        return data, metas
+
+    def _temp_suffix(self) -> str:
+        # Unique per write: another process (or compaction) may be writing the same repository's files.
+        return f".{os.getpid()}.{secrets.token_hex(4)}.tmp"
+
+    def _discard_temp(self, tmp: str):
+        for suffix in (".json", ".trg"):
+            if self._base and os.path.exists(self._base + suffix + tmp):
+                os.remove(self._base + suffix + tmp)
+
+    def _install(self, data: bytes, metas: List[dict], graph_version: Optional[int], tmp: str, touched: Set[str]):
+        """Swaps in the segment `_write` built; chunks in `touched` changed after its snapshot and keep their delta state."""
+        kept = [self._delta[chunk_id] for chunk_id in touched if chunk_id in self._delta]
+        if self._base:
+            for suffix in (".json", ".trg"):
+                os.replace(self._base + suffix + tmp, self._base + suffix)
+            self._open_segment()
+        else:
+            buf = mmap.mmap(-1, max(len(data), 1))
+            buf.write(data)
+            self._open_segment(buf, metas, graph_version)
+        self._delta.clear()
+        self._delta_postings.clear()
+        for chunk_id in touched:
+            if chunk_id in self._segment_ids:
+                self._tombstones.add(self._segment_ids[chunk_id])
+                path_ids = self._by_path.get(self._segment.metas[self._segment_ids[chunk_id]]["path"])
+                if path_ids is not None:
+                    path_ids.discard(chunk_id)
+        for doc in kept:
+            self._add_delta(doc)
+
+    def compact(self, graph_version: Optional[int] = None):
+        """Rewrites the live chunks into a new segment (recording `graph_version`) and empties the delta and tombstones."""
+        start = time.perf_counter()
+        docs, tmp = self._snapshot(), self._temp_suffix()
+        try:
+            data, metas = self._write(docs, graph_version, tmp)
+            self._install(data, metas, graph_version, tmp, set())
+        finally:
+            self._discard_temp(tmp)
+        logger.info(f"TRIGRAM_INDEX({self.repo}): Compacted {len(docs)} chunks ({len(data)} bytes) in {time.perf_counter() - start:.3f}s.")
+
+    async def compact_in_background(self, graph_version: Optional[int] = None):
+        """compact() with the build and write in a worker thread. Skipped while another one runs."""
+        if self._touched is not None:
+            return
+        start = time.perf_counter()
+        docs, generation, self._touched = self._snapshot(), self._generation, set()
+        tmp = self._temp_suffix()
+        try:
+            data, metas = await asyncio.to_thread(self._write, docs, graph_version, tmp)
+            if self._generation != generation:
+                # A reseed or synchronous compaction installed a newer segment meanwhile.
+                return
+            self._install(data, metas, graph_version, tmp, self._touched)
+        except (OSError, ValueError) as e:
+            logger.warning(f"TRIGRAM_INDEX({self.repo}): Background compaction failed: {e}")
+            return
+        finally:
+            self._touched = None
+            self._discard_temp(tmp)
+        logger.info(f"TRIGRAM_INDEX({self.repo}): Compacted {len(docs)} chunks ({len(data)} bytes) in the background in {time.perf_counter() - start:.3f}s.")
+
+    @property
+    def dirty(self) -> bool:
+        return bool(self._delta or self._tombstones)
+
+    # --- Search ---
+
+    def _candidates(self, literals: List[str]) -> Iterator[ChunkDoc]:
+        keys = set()
+        for literal in literals:
+            keys |= trigram_keys(literal)
+        if not keys:
+            yield from self._live_docs()
+            return
+        if self._segment is not None:
+            runs = sorted((self._segment.postings(k) for k in keys), key=len)
+            doc_nums = set(runs[0])
+            for run in runs[1:]:
+                if not doc_nums: break
+                doc_nums.intersection_update(run)
+            del runs
+            for doc_num in sorted(doc_nums - self._tombstones):
+                yield self._segment.doc(doc_num)
+        runs = sorted((self._delta_postings.get(k, set()) for k in keys), key=len)
+        for chunk_id in set.intersection(*runs) if runs[0] else ():
+            yield self._delta[chunk_id]
+
+    def search(self, pattern: str, regex: bool = False, case_sensitive: bool = False, limit: int = 50) -> List[dict]:
+        """
+        Line hits for `pattern` (a literal substring, or a Python regex when `regex`), each with its
+        chunk ID, path, absolute line number, line text and the IDs of entities spanning that line.
+        """
+        compiled, literals = compile_pattern(pattern, regex, case_sensitive)
+        return self.verify(self._candidates(literals), compiled, limit)
+
+    def candidates(self, literals: List[str]) -> List[ChunkDoc]:
+        """The chunks that may contain every literal, as a list another thread can verify."""
+        return list(self._candidates(literals))
+
+    def verify(self, docs: Iterable[ChunkDoc], compiled: "re.Pattern", limit: int, deadline: Optional[float] = None) -> List[dict]:
+        """search's hits among `docs`; past the time.monotonic() `deadline` it stops between chunks with TimeoutError."""
+        hits: List[dict] = []
+        for doc in docs:
+            if deadline is not None and time.monotonic() > deadline:
+                raise TimeoutError("regex search deadline passed")
+            seen_lines = set()
+            for match in compiled.finditer(doc.content):
+                line_index = doc.content.count("\n", 0, match.start())
+                if line_index in seen_lines:
+                    continue
+                seen_lines.add(line_index)
+                line_start = doc.content.rfind("\n", 0, match.start()) + 1
+                line_end = doc.content.find("\n", match.start())
+                line = doc.start_line + line_index
+                hits.append({
+                    "repo": self.repo, "chunk_id": doc.chunk_id, "path": doc.path, "line": line,
+                    "text": doc.content[line_start:line_end if line_end != -1 else None][:MAX_LINE_CHARS],
+                    "entity_ids": [e[0] for e in doc.entities if e[1] <= line <= e[2]],
+                })
+                if len(hits) >= limit:
+                    return hits
+        return hits
+
+def compile_pattern(pattern: str, regex: bool, case_sensitive: bool) -> Tuple["re.Pattern", List[str]]:
+    """The compiled pattern and the literals every match contains, for candidate lookup."""
+    if regex:
+        check_regex(pattern)
+    compiled = re.compile(pattern if regex else re.escape(pattern), 0 if case_sensitive else re.IGNORECASE)
+    return compiled, required_literals(pattern) if regex else [pattern]
+
+class TrigramIndexes:
+    """The per-repository trigram indexes of this process."""
+    def __init__(self, directory: Optional[str] = TRIGRAM_INDEX_DIR, compact_threshold: int = TRIGRAM_COMPACT_THRESHOLD,
+                 regex_timeout_seconds: float = TRIGRAM_REGEX_TIMEOUT_SECONDS):
+        self.directory = directory or None
+        self.compact_threshold = compact_threshold
+        self.regex_timeout_seconds = regex_timeout_seconds
+        self._repos: Dict[str, RepoTrigramIndex] = {}
+        self._seeded = SeedStamps()
+        self._compactions: Set[asyncio.Task] = set()
+
+    def get(self, repo: str) -> RepoTrigramIndex:
+        if repo not in self._repos:
+            self._repos[repo] = RepoTrigramIndex(repo, self.directory, self.compact_threshold)
+        return self._repos[repo]
+
+    def repos(self, scopes: Optional[Iterable[str]] = None) -> List[str]:
+        if scopes is None:
+            return sorted(self._repos)
+        prefixes = [s.strip("/") for s in scopes if s and s.strip("/")]
+        return sorted(r for r in self._repos if any(r == p or r.startswith(p + "@") for p in prefixes))
+
+    def on_island_saved(self, repo: str, island):
+        index = self.get(repo)
+        entities_by_chunk: Dict[str, List[Tuple[str, int, int]]] = {}
+        for entity in island.code_entities:
+            # Same parent as the orchestrator's DEFINES_CODE_ENTITY edge.
+            parent = next((c for c in island.text_chunks if c.start_line <= entity.start_line <= c.end_line), None)
+            if parent is not None:
+                entities_by_chunk.setdefault(parent.id, []).append((entity.id, entity.start_line, entity.end_line))
+        relative_path = island.source_file.relative_path
+        for chunk in island.text_chunks:
+            index.add(ChunkDoc(chunk.id, relative_path, chunk.start_line, chunk.chunk_content, entities_by_chunk.get(chunk.id, [])))
+        if index.needs_compaction:
+            self._compact_later(index)
+
+    def _compact_later(self, index: RepoTrigramIndex):
+        """
+        Compacts off the ingest hook: in a background task when a loop runs, else right away. Skipped
+        until the repository is seeded: an ingest-only process (extract_cli, shard workers) never
+        seeds, and its segment would replace the server's with one recording no graph version.
+        """
+        if index.repo not in self._seeded:
+            return
+        try:
+            loop = asyncio.get_running_loop()
+        except RuntimeError:
+            index.compact(self._seeded.get(index.repo))
+            return
+        task = loop.create_task(index.compact_in_background(self._seeded.get(index.repo)))
+        self._compactions.add(task)
+        task.add_done_callback(self._compactions.discard)
+
+    def on_path_deleted(self, repo: str, relative_path: str):
+        if repo in self._repos:
+            self._repos[repo].remove_path(relative_path)
+
+    async def ensure_seeded(self, repo: str, refresh: bool = False):
+        """
+        Builds a repository's segment from its TextChunk and CodeEntity nodes, unless the segment
+        loaded from disk records the repository's current stored graph version.
+        """
+        from .graph_utils import find_nodes_with_filter
+        index = self.get(repo)
+        if repo not in self._seeded and index.persisted and index.graph_version is not None and not refresh:
+            stored = await get_graph_versions().stored_version(repo)
+            if index.graph_version == stored:
+                self._seeded.stamp(repo, stored)
+                return
+        if (version := await self._seeded.due(repo, refresh)) is None:
+            return
+        chunk_nodes = await find_nodes_with_filter({"type": "TextChunk", "repo_id_str": repo})
+        entity_nodes = await find_nodes_with_filter({"type": "CodeEntity", "repo_id_str": repo})
+        entities_by_chunk: Dict[str, List[Tuple[str, int, int]]] = {}
+        for node in entity_nodes:
+            # Entity IDs extend their chunk's ID: 'chunk id|fqn@line'.
+            chunk_id = node.id.rsplit("|", 1)[0]
+            entities_by_chunk.setdefault(chunk_id, []).append((node.id, node.attributes.get("start_line") or 0, node.attributes.get("end_line") or 0))
+        for chunk_id in list(index._segment_ids) + list(index._delta):
+            index.remove(chunk_id)
+        for node in chunk_nodes:
+            a = node.attributes
+            path = node.id.split("|", 2)[1].rsplit("@", 1)[0] if node.id.count("|") >= 2 else ""
+            index._delta[node.id] = ChunkDoc(node.id, path, a.get("start_line") or 1, a.get("chunk_content") or "", entities_by_chunk.get(node.id, []))
+        index.compact(version)
+        self._seeded.stamp(repo, version)
+        logger.info(f"TRIGRAM_INDEX({repo}): Seeded {len(chunk_nodes)} chunks from the graph.")
+
+    async def search(self, scopes: Iterable[str], pattern: str, regex: bool = False, case_sensitive: bool = False, limit: int = 50) -> List[dict]:
+        prefixes = [s.strip("/") for s in scopes if s and s.strip("/")]
+        repos = await get_graph_versions().known_repos(prefixes)
+        compiled, literals = compile_pattern(pattern, regex, case_sensitive)
+        deadline = time.monotonic() + self.regex_timeout_seconds
+        hits: List[dict] = []
+        with timed(TRIGRAM_SEARCH_SECONDS, mode="regex" if regex else "substring"):
+            for repo in sorted(set(repos) | set(self.repos(prefixes))):
+                await self.ensure_seeded(repo)
+                index = self.get(repo)
+                if not regex:
+                    hits.extend(index.search(pattern, regex, case_sensitive, limit - len(hits)))
+                else:
+                    # A regex may still scan every chunk; the loop keeps running and stops waiting at the deadline.
+                    verify = asyncio.to_thread(index.verify, index.candidates(literals), compiled, limit - len(hits), deadline)
+                    try:
+                        hits.extend(await asyncio.wait_for(verify, max(deadline - time.monotonic(), 0.001)))
+                    except (TimeoutError, asyncio.TimeoutError):
+                        raise TimeoutError(f"Regex search for {pattern!r} exceeded {self.regex_timeout_seconds}s") from None
+                if len(hits) >= limit:
+                    break
+        return hits
+
+    def flush(self):
+        """Compacts every seeded repository with unsaved changes (persistent directories only)."""
+        if not self.directory:
+            return
+        for index in self._repos.values():
+            if index.dirty and index.repo in self._seeded:
+                try:
+                    index.compact(self._seeded.get(index.repo))
+                except (OSError, ValueError) as e:
+                    logger.warning(f"TRIGRAM_INDEX({index.repo}): Flush failed: {e}")
+
+_indexes: Optional[TrigramIndexes] = None
+
+def get_trigram_indexes() -> TrigramIndexes:
+    global _indexes
+    if _indexes is None:
+        import atexit
+        _indexes = TrigramIndexes()
+        atexit.register(_indexes.flush)
+    return _indexes
@@ -2,10 +2,23 @@ import asyncio
 import aiofiles
 from pathlib import Path
 import os
+import logging
+import sys
 from typing import Optional, Any, List, Dict, Tuple
 
-from cognee.shared.logging_utils import get_logger
-logger = get_logger(__name__)
+class PrintLogger(logging.Logger):
+    """Plain stderr logger used when cognee is not installed (e.g. the standalone extractor)."""
+    def __init__(self, name: str):
+        super().__init__(name, level=os.environ.get("LOG_LEVEL", "INFO").upper())
+        handler = logging.StreamHandler(sys.stderr)
+        handler.setFormatter(logging.Formatter("%(asctime)s %(levelname)s %(message)s"))
+        self.addHandler(handler)
+
+try:
+    from cognee.shared.logging_utils import get_logger
+    logger = get_logger(__name__)
+except ImportError:
+    logger = PrintLogger(__name__)
 
 try:
     from tree_sitter import Node as TSNODE_TYPE, Parser, Language
@@ -0,0 +1,128 @@
+# .roo/cognee/src/retrieval_cache.py
+"""
+Result cache for DevCodeRetriever, keyed by (kind, normalized query, datasets, top_k, principal).
+The principal is the requesting user's ID: dataset access is per user, so one user's results are
+never served to another.
+
+Each entry remembers the graph version vector (src.parser.graph_versions) it was computed
+against; a lookup after the orchestrator or dispatcher committed to one of those repositories
+finds it stale and recomputes. A TTL bounds staleness from writers in other processes.
+Concurrent identical lookups share one computation. It runs as its own task, so a caller that
+is cancelled (e.g. a client disconnect) neither cancels it for the others nor loses its result.
+"""
+import asyncio
+import copy
+import time
+from collections import OrderedDict
+from dataclasses import dataclass
+from typing import Any, Awaitable, Callable, Dict, Iterable, Optional, Tuple
+
+from src.parser.graph_versions import GraphVersions, get_graph_versions
+from src.parser.metrics import increment, RETRIEVAL_CACHE_REQUESTS, RETRIEVAL_CACHE_SAVED_SECONDS
+
+CacheKey = Tuple[str, str, Tuple[str, ...], int, Optional[str]]
+
+@dataclass
+class _Entry:
+    value: Any
+    versions: Tuple
+    created: float
+    compute_seconds: float
+    hits: int = 0
+
+def normalize_query(query: str) -> str:
+    return " ".join((query or "").lower().split())
+
+class RetrievalCache:
+    def __init__(self, max_entries: int = 256, ttl_seconds: Optional[float] = 300.0, versions: Optional[GraphVersions] = None):
+        self.max_entries = max_entries
+        self.ttl_seconds = ttl_seconds
+        self._versions = versions
+        self._entries: "OrderedDict[CacheKey, _Entry]" = OrderedDict()
+        self._inflight: Dict[CacheKey, asyncio.Future] = {}
+        self.hits = self.misses = self.stale = 0
+        self.saved_seconds = 0.0
+
+    @property
+    def versions(self) -> GraphVersions:
+        return self._versions or get_graph_versions()
+
+    @staticmethod
+    def key(kind: str, query: str, datasets: Optional[Iterable[str]], top_k: int, principal: Optional[str] = None) -> CacheKey:
+        return kind, normalize_query(query), tuple(sorted(set(datasets or ()))), top_k, principal
+
+    def _lookup(self, key: CacheKey) -> Optional[_Entry]:
+        entry = self._entries.get(key)
+        if entry is None:
+            return None
+        expired = self.ttl_seconds is not None and time.time() - entry.created > self.ttl_seconds
+        if expired or entry.versions != self.versions.snapshot(key[2]):
+            del self._entries[key]
+            self.stale += 1
+            increment(RETRIEVAL_CACHE_REQUESTS, kind=key[0], outcome="stale")
+            return None
+        self._entries.move_to_end(key)
+        return entry
+
+    def _store(self, key: CacheKey, value: Any, versions: Tuple, compute_seconds: float):
+        self._entries[key] = _Entry(copy.deepcopy(value), versions, time.time(), compute_seconds)
+        self._entries.move_to_end(key)
+        while len(self._entries) > self.max_entries:
+            self._entries.popitem(last=False)
+
+    async def get_or_compute(self, kind: str, query: str, datasets: Optional[Iterable[str]], top_k: int,
+                             compute: Callable[[], Awaitable[Any]], cacheable: Callable[[Any], bool] = lambda value: True,
+                             principal: Optional[str] = None) -> Tuple[Any, bool]:
+        """Returns (value, hit). Values are deep-copied in and out, so callers may mutate them."""
+        key = self.key(kind, query, datasets, top_k, principal)
+        entry = self._lookup(key)
+        if entry is not None:
+            entry.hits += 1
+            self.hits += 1
+            self.saved_seconds += entry.compute_seconds
+            increment(RETRIEVAL_CACHE_REQUESTS, kind=kind, outcome="hit")
+            increment(RETRIEVAL_CACHE_SAVED_SECONDS, entry.compute_seconds, kind=kind)
+            return copy.deepcopy(entry.value), True
+        if key in self._inflight:
+            self.hits += 1
+            increment(RETRIEVAL_CACHE_REQUESTS, kind=kind, outcome="shared")
+            return copy.deepcopy(await asyncio.shield(self._inflight[key])), True
+
+        self.misses += 1
+        increment(RETRIEVAL_CACHE_REQUESTS, kind=kind, outcome="miss")
+        task = asyncio.ensure_future(self._compute_and_store(key, compute, cacheable))
+        self._inflight[key] = task
+        task.add_done_callback(lambda done: done.cancelled() or done.exception())  # Retrieved even if every caller left.
+        return await asyncio.shield(task), False
+
+    async def _compute_and_store(self, key: CacheKey, compute: Callable[[], Awaitable[Any]], cacheable: Callable[[Any], bool]) -> Any:
+        versions = self.versions.snapshot(key[2])  # Taken first: a write during compute leaves the entry stale.
+        start = time.perf_counter()
+        try:
+            value = await compute()
+            if cacheable(value):
+                self._store(key, value, versions, time.perf_counter() - start)
+            return value
+        finally:
+            del self._inflight[key]
+
+    def put(self, kind: str, query: str, datasets: Optional[Iterable[str]], top_k: int, value: Any, versions: Tuple,
+            compute_seconds: float = 0.0, principal: Optional[str] = None):
+        """Stores a value computed outside get_or_compute, against the versions snapshot taken before computing it."""
+        key = self.key(kind, query, datasets, top_k, principal)
+        if key not in self._inflight and self._lookup(key) is None:
+            self._store(key, value, versions, compute_seconds)
+
+    def clear(self):
+        self._entries.clear()
+
+    def stats(self) -> dict:
+        lookups = self.hits + self.misses
+        return {
+            "entries": len(self._entries),
+            "hits": self.hits,
+            "misses": self.misses,
+            "stale": self.stale,
+            "hit_rate": round(self.hits / lookups, 4) if lookups else 0.0,
+            "saved_seconds": round(self.saved_seconds, 3),
+        }
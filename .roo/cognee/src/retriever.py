@@ -1,5 +1,5 @@
 # retrieve.py
-from typing import Any, Dict, List, Optional, Union, Tuple, Type
+from typing import Any, Dict, List, Optional, Set, Union, Tuple, Type, get_args
 import json
 import re
 import time
@@ -10,6 +10,17 @@ import os
 import hashlib
 from pydantic import BaseModel, Field, ValidationError, validator
 
+from src.context_packer import ContextPacker
+from src.retrieval_cache import RetrievalCache
+from src.speculative_retrieval import Speculation, speculation_candidates
+from src.parser.entities import AdaptableNode
+from src.parser.graph_utils import get_edge_details_batch, get_node_details_batch
+from src.parser.symbol_index import extract_identifiers, get_symbol_index
+from src.parser.class_hierarchy import get_class_hierarchy
+from src.parser.call_graph import get_call_graph
+from src.parser.trigram_index import get_trigram_indexes
+from src.parser.metrics import timed, RETRIEVAL_PHASE_SECONDS
+
 # --- Cognee Imports ---
 try:
     from cognee.modules.retrieval.base_retriever import BaseRetriever
@@ -73,7 +84,11 @@ class DevCodeRetriever(BaseRetriever):
     Developer-focused retriever using a multi-stage, graph-centric pipeline.
     Relies on Cognee's `brute_force_triplet_search` to find relevant triplets.
     Uses LLM for analysis and planning (selecting relevant triplet indices),
-    and final synthesis. No internal caching is used.
+    and final synthesis. Completed answers and Phase 1 search results are cached per
+    (normalized query, datasets, top_k) and invalidated by the graph version counters.
+    Prompt context is packed to a token budget, each source span sent once (src/context_packer.py).
+    While the LLM plans, cheap index expansions of likely next-loop symbols run alongside it
+    (src/speculative_retrieval.py) and are merged in when the plan loops on them.
     """
 
     def __init__(
@@ -108,6 +123,19 @@ class DevCodeRetriever(BaseRetriever):
 
         # --- LLM & Loop Control ---
         max_planning_retries: int = 2,
+
+        # --- Result Cache (0 entries disables it) ---
+        cache_max_entries: int = 256,
+        cache_ttl_seconds: Optional[float] = 300.0,
+
+        # --- Speculative Expansion During Planning (0 candidates disables it) ---
+        speculative_candidates: int = 6,
+        speculative_expansion_limit: int = 10,
+        speculative_wait_seconds: float = 1.0,
+
+        # --- Context Packing ---
+        llm_context_token_budget: int = 6000,
+        context_snippet_lines: int = 5,
     ):
         # Store config
         self.analysis_system_prompt_path = analysis_system_prompt_path
@@ -139,8 +167,14 @@ class DevCodeRetriever(BaseRetriever):
         self.max_llm_context_triplets = max_llm_context_triplets
         self.max_final_context_triplets = max_final_context_triplets
         self.max_planning_retries = max_planning_retries
-
-        logger.info("DevCodeRetriever initialized (Graph-Centric, Index-Based Planning, No Cache).")
+        self.cache = RetrievalCache(cache_max_entries, cache_ttl_seconds) if cache_max_entries > 0 else None
+        self.speculative_candidates = speculative_candidates
+        self.speculative_expansion_limit = speculative_expansion_limit
+        self.speculative_wait_seconds = speculative_wait_seconds
+        self.context_packer = ContextPacker(llm_context_token_budget, context_snippet_lines, node_id_prop, node_text_prop, node_type_prop, edge_type_prop)
+
+        cache_note = f"Cache {cache_max_entries} entries, TTL {cache_ttl_seconds}s" if self.cache else "No Cache"
+        logger.info(f"DevCodeRetriever initialized (Graph-Centric, Index-Based Planning, {cache_note}).")
         logger.info(f" Phase 1 Search: Using 'brute_force_triplet_search', top_k={self.phase1_top_k}")
         logger.info(f" Node Properties Projected: {self.node_properties_to_project}")
         logger.info(f" Edge Properties Projected: {self.edge_properties_to_project}")
@@ -158,8 +192,35 @@ class DevCodeRetriever(BaseRetriever):
         datasets: List[str] = None,
     ) -> Dict[str, Any]:
         """
-        Orchestrates the multi-stage, graph-centric retrieval pipeline.
+        Orchestrates the multi-stage, graph-centric retrieval pipeline, answering repeated
+        questions from the cache while the graph they were answered from is unchanged.
         """
+        if not self.cache or not datasets:
+            return await self._compute_completion(query, user, datasets)
+        start_time = time.time()
+        if user is None:
+            user = await get_default_user()
+        result, hit = await self.cache.get_or_compute(
+            "completion", query, datasets, self.phase1_top_k,
+            lambda: self._compute_completion(query, user, datasets),
+            cacheable=lambda r: not str(r.get("status", "")).startswith("error"),
+            principal=str(user.id),
+        )
+        if hit:
+            logger.info(f"get_completion served from cache for query: '{query}'")
+            result.setdefault("trace", []).append({"stage": "cache", "status": "hit", "duration": time.time() - start_time})
+        return result
+
+    def cache_stats(self) -> Dict[str, Any]:
+        """Hit rate and saved latency of the result cache."""
+        return self.cache.stats() if self.cache else {"enabled": False}
+
+    async def _compute_completion(
+        self,
+        query: str,
+        user: Optional[User] = None,
+        datasets: List[str] = None,
+    ) -> Dict[str, Any]:
         trace = []
         start_time = time.time()
 
@@ -178,7 +239,7 @@ class DevCodeRetriever(BaseRetriever):
         original_query = query
 
         try:
-            # --- Initial Phase 1 Run (No Caching) ---
+            # --- Initial Phase 1 Run ---
             stage_start_time = time.time()
             trace.append({"stage": "initial_retrieval", "status": "started"})
             logger.info("Running initial retrieval phase...")
@@ -205,7 +266,15 @@ class DevCodeRetriever(BaseRetriever):
                     logger.warning("Planning phase entered with empty context. Exiting loop.")
                     return {"output": f"Analysis stopped due to lack of relevant context after loops for query: '{query}'", "relevant_context": [], "status": "no_results_post_loop"}
 
-                plan = await self._analyze_and_plan(original_query, current_triplets, datasets)
+                speculation = self._start_speculation(original_query, current_triplets, datasets, user)
+                trace[-1]["speculative_candidates"] = sorted(speculation.tasks)
+                try:
+                    plan = await self._analyze_and_plan(original_query, current_triplets, datasets, trace[-1])
+                except BaseException:
+                    speculation.cancel()
+                    raise
+                if not plan.loop or is_last_attempt:
+                    speculation.cancel()
                 trace[-1].update({"status": "completed", "duration": time.time() - stage_start_time, "plan_details": plan.dict()})
 
                 # --- Process Plan Flags ---
@@ -222,8 +291,15 @@ class DevCodeRetriever(BaseRetriever):
                     loop_stage_name = f"loop_retrieval_attempt_{retry_count + 1}"
                     trace.append({"stage": loop_stage_name, "status": "started"})
                     logger.info(f"Running loop retrieval phase (query: '{plan.search_query}')...")
-                    new_triplets = await self._run_retrieval_phase(plan.search_query, user, datasets)
-                    trace[-1].update({"status": "completed", "duration": time.time() - loop_stage_start, "triplet_count": len(new_triplets)})
+                    new_triplets, speculative_triplets = await asyncio.gather(
+                        self._run_retrieval_phase(plan.search_query, user, datasets),
+                        speculation.take(plan.search_query, self.speculative_wait_seconds),
+                    )
+                    seen = {self._triplet_key(t) for t in new_triplets}
+                    searched = len(new_triplets)
+                    new_triplets = new_triplets + [t for t in speculative_triplets if self._triplet_key(t) not in seen]
+                    trace[-1].update({"status": "completed", "duration": time.time() - loop_stage_start, "triplet_count": searched,
+                                      "speculative_triplet_count": len(new_triplets) - searched})
                     logger.info(f"Loop retrieval phase completed ({len(new_triplets)} new triplets found).")
 
                     prep_stage_start = time.time()
@@ -256,10 +332,11 @@ class DevCodeRetriever(BaseRetriever):
                     stage_start_time = time.time()
                     trace.append({"stage": "final_summary_generation", "status": "started"})
                     final_response = await self._generate_comprehensive_response(
-                        original_query, plan.output, final_triplets
+                        original_query, plan.output, final_triplets, trace[-1]
                     )
                     trace[-1].update({"status": "completed", "duration": time.time() - stage_start_time})
                     final_response["trace"] = trace
+                    final_response["context_packing"] = self._packing_totals(trace)
                     logger.info(f"get_completion finished in {time.time() - start_time:.2f} seconds.")
                     return final_response
 
@@ -279,7 +356,27 @@ class DevCodeRetriever(BaseRetriever):
     async def _run_retrieval_phase(self, query: str, user: User, datasets: List[str]) -> List[Dict]:
         """
         Runs the graph-based semantic search using Cognee's brute_force_triplet_search.
+        Non-empty results of scoped searches are cached (like completions), so planning loops
+        re-asking a query skip the search.
         """
+        with timed(RETRIEVAL_PHASE_SECONDS, phase="total"):
+            if not self.cache or not datasets:
+                return await self._search_triplets(query, user, datasets)
+            triplets, _ = await self.cache.get_or_compute(
+                "triplets", query, datasets, self.phase1_top_k,
+                lambda: self._search_triplets(query, user, datasets), cacheable=bool, principal=str(user.id),
+            )
+            return triplets
+
+    async def _search_triplets(self, query: str, user: User, datasets: List[str]) -> List[Dict]:
+        """
+        A query naming a symbol exactly (or by a trailing run of its '::' segments) is answered from the
+        symbol index alone. Prefix matches are only candidates: they lead the semantic search results.
+        """
+        symbol_triplets, strong = await self._symbol_lookup(query, datasets)
+        if strong:
+            logger.info(f"Answered '{query[:100]}' from the symbol index ({len(symbol_triplets)} triplets).")
+            return symbol_triplets
         logger.info(f"Executing graph search for query: '{query[:100]}...'")
         start_time = time.time()
 
@@ -291,13 +388,16 @@ class DevCodeRetriever(BaseRetriever):
         properties_to_request = list(set(self.node_properties_to_project + self.edge_properties_to_project))
 
         try:
-            raw_triplets = await brute_force_triplet_search(
-                query=query,
-                user=user,
-                top_k=self.phase1_top_k,
-                collections=graph_collections,
-                properties_to_project=properties_to_request
-            )
+            with timed(RETRIEVAL_PHASE_SECONDS, phase="search"):
+                raw_triplets = await brute_force_triplet_search(
+                    query=query,
+                    user=user,
+                    top_k=self.phase1_top_k,
+                    collections=graph_collections,
+                    properties_to_project=properties_to_request
+                )
+            with timed(RETRIEVAL_PHASE_SECONDS, phase="details"):
+                raw_triplets = await self._fill_triplet_details(raw_triplets or [])
 
             processed_triplets = []
             if raw_triplets:
@@ -311,14 +411,14 @@ class DevCodeRetriever(BaseRetriever):
 
             duration = time.time() - start_time
             logger.info(f"Graph search completed in {duration:.2f}s, yielded {len(processed_triplets)} processed triplets.")
-            return processed_triplets
+            return symbol_triplets + processed_triplets
 
         except Exception as e:
             logger.exception(f"Error during _run_retrieval_phase calling brute_force_triplet_search: {e}")
-            return []
+            return symbol_triplets
 
     # --- Phase 2: LLM Planning ---
-    async def _analyze_and_plan(self, original_query: str, current_triplets: List[Dict], datasets: List[str]) -> RevisedRetrievalPlan:
+    async def _analyze_and_plan(self, original_query: str, current_triplets: List[Dict], datasets: List[str], trace_entry: Optional[Dict] = None) -> RevisedRetrievalPlan:
         """
         Analyzes the current triplets and generates a plan using the LLM.
         """
@@ -337,12 +437,12 @@ class DevCodeRetriever(BaseRetriever):
         logger.debug(f"Context Node Types for LLM: {available_node_types}")
         logger.debug(f"Context Edge Types for LLM: {available_edge_types}")
 
-        # Format triplets for the LLM prompt
-        formatted_triplets_for_prompt = self._format_triplets_for_llm(triplets_for_llm)
+        # Pack triplets for the LLM prompt
+        packed_triplets_json = self._pack_context(triplets_for_llm, trace_entry)
 
         prompt_context = {
             "original_query": original_query,
-            "current_triplets_json": json.dumps(formatted_triplets_for_prompt, indent=2),
+            "current_triplets_json": packed_triplets_json,
             "triplet_input_count": len(triplets_for_llm),
             "total_triplet_count": len(current_triplets),
             "available_node_types": ", ".join(available_node_types) or "N/A",
@@ -355,7 +455,7 @@ class DevCodeRetriever(BaseRetriever):
         except Exception as e:
             logger.error(f"Error rendering analysis prompts: {e}")
             system_prompt = "You are a code analysis planner. Analyze the query and the provided triplets (JSON format). Decide to loop (provide search_query), finish (done=True), or exit. Output a JSON matching the RevisedRetrievalPlan model, including relevant_triplet_indices."
-            user_prompt = f"Query: {original_query}\n\nTriplets:\n{json.dumps(formatted_triplets_for_prompt, indent=2)}\n\nBased on the query and triplets, determine the next step (loop, done, exit) and select the indices of relevant triplets."
+            user_prompt = f"Query: {original_query}\n\nTriplets:\n{packed_triplets_json}\n\nBased on the query and triplets, determine the next step (loop, done, exit) and select the indices of relevant triplets."
 
         try:
             plan = await llm_client.acreate_structured_output(
@@ -387,7 +487,8 @@ class DevCodeRetriever(BaseRetriever):
         self,
         original_query: str,
         analysis_output: str,
-        final_triplets: List[Dict]
+        final_triplets: List[Dict],
+        trace_entry: Optional[Dict] = None,
     ) -> Dict[str, Any]:
         """
         Generates the final unstructured summary using the LLM based on final triplets.
@@ -396,12 +497,12 @@ class DevCodeRetriever(BaseRetriever):
         llm_client = get_llm_client()
 
         triplets_for_summary_prompt = final_triplets[:self.max_llm_context_triplets]
-        formatted_triplets = self._format_triplets_for_llm(triplets_for_summary_prompt)
+        packed_triplets_json = self._pack_context(triplets_for_summary_prompt, trace_entry)
 
         prompt_context = {
             "original_query": original_query,
             "analysis_notes": analysis_output,
-            "final_triplets_json": json.dumps(formatted_triplets, indent=2),
+            "final_triplets_json": packed_triplets_json,
         }
 
         try:
@@ -410,7 +511,7 @@ class DevCodeRetriever(BaseRetriever):
         except Exception as e:
             logger.error(f"Error rendering summary prompts: {e}")
             system_prompt = "You are a helpful code assistant. Summarize the findings based ONLY on the provided context."
-            user_prompt = f"Original Query: {original_query}\nAnalysis Notes: {analysis_output}\n\nRelevant Context (Triplets):\n{json.dumps(formatted_triplets, indent=2)}\n\nProvide a comprehensive summary based on the information above."
+            user_prompt = f"Original Query: {original_query}\nAnalysis Notes: {analysis_output}\n\nRelevant Context (Triplets):\n{packed_triplets_json}\n\nProvide a comprehensive summary based on the information above."
 
         try:
             llm_summary = await llm_client.acreate(
@@ -438,6 +539,15 @@ class DevCodeRetriever(BaseRetriever):
 
     # --- Context Preparation & Helper Functions ---
 
+    def _triplet_key(self, triplet: Dict) -> Optional[str]:
+        """Identity of a triplet, (source, edge type, target); None when one of them is missing."""
+        source_id = triplet.get("source_node", {}).get("id")
+        target_id = triplet.get("target_node", {}).get("id")
+        edge_type = triplet.get("edge", {}).get("attributes", {}).get(self.edge_type_prop)
+        if not all([source_id, target_id, edge_type]):
+            return None
+        return hashlib.sha256(f"{source_id}:{edge_type}:{target_id}".encode()).hexdigest()
+
     async def _prepare_context_for_llm(
         self,
         previous_triplets: List[Dict],
@@ -462,17 +572,11 @@ class DevCodeRetriever(BaseRetriever):
         deduplicated_triplets_dict = OrderedDict()
         for triplet in combined_triplets:
             try:
-                source_id = triplet.get("source_node", {}).get("id")
-                target_id = triplet.get("target_node", {}).get("id")
-                edge_type = triplet.get("edge", {}).get("attributes", {}).get(self.edge_type_prop)
-
-                if not all([source_id, target_id, edge_type]):
+                key = self._triplet_key(triplet)
+                if key is None:
                     logger.warning(f"Skipping triplet during deduplication due to missing ID/Type. Triplet Score: {triplet.get('score')}")
                     continue
 
-                key_str = f"{source_id}:{edge_type}:{target_id}"
-                key = hashlib.sha256(key_str.encode()).hexdigest()
-
                 existing = deduplicated_triplets_dict.get(key)
                 current_score = triplet.get("score", 0)
 
@@ -489,6 +593,29 @@ class DevCodeRetriever(BaseRetriever):
         logger.info(f"Context preparation complete. Returning {len(final_prepared_triplets)} triplets.")
         return final_prepared_triplets
 
+    def _pack_context(self, triplets: List[Dict], trace_entry: Optional[Dict] = None) -> str:
+        """
+        The prompt JSON for `triplets`: de-duplicated source spans within the token budget. The
+        savings against _format_triplets_for_llm's output are recorded on the trace entry.
+        """
+        packed = self.context_packer.pack(triplets, self.context_packer.naive_tokens(triplets, self._format_triplets_for_llm))
+        logger.info(f"Packed {packed.stats['triplets_packed']}/{len(triplets)} triplets into ~{packed.stats['packed_tokens']} tokens "
+                    f"(~{packed.stats['saved_tokens']} saved, {packed.stats['deduplicated_nodes']} duplicate texts, {packed.stats['merged_spans']} merged spans).")
+        if trace_entry is not None:
+            trace_entry["context_packing"] = packed.stats
+        return packed.to_json()
+
+    @staticmethod
+    def _packing_totals(trace: List[Dict]) -> Dict[str, int]:
+        """Token estimates summed over every LLM call of one query."""
+        totals = {"llm_calls": 0, "naive_tokens": 0, "packed_tokens": 0, "saved_tokens": 0}
+        for entry in trace:
+            if stats := entry.get("context_packing"):
+                totals["llm_calls"] += 1
+                for key in ("naive_tokens", "packed_tokens", "saved_tokens"):
+                    totals[key] += stats.get(key, 0)
+        return totals
+
     def _format_triplets_for_llm(self, triplets: List[Dict]) -> List[Dict]:
         """ Formats triplets into a JSON-serializable structure for the LLM prompt. """
         formatted = []
@@ -715,11 +842,203 @@ class DevCodeRetriever(BaseRetriever):
             return path if path else None, name if name else None
         except Exception: return None, None
 
-    # --- Placeholders (Remove if brute_force_search is sufficient) ---
-    async def _get_node_details(self, node_id: str, graph_engine: GraphEngine) -> Optional[Dict]:
-        logger.warning(f"_get_node_details called for {node_id}. Should not be needed if brute_force_search projects correctly.")
-        return None
+    # --- Speculative Expansion ---
+    NEIGHBOR_SCORE = 0.6
+    MENTION_SCORE = 0.55
 
-    async def _get_edge_details(self, triplet_info: Dict, graph_engine: GraphEngine) -> Optional[Dict]:
-        logger.warning(f"_get_edge_details called. Should not be needed if brute_force_search projects correctly.")
-        return None
+    def _start_speculation(self, query: str, triplets: List[Dict], datasets: List[str], user: User) -> Speculation:
+        """Launches index expansions of the likely next-loop symbols; they run while the LLM plans."""
+        candidates = []
+        if self.speculative_candidates > 0 and datasets:
+            candidates = speculation_candidates(query, triplets[:self.max_llm_context_triplets], self.speculative_candidates)
+        return Speculation(candidates, lambda name: self._expand_symbol(name, datasets, user))
+
+    async def _expand_symbol(self, name: str, datasets: List[str], user: User) -> List[Dict]:
+        """
+        Exact-symbol triplets for `name`, cached as a Phase 1 search for it would be, plus its direct
+        callers and callees (one CALLS edge away) and the entities whose code mentions it. Index-only:
+        no search, no LLM.
+        """
+        versions = self.cache.versions.snapshot(tuple(sorted(set(datasets)))) if self.cache and datasets else None
+        start = time.perf_counter()
+        symbol_triplets, strong = await self._symbol_lookup(name, datasets)
+        if strong and versions is not None:
+            # A Phase 1 search for `name` returns exactly these, so the next loop asking for it is a cache hit.
+            self.cache.put("triplets", name, datasets, self.phase1_top_k, symbol_triplets, versions, time.perf_counter() - start, str(user.id))
+        roots = [t["source_node"] for t in symbol_triplets if t["edge"]["attributes"].get(self.edge_type_prop) == "DEFINED_IN"]
+        if not roots:
+            return symbol_triplets
+
+        def node(entity_id: str, fqn: str) -> Dict:
+            return {self.node_id_prop: entity_id, "attributes": {"name": fqn, "canonical_fqn": fqn}}
+
+        limit = self.speculative_expansion_limit
+        root = roots[0]
+        call_graph = get_call_graph()
+        try:
+            callers, callees, mentions = await asyncio.gather(
+                call_graph.neighbours(root[self.node_id_prop], "callers", limit),
+                call_graph.neighbours(root[self.node_id_prop], "callees", limit),
+                get_trigram_indexes().search(datasets, name.rsplit("::", 1)[-1], False, True, limit),
+            )
+        except Exception as e:
+            logger.warning(f"Speculative expansion of '{name}' kept only its symbol matches: {e}")
+            return symbol_triplets
+        triplets = list(symbol_triplets)
+        for caller in callers:
+            triplets.append({"score": self.NEIGHBOR_SCORE, "source_node": node(caller["entity_id"], caller["fqn"]),
+                             "edge": {"attributes": {self.edge_type_prop: "CALLS"}}, "target_node": root})
+        for callee in callees:
+            triplets.append({"score": self.NEIGHBOR_SCORE, "source_node": root,
+                             "edge": {"attributes": {self.edge_type_prop: "CALLS"}}, "target_node": node(callee["entity_id"], callee["fqn"])})
+        for hit in mentions:
+            source_id = hit["entity_ids"][-1] if hit["entity_ids"] else hit["chunk_id"]
+            if source_id == root[self.node_id_prop]:
+                continue
+            source = {self.node_id_prop: source_id, "attributes": {self.node_text_prop: hit["text"], "name": f"{hit['path']}:{hit['line']}",
+                                                                  "start_line": hit["line"], "end_line": hit["line"]}}
+            triplets.append({"score": self.MENTION_SCORE, "source_node": source,
+                             "edge": {"attributes": {self.edge_type_prop: "MENTIONS"}}, "target_node": root})
+        return triplets
+
+    # --- Exact Symbol Lookup ---
+    SYMBOL_MATCH_SCORES = {"exact": 1.0, "exact_ci": 0.95, "segment_suffix": 0.9, "prefix": 0.8, "name_prefix": 0.7}
+    # Match kinds that identify the symbol the query names; prefix matches are only candidates.
+    STRONG_SYMBOL_MATCHES = ("exact", "exact_ci", "segment_suffix")
+
+    async def _symbol_lookup(self, query: str, datasets: List[str]) -> Tuple[List[Dict], bool]:
+        """
+        Identifier-shaped queries are looked up in the in-process symbol index, as
+        (entity)-[DEFINED_IN]->(file) triplets, and whether any match is strong (STRONG_SYMBOL_MATCHES).
+        """
+        if not extract_identifiers(query):
+            return [], False
+        try:
+            index = get_symbol_index()
+            with timed(RETRIEVAL_PHASE_SECONDS, phase="symbol_lookup"):
+                await index.ensure_seeded()
+                matches = index.search(query, scopes=datasets, limit=self.phase1_top_k)
+                if not matches:
+                    return [], False
+                wanted = [p for p in self.node_properties_to_project if p != self.node_id_prop] + ["snippet_content"]
+                details = await get_node_details_batch([m["entity_id"] for m in matches], wanted)
+        except Exception as e:
+            logger.warning(f"Symbol index lookup failed for '{query[:100]}'; using semantic search: {e}")
+            return [], False
+
+        triplets = []
+        for match in matches:
+            attributes = {**details.get(match["entity_id"], {}), self.node_type_prop: match["entity_type"], "name": match["name"],
+                          "canonical_fqn": match["canonical_fqn"], "start_line": match["start_line"], "end_line": match["end_line"]}
+            attributes.setdefault(self.node_text_prop, attributes.get("snippet_content"))
+            file_id = "|".join(match["entity_id"].split("|", 2)[:2])
+            triplets.append({
+                "score": self.SYMBOL_MATCH_SCORES.get(match["match"], 0.5),
+                "source_node": {self.node_id_prop: match["entity_id"], "attributes": attributes},
+                "edge": {"attributes": {self.edge_type_prop: "DEFINED_IN"}},
+                "target_node": {self.node_id_prop: file_id, "attributes": {self.node_type_prop: "SourceFile", "name": match["path"]}},
+            })
+        try:
+            triplets.extend(await self._hierarchy_triplets(matches))
+        except Exception as e:
+            logger.warning(f"Class hierarchy lookup failed for '{query[:100]}': {e}")
+        return triplets, any(m["match"] in self.STRONG_SYMBOL_MATCHES for m in matches)
+
+    HIERARCHY_SCORE = 0.85
+
+    async def _hierarchy_triplets(self, matches: List[Dict]) -> List[Dict]:
+        """
+        For symbol matches that are classes or methods: (subclass)-[INHERITS_FROM]->(class) and
+        (override)-[OVERRIDES]->(method) triplets from the class hierarchy index.
+        """
+        hierarchy_index = get_class_hierarchy()
+        await hierarchy_index.ensure_seeded(sorted({m["repo"] for m in matches}))
+
+        def node(entity_id: str, entity_type: str, fqn: str) -> Dict:
+            return {self.node_id_prop: entity_id, "attributes": {self.node_type_prop: entity_type, "name": fqn, "canonical_fqn": fqn}}
+
+        triplets = []
+        for match in matches:
+            hierarchy = hierarchy_index.get(match["repo"]).derived()
+            target = node(match["entity_id"], match["entity_type"], match["canonical_fqn"])
+            related = []
+            if match["entity_id"] in hierarchy.methods:
+                related = [(hierarchy.methods[m], "OVERRIDES") for m in hierarchy.overriders.get(match["entity_id"], ())]
+                related = [(node(m.entity_id, "FunctionDefinition", m.canonical_fqn), edge) for m, edge in related]
+            elif info := hierarchy.classes.get(match["entity_id"]):
+                for key in sorted(hierarchy.descendants.get(info.key, ()), key=hierarchy.position.get):
+                    related += [(node(c, hierarchy.classes[c].entity_type, hierarchy.classes[c].canonical_fqn), "INHERITS_FROM") for c in hierarchy.class_ids.get(key, ())]
+            for source, edge_type in related[:self.phase1_top_k]:
+                triplets.append({"score": self.HIERARCHY_SCORE, "source_node": source, "edge": {"attributes": {self.edge_type_prop: edge_type}}, "target_node": target})
+        return triplets
+
+    # --- Batched Detail Fetch ---
+    # Attributes the graph holds per parser node kind: the entity's fields plus the adapter's node_type and slug_id.
+    STORED_NODE_ATTRIBUTES: Dict[str, Set[str]] = {model.__name__: set(model.model_fields) | {"node_type", "slug_id"} for model in get_args(AdaptableNode)}
+    # The parser's composite IDs by '|' segment count: repo|file, repo|file|chunk, repo|file|chunk|entity.
+    COMPOSITE_ID_KINDS = {2: "SourceFile", 3: "TextChunk", 4: "CodeEntity"}
+
+    def _stored_attributes(self, node: Dict) -> Optional[Set[str]]:
+        """What the graph can return for a node the parser wrote, or None for other nodes (unknown: fetch all)."""
+        attributes = node.get("attributes") or {}
+        for kind in (attributes.get("node_type"), attributes.get(self.node_type_prop)):
+            if kind in self.STORED_NODE_ATTRIBUTES:
+                return self.STORED_NODE_ATTRIBUTES[kind]
+        kind = self.COMPOSITE_ID_KINDS.get(len(str(node.get(self.node_id_prop) or "").split("|", 3)))
+        return self.STORED_NODE_ATTRIBUTES[kind] if kind else None
+
+    async def _fill_triplet_details(self, triplets: List[Dict]) -> List[Dict]:
+        """
+        Completes projected node/edge properties the search did not return. All node IDs and
+        (source, target) pairs of the phase are de-duplicated and fetched in one batched query
+        per kind, projecting only node_properties_to_project/edge_properties_to_project.
+        A parser node is fetched only for projected properties its kind stores, and an edge between
+        two of them only for its type: the rest of the projection (e.g. text, dataset_path) is
+        never in the graph for them, so its absence does not warrant a round trip.
+        """
+        node_props = [p for p in self.node_properties_to_project if p != self.node_id_prop]
+        edge_props = self.edge_properties_to_project
+        node_ids, pairs = set(), set()
+        for triplet in triplets:
+            if not isinstance(triplet, dict): continue
+            source, target = triplet.get("source_node") or {}, triplet.get("target_node") or {}
+            source_id, target_id = source.get(self.node_id_prop), target.get(self.node_id_prop)
+            stored = [self._stored_attributes(source), self._stored_attributes(target)]
+            for node, node_id, kind_attributes in ((source, source_id, stored[0]), (target, target_id, stored[1])):
+                wanted = set(node_props) if kind_attributes is None else set(node_props) & kind_attributes
+                if node_id and not wanted <= set(node.get("attributes") or {}):
+                    node_ids.add(node_id)
+            wanted = set(edge_props) if None in stored else {self.edge_type_prop}
+            if source_id and target_id and not wanted <= set((triplet.get("edge") or {}).get("attributes") or {}):
+                pairs.add((source_id, target_id))
+        if not node_ids and not pairs:
+            return triplets
+
+        try:
+            node_details, edge_rows = await asyncio.gather(
+                get_node_details_batch(sorted(node_ids), node_props),
+                get_edge_details_batch(sorted(pairs), edge_props),
+            )
+        except Exception as e:
+            logger.warning(f"Batched detail fetch failed ({len(node_ids)} nodes, {len(pairs)} edges); using search results as-is: {e}")
+            return triplets
+        logger.debug(f"Fetched details for {len(node_details)}/{len(node_ids)} nodes and {len(edge_rows)} edges in one batch.")
+
+        edges_by_pair: Dict[Tuple[str, str], List[Dict]] = {}
+        for source_id, target_id, rel_type, attributes in edge_rows:
+            edges_by_pair.setdefault((source_id, target_id), []).append({self.edge_type_prop: rel_type, **attributes})
+        for triplet in triplets:
+            if not isinstance(triplet, dict): continue
+            for key in ("source_node", "target_node"):
+                node = triplet.get(key)
+                if isinstance(node, dict) and node.get(self.node_id_prop) in node_details:
+                    node["attributes"] = {**node_details[node[self.node_id_prop]], **(node.get("attributes") or {})}
+            pair = ((triplet.get("source_node") or {}).get(self.node_id_prop), (triplet.get("target_node") or {}).get(self.node_id_prop))
+            candidates = edges_by_pair.get(pair, [])
+            edge = triplet.setdefault("edge", {})
+            existing = edge.get("attributes") or {}
+            edge_type = existing.get(self.edge_type_prop)
+            matches = [c for c in candidates if c.get(self.edge_type_prop) == edge_type] if edge_type else candidates
+            if len(matches) == 1:
+                edge["attributes"] = {**matches[0], **existing}
+        return triplets
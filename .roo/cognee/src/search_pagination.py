@@ -0,0 +1,196 @@
+# .roo/cognee/src/search_pagination.py
+"""
+Cursor pagination and field projection for the MCP search tool.
+
+A search's result list is computed once and kept server-side for cursor_ttl_seconds; only its first
+result_limit items are taken, and the response's truncated flag says whether there were more. Each
+call returns one page: only that page's items are projected to the requested fields and serialized,
+one item at a time, until page_size items or max_bytes of JSON are written. The response carries an
+opaque next_cursor (query fingerprint, the list's nonce, offset). Every first page computes a new
+list under a new nonce, so clients running the same query never page through each other's lists.
+Following a cursor serves the next page from its list, so pages stay consistent while the graph
+changes underneath. An expired cursor re-runs the search and resumes at its offset.
+
+Projection fields: id, fqn, type, location (path, start_line, end_line), snippet (truncated).
+Graph triplets project each end and keep the relationship name.
+"""
+import base64
+import hashlib
+import json
+import secrets
+import time
+from collections import OrderedDict
+from itertools import islice
+from typing import Any, Awaitable, Callable, Iterable, Iterator, List, NamedTuple, Optional, Sequence, Tuple
+
+from src.parser.configs import (
+    SEARCH_CURSOR_TTL_SECONDS, SEARCH_PAGE_MAX_BYTES, SEARCH_PAGE_SIZE, SEARCH_RESULT_LIMIT, SEARCH_SNIPPET_MAX_CHARS,
+)
+from src.parser.metrics import increment, observe, SEARCH_PAGE_BYTES, SEARCH_PAGES
+
+FIELDS = ("id", "fqn", "type", "location", "snippet")
+DEFAULT_FIELDS = ("id", "fqn", "type", "location")
+
+class CursorError(ValueError):
+    """A cursor that is malformed or belongs to a different query."""
+
+def query_fingerprint(*parts: str) -> str:
+    return hashlib.sha1("\x00".join(" ".join((p or "").lower().split()) for p in parts).encode("utf-8")).hexdigest()[:16]
+
+def encode_cursor(fingerprint: str, offset: int, nonce: str = "") -> str:
+    return base64.urlsafe_b64encode(f"{fingerprint}:{nonce}:{offset}".encode("ascii")).decode("ascii").rstrip("=")
+
+def _parse_cursor(cursor: str) -> Tuple[str, str, int]:
+    try:
+        text = base64.urlsafe_b64decode(cursor + "=" * (-len(cursor) % 4)).decode("ascii")
+        owner, nonce, offset = text.split(":")
+        return owner, nonce, int(offset)
+    except (ValueError, UnicodeDecodeError) as e:
+        raise CursorError(f"Malformed cursor: {cursor!r}") from e
+
+def cursor_owner(cursor: str) -> Optional[str]:
+    """The fingerprint of the query a cursor was issued for; None when it is malformed."""
+    try:
+        return _parse_cursor(cursor)[0]
+    except CursorError:
+        return None
+
+def decode_cursor(cursor: str, fingerprint: str) -> Tuple[str, int]:
+    """The (nonce, offset) of a cursor issued for `fingerprint`."""
+    owner, nonce, offset = _parse_cursor(cursor)
+    if owner != fingerprint or offset < 0:
+        raise CursorError("Cursor does not belong to this query.")
+    return nonce, offset
+
+def normalize_fields(fields: Optional[Iterable[str]]) -> Tuple[str, ...]:
+    if not fields:
+        return DEFAULT_FIELDS
+    unknown = set(fields) - set(FIELDS)
+    if unknown:
+        raise ValueError(f"Unknown fields {sorted(unknown)}; choose from {list(FIELDS)}.")
+    return tuple(f for f in FIELDS if f in set(fields))
+
+# --- Projection ---
+
+def _first(d: dict, *keys: str) -> Any:
+    for key in keys:
+        if d.get(key) not in (None, ""):
+            return d[key]
+    return None
+
+def project_entity(d: dict, fields: Sequence[str]) -> dict:
+    """An entity-like dict (symbol-index match, graph node, code search hit) reduced to `fields`."""
+    from src.parser.interval_index import span_of
+    from src.parser.symbol_index import locate
+    entity_id = _first(d, "entity_id", "id")
+    entity_id = str(entity_id) if entity_id is not None else None
+    out = {}
+    if "id" in fields and entity_id:
+        out["id"] = entity_id
+    if "fqn" in fields and (fqn := _first(d, "canonical_fqn", "qualified_name", "name")):
+        out["fqn"] = str(fqn)
+    if "type" in fields and (kind := _first(d, "entity_type", "type")):
+        out["type"] = str(kind)
+    if "location" in fields:
+        path = _first(d, "path", "relative_path", "file_path")
+        # Only chunk and entity IDs ('file id|chunk@s-e[|fqn@s-e]') end in a line span; a SourceFile's ends in its content hash.
+        spanned = entity_id and (entity_id.count("|") >= 2 or (d.get("start_line") and d.get("end_line")))
+        span = span_of(entity_id, d) if spanned else None
+        if not path and entity_id and "|" in entity_id:
+            path = locate(entity_id)[1]
+        if path:
+            out["location"] = {"path": str(path)}
+            if span:
+                out["location"].update(start_line=span.start_line, end_line=span.end_line)
+    if "snippet" in fields and (text := _first(d, "snippet_content", "source_code", "text", "signature")):
+        text = str(text)
+        out["snippet"] = text if len(text) <= SEARCH_SNIPPET_MAX_CHARS else text[:SEARCH_SNIPPET_MAX_CHARS] + "…"
+    return out
+
+def project(item: Any, fields: Sequence[str]) -> dict:
+    if isinstance(item, dict):
+        return project_entity(item, fields)
+    if isinstance(item, (tuple, list)) and len(item) == 3 and all(isinstance(x, dict) for x in item):
+        source, edge, target = item
+        return {"source": project_entity(source, fields), "relationship": edge.get("relationship_name"),
+                "target": project_entity(target, fields)}
+    text = str(item)
+    return {"value": text if len(text) <= SEARCH_SNIPPET_MAX_CHARS else text[:SEARCH_SNIPPET_MAX_CHARS] + "…"}
+
+# --- Pages ---
+
+def iter_page_json(source: str, results: List[Any], fingerprint: str, offset: int, page_size: int,
+                   fields: Sequence[str], max_bytes: int, nonce: str = "", truncated: bool = False) -> Iterator[str]:
+    """
+    The page starting at `offset` as JSON text chunks; items are projected and encoded as they are
+    written. `total` counts the held results; `truncated` says the search found more than that.
+    """
+    head = json.dumps({"source": source, "total": len(results), "truncated": truncated, "offset": offset, "fields": list(fields)})
+    yield head[:-1] + ', "results": ['
+    written, end = len(head), offset
+    while end < len(results) and end - offset < page_size:
+        chunk = json.dumps(project(results[end], fields), ensure_ascii=False, default=str)
+        size = len(chunk.encode("utf-8")) + 2
+        if end > offset and written + size > max_bytes:
+            break
+        yield ("" if end == offset else ", ") + chunk
+        written += size
+        end += 1
+    next_cursor = encode_cursor(fingerprint, end, nonce) if end < len(results) else None
+    yield f'], "next_cursor": {json.dumps(next_cursor)}}}'
+
+class _HeldResults(NamedTuple):
+    stored_at: float
+    nonce: str
+    results: List[Any]
+    truncated: bool
+
+class SearchPager:
+    """Server-side result lists behind search cursors, one per first page issued."""
+    def __init__(self, max_entries: int = 64, ttl_seconds: float = SEARCH_CURSOR_TTL_SECONDS, result_limit: int = SEARCH_RESULT_LIMIT):
+        self.max_entries = max_entries
+        self.ttl_seconds = ttl_seconds
+        self.result_limit = result_limit
+        self._results: "OrderedDict[Tuple[str, str], _HeldResults]" = OrderedDict()
+
+    async def _results_for(self, fingerprint: str, compute: Callable[[], Awaitable[Iterable[Any]]], nonce: Optional[str]) -> Tuple[_HeldResults, bool]:
+        """The list a cursor's nonce names while it is held; otherwise a new one under a new nonce."""
+        entry = self._results.get((fingerprint, nonce)) if nonce is not None else None
+        if entry is not None and time.monotonic() - entry.stored_at <= self.ttl_seconds:
+            self._results.move_to_end((fingerprint, nonce))
+            return entry, True
+        # One item past the limit tells whether there were more, without copying the rest.
+        taken = list(islice(await compute(), self.result_limit + 1))
+        entry = _HeldResults(time.monotonic(), secrets.token_hex(4), taken[:self.result_limit], len(taken) > self.result_limit)
+        self._results[(fingerprint, entry.nonce)] = entry
+        while len(self._results) > self.max_entries:
+            self._results.popitem(last=False)
+        return entry, False
+
+    async def page(self, source: str, fingerprint: str, compute: Callable[[], Awaitable[Iterable[Any]]],
+                   cursor: Optional[str] = None, page_size: Optional[int] = None, fields: Optional[Iterable[str]] = None,
+                   max_bytes: int = SEARCH_PAGE_MAX_BYTES) -> Iterator[str]:
+        """
+        One page of `compute()`'s results as JSON chunks. A first page (no cursor) recomputes the
+        results; a cursor reuses the list its first page produced while it is still held.
+        """
+        fields = normalize_fields(fields)
+        nonce, offset = decode_cursor(cursor, fingerprint) if cursor else (None, 0)
+        entry, cached = await self._results_for(fingerprint, compute, nonce)
+        increment(SEARCH_PAGES, source=source, results="cached" if cached else "computed")
+        page_size = max(1, min(int(page_size or SEARCH_PAGE_SIZE), self.result_limit))
+        return iter_page_json(source, entry.results, fingerprint, min(offset, len(entry.results)), page_size, fields, max_bytes,
+                              entry.nonce, entry.truncated)
+
+    async def render(self, *args, **kwargs) -> str:
+        text = "".join(await self.page(*args, **kwargs))
+        observe(SEARCH_PAGE_BYTES, len(text))
+        return text
+
+_pager: Optional[SearchPager] = None
+
+def get_search_pager() -> SearchPager:
+    global _pager
+    if _pager is None:
+        _pager = SearchPager()
+    return _pager
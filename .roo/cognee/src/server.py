@@ -3,13 +3,10 @@ import json
 import os
 import sys
 import re
-import subprocess
-import tempfile
-from urllib.parse import urlparse
 import cognee
 from cognee.shared.logging_utils import get_logger, get_log_file_location
 import importlib.util
-from contextlib import redirect_stdout
+from contextlib import AsyncExitStack, redirect_stdout
 
 import mcp.types as types
 from mcp.server import Server, NotificationOptions
@@ -17,11 +14,15 @@ from mcp.server.models import InitializationOptions
 from cognee.api.v1.cognify.code_graph_pipeline import run_code_graph_pipeline
 from cognee.modules.search.types import SearchType
 from cognee.shared.data_models import KnowledgeGraph
-from cognee.modules.storage.utils import JSONEncoder
+from src.parser.configs import GIT_MIRROR_ALLOW_FILE_URLS
 
 mcp = Server("cognee")
 logger = get_logger()
 
+# Repository URLs codify fetches through the git mirror cache instead of reading from disk; file:// only when
+# GIT_MIRROR_ALLOW_FILE_URLS is set.
+REMOTE_REPO_PATTERN = r'^(https?|ssh|git)://|^[^/@\s-][^/@\s]*@[^:/\s]+:' + (r'|^file://' if GIT_MIRROR_ALLOW_FILE_URLS else '')
+
 
 @mcp.list_tools()
 async def list_tools() -> list[types.Tool]:
@@ -58,6 +59,10 @@ async def list_tools() -> list[types.Tool]:
                         "type": "string",
                         "description": "Path to repository - can be a GitHub URL (https://github.com/username/repo) or a local path (/workspace/...). Local paths will be accessed with the same path structure as in the devcontainer.",
                     },
+                    "ref": {
+                        "type": "string",
+                        "description": "Branch, tag or commit to codify for a remote repository (default: its HEAD).",
+                    },
                 },
                 "required": ["repo_path"],
             },
@@ -76,6 +81,19 @@ async def list_tools() -> list[types.Tool]:
                         "type": "string",
                         "description": "The type of search to perform (e.g., INSIGHTS, CODE)",
                     },
+                    "cursor": {
+                        "type": "string",
+                        "description": "next_cursor from the previous page of the same query",
+                    },
+                    "page_size": {
+                        "type": "integer",
+                        "description": "Results per page (default 20); a page is also cut short at the server's size limit",
+                    },
+                    "fields": {
+                        "type": "array",
+                        "items": {"type": "string", "enum": ["id", "fqn", "type", "location", "snippet"]},
+                        "description": "Fields to return per result (default: id, fqn, type, location)",
+                    },
                 },
                 "required": ["search_query"],
             },
@@ -85,6 +103,140 @@ async def list_tools() -> list[types.Tool]:
             description="Prunes knowledge graph",
             inputSchema={"type": "object", "properties": {}},
         ),
+        types.Tool(
+            name="link_stats",
+            description="Reports the PendingLink backlog per repo@branch: counts by status, age buckets, per-tier resolution and escalation rates, top unresolved targets and enhancement cycle durations",
+            inputSchema={
+                "type": "object",
+                "properties": {
+                    "repo": {
+                        "type": "string",
+                        "description": "Repository as 'repo_id@branch'; omit for every repository in the graph",
+                    },
+                    "top": {
+                        "type": "integer",
+                        "description": "Number of unresolved target expressions to list (default 10)",
+                    },
+                    "refresh": {
+                        "type": "boolean",
+                        "description": "Rebuild the repository's counters from the graph before reporting",
+                    },
+                },
+            },
+        ),
+        types.Tool(
+            name="code_search",
+            description="Substring or regex search over indexed source text, answered from the trigram index; returns matching lines with their path, line number, chunk ID and enclosing code entity IDs",
+            inputSchema={
+                "type": "object",
+                "properties": {
+                    "repo": {
+                        "type": "string",
+                        "description": "Repository scope: 'repo_id' for every branch or 'repo_id@branch'",
+                    },
+                    "pattern": {
+                        "type": "string",
+                        "description": "Text to find, or a Python regular expression when 'regex' is true",
+                    },
+                    "regex": {"type": "boolean", "description": "Treat the pattern as a regular expression"},
+                    "case_sensitive": {"type": "boolean", "description": "Match case exactly (default false)"},
+                    "limit": {"type": "integer", "description": "Maximum number of matching lines (default 50)"},
+                },
+                "required": ["repo", "pattern"],
+            },
+        ),
+        types.Tool(
+            name="call_graph",
+            description="Transitive callers (what can reach a function, i.e. its change impact) or transitive callees of a function, answered from the maintained call-graph reachability index over resolved FUNCTION_CALL edges",
+            inputSchema={
+                "type": "object",
+                "properties": {
+                    "repo": {
+                        "type": "string",
+                        "description": "Repository scope: 'repo_id' for every branch or 'repo_id@branch'",
+                    },
+                    "function": {
+                        "type": "string",
+                        "description": "Function name (e.g. 'utility_printer', 'ns::Class::method') or CodeEntity ID",
+                    },
+                    "direction": {
+                        "type": "string",
+                        "enum": ["callers", "callees"],
+                        "description": "'callers' (default) or 'callees'",
+                    },
+                    "limit": {"type": "integer", "description": "Maximum number of functions listed (default 200)"},
+                },
+                "required": ["repo", "function"],
+            },
+        ),
+        types.Tool(
+            name="class_hierarchy",
+            description="Class hierarchy and override lookups from the precomputed hierarchy index: overrides of a method (matched by normalized signature), methods it overrides, transitive subclasses or concrete ones (no pure virtual left unimplemented), transitive bases, or the topologically ordered class table",
+            inputSchema={
+                "type": "object",
+                "properties": {
+                    "repo": {
+                        "type": "string",
+                        "description": "Repository scope: 'repo_id' for every branch or 'repo_id@branch'",
+                    },
+                    "name": {
+                        "type": "string",
+                        "description": "Method (e.g. 'Base1::commonMethod', optionally with a parameter list) or class name; ignored for 'classes'",
+                    },
+                    "kind": {
+                        "type": "string",
+                        "enum": ["overrides", "overridden", "subclasses", "concrete_subclasses", "bases", "classes"],
+                        "description": "What to list (default 'overrides')",
+                    },
+                },
+                "required": ["repo"],
+            },
+        ),
+        types.Tool(
+            name="graph_analytics",
+            description="Whole-graph analytics over a CSR snapshot of one repository branch: highest fan-in entities, include cycles, dead-code candidates (functions nothing calls), or PageRank centrality",
+            inputSchema={
+                "type": "object",
+                "properties": {
+                    "repo": {
+                        "type": "string",
+                        "description": "Repository branch as 'repo_id@branch'",
+                    },
+                    "analysis": {
+                        "type": "string",
+                        "enum": ["fan_in", "include_cycles", "dead_code", "pagerank"],
+                        "description": "Which analysis to run",
+                    },
+                    "top": {
+                        "type": "integer",
+                        "description": "Maximum number of results (default 20)",
+                    },
+                },
+                "required": ["repo", "analysis"],
+            },
+        ),
+        types.Tool(
+            name="entity_at",
+            description="The innermost code entity at a source position and the scopes enclosing it, from the per-file interval index",
+            inputSchema={
+                "type": "object",
+                "properties": {
+                    "repo": {
+                        "type": "string",
+                        "description": "Repository branch as 'repo_id@branch'",
+                    },
+                    "path": {
+                        "type": "string",
+                        "description": "File path relative to the repository root",
+                    },
+                    "line": {
+                        "type": "integer",
+                        "description": "1-based line number",
+                    },
+                },
+                "required": ["repo", "path", "line"],
+            },
+        ),
     ]
 
 @mcp.call_tool()
@@ -107,7 +259,7 @@ async def call_tools(name: str, arguments: dict) -> list[types.TextContent]:
                 )
                 return [types.TextContent(type="text", text=text)]
             if name == "codify":
-                asyncio.create_task(codify(arguments.get("repo_path")))
+                asyncio.create_task(codify(arguments.get("repo_path"), arguments.get("ref")))
                 text = (
                     "Background process launched due to MCP timeout limitations.\n"
                     "Average completion time is around 4 minutes.\n"
@@ -115,11 +267,35 @@ async def call_tools(name: str, arguments: dict) -> list[types.TextContent]:
                 )
                 return [types.TextContent(type="text", text=text)]
             elif name == "search":
-                search_results = await search(arguments["search_query"], arguments["search_type"])
+                search_results = await search(
+                    arguments["search_query"], arguments.get("search_type"), arguments.get("cursor"),
+                    arguments.get("page_size"), arguments.get("fields"),
+                )
                 return [types.TextContent(type="text", text=search_results)]
             elif name == "prune":
                 await prune()
                 return [types.TextContent(type="text", text="Pruned")]
+            elif name == "link_stats":
+                stats = await link_stats(arguments.get("repo"), arguments.get("top", 10), arguments.get("refresh", False))
+                return [types.TextContent(type="text", text=stats)]
+            elif name == "code_search":
+                hits = await code_search(
+                    arguments["repo"], arguments["pattern"], arguments.get("regex", False),
+                    arguments.get("case_sensitive", False), arguments.get("limit", 50),
+                )
+                return [types.TextContent(type="text", text=hits)]
+            elif name == "call_graph":
+                reach = await call_graph(arguments["repo"], arguments["function"], arguments.get("direction", "callers"), arguments.get("limit", 200))
+                return [types.TextContent(type="text", text=reach)]
+            elif name == "class_hierarchy":
+                hierarchy = await class_hierarchy(arguments["repo"], arguments.get("name", ""), arguments.get("kind", "overrides"))
+                return [types.TextContent(type="text", text=hierarchy)]
+            elif name == "graph_analytics":
+                analytics = await graph_analytics(arguments["repo"], arguments["analysis"], arguments.get("top", 20))
+                return [types.TextContent(type="text", text=analytics)]
+            elif name == "entity_at":
+                located = await entity_at(arguments["repo"], arguments["path"], arguments["line"])
+                return [types.TextContent(type="text", text=located)]
     except Exception as e:
         logger.error(f"Error calling tool '{name}': {str(e)}")
         return [types.TextContent(type="text", text=f"Error calling tool '{name}': {str(e)}")]
@@ -142,55 +318,32 @@ async def cognify(text: str, graph_model_file: str = None, graph_model_name: str
             raise ValueError(f"Failed to cognify: {str(e)}")
 
 
-async def codify(repo_path: str):
+async def codify(repo_path: str, ref: str = None):
     """Transform the codebase into a knowledge graph.
     Args:
         repo_path: Can be either:
-            - A GitHub URL (https://github.com/username/repo)
+            - A GitHub URL (https://github.com/username/repo), or another git remote URL
             - A local path in the workspace (/workspace/...)
+        ref: Branch, tag or commit of a remote repository to codify; defaults to its HEAD.
+    Remote repositories are served from the git mirror cache: cloned once, then only fetched.
     """
+    from src.git_mirror_cache import GitMirrorError, get_git_mirror_cache
     with redirect_stdout(sys.stderr):
         logger.info(f"Codify process starting for: {repo_path}")
-        is_github_url = False
-        local_repo_path = repo_path
-        temp_dir = None
-        github_pattern = r'^https?://github\.com/[^/]+/[^/]+(/)?$'
-        if re.match(github_pattern, repo_path):
-            is_github_url = True
-            logger.info(f"Detected GitHub repository URL: {repo_path}")
-            temp_dir = tempfile.mkdtemp(prefix="cognee_repo_")
-            try:
-                parsed_url = urlparse(repo_path)
-                path_parts = parsed_url.path.strip('/').split('/')
-                if len(path_parts) >= 2:
-                    owner, repo_name = path_parts[0], path_parts[1]
-                    logger.info(f"Cloning repository {owner}/{repo_name} to {temp_dir}")
-                clone_cmd = ["git", "clone", repo_path, temp_dir]
-                logger.info(f"Running: {' '.join(clone_cmd)}")
-                process = subprocess.run(
-                    clone_cmd,
-                    check=True,
-                    stdout=subprocess.PIPE,
-                    stderr=subprocess.PIPE,
-                    text=True
-                )
-                logger.info(f"Clone output: {process.stdout}")
-                local_repo_path = temp_dir
-                logger.info(f"Successfully cloned repository to {local_repo_path}")
-            except subprocess.CalledProcessError as e:
-                logger.error(f"Git clone failed: {e.stderr}")
-                raise ValueError(f"Failed to clone repository: {e.stderr}")
-            except Exception as e:
-                logger.error(f"Error during repository cloning: {str(e)}")
-                if temp_dir and os.path.exists(temp_dir):
-                    import shutil
-                    shutil.rmtree(temp_dir)
-                raise ValueError(f"Failed to process repository: {str(e)}")
-        elif not os.path.exists(local_repo_path):
-            logger.error(f"Repository path does not exist: {local_repo_path}")
-            raise FileNotFoundError(f"Repository path {local_repo_path} does not exist. "
-                                    f"Please provide a valid local path or GitHub URL.")
-        try:
+        async with AsyncExitStack() as stack:
+            local_repo_path = repo_path
+            if re.match(REMOTE_REPO_PATTERN, repo_path):
+                logger.info(f"Detected remote repository URL: {repo_path} (ref: {ref or 'HEAD'})")
+                try:
+                    local_repo_path = await stack.enter_async_context(get_git_mirror_cache().checkout(repo_path, ref))
+                except GitMirrorError as e:
+                    logger.error(f"Git mirror checkout failed: {e}")
+                    raise ValueError(f"Failed to check out repository: {e}")
+                logger.info(f"Using cached checkout at {local_repo_path}")
+            elif not os.path.exists(local_repo_path):
+                logger.error(f"Repository path does not exist: {local_repo_path}")
+                raise FileNotFoundError(f"Repository path {local_repo_path} does not exist. "
+                                        f"Please provide a valid local path or GitHub URL.")
             logger.info(f"Processing repository at: {local_repo_path}")
             results = []
             async for result in run_code_graph_pipeline(local_repo_path, False):
@@ -200,26 +353,57 @@ async def codify(repo_path: str):
                 logger.info("Codify process finished successfully.")
             else:
                 logger.info("Codify process failed.")
-        finally:
-            if is_github_url and temp_dir and os.path.exists(temp_dir):
-                import shutil
-                logger.info(f"Cleaning up temporary directory: {temp_dir}")
-                shutil.rmtree(temp_dir)
 
 
-async def search(search_query: str, search_type: str) -> str:
-    """Search the knowledge graph."""
+# Search types whose results are code entities, which a symbol index match can stand in for.
+SYMBOL_SEARCH_TYPES = ("CODE", "INSIGHTS")
+
+async def search(search_query: str, search_type: str, cursor: str = None, page_size: int = None, fields: list = None) -> str:
+    """
+    Search the knowledge graph. For the entity-listing types (SYMBOL_SEARCH_TYPES), identifier-shaped
+    queries are answered from the symbol index first; completion and chunk searches always go to cognee.
+    Result lists are paginated: one projected page per call, with next_cursor pointing at the next one.
+    """
+    from src.search_pagination import cursor_owner, get_search_pager, query_fingerprint
     with redirect_stdout(sys.stderr):
-        search_results = await cognee.search(
-            query_type=SearchType[search_type.upper()], query_text=search_query
-        )
-        if search_type.upper() == "CODE":
-            return json.dumps(search_results, cls=JSONEncoder)
-        elif search_type.upper() in ("GRAPH_COMPLETION", "RAG_COMPLETION"):
+        pager = get_search_pager()
+        search_type = (search_type or "INSIGHTS").upper()
+        symbol_key = query_fingerprint("symbol_index", search_query)
+        if search_type in SYMBOL_SEARCH_TYPES:
+            async def symbol_search():
+                return await _symbol_search(search_query, pager.result_limit + 1)
+            if cursor is not None and cursor_owner(cursor) == symbol_key:
+                # Later pages come from the held list; the lookup reruns only once that has expired.
+                return await pager.render("symbol_index", symbol_key, symbol_search, cursor, page_size, fields)
+            # The first page runs it up front: no matches means the query goes to cognee instead.
+            if cursor is None and (symbol_matches := await symbol_search()):
+                return await pager.render("symbol_index", symbol_key, _constant(symbol_matches), cursor, page_size, fields)
+        if search_type in ("GRAPH_COMPLETION", "RAG_COMPLETION"):
+            search_results = await cognee.search(query_type=SearchType[search_type], query_text=search_query)
             return search_results[0]
-        else:
-            results = retrieved_edges_to_string(search_results)
-            return results
+
+        async def compute():
+            return await cognee.search(query_type=SearchType[search_type], query_text=search_query)
+        return await pager.render(search_type.lower(), query_fingerprint(search_type, search_query), compute, cursor, page_size, fields)
+
+
+def _constant(results: list):
+    async def compute():
+        return results
+    return compute
+
+
+async def _symbol_search(search_query: str, limit: int = 20) -> list:
+    from src.parser.symbol_index import extract_identifiers, get_symbol_index
+    if not extract_identifiers(search_query):
+        return []
+    try:
+        index = get_symbol_index()
+        await index.ensure_seeded()
+        return index.search(search_query, limit=limit)
+    except Exception as e:
+        logger.warning(f"Symbol index lookup failed, falling back to semantic search: {e}")
+        return []
 
 
 async def prune():
@@ -228,21 +412,47 @@ async def prune():
     await cognee.prune.prune_system(metadata=True)
 
 
-def node_to_string(node):
-    node_data = ", ".join(
-        [f'{key}: "{value}"' for key, value in node.items() if key in ["id", "name"]]
-    )
-    return f"Node({node_data})"
+async def link_stats(repo: str = None, top: int = 10, refresh: bool = False) -> str:
+    """PendingLink backlog stats as JSON."""
+    from src.parser.link_stats import get_link_backlog_stats
+    with redirect_stdout(sys.stderr):
+        return json.dumps(await get_link_backlog_stats(repo, top, refresh), indent=2)
 
 
-def retrieved_edges_to_string(search_results):
-    edge_strings = []
-    for triplet in search_results:
-        node1, edge, node2 = triplet
-        relationship_type = edge["relationship_name"]
-        edge_str = f"{node_to_string(node1)} {relationship_type} {node_to_string(node2)}"
-        edge_strings.append(edge_str)
-    return "\n".join(edge_strings)
+async def code_search(repo: str, pattern: str, regex: bool = False, case_sensitive: bool = False, limit: int = 50) -> str:
+    """Trigram-index substring/regex search as JSON."""
+    from src.parser.trigram_index import get_trigram_indexes
+    with redirect_stdout(sys.stderr):
+        hits = await get_trigram_indexes().search([repo], pattern, regex, case_sensitive, limit)
+        return json.dumps({"source": "trigram_index", "matches": hits}, indent=2)
+
+
+async def call_graph(repo: str, function: str, direction: str = "callers", limit: int = 200) -> str:
+    """Transitive callers or callees from the call-graph index as JSON."""
+    from src.parser.call_graph import get_call_graph
+    with redirect_stdout(sys.stderr):
+        return json.dumps(await get_call_graph().query([repo], function, direction, limit), indent=2)
+
+
+async def class_hierarchy(repo: str, name: str = "", kind: str = "overrides") -> str:
+    """Class hierarchy / override lookups as JSON."""
+    from src.parser.class_hierarchy import get_class_hierarchy
+    with redirect_stdout(sys.stderr):
+        return json.dumps(await get_class_hierarchy().query([repo], name, kind), indent=2)
+
+
+async def graph_analytics(repo: str, analysis: str, top: int = 20) -> str:
+    """CSR snapshot analytics as JSON."""
+    from src.parser.graph_snapshot import analyze
+    with redirect_stdout(sys.stderr):
+        return json.dumps(await analyze(repo, analysis, top), indent=2)
+
+
+async def entity_at(repo: str, path: str, line: int) -> str:
+    """Innermost entity and enclosing scopes at a position as JSON."""
+    from src.parser.interval_index import get_interval_indexes
+    with redirect_stdout(sys.stderr):
+        return json.dumps(await get_interval_indexes().entity_at(repo, path, int(line)), indent=2)
 
 
 def load_class(model_file, model_name):
@@ -256,7 +466,11 @@ def run_sse_server():
     from mcp.server.sse import SseServerTransport
     from starlette.applications import Starlette
     from starlette.routing import Route, Mount
+    from starlette.responses import Response
     import uvicorn
+    from src.parser.metrics import render_response
+    from src.parser.parser_registry import prewarm_from_config
+    prewarm_from_config()
     sse = SseServerTransport("/messages/")
     async def handle_sse(request):
         async with sse.connect_sse(
@@ -275,10 +489,17 @@ def run_sse_server():
                 ),
                 raise_exceptions=True,
             )
+    # This process only serves retrieval, so these routes carry retrieval metrics; ingestion and
+    # enhancement metrics are served by sharded_ingest / replay --metrics-port (see src/parser/metrics.py).
+    async def handle_metrics(request):
+        status, content_type, body = render_response(request.url.path)
+        return Response(body, status_code=status, headers={"Content-Type": content_type})
     starlette_app = Starlette(
         debug=True,
         routes=[
             Route("/sse", endpoint=handle_sse),
+            Route("/metrics", endpoint=handle_metrics),
+            Route("/metrics.json", endpoint=handle_metrics),
             Mount("/messages/", app=sse.handle_post_message),
         ],
     )
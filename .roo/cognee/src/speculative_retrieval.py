@@ -0,0 +1,79 @@
+# .roo/cognee/src/speculative_retrieval.py
+"""
+Speculative expansions that DevCodeRetriever runs while the LLM plans.
+
+A planning call takes seconds, and the in-process indexes answer in milliseconds. So while the planner
+reads the current context, the retriever expands the symbols it is most likely to ask about next.
+Those are the identifiers in the question plus the best-scored entities already in context. Each
+candidate gets an exact-symbol lookup, its call-graph neighbours and its trigram mentions. When the
+plan loops, every expansion whose symbol its search_query names is merged into the next context.
+Expansions it did not ask for are cancelled. No LLM calls are added, and a plan that stops wastes
+only index lookups.
+
+The exact-symbol lookups go through the retriever's result cache under the same key a Phase 1 search
+for that symbol would use. A next-loop query that is just that symbol is therefore already answered.
+"""
+import asyncio
+import re
+from typing import Awaitable, Callable, Dict, Iterable, List, Optional
+
+from src.parser.metrics import increment, SPECULATIVE_EXPANSIONS
+from src.parser.symbol_index import IDENTIFIER_RE, extract_identifiers, name_segments, split_signature
+
+_WORD_RE = re.compile(r"~?[A-Za-z_]\w*(?:::~?[A-Za-z_]\w*)*")
+
+def speculation_candidates(query: str, triplets: Iterable[Dict], limit: int) -> List[str]:
+    """The question's identifiers, then the names of the highest-scored entities in context, de-duplicated."""
+    names = list(extract_identifiers(query))
+    for triplet in sorted(triplets, key=lambda t: t.get("score", 0), reverse=True):
+        for key in ("source_node", "target_node"):
+            attributes = (triplet.get(key) or {}).get("attributes") or {}
+            name = attributes.get("canonical_fqn") or attributes.get("name")
+            if isinstance(name, str) and IDENTIFIER_RE.match(name.strip()):
+                names.append(split_signature(name.strip())[0])
+    seen, candidates = set(), []
+    for name in names:
+        if name and name.lower() not in seen:
+            seen.add(name.lower())
+            candidates.append(name)
+    return candidates[:limit]
+
+def named_in(candidate: str, query: str) -> bool:
+    """Whether `query` mentions `candidate`, qualified or by its last name segment (case-insensitive)."""
+    words = {w.lower() for w in _WORD_RE.findall(query or "")}
+    words |= {segments[-1].lower() for w in list(words) if (segments := name_segments(w))}
+    segments = name_segments(candidate)
+    return candidate.lower() in words or bool(segments) and segments[-1].lower() in words
+
+class Speculation:
+    """The expansions launched for one planning call."""
+    def __init__(self, candidates: Iterable[str], expand: Callable[[str], Awaitable[List[Dict]]]):
+        self.tasks: Dict[str, asyncio.Task] = {c: asyncio.ensure_future(expand(c)) for c in candidates}
+
+    async def take(self, search_query: str, timeout: Optional[float] = None) -> List[Dict]:
+        """
+        Triplets of the expansions `search_query` names, waiting up to `timeout` for any still running.
+        Every other expansion is cancelled; a failed or late one contributes nothing.
+        """
+        wanted = {c: t for c, t in self.tasks.items() if named_in(c, search_query)}
+        if pending := [t for t in wanted.values() if not t.done()]:
+            await asyncio.wait(pending, timeout=timeout)
+        triplets = []
+        for candidate in wanted:
+            task = self.tasks.pop(candidate)
+            if task.done() and not task.cancelled() and task.exception() is None:
+                triplets.extend(task.result())
+                increment(SPECULATIVE_EXPANSIONS, outcome="used")
+            else:
+                self.tasks[candidate] = task
+        self.cancel()
+        return triplets
+
+    def cancel(self):
+        for task in self.tasks.values():
+            increment(SPECULATIVE_EXPANSIONS, outcome="unused")
+            if not task.done():
+                task.cancel()
+            elif not task.cancelled():
+                task.exception()  # Retrieved, so an expansion's failure is not reported as unhandled.
+        self.tasks = {}
@@ -1,8 +1,11 @@
 # .roo/cognee/tests/conftest.py
 from dataclasses import dataclass
+from pathlib import Path
+from typing import List
 import pytest
 # IMPORTANT: Import the new, correct entities
-from src.parser.entities import CodeEntity, RawSymbolReference, ParserOutput
+from src.parser.entities import CodeEntity, RawSymbolReference, ParserOutput, FileProcessingRequest
+from tests.shared_test_utils import DirectiveParser
 
 @dataclass
 class ParserTestOutput:
@@ -23,3 +26,50 @@ def parse_file_and_collect_output():
                 output.raw_symbol_references.append(item)
         return output
     return _parse_and_collect
+
+class _NoDispatch:
+    async def notify_ingestion_activity(self, *args):
+        pass
+
+class LocalGraph:
+    """What the `local_graph` fixture yields: the embedded backend and an 'org/repo@main' checkout to ingest from."""
+    def __init__(self, backend, root: Path):
+        self.backend, self.root = backend, root
+
+    def request(self, name: str, is_delete: bool = False) -> FileProcessingRequest:
+        return FileProcessingRequest(absolute_path=str(self.root / name), repo_path=str(self.root), repo_id="org/repo", branch="main", commit_index=1, is_delete=is_delete)
+
+    async def ingest(self, name: str, text: str):
+        from src.parser import orchestrator
+        (self.root / name).write_text(text)
+        assert await orchestrator.process_single_file(self.request(name))
+
+    async def delete(self, name: str):
+        from src.parser import orchestrator
+        (self.root / name).unlink()
+        assert await orchestrator.process_single_file(self.request(name, is_delete=True))
+
+@pytest.fixture
+def local_graph(tmp_path: Path, monkeypatch):
+    """
+    Ingestion into an embedded graph with DirectiveParser for every file and no enhancement
+    dispatcher. The per-process code indexes, link stats and graph versions start empty.
+    """
+    from src.parser import (call_graph, class_hierarchy, graph_snapshot, graph_utils, graph_versions, include_graph,
+                            interval_index, link_stats, local_graph_backend, orchestrator, symbol_index, trigram_index)
+    from src.parser.local_graph_backend import LocalGraphBackend
+    backend = LocalGraphBackend(str(tmp_path / "graph.db"))
+    monkeypatch.setattr(orchestrator, "get_parser_for_file", lambda path: DirectiveParser())
+    monkeypatch.setattr(orchestrator, "get_dispatcher", lambda: _NoDispatch())
+    monkeypatch.setattr(graph_utils, "GRAPH_BACKEND", "local")
+    monkeypatch.setattr(local_graph_backend, "_instance", backend)
+    for module, singleton in ((symbol_index, "_index"), (call_graph, "_index"), (class_hierarchy, "_index"),
+                              (include_graph, "_index"), (trigram_index, "_indexes"), (interval_index, "_indexes"),
+                              (link_stats, "_tracker"), (graph_versions, "_versions")):
+        monkeypatch.setattr(module, singleton, None)
+    monkeypatch.setattr(graph_snapshot, "_snapshots", {})
+    monkeypatch.setattr(graph_snapshot, "_locks", {})
+    root = tmp_path / "repo"
+    root.mkdir()
+    yield LocalGraph(backend, root)
+    backend.close()
@@ -4,6 +4,7 @@ import asyncio
 from pathlib import Path
 from typing import List, Optional, Any
 import os
+from unittest.mock import patch
 
 # --- Cognee src imports ---
 # IMPORTANT: We import the new data contracts
@@ -103,6 +104,10 @@ async def test_parse_my_class_hpp(cpp_parser: CppParser):
     assert find_code_entity_by_exact_temp_id(ces, "Processing::MyDataProcessor@9")
     assert find_code_entity_by_exact_temp_id(ces, "Processing::MyDataProcessor::MyDataProcessor(const std::string&)@15")
     assert find_code_entity_by_exact_temp_id(ces, "Processing::helperFunction(int)@29")
+    # Every definition spans its full node, so enclosing scopes contain what they define.
+    assert all(1 <= ce.start_line <= ce.end_line for ce in ces)
+    namespace = next(ce for ce in ces if ce.type == "NamespaceDefinition")
+    assert all(namespace.start_line <= ce.start_line and ce.end_line <= namespace.end_line for ce in ces)
 
     # Test references (includes)
     string_include = find_raw_symbol_references(refs, target_expression="string", reference_type="INCLUDE")
@@ -159,3 +164,27 @@ async def test_parse_calls_specific(cpp_parser: CppParser):
 
     static_call = find_raw_symbol_references(refs, source_entity_id_prefix="main_calls_demo", target_expression="MemberCallTester::static_method_target", reference_type="FUNCTION_CALL")
     assert len(static_call) == 1
+
+@pytest.mark.skipif(get_language("cpp") is None, reason="The parallel walk re-parses the file in workers, so it needs the C++ grammar.")
+@pytest.mark.parametrize("filename", ["calls_specific.cpp", "inheritance_variations.hpp", "closely_packed_definitions.cpp"])
+async def test_parallel_extraction_matches_sequential(cpp_parser: CppParser, filename: str):
+    sequential = await run_parser(cpp_parser, filename)
+    with patch("src.parser.parsers.cpp_parser.PARALLEL_EXTRACTION_MIN_LINES", 1), \
+         patch("src.parser.parsers.cpp_parser.PARALLEL_EXTRACTION_MAX_WORKERS", 2):
+        parallel = await run_parser(cpp_parser, filename)
+
+    assert parallel.slice_lines == sequential.slice_lines
+    assert [ce.model_dump() for ce in parallel.code_entities] == [ce.model_dump() for ce in sequential.code_entities]
+    assert [ref.model_dump() for ref in parallel.raw_symbol_references] == [ref.model_dump() for ref in sequential.raw_symbol_references]
+
+async def test_pool_workers_get_a_share_of_the_extraction_workers():
+    import multiprocessing
+    from concurrent.futures import ProcessPoolExecutor
+    from src.parser.parsers.cpp_parser import PARALLEL_EXTRACTION_MAX_WORKERS, extraction_workers, set_extraction_worker_budget
+    assert extraction_workers() == PARALLEL_EXTRACTION_MAX_WORKERS
+    context = multiprocessing.get_context("spawn")
+    # Without a budget a pool worker extracts serially; with one it gets cores / pool size.
+    with ProcessPoolExecutor(max_workers=1, mp_context=context) as executor:
+        assert executor.submit(extraction_workers).result() == 1
+    with ProcessPoolExecutor(max_workers=1, mp_context=context, initializer=set_extraction_worker_budget, initargs=(1,)) as executor:
+        assert executor.submit(extraction_workers).result() == min(os.cpu_count() or 1, PARALLEL_EXTRACTION_MAX_WORKERS)
@@ -0,0 +1,84 @@
+# .roo/cognee/tests/parser/test_bulk_reader.py
+import asyncio
+import pytest
+import hashlib
+from pathlib import Path
+from unittest.mock import patch
+
+from src.parser.bulk_reader import read_files_bulk, BulkReadResult
+from src.parser.utils import read_file_content
+
+pytestmark = pytest.mark.asyncio
+
+SAMPLES = {
+    "ascii.cpp": b"int main() {\n    return 0;\n}\n",
+    "utf8.txt": "Line 1\nUTF-8 char: \xe9\n".encode("utf-8"),
+    "crlf.txt": b"first\r\nsecond\rthird\n",
+    "invalid.bin": b"ok\xff\xfebytes\n",
+    "empty.txt": b"",
+}
+
+async def collect(paths, **kwargs):
+    return [r async for r in read_files_bulk(paths, **kwargs)]
+
+async def test_bulk_read_matches_read_file_content(tmp_path: Path):
+    paths = []
+    for name, data in SAMPLES.items():
+        (tmp_path / name).write_bytes(data)
+        paths.append(str(tmp_path / name))
+
+    results = await collect(paths, batch_size=2, max_inflight_batches=2)
+
+    assert [r.path for r in results] == paths
+    for result in results:
+        expected = await read_file_content(result.path)
+        assert result.content == expected
+        assert result.content_hash == hashlib.sha256(expected.encode("utf-8")).hexdigest()
+        assert result.size == Path(result.path).stat().st_size
+        assert result.error is None
+
+async def test_bulk_read_reports_missing_file(tmp_path: Path):
+    present = tmp_path / "present.txt"
+    present.write_text("data")
+    missing = tmp_path / "missing.txt"
+
+    with patch("src.parser.bulk_reader.logger") as mock_logger:
+        results = await collect([str(missing), str(present)])
+
+    assert results[0] == BulkReadResult(str(missing), None, None, error="not found")
+    assert results[1].content == "data"
+    mock_logger.error.assert_called_once()
+
+async def test_bulk_read_empty_input():
+    assert await collect([]) == []
+
+async def test_bulk_ingest_bounds_the_reads_waiting_for_workers(tmp_path: Path, monkeypatch):
+    from src.parser import orchestrator
+    from src.parser.entities import FileProcessingRequest
+    paths = []
+    for i in range(12):
+        (tmp_path / f"f{i}.txt").write_text(f"file {i}\n")
+        paths.append(str(tmp_path / f"f{i}.txt"))
+    requests = [FileProcessingRequest(absolute_path=p, repo_path=str(tmp_path), repo_id="org/repo", branch="main", commit_index=1, is_delete=False) for p in paths]
+    read, processed, waiting = [], [], []
+
+    async def reader(paths, **kwargs):
+        async for result in read_files_bulk(paths, batch_size=1, max_inflight_batches=1):
+            read.append(result.path)
+            yield result
+
+    async def process(request, preloaded, redo=False):
+        waiting.append(len(read) - len(processed))
+        await asyncio.sleep(0.001)
+        processed.append(request.absolute_path)
+        return True
+
+    monkeypatch.setattr(orchestrator, "read_files_bulk", reader)
+    monkeypatch.setattr(orchestrator, "process_single_file", process)
+    monkeypatch.setattr(orchestrator, "BULK_INGEST_QUEUE_SIZE", 2)
+    with patch("src.parser.orchestrator.logger") as mock_logger:
+        await orchestrator.process_files_bulk(requests + requests[:1], concurrency=2)
+
+    assert sorted(processed) == sorted(paths)  # The duplicate is read and ingested once...
+    mock_logger.warning.assert_called_once()  # ...and reported.
+    assert max(waiting) <= 2 + 2 + 1  # Queued, in workers, and the one the reader holds.
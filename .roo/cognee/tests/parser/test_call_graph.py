@@ -0,0 +1,74 @@
+# .roo/cognee/tests/parser/test_call_graph.py
+import pytest
+import random
+
+from src.parser.call_graph import CallGraphIndex, RepoCallGraph, get_call_graph
+
+pytestmark = pytest.mark.asyncio
+
+REPO = "org/repo@main"
+
+def fn(name: str, path: str = "a.cpp") -> str:
+    return f"{REPO}|{path}@1-1|0@1-9|{name}@1"
+
+def naive_closure(edges, start):
+    seen, stack = set(), [start]
+    while stack:
+        node = stack.pop()
+        for target in [t for s, t in edges if s == node]:
+            if target not in seen:
+                seen.add(target); stack.append(target)
+    return seen
+
+async def test_incremental_condensation_matches_a_naive_traversal():
+    rng = random.Random(7)
+    nodes = [fn(f"f{i}", f"file{i % 4}.cpp") for i in range(14)]
+    graph, edges = RepoCallGraph(REPO), set()
+    for step in range(300):
+        if rng.random() < 0.75 or not edges:
+            edge = (rng.choice(nodes), rng.choice(nodes))
+            graph.add_edge(*edge); edges.add(edge)
+        elif rng.random() < 0.8:
+            edge = rng.choice(sorted(edges))
+            graph.remove_edge(*edge); edges.discard(edge)
+        else:
+            path = f"file{rng.randrange(4)}.cpp"
+            graph.remove_path(path)
+            edges = {(s, t) for s, t in edges if f"|{path}@" not in s and f"|{path}@" not in t}
+        if step % 10 == 0:
+            order = graph.pos
+            assert all(order[graph.comp[s]] <= order[graph.comp[t]] for s, t in edges)
+            for node in nodes:
+                reachable = naive_closure(edges, node)
+                assert graph.callees(node) == reachable
+                assert all(graph.reaches(node, other) == (other in reachable) for other in nodes)
+
+    fresh = RepoCallGraph(REPO)
+    fresh.load(edges)
+    assert fresh.stats()["components"] == graph.stats()["components"] and all(fresh.callers(n) == graph.callers(n) for n in nodes)
+
+async def test_resolved_calls_are_indexed_and_queried_by_name(local_graph):
+    ingest = local_graph.ingest
+
+    # Tier 1 resolves calls to entities already in the graph, so callees are ingested first.
+    await ingest("util.txt", "def utility_printer\n")
+    await ingest("mid.txt", "def helper\ncall utility_printer\n")
+    await ingest("main.txt", "def main\ncall helper\n")
+
+    callers = await get_call_graph().query(["org/repo"], "utility_printer", "callers")
+    assert sorted(r["fqn"] for r in callers["results"]) == ["helper", "main"] and callers["total"] == 2
+    callees = await get_call_graph().query(["org/repo@main"], "main", "callees")
+    assert sorted(r["fqn"] for r in callees["results"]) == ["helper", "utility_printer"]
+    main_id = callers["results"][[r["fqn"] for r in callers["results"]].index("main")]["entity_id"]
+    assert [r["fqn"] for r in await get_call_graph().neighbours(main_id, "callees")] == ["helper"]
+    assert await get_call_graph().neighbours(main_id, "callers") == []
+
+    # A fresh process loads the same edges from the graph in bulk.
+    fresh = CallGraphIndex()
+    await fresh.ensure_seeded(REPO)
+    assert fresh.get(REPO).stats() == get_call_graph().get(REPO).stats() == {"functions": 3, "calls": 2, "components": 3, "largest_component": 1}
+
+    await ingest("mid.txt", "def helper\n")
+    assert (await get_call_graph().query(["org/repo"], "utility_printer", "callers"))["results"] == []
+    with pytest.raises(ValueError):
+        await get_call_graph().query(["org/repo"], "main", "sideways")
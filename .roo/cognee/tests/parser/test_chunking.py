@@ -1,5 +1,5 @@
 import pytest
-from src.parser.chunking import generate_text_chunks_from_slice_lines
+from src.parser.chunking import generate_text_chunks_from_slice_lines, generate_intelligent_chunks
 from src.parser.entities import TextChunk
 
 pytestmark = pytest.mark.asyncio
@@ -84,3 +84,9 @@ def test_generate_chunks_with_duplicate_and_unsorted_slice_lines():
     assert len(chunks) == 2
     assert chunks[0].id == "repo|file.rs|0@1-3"
     assert chunks[1].id == "repo|file.rs|1@4-5"
+
+def test_generate_intelligent_chunks_uses_1_based_slice_lines():
+    content = "line 1\nline 2\nline 3\nline 4\n"
+    chunks = generate_intelligent_chunks("file|id", content, [1, 3])
+    assert [(c.start_line, c.end_line) for c in chunks] == [(1, 2), (3, 4)]
+    assert chunks[1].chunk_content == "line 3\nline 4\n"
@@ -0,0 +1,100 @@
+# .roo/cognee/tests/parser/test_class_hierarchy.py
+import asyncio
+import pytest
+
+from src.parser import graph_utils
+from src.parser.class_hierarchy import ClassHierarchyIndex, RepoHierarchy, base_expression, get_class_hierarchy, member_declarations
+
+pytestmark = pytest.mark.asyncio
+
+REPO = "org/repo@main"
+
+def eid(path: str, fqn: str, line: int = 1) -> str:
+    return f"{REPO}|{path}@1-1|0@1-50|{fqn}@{line}"
+
+async def test_hierarchy_order_transitive_bases_and_overrides():
+    assert base_expression("public virtual ns::Base<int>") == "ns::Base<int>" and base_expression("private") == ""
+    assert member_declarations("struct S : B {\n  virtual ~S();\n  void f(int a) const override;\n  virtual int g() = 0;\n  int h() { return k(1); }\n};") == \
+        {("f", "(int)", False), ("g", "()", True)}
+
+    h = RepoHierarchy(REPO)
+    for path, fqn, kind, snippet in [
+        ("base.hpp", "app::Base1", "ClassDefinition", "class Base1 {\n public:\n  virtual void reset(int n);\n  void helper();\n};"),
+        ("base.hpp", "app::Base1::commonMethod()", "FunctionDefinition", "virtual void commonMethod() { }"),
+        ("base.cpp", "app::Base1::reset(int n)", "FunctionDefinition", "void Base1::reset(int n) {"),
+        ("base.cpp", "app::Base1::helper()", "FunctionDefinition", "void Base1::helper() {"),
+        ("base.hpp", "app::Base2", "StructDefinition", "struct Base2 {\n  virtual int size() const = 0;\n};"),
+        ("base.hpp", "app::TemplatedBase<T>", "TemplateDefinition", "template <typename T> class TemplatedBase {"),
+        ("derived.cpp", "app::DerivedSingle", "ClassDefinition", "class DerivedSingle : public Base1 {"),
+        ("derived.cpp", "app::DerivedSingle::commonMethod()", "FunctionDefinition", "void DerivedSingle::commonMethod() {"),
+        ("derived.cpp", "app::DerivedSingle::commonMethod(int x)", "FunctionDefinition", "void commonMethod(int x) {"),
+        ("derived.cpp", "app::DerivedSingle::reset(int)", "FunctionDefinition", "void reset(int) {"),
+        ("derived.cpp", "app::DerivedSingle::helper()", "FunctionDefinition", "void helper() {"),
+        ("derived.cpp", "app::DerivedMultiple", "ClassDefinition", "class DerivedMultiple : public Base1, private Base2 {"),
+        ("leaf.cpp", "app::Leaf", "ClassDefinition", "class Leaf : public DerivedSingle, TemplatedBase<int> {"),
+        ("leaf.cpp", "app::Leaf::commonMethod()", "FunctionDefinition", "void commonMethod() override {"),
+    ]:
+        h.add_entity(eid(path, fqn), kind, fqn, snippet)
+    h.add_base(eid("derived.cpp", "app::DerivedSingle"), "public Base1")
+    h.add_base(eid("derived.cpp", "app::DerivedMultiple"), "Base1")
+    h.add_base(eid("derived.cpp", "app::DerivedMultiple"), "private app::Base2")
+    h.add_base(eid("leaf.cpp", "app::Leaf"), "DerivedSingle")
+    h.add_base(eid("leaf.cpp", "app::Leaf"), "TemplatedBase<int>")
+
+    table = h.class_table()
+    order = [row["class"] for row in table]
+    assert all(order.index(base) < order.index(row["class"]) for row in table for base in row["bases"])
+    assert h.ancestors["app::Leaf"] == ("app::DerivedSingle", "app::Base1", "app::TemplatedBase")
+    assert h.descendants["app::Base1"] == {"app::DerivedSingle", "app::DerivedMultiple", "app::Leaf"}
+
+    base_method = eid("base.hpp", "app::Base1::commonMethod()")
+    assert sorted(h.overriders[base_method]) == sorted([eid("derived.cpp", "app::DerivedSingle::commonMethod()"), eid("leaf.cpp", "app::Leaf::commonMethod()")])
+    assert eid("derived.cpp", "app::DerivedSingle::commonMethod()") in h.virtual  # Virtual through its base.
+    assert eid("derived.cpp", "app::DerivedSingle::commonMethod(int x)") not in h.overridden
+    assert [m.class_key for m in h.match_methods("Base1::commonMethod()")] == ["app::Base1"]
+    assert len(h.match_methods("commonMethod")) == 4
+    # reset is virtual by its in-class declaration; helper is not, so DerivedSingle's hides it.
+    assert h.overriders[eid("base.cpp", "app::Base1::reset(int n)")] == [eid("derived.cpp", "app::DerivedSingle::reset(int)")]
+    assert eid("base.cpp", "app::Base1::helper()") not in h.overriders and eid("derived.cpp", "app::DerivedSingle::helper()") not in h.virtual
+    # Base2::size() is pure and DerivedMultiple does not implement it.
+    assert {row["class"] for row in table if row["abstract"]} == {"app::Base2", "app::DerivedMultiple"}
+
+    h.remove_path("derived.cpp")
+    # Leaf's declared base is gone with derived.cpp, and with it the path to Base1.
+    assert h.derived().ancestors["app::Leaf"] == ("app::TemplatedBase",) and base_method not in h.overriders
+
+async def test_ingested_hierarchy_is_queryable_and_reseeded(local_graph, monkeypatch):
+    ingest = local_graph.ingest
+
+    await ingest("base.txt", "class Shape\npure Shape::area()\n")
+    await ingest("circle.txt", "class Circle\ninherit public Shape\ndef Circle::area()\ndef Circle::draw()\n")
+    await ingest("ring.txt", "class Ring\ninherit Circle\ndef Ring::area()\ndef Ring::draw()\n")
+    await ingest("blob.txt", "class Blob\ninherit Shape\n")
+
+    overrides = await get_class_hierarchy().query(["org/repo"], "Shape::area", "overrides")
+    assert sorted(r["class"] for r in overrides["results"]) == ["Circle", "Ring"] and all(r["virtual"] for r in overrides["results"])
+    assert (await get_class_hierarchy().query(["org/repo"], "Circle::draw", "overrides"))["total"] == 0  # Hidden, not overridden.
+    concrete = await get_class_hierarchy().query(["org/repo"], "Shape", "concrete_subclasses")
+    assert [r["class"] for r in concrete["results"]] == ["Circle", "Ring"]
+
+    # A fresh process rebuilds from entities plus resolved and pending INHERITANCE references.
+    fresh = ClassHierarchyIndex()
+    bases = await fresh.query(["org/repo@main"], "Ring", "bases")
+    assert [r["class"] for r in bases["results"]] == ["Circle", "Shape"]
+
+    # A reseed builds aside: readers keep the previous hierarchy until the scan finishes.
+    release, real_find = asyncio.Event(), graph_utils.find_nodes_with_filter
+    async def slow_find(*args, **kwargs):
+        await release.wait()
+        return await real_find(*args, **kwargs)
+    monkeypatch.setattr(graph_utils, "find_nodes_with_filter", slow_find)
+    previous = fresh.get("org/repo@main")
+    reseed = asyncio.ensure_future(fresh.ensure_seeded(["org/repo@main"], refresh=True))
+    await asyncio.sleep(0.01)
+    assert fresh.get("org/repo@main") is previous and len(previous) == 4
+    release.set()
+    await reseed
+    assert fresh.get("org/repo@main") is not previous and len(fresh.get("org/repo@main")) == 4
+
+    await ingest("ring.txt", "class Ring\n")
+    assert (await get_class_hierarchy().query(["org/repo"], "Shape", "subclasses"))["total"] == 2
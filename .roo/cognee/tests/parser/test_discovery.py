@@ -7,7 +7,7 @@ from typing import AsyncGenerator, Tuple, Set, Optional, List
 pytestmark = pytest.mark.asyncio
 
 from src.parser.discovery import discover_files
-from src.parser.config import IGNORED_DIRS, IGNORED_FILES, SUPPORTED_EXTENSIONS
+from src.parser.configs import IGNORED_DIRS, IGNORED_FILES, SUPPORTED_EXTENSIONS
 
 async def run_discovery_test_helper(path: str) -> list:
     results = []
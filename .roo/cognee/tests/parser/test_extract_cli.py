@@ -0,0 +1,45 @@
+# .roo/cognee/tests/parser/test_extract_cli.py
+import pytest
+import shutil
+from pathlib import Path
+
+from src.parser.entities import SourceFile
+from src.parser.extraction import extract_file_island, island_to_records, records_to_islands, read_records
+from src.parser.parsers.treesitter_setup import get_language
+from src.parser.utils import read_file_content
+from src.parser import extract_cli
+
+pytestmark = pytest.mark.asyncio
+
+CPP_FIXTURES_DIR = Path(__file__).resolve().parent / "test_data" / "cpp"
+
+def _comparable(records):
+    for record in records:
+        data = dict(record["data"])
+        data.pop("timestamp", None)
+        yield record["record"], data
+
+async def test_cli_output_matches_cpp_parser(tmp_path: Path):
+    if get_language("cpp") is None:
+        pytest.skip("C++ tree-sitter language not loaded or available.")
+    from src.parser.parsers.cpp_parser import CppParser
+
+    repo = tmp_path / "repo"
+    shutil.copytree(CPP_FIXTURES_DIR, repo)
+    out_path = tmp_path / "out.ndjson"
+    assert extract_cli.main([str(repo), "--repo-id", "org/repo", "--branch", "main", "--commit-index", "3", "-o", str(out_path), "-j", "2"]) == 0
+
+    islands = {i.source_file.relative_path: i for i in records_to_islands(read_records(str(out_path)))}
+    assert set(islands) == {p.name for p in CPP_FIXTURES_DIR.iterdir() if p.suffix in {".cpp", ".hpp"}}
+
+    for relative_path, island in islands.items():
+        content = await read_file_content(str(repo / relative_path))
+        expected_source = island.source_file.model_copy(update={"id": f"org/repo@main|{relative_path}@3-1"})
+        if content.strip():
+            expected = await extract_file_island(CppParser(), expected_source, content, "TEST")
+        else:
+            expected = island.__class__(source_file=expected_source)
+        assert list(_comparable(island_to_records(island))) == list(_comparable(island_to_records(expected))), relative_path
+
+async def test_cli_rejects_missing_repo(tmp_path: Path):
+    assert extract_cli.main([str(tmp_path / "missing"), "--repo-id", "r", "--branch", "b", "--commit-index", "1"]) == 2
@@ -0,0 +1,42 @@
+# .roo/cognee/tests/parser/test_extraction.py
+import pytest
+from pathlib import Path
+
+from src.parser.entities import SourceFile, TextChunk, CodeEntity, RawSymbolReference, ReferenceContext, ImportType
+from src.parser.extraction import FileIsland, island_to_records, records_to_islands, write_ndjson, read_records
+
+SFID = "org/repo@main|src/a.cpp@7-1"
+
+def make_island() -> FileIsland:
+    chunk = TextChunk(id=f"{SFID}|0@1-3", start_line=1, end_line=3, chunk_content="void f() {\n  g();\n}\n")
+    entity = CodeEntity(id=f"{chunk.id}|f()@1-3", type="FunctionDefinition", start_line=1, end_line=3, canonical_fqn="f()", snippet_content=chunk.chunk_content)
+    ref = RawSymbolReference(source_entity_id=entity.id, target_expression="g", reference_type="FUNCTION_CALL", context=ReferenceContext(import_type=ImportType.ABSOLUTE, path_parts=["g"]))
+    source_file = SourceFile(id=SFID, relative_path="src/a.cpp", commit_index=7, local_save=1, content_hash="abc")
+    return FileIsland(source_file, [chunk], [entity], [ref])
+
+def test_records_round_trip_through_ndjson(tmp_path: Path):
+    islands = [make_island(), FileIsland(SourceFile(id="org/repo@main|empty.h@7-1", relative_path="empty.h", commit_index=7, local_save=1))]
+    out_path = tmp_path / "out.ndjson"
+    with open(out_path, "w", encoding="utf-8") as out:
+        count = write_ndjson((r for island in islands for r in island_to_records(island)), out)
+    assert count == 5
+
+    restored = list(records_to_islands(read_records(str(out_path))))
+    assert [i.source_file for i in restored] == [i.source_file for i in islands]
+    assert restored[0].text_chunks == islands[0].text_chunks
+    assert restored[0].code_entities == islands[0].code_entities
+    assert restored[0].raw_references == islands[0].raw_references
+    assert restored[1].text_chunks == []
+
+def test_records_must_follow_their_source_file():
+    records = list(island_to_records(make_island()))
+    with pytest.raises(ValueError):
+        list(records_to_islands(records[1:]))
+
+def test_with_source_file_id_reroots_all_ids():
+    new_sfid = "org/repo@main|src/a.cpp@7-3"
+    island = make_island().with_source_file_id(new_sfid, 3)
+    assert island.source_file.id == new_sfid and island.source_file.local_save == 3
+    assert island.text_chunks[0].id == f"{new_sfid}|0@1-3"
+    assert island.code_entities[0].id == f"{new_sfid}|0@1-3|f()@1-3"
+    assert island.raw_references[0].source_entity_id == island.code_entities[0].id
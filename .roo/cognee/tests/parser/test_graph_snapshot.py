@@ -0,0 +1,87 @@
+# .roo/cognee/tests/parser/test_graph_snapshot.py
+import asyncio
+import os
+import pytest
+from pathlib import Path
+
+from src.parser import graph_snapshot, graph_versions
+from src.parser.graph_snapshot import CSRSnapshot, analyze, get_snapshot
+from src.parser.graph_versions import GraphVersions, get_graph_versions
+
+pytestmark = pytest.mark.asyncio
+
+def fqn(entity_id: str) -> str:
+    return entity_id.rsplit("|", 1)[1].split("@")[0]
+
+async def test_kernels_on_a_written_snapshot(tmp_path: Path):
+    nodes = ["a.h", "b.h", "c.h", "main", "helper", "unused"]
+    types = ["SourceFile", "SourceFile", "SourceFile", "FunctionDefinition", "FunctionDefinition", "FunctionDefinition"]
+    edges = [("a.h", "b.h", "INCLUDE"), ("b.h", "a.h", "INCLUDE"), ("b.h", "c.h", "INCLUDE"),
+             ("main", "helper", "FUNCTION_CALL"), ("a.h", "main", "CONTAINS"), ("a.h", "ghost", "CONTAINS")]
+    snapshot = CSRSnapshot.write(str(tmp_path / "snap"), "org/repo@main", nodes, types, edges, version=3)
+    assert (snapshot.n, snapshot.m) == (6, 5)  # The edge to an unknown node is dropped.
+
+    a = snapshot.index("a.h")
+    assert {nodes[i]: d for i, d in snapshot.bfs([a]).items()} == {"a.h": 0, "b.h": 1, "main": 1, "c.h": 2, "helper": 2}
+    assert {nodes[i] for i in snapshot.bfs([a], rel_types=["INCLUDE"], max_depth=1)} == {"a.h", "b.h"}
+    assert {nodes[i] for i in snapshot.bfs([snapshot.index("c.h")], direction="in")} == {"a.h", "b.h", "c.h"}
+    assert snapshot.cycles() == [["a.h", "b.h"]]
+    assert snapshot.dead_code_candidates() == ["main", "unused"]
+    assert snapshot.fan_in(2) == [("a.h", 1), ("b.h", 1)]
+
+    rank = snapshot.pagerank(iterations=200)
+    assert abs(sum(rank) - 1.0) < 1e-6 and rank[snapshot.index("c.h")] > rank[snapshot.index("unused")]
+
+    reopened = CSRSnapshot(str(tmp_path / "snap"))
+    assert reopened.version == 3 and list(reopened.out_targets) == list(snapshot.out_targets) and reopened.scc() == snapshot.scc()
+    snapshot.close(); reopened.close()
+
+async def test_snapshot_is_built_from_the_graph_and_rebuilt_when_stale(tmp_path: Path, local_graph, monkeypatch):
+    monkeypatch.setattr(graph_snapshot, "GRAPH_SNAPSHOT_DIR", str(tmp_path / "snapshots"))
+    ingest = local_graph.ingest
+
+    await ingest("util.txt", "def utility_printer\ndef orphan\n")
+    await ingest("main.txt", "def main\ncall utility_printer\n")
+
+    dead = await analyze("org/repo@main", "dead_code")
+    assert sorted(fqn(r["id"]) for r in dead["results"]) == ["main", "orphan"]
+    first = await get_snapshot("org/repo@main")
+    assert first.version == await get_graph_versions().stored_version("org/repo@main") and sorted(set(first.node_types)) == ["FunctionDefinition", "SourceFile"]
+
+    await ingest("other.txt", "def other\ncall orphan\n")
+    second = await get_snapshot("org/repo@main")
+    assert second is not first and second.n == first.n + 2
+    assert sorted(fqn(r["id"]) for r in (await analyze("org/repo@main", "dead_code"))["results"]) == ["main", "other"]
+    with pytest.raises(ValueError):
+        await analyze("org/repo@main", "betweenness")
+
+async def test_a_snapshot_on_disk_is_reused_by_a_new_process_until_the_graph_moves_on(tmp_path: Path, local_graph, monkeypatch):
+    monkeypatch.setattr(graph_snapshot, "GRAPH_SNAPSHOT_DIR", str(tmp_path / "snapshots"))
+    monkeypatch.setattr(graph_versions, "_versions", GraphVersions(poll_seconds=0))
+    await local_graph.ingest("util.txt", "def utility_printer\ndef orphan\n")
+    # Concurrent requests share one build, written through temp files of its own.
+    builds, real_build = [], graph_snapshot.build_snapshot
+    async def counted_build(*args, **kwargs):
+        builds.append(1)
+        return await real_build(*args, **kwargs)
+    monkeypatch.setattr(graph_snapshot, "build_snapshot", counted_build)
+    first, again = await asyncio.gather(get_snapshot("org/repo@main"), get_snapshot("org/repo@main"))
+    assert first is again and len(builds) == 1
+    assert sorted(os.listdir(tmp_path / "snapshots")) == ["org__repo@main.csr", "org__repo@main.json"]
+
+    # A new process maps the file instead of rebuilding it.
+    monkeypatch.setattr(graph_snapshot, "_snapshots", {})
+    async def no_build(*args, **kwargs):
+        raise AssertionError("rebuilt a current snapshot")
+    monkeypatch.setattr(graph_snapshot, "build_snapshot", no_build)
+    reopened = await get_snapshot("org/repo@main")
+    assert reopened is not first and reopened.version == first.version and reopened.node_ids == first.node_ids
+
+    # Once the stored version moves on, the next request rebuilds.
+    await local_graph.ingest("main.txt", "def main\ncall orphan\n")
+    monkeypatch.setattr(graph_snapshot, "build_snapshot", real_build)
+    with reopened.reading():
+        rebuilt = await get_snapshot("org/repo@main")
+        assert list(reopened.out_offsets)  # Still mapped while a kernel reads it.
+    assert rebuilt.version == first.version + 1 and rebuilt.n == first.n + 2
+    assert sorted(fqn(r["id"]) for r in (await analyze("org/repo@main", "dead_code"))["results"]) == ["main", "utility_printer"]
@@ -0,0 +1,83 @@
+# .roo/cognee/tests/parser/test_include_graph.py
+import pytest
+
+from src.parser import graph_enhancement_engine, graph_utils
+from src.parser.dispatcher import IntelligentEnrichmentDispatcher
+from src.parser.entities import LinkStatus
+from src.parser.graph_enhancement_engine import run_header_impact_recheck
+from src.parser.include_graph import IncludeGraphIndex, RepoIncludeGraph, get_include_graph, reference_name
+
+pytestmark = pytest.mark.asyncio
+
+REPO = "org/repo@main"
+
+async def test_transitive_includers_and_declaration_diff():
+    assert reference_name("ns::Box<int>::get(int a)") == "get" and reference_name("ptr->run") == "run"
+    g = RepoIncludeGraph(REPO)
+    g.set_file("include/util.h", [], {"u1": ("app::helper()", "void helper()"), "u2": ("app::gone()", "int gone()")})
+    g.set_file("include/other/util.h", [], {})
+    g.set_file("include/mid.h", [("util.h", True)], {})
+    g.set_file("src/main.cpp", [("mid.h", False)], {})
+    g.set_file("src/local.cpp", [("../include/other/util.h", True)], {})
+    g.set_file("src/leaf.cpp", [("other/util.h", False)], {})
+    assert g.dependents("include/util.h") == {"include/mid.h", "src/main.cpp"}  # Quoted resolves next to the includer first.
+    assert g.dependents("include/other/util.h") == {"src/local.cpp", "src/leaf.cpp"}
+
+    g.record_delete("include/util.h", [("m1", "u1", "FUNCTION_CALL"), ("m1", "u2", "FUNCTION_CALL"), ("x", "chunk", "CONTAINS_CHUNK")])
+    g.remove_path("include/util.h")
+    g.set_file("include/util.h", [], {"v1": ("app::helper()", "void helper()"), "v2": ("app::later()", "void later()")})
+    plan = g.plan()
+    assert plan.headers == {"include/util.h": {"app::gone()", "app::later()"}}
+    assert plan.files == {"include/mid.h": {"gone", "later"}, "src/main.cpp": {"gone", "later"}}
+    assert plan.repoint == [("m1", "include/util.h", "app::helper()", "FUNCTION_CALL")]
+    assert plan.recheck == [("m1", "app::gone()", "FUNCTION_CALL")]
+    assert plan.revisions == {"include/util.h": 1}
+
+async def test_header_reingest_repoints_and_reopens_only_dependent_links(local_graph, monkeypatch):
+    backend = local_graph.backend
+    ingest = local_graph.ingest
+
+    async def calls_from(fqn: str):
+        source = (await graph_utils.find_nodes_with_filter({"type": "CodeEntity", "canonical_fqn": fqn}))[0].id
+        return sorted(t.rsplit("|", 1)[1].split("@")[0] for _, t, r, _ in await backend.get_edges(source_id=source) if r == "FUNCTION_CALL")
+
+    async def links(expression: str):
+        return [n.attributes["status"] for n in await graph_utils.find_nodes_with_filter({"type": "PendingLink"})
+                if n.attributes["reference_data"]["target_expression"] == expression]
+
+    await ingest("util.h", "def helper\ndef gone\n")
+    await ingest("mid.h", "include util.h\n")
+    await ingest("main.cpp", "include mid.h\ndef main\ncall helper\ncall gone\ncall later\n")
+    await ingest("solo.cpp", "def solo\ncall later\n")
+    for node in await graph_utils.find_nodes_with_filter({"type": "PendingLink"}):
+        if node.attributes["reference_data"]["target_expression"] == "later":
+            await graph_utils.update_pending_link_status(node.id, LinkStatus.UNRESOLVABLE)
+    assert await calls_from("main") == ["gone", "helper"]
+
+    await ingest("util.h", "def helper\ndef later\n")
+    assert await calls_from("main") == []  # The delete detached both resolved calls.
+    plan = await get_include_graph().plan(REPO)
+    assert plan.files == {"mid.h": {"gone", "later"}, "main.cpp": {"gone", "later"}}
+    # The change is stored with the delete: a new process plans the same.
+    assert (await IncludeGraphIndex().plan(REPO)).to_dict() == plan.to_dict()
+
+    # A recheck that fails leaves the change for the next cycle.
+    async def failing(*args):
+        raise ConnectionError("graph went away")
+    real_recheck = graph_enhancement_engine._run_impact_recheck
+    monkeypatch.setattr(graph_enhancement_engine, "_run_impact_recheck", failing)
+    with pytest.raises(ConnectionError):
+        await run_header_impact_recheck(REPO)
+    monkeypatch.setattr(graph_enhancement_engine, "_run_impact_recheck", real_recheck)
+    assert (await get_include_graph().plan(REPO)).to_dict() == plan.to_dict()
+
+    assert (await run_header_impact_recheck(REPO)).repoint[0][2] == "helper"
+    assert await calls_from("main") == ["helper"]
+    assert await links("gone") == [LinkStatus.PENDING_RESOLUTION.value]
+    # main.cpp includes the header and is reopened; solo.cpp does not and keeps its verdict.
+    assert sorted(await links("later")) == [LinkStatus.PENDING_RESOLUTION.value, LinkStatus.UNRESOLVABLE.value]
+    assert await get_include_graph().plan(REPO) is None
+
+    await ingest("util.h", "def helper\ndef later\ndef extra\n")
+    await IntelligentEnrichmentDispatcher()._run_full_enhancement_cycle(REPO)
+    assert await calls_from("main") == ["helper", "later"]
@@ -0,0 +1,88 @@
+# .roo/cognee/tests/parser/test_ingest_journal.py
+import pytest
+import os
+import sqlite3
+from pathlib import Path
+
+from src.parser.ingest_journal import IngestJournal, JournalEntry, FileState
+from src.parser.sharded_ingest import ShardedIngestCoordinator
+from tests.shared_test_utils import MemoryIslandSink, make_text_repo
+
+pytestmark = pytest.mark.asyncio
+
+def stat_entry(path: str, rel: str, state: FileState) -> JournalEntry:
+    st = os.stat(path)
+    return JournalEntry(rel, state, st.st_size, st.st_mtime_ns, "hash")
+
+async def test_journal_uses_wal_and_keeps_stats_across_states(tmp_path: Path):
+    files = make_text_repo(tmp_path / "repo", 2)
+    journal = IngestJournal(str(tmp_path / "journal.db"), "org/repo@main", 3)
+    journal.record([stat_entry(*files[0], FileState.PARSED)])
+    journal.record([JournalEntry(files[0][1], FileState.COMMITTED)])
+    journal.close()
+
+    conn = sqlite3.connect(str(tmp_path / "journal.db"))
+    assert conn.execute("PRAGMA journal_mode").fetchone()[0] == "wal"
+    row = conn.execute("SELECT state, size, content_hash FROM file_progress").fetchone()
+    assert row == ("committed", os.stat(files[0][0]).st_size, "hash")
+
+async def test_filter_pending_skips_only_unchanged_committed_files(tmp_path: Path):
+    files = make_text_repo(tmp_path / "repo", 3)
+    journal = IngestJournal(str(tmp_path / "journal.db"), "org/repo@main", 3)
+    journal.record([stat_entry(*files[0], FileState.COMMITTED), stat_entry(*files[1], FileState.COMMITTED), stat_entry(*files[2], FileState.FAILED)])
+
+    Path(files[1][0]).write_text("changed since the last run\n")
+    pending, skipped = journal.filter_pending(files)
+    assert skipped == 1
+    assert [rel for _, rel in pending] == [files[1][1], files[2][1]]
+
+    other_commit = IngestJournal(str(tmp_path / "journal.db"), "org/repo@main", 4)
+    assert other_commit.filter_pending(files) == (files, 0)
+
+async def test_sharded_ingest_resumes_from_journal(tmp_path: Path):
+    files = make_text_repo(tmp_path / "repo", 10)
+    journal_path = str(tmp_path / "journal.db")
+
+    first = await ShardedIngestCoordinator(MemoryIslandSink(), num_workers=2, journal=IngestJournal(journal_path, "org/repo@main", 1)).run(files, "org/repo", "main", 1)
+    assert first.committed == 10 and first.skipped == 0
+
+    Path(files[4][0]).write_text("edited\n")
+    sink = MemoryIslandSink()
+    journal = IngestJournal(journal_path, "org/repo@main", 1)
+    second = await ShardedIngestCoordinator(sink, num_workers=2, journal=journal).run(files, "org/repo", "main", 1)
+    assert second.skipped == 9
+    assert [i.source_file.relative_path for g in sink.groups for i in g] == [files[4][1]]
+    assert journal.state_counts() == {"committed": 10}
+
+async def test_bulk_ingest_redoes_incomplete_files_and_fails_unparseable_ones(tmp_path: Path, monkeypatch):
+    from src.parser import graph_utils, local_graph_backend, orchestrator
+    from src.parser.entities import FileProcessingRequest
+    from src.parser.local_graph_backend import LocalGraphBackend
+    from tests.shared_test_utils import DirectiveParser
+
+    class _NoDispatch:
+        async def notify_ingestion_activity(self, *args):
+            pass
+
+    files = make_text_repo(tmp_path / "repo", 2)
+    parsers = {files[0][0]: DirectiveParser(), files[1][0]: DirectiveParser()}
+    monkeypatch.setattr(orchestrator, "get_parser_for_file", lambda path: parsers.get(str(path)))
+    monkeypatch.setattr(orchestrator, "get_dispatcher", lambda: _NoDispatch())
+    monkeypatch.setattr(graph_utils, "GRAPH_BACKEND", "local")
+    monkeypatch.setattr(local_graph_backend, "_instance", LocalGraphBackend(str(tmp_path / "graph.db")))
+    requests = [FileProcessingRequest(absolute_path=a, repo_path=str(tmp_path / "repo"), repo_id="org/repo", branch="main", commit_index=1, is_delete=False) for a, _ in files]
+    requests.append(FileProcessingRequest(absolute_path=str(tmp_path / "elsewhere.txt"), repo_path=str(tmp_path / "repo"), repo_id="org/repo", branch="main", commit_index=1, is_delete=False))
+    journal = IngestJournal(str(tmp_path / "journal.db"), "org/repo@main", 1)
+    await orchestrator.process_files_bulk(requests, journal=journal)
+    assert journal.state_counts() == {"committed": 2}  # The path outside the repository is rejected, not journaled.
+
+    async def versions():
+        return sorted(n.attributes["local_save"] for n in await graph_utils.find_nodes_with_filter({"type": "SourceFile"}))
+
+    # A crash after the graph write but before the journal's COMMITTED leaves the file READ: it is redone, not skipped.
+    journal.record([JournalEntry(files[0][1], FileState.READ)])
+    del parsers[files[1][0]]
+    journal.record([JournalEntry(files[1][1], FileState.READ)])
+    await orchestrator.process_files_bulk(requests[:2], journal=journal)
+    assert await versions() == [1, 2]  # files[0] was re-ingested; files[1], with no parser, kept its version...
+    assert journal.state_counts() == {"committed": 1, "failed": 1}  # ...and is reported as a failure.
@@ -0,0 +1,67 @@
+# .roo/cognee/tests/parser/test_interval_index.py
+import pytest
+import random
+from pathlib import Path
+
+from src.parser import graph_versions, interval_index
+from src.parser.graph_versions import GraphVersions
+from src.parser.interval_index import EntitySpan, FileIntervals, IntervalIndexes, get_interval_indexes, span_of
+
+pytestmark = pytest.mark.asyncio
+
+REPO = "org/repo@main"
+
+def nested_spans(rng: random.Random, start: int, end: int, depth: int, out: list):
+    line = start
+    while line <= end and depth < 4:
+        length = rng.randint(0, max(0, min(12, end - line)))
+        out.append(EntitySpan(f"e{len(out)}", line, line + length, "FunctionDefinition", f"f{len(out)}"))
+        if length > 1 and rng.random() < 0.6:
+            nested_spans(rng, line + 1, line + length - 1, depth + 1, out)
+        line += length + rng.randint(1, 3)
+
+async def test_innermost_and_enclosing_match_a_linear_scan():
+    rng = random.Random(11)
+    for _ in range(30):
+        spans: list = []
+        nested_spans(rng, 1, 120, 0, spans)
+        spans.append(EntitySpan("twin", spans[0].start_line, spans[0].end_line, "TemplateDefinition", "twin"))  # Same span, emitted later: inner.
+        intervals = FileIntervals(spans)
+        for line in range(0, 125):
+            containing = [s for s in spans if s.start_line <= line <= s.end_line]
+            expected = sorted(containing, key=lambda s: (s.end_line - s.start_line, -spans.index(s)))
+            assert intervals.innermost(line) == (expected[0] if expected else None)
+            assert intervals.enclosing(line) == expected
+    assert span_of("r|a.cpp@1-1|0@1-9|f()@3-7", {"type": "FunctionDefinition"}).end_line == 7
+
+async def test_index_follows_ingest_and_persists(tmp_path: Path, local_graph, monkeypatch):
+    monkeypatch.setattr(interval_index, "_indexes", IntervalIndexes(str(tmp_path / "intervals")))
+    monkeypatch.setattr(graph_versions, "_versions", GraphVersions(poll_seconds=0))
+    ingest = local_graph.ingest
+
+    await ingest("a.txt", "def first\ncall x\ndef second\n")
+    at = await get_interval_indexes().entity_at(REPO, "a.txt", 3)
+    assert at["innermost"]["canonical_fqn"] == "second" and at["enclosing"] == []
+    assert (await get_interval_indexes().entity_at(REPO, "a.txt", 2))["innermost"] is None
+
+    await ingest("a.txt", "call x\ndef first\n")
+    first = (await get_interval_indexes().entity_at(REPO, "a.txt", 2))["innermost"]
+    assert first["canonical_fqn"] == "first" and first["start_line"] == 2
+    get_interval_indexes().flush()
+
+    # A new process loads the saved spans; without a directory it seeds them from the graph.
+    for fresh in (IntervalIndexes(str(tmp_path / "intervals")), IntervalIndexes(None)):
+        assert (await fresh.entity_at(REPO, "a.txt", 2))["innermost"] == first
+
+    # Spans saved before a later write are stale: a new process seeds from the graph instead.
+    await ingest("a.txt", "def renamed\ndef first\n")
+    stale = IntervalIndexes(str(tmp_path / "intervals"))
+    assert stale.get(REPO).persisted and stale.get(REPO).graph_version == 2
+    assert (await stale.entity_at(REPO, "a.txt", 1))["innermost"]["canonical_fqn"] == "renamed"
+
+    # An ingest-only process never seeds, so its exit flush leaves the saved spans alone.
+    ingest_only = IntervalIndexes(str(tmp_path / "intervals"))
+    ingest_only.get(REPO).set_file("b.txt", [EntitySpan("b", 1, 2, "FunctionDefinition", "b")])
+    ingest_only.flush()
+    assert IntervalIndexes(str(tmp_path / "intervals")).get(REPO).graph_version == 2
+    assert len(list((tmp_path / "intervals").iterdir())) == 1
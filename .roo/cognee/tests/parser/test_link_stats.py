@@ -0,0 +1,107 @@
+# .roo/cognee/tests/parser/test_link_stats.py
+import weakref
+import pytest
+from pathlib import Path
+
+from src.parser import dispatcher, graph_utils, graph_versions, link_stats, local_graph_backend, orchestrator
+from src.parser.dispatcher import IntelligentEnrichmentDispatcher
+from src.parser.entities import FileProcessingRequest, LinkStatus
+from src.parser.graph_versions import GraphVersions
+from src.parser.link_stats import LinkStatsTracker, get_link_backlog_stats, get_link_stats
+from src.parser.local_graph_backend import LocalGraphBackend
+from src.parser.metrics import REGISTRY
+from tests.shared_test_utils import DirectiveParser
+
+pytestmark = pytest.mark.asyncio
+
+REPO = "org/repo@main"
+
+@pytest.fixture
+def repo(tmp_path: Path, monkeypatch) -> Path:
+    monkeypatch.setattr(orchestrator, "get_parser_for_file", lambda path: DirectiveParser())
+    monkeypatch.setattr(orchestrator, "get_dispatcher", lambda: _NoDispatch())
+    monkeypatch.setattr(graph_utils, "GRAPH_BACKEND", "local")
+    monkeypatch.setattr(local_graph_backend, "_instance", LocalGraphBackend(str(tmp_path / "graph.db")))
+    monkeypatch.setattr(link_stats, "_tracker", None)
+    monkeypatch.setattr(graph_versions, "_versions", GraphVersions(poll_seconds=0))
+    REGISTRY.reset()
+    path = tmp_path / "repo"
+    path.mkdir()
+    return path
+
+async def _ingest(repo: Path, name: str, content: str = None):
+    if content is not None:
+        (repo / name).write_text(content)
+    request = FileProcessingRequest(absolute_path=str(repo / name), repo_path=str(repo), repo_id="org/repo", branch="main", commit_index=1, is_delete=content is None)
+    assert await orchestrator.process_single_file(request)
+
+async def test_counters_follow_links_through_an_enhancement_cycle(repo: Path, monkeypatch):
+    await _ingest(repo, "a.txt", "def app::main\ncall Net::open\ncall Missing::thing\ncall Missing::thing2\n")
+    await _ingest(repo, "b.txt", "def lib::Net::open\ncall Missing::thing\n")
+
+    (stats,) = await get_link_backlog_stats(REPO)
+    assert stats["outstanding"] == 4
+    assert stats["by_status"]["pending_resolution"] == 4
+    assert stats["top_unresolved_targets"][0] == {"target_expression": "Missing::thing", "count": 2}
+    assert stats["age"]["buckets"]["<1m"] == 4
+
+    monkeypatch.setattr(dispatcher, "QUIESCENCE_PERIOD_SECONDS", 0)
+    await IntelligentEnrichmentDispatcher()._watch_for_quiescence(REPO)
+
+    (stats,) = await get_link_backlog_stats(REPO)
+    assert stats["outstanding"] == 3
+    assert stats["by_status"]["ready_for_llm"] == 3 and stats["by_status"]["pending_resolution"] == 0
+    assert stats["resolved_by_tier"] == {"tier2": 1}
+    assert stats["tiers"]["tier2"]["resolved"] == 1 and stats["tiers"]["tier2"]["promoted"] == 3
+    assert stats["tiers"]["tier2"]["resolution_rate"] == 0.25 and stats["tiers"]["tier2"]["escalation_rate"] == 0.75
+    assert stats["cycles"]["count"] == 1 and stats["cycles"]["failed"] == 0
+    assert [row["target_expression"] for row in stats["top_unresolved_targets"]] == ["Missing::thing", "Missing::thing2"]
+
+async def test_reingest_and_delete_drop_a_files_links(repo: Path):
+    await _ingest(repo, "a.txt", "def app::main\ncall Missing::one\ncall Missing::two\n")
+    await _ingest(repo, "b.txt", "def app::other\ncall Missing::one\n")
+    tracker = get_link_stats()
+    assert tracker.stats(REPO)["outstanding"] == 3
+
+    await _ingest(repo, "a.txt", "def app::main\ncall Missing::three\n")
+    stats = tracker.stats(REPO)
+    assert stats["outstanding"] == 2
+    assert {row["target_expression"] for row in stats["top_unresolved_targets"]} == {"Missing::one", "Missing::three"}
+
+    (repo / "a.txt").unlink()
+    await _ingest(repo, "a.txt")
+    assert tracker.stats(REPO)["top_unresolved_targets"] == [{"target_expression": "Missing::one", "count": 1}]
+
+async def test_first_request_seeds_from_the_graph(repo: Path, monkeypatch):
+    await _ingest(repo, "a.txt", "def app::main\ncall Missing::one\ncall Missing::two\n")
+    await graph_utils.update_pending_link_status((await graph_utils.find_nodes_with_filter({"type": "PendingLink"}))[0].id, LinkStatus.UNRESOLVABLE)
+
+    # A new process: the repository is found in the graph and seeded from it.
+    monkeypatch.setattr(link_stats, "_tracker", LinkStatsTracker())
+    monkeypatch.setattr(graph_versions, "_versions", GraphVersions(poll_seconds=0))
+    (stats,) = await get_link_backlog_stats()
+    assert stats["repo"] == REPO and stats["seeded_at_version"] == 1
+    assert stats["by_status"]["unresolvable"] == 1 and stats["by_status"]["pending_resolution"] == 1
+    assert stats["age"]["buckets"]["<1m"] == 2
+    assert not stats["enhancement_observed"] and stats["tiers"] == {}
+
+async def test_writes_by_another_process_reseed_the_counters(repo: Path, monkeypatch):
+    await _ingest(repo, "a.txt", "def app::main\ncall Missing::one\n")
+    server = get_link_stats()
+    (stats,) = await get_link_backlog_stats(REPO)
+    assert stats["outstanding"] == 1
+
+    # Another process ingests: neither its hooks nor its stored-version bump reach this tracker.
+    monkeypatch.setattr(link_stats, "_tracker", LinkStatsTracker())
+    monkeypatch.setattr(graph_versions, "_stamp_sets", weakref.WeakSet())
+    await _ingest(repo, "b.txt", "def app::other\ncall Missing::two\ncall Missing::three\n")
+    assert server.stats(REPO)["outstanding"] == 1
+
+    monkeypatch.setattr(link_stats, "_tracker", server)
+    (stats,) = await get_link_backlog_stats(REPO)
+    assert stats["outstanding"] == 3
+    assert stats["seeded_at_version"] == 2
+
+class _NoDispatch:
+    async def notify_ingestion_activity(self, *args):
+        pass
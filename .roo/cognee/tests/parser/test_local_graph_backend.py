@@ -0,0 +1,167 @@
+# .roo/cognee/tests/parser/test_local_graph_backend.py
+import asyncio
+import pytest
+from pathlib import Path
+from unittest.mock import AsyncMock
+
+from src.parser import graph_utils, local_graph_backend
+from src.parser.local_graph_backend import LocalGraphBackend
+from src.parser.entities import (
+    CodeEntity, FileProcessingRequest, LinkStatus, PendingLink, RawSymbolReference,
+    ReferenceContext, ImportType, Relationship, Repository, SourceFile, TextChunk,
+)
+from src.parser.cognee_adapter import adapt_parser_entities_to_graph_elements
+
+pytestmark = pytest.mark.asyncio
+
+REPO = "org/repo@main"
+SFID = f"{REPO}|src/a.cpp@1-1"
+
+@pytest.fixture
+def local_graph(tmp_path: Path, monkeypatch) -> LocalGraphBackend:
+    backend = LocalGraphBackend(str(tmp_path / "graph.db"))
+    monkeypatch.setattr(graph_utils, "GRAPH_BACKEND", "local")
+    monkeypatch.setattr(local_graph_backend, "_instance", backend)
+    yield backend
+    backend.close()
+
+def entity(fqn: str, line: int) -> CodeEntity:
+    return CodeEntity(id=f"{SFID}|0@1-20|{fqn}@{line}-{line + 1}", type="FunctionDefinition", start_line=line, end_line=line + 1, canonical_fqn=fqn, snippet_content="{}")
+
+def pending_link(target: str) -> PendingLink:
+    ref = RawSymbolReference(source_entity_id=entity("app::main", 1).id, target_expression=target, reference_type="FUNCTION_CALL", context=ReferenceContext(import_type=ImportType.ABSOLUTE, path_parts=[]))
+    return PendingLink(id=f"link-{target}", reference_data=ref)
+
+async def save(*items):
+    nodes, edges = adapt_parser_entities_to_graph_elements(list(items))
+    await graph_utils.save_graph_data(nodes, edges)
+
+async def test_save_find_and_detach_delete(local_graph: LocalGraphBackend):
+    chunk = TextChunk(id=f"{SFID}|0@1-20", chunk_content="x", start_line=1, end_line=20)
+    source_file = SourceFile(id=SFID, relative_path="src/a.cpp", commit_index=1, local_save=1, content_hash="abc")
+    await save(Repository(id=REPO, path="/r", repo_id="org/repo", branch="main"), source_file, chunk, entity("app::main", 1),
+               Relationship(source_id=SFID, target_id=chunk.id, type="CONTAINS_CHUNK"))
+
+    assert await graph_utils.check_content_exists("abc")
+    assert [n.id for n in await graph_utils.find_nodes_with_filter({"type": "TextChunk", "repo_id_str": REPO})] == [chunk.id]
+    assert await graph_utils.find_code_entity_by_path(REPO, "src/a.cpp", "app::main") == entity("app::main", 1).id
+    assert await graph_utils.find_code_entity_by_path(REPO, "src/other.cpp", "app::main") is None
+    assert await local_graph.get_edges(source_id=SFID) == [(SFID, chunk.id, "CONTAINS_CHUNK", {})]
+
+    await graph_utils.delete_nodes_with_filter({"repo_id_str": REPO, "relative_path_str": "src/a.cpp"})
+    remaining = await graph_utils.find_nodes_with_filter({"repo_id_str": REPO})
+    assert [n.id for n in remaining] == [REPO]
+    assert await local_graph.get_edges() == []
+
+async def test_fqn_suffix_query_matches_ends_with(local_graph: LocalGraphBackend):
+    await save(entity("app::net::Socket::open", 1), entity("app::Socket::open", 5), entity("app::Socket::openAll", 9), entity("Socket::close", 13))
+    matches = await graph_utils.find_code_entity_ids_by_fqn_suffix(REPO, "Socket::open")
+    assert sorted(matches) == sorted([entity("app::Socket::open", 5).id, entity("app::net::Socket::open", 1).id])
+    assert await graph_utils.find_code_entity_ids_by_fqn_suffix("other@main", "Socket::open") == []
+
+    plan = " ".join(str(row) for row in local_graph._conn.execute(
+        "EXPLAIN QUERY PLAN SELECT slug_id FROM nodes WHERE repo_id_str = ? AND node_type = 'CodeEntity' AND reversed_fqn >= ? AND reversed_fqn < ?", (REPO, "a", "b")))
+    assert "idx_nodes_repo_reversed_fqn" in plan
+
+async def test_version_counter_is_per_file_and_commit(local_graph: LocalGraphBackend):
+    counts = [await graph_utils.atomic_get_and_increment_local_save(REPO, "src/a.cpp", 1) for _ in range(3)]
+    assert counts == [1, 2, 3]
+    assert await graph_utils.atomic_get_and_increment_local_save(REPO, "src/a.cpp", 2) == 1
+    assert await graph_utils.atomic_get_and_increment_local_save(REPO, "src/b.cpp", 1) == 1
+
+async def test_pending_link_status_updates_are_filterable(local_graph: LocalGraphBackend):
+    await save(pending_link("Socket::open"))
+    await graph_utils.update_pending_link_status("link-Socket::open", LinkStatus.AWAITING_TARGET, {"awaits_fqn": "app::Socket::open"})
+    found = await graph_utils.find_nodes_with_filter({"type": "PendingLink", "status": LinkStatus.AWAITING_TARGET.value, "awaits_fqn": "app::Socket::open", "repo_id_str": REPO})
+    assert [n.id for n in found] == ["link-Socket::open"]
+    assert found[0].attributes["reference_data"]["target_expression"] == "Socket::open"
+
+async def test_transaction_rolls_back_every_call(local_graph: LocalGraphBackend):
+    with pytest.raises(RuntimeError):
+        async with graph_utils.graph_transaction():
+            await save(entity("app::main", 1))
+            await graph_utils.atomic_get_and_increment_local_save(REPO, "src/a.cpp", 1)
+            raise RuntimeError("abort")
+    assert await graph_utils.find_nodes_with_filter({"type": "CodeEntity"}) == []
+    assert await graph_utils.atomic_get_and_increment_local_save(REPO, "src/a.cpp", 1) == 1
+
+async def test_index_hooks_run_after_commit_and_are_dropped_on_rollback(local_graph: LocalGraphBackend):
+    seen = []
+    with pytest.raises(RuntimeError):
+        async with graph_utils.graph_transaction():
+            graph_utils.after_commit(seen.append, "rolled back")
+            raise RuntimeError("abort")
+    async with graph_utils.graph_transaction():
+        async with graph_utils.graph_transaction():  # Nested: deferred to the outer commit.
+            graph_utils.after_commit(seen.append, "committed")
+        assert seen == []
+    assert seen == ["committed"]
+
+async def test_reads_do_not_wait_for_another_tasks_transaction(local_graph: LocalGraphBackend):
+    await save(entity("app::main", 1))
+    inside, release = asyncio.Event(), asyncio.Event()
+
+    async def writer():
+        async with graph_utils.graph_transaction():
+            await save(entity("app::helper", 5))
+            inside.set()
+            await release.wait()
+
+    task = asyncio.create_task(writer())
+    await inside.wait()
+    found = await asyncio.wait_for(graph_utils.find_nodes_with_filter({"type": "CodeEntity"}), timeout=1.0)
+    assert [n.attributes["canonical_fqn"] for n in found] == ["app::main"]  # The open transaction's write is not visible yet.
+    release.set()
+    await task
+    assert len(await graph_utils.find_nodes_with_filter({"type": "CodeEntity"})) == 2
+
+async def test_detail_batches_fetch_projected_properties_in_one_call(local_graph: LocalGraphBackend):
+    main, helper, other = entity("app::main", 1), entity("app::helper", 5), entity("app::other", 9)
+    await save(main, helper, other, Relationship(source_id=main.id, target_id=helper.id, type="FUNCTION_CALL", properties={"line": 2, "weight": 1}))
+    local_graph.op_counts.clear()
+
+    details = await graph_utils.get_node_details_batch([main.id, helper.id, main.id, "missing", other.id], ["canonical_fqn", "start_line", "absent"])
+    assert details == {
+        main.id: {"canonical_fqn": "app::main", "start_line": 1},
+        helper.id: {"canonical_fqn": "app::helper", "start_line": 5},
+        other.id: {"canonical_fqn": "app::other", "start_line": 9},
+    }
+    edges = await graph_utils.get_edge_details_batch([(main.id, helper.id), (main.id, helper.id), (helper.id, other.id)], ["line"])
+    assert edges == [(main.id, helper.id, "FUNCTION_CALL", {"line": 2})]
+    assert local_graph.op_counts == {"get_nodes_by_ids": 1, "get_edges_between": 1}
+
+async def test_mark_enhancement_failed_annotates_repository(local_graph: LocalGraphBackend):
+    await save(Repository(id=REPO, path="/r", repo_id="org/repo", branch="main"))
+    await graph_utils.mark_enhancement_failed(REPO, "boom")
+    repo_node = (await graph_utils.find_nodes_with_filter({"type": "Repository"}))[0]
+    assert repo_node.attributes["enhancement_status"] == "failed"
+    assert repo_node.attributes["enhancement_error"] == "boom"
+
+async def test_tier2_resolves_suffix_match_end_to_end(local_graph: LocalGraphBackend):
+    from src.parser.graph_enhancement_engine import run_tier2_enhancement
+    await save(entity("app::main", 1), entity("app::net::Socket::open", 5), pending_link("Socket::open"))
+    await graph_utils.update_pending_link_status("link-Socket::open", LinkStatus.READY_FOR_HEURISTICS)
+
+    await run_tier2_enhancement(REPO)
+
+    assert await graph_utils.find_nodes_with_filter({"type": "PendingLink"}) == []
+    assert [n.attributes["resolved_target_id"] for n in await graph_utils.find_nodes_with_filter({"type": "ResolutionCache"})] == [entity("app::net::Socket::open", 5).id]
+    assert await local_graph.get_edges(target_id=entity("app::net::Socket::open", 5).id) == [(entity("app::main", 1).id, entity("app::net::Socket::open", 5).id, "FUNCTION_CALL", {})]
+
+async def test_orchestrator_ingests_and_reingests_into_local_graph(local_graph: LocalGraphBackend, tmp_path: Path, monkeypatch):
+    from src.parser import orchestrator
+    monkeypatch.setattr(orchestrator, "get_dispatcher", lambda: AsyncMock())
+    repo = tmp_path / "repo"
+    (repo / "docs").mkdir(parents=True)
+    path = repo / "docs" / "notes.txt"
+    path.write_text("first line\nsecond line\n")
+    request = FileProcessingRequest(absolute_path=str(path), repo_path=str(repo), repo_id="org/repo", branch="main", commit_index=1, is_delete=False)
+
+    assert await orchestrator.process_single_file(request)
+    assert [n.id for n in await graph_utils.find_nodes_with_filter({"type": "SourceFile"})] == [f"{REPO}|docs/notes.txt@1-1"]
+
+    path.write_text("first line\nchanged\n")
+    assert await orchestrator.process_single_file(request)
+    assert [n.id for n in await graph_utils.find_nodes_with_filter({"type": "SourceFile"})] == [f"{REPO}|docs/notes.txt@1-2"]
+    chunks = await graph_utils.find_nodes_with_filter({"type": "TextChunk"})
+    assert chunks and all(c.id.startswith(f"{REPO}|docs/notes.txt@1-2|") for c in chunks)
@@ -0,0 +1,115 @@
+# .roo/cognee/tests/parser/test_metrics.py
+import pytest
+import asyncio
+import json
+from pathlib import Path
+
+from src.parser import graph_utils, local_graph_backend, metrics, orchestrator
+from src.parser.entities import FileProcessingRequest
+from src.parser.local_graph_backend import LocalGraphBackend
+from src.parser.metrics import (
+    REGISTRY, MetricsRegistry, INGEST_STAGE_SECONDS, INGEST_FILE_SECONDS, INGEST_FILES, INGEST_ENTITIES,
+    INGEST_REFERENCES, INGEST_PENDING_LINKS, INGEST_INFLIGHT, ENHANCEMENT_CYCLES, count, increment, observe,
+    start_metrics_server,
+)
+from tests.shared_test_utils import DirectiveParser
+
+pytestmark = pytest.mark.asyncio
+
+@pytest.fixture(autouse=True)
+def clean_registry():
+    REGISTRY.reset()
+    yield
+    REGISTRY.reset()
+
+async def test_openmetrics_text_format():
+    registry = MetricsRegistry()
+    histogram = registry.histogram("stage_seconds", "Stage time.", buckets=(0.1, 1.0))
+    histogram.observe(0.05, stage="parse")
+    histogram.observe(0.5, stage="parse")
+    histogram.observe(3.0, stage="parse")
+    registry.counter("files", "Files.").inc(2, repo='org/"r"@main')
+    depth = [7]
+    registry.gauge("queue_depth", "Depth.").set_function(lambda: depth[0], queue="q")
+
+    lines = registry.render_openmetrics().splitlines()
+    assert 'stage_seconds_bucket{stage="parse",le="0.1"} 1' in lines
+    assert 'stage_seconds_bucket{stage="parse",le="1.0"} 2' in lines
+    assert 'stage_seconds_bucket{stage="parse",le="+Inf"} 3' in lines
+    assert 'stage_seconds_count{stage="parse"} 3' in lines
+    assert 'stage_seconds_sum{stage="parse"} 3.55' in lines
+    assert 'files_total{repo="org/\\"r\\"@main"} 2' in lines
+    assert 'queue_depth{queue="q"} 7' in lines
+    assert "# TYPE stage_seconds histogram" in lines
+    assert lines[-1] == "# EOF"
+
+    with pytest.raises(ValueError):
+        registry.gauge("files", "Not a counter.")
+
+async def test_recording_helpers_are_off_when_metrics_are_disabled(monkeypatch):
+    monkeypatch.setattr(metrics, "METRICS_ENABLED", False)
+    count(INGEST_FILES, outcome="indexed")
+    increment(ENHANCEMENT_CYCLES, repo="org/repo@main", outcome="ok")
+    observe(INGEST_FILE_SECONDS, 0.5, outcome="indexed")
+    assert REGISTRY.snapshot()["metrics"]["enhancement_cycles"]["series"] == []
+    assert INGEST_FILES.get(outcome="indexed") == 0 and INGEST_FILE_SECONDS.count(outcome="indexed") == 0
+
+    monkeypatch.setattr(metrics, "METRICS_ENABLED", True)
+    with metrics.labelled(language="cpp"):
+        increment(ENHANCEMENT_CYCLES, repo="org/repo@main", outcome="ok")
+    assert ENHANCEMENT_CYCLES.get(repo="org/repo@main", outcome="ok") == 1  # Bound labels are not merged.
+
+async def test_process_single_file_records_stages_and_counters(tmp_path: Path, monkeypatch):
+    repo = tmp_path / "repo"
+    repo.mkdir()
+    (repo / "a.txt").write_text("def app::main\ncall Net::open\ncall Missing::thing\n")
+    monkeypatch.setattr(orchestrator, "get_parser_for_file", lambda path: DirectiveParser())
+    monkeypatch.setattr(orchestrator, "get_dispatcher", lambda: _NoDispatch())
+    monkeypatch.setattr(graph_utils, "GRAPH_BACKEND", "local")
+    monkeypatch.setattr(local_graph_backend, "_instance", LocalGraphBackend(str(tmp_path / "graph.db")))
+    request = FileProcessingRequest(absolute_path=str(repo / "a.txt"), repo_path=str(repo), repo_id="org/repo", branch="main", commit_index=1, is_delete=False)
+
+    await orchestrator.process_files_bulk([request])
+    assert await orchestrator.process_single_file(request)  # Same content: stops at the content check.
+
+    labels = {"repo": "org/repo@main", "language": "text"}
+    for name in ("hash", "content_check", "delete", "version_counter", "parse", "chunk", "tier1", "adapt", "save"):
+        assert INGEST_STAGE_SECONDS.count(stage=name, **labels) >= 1, name
+    assert INGEST_STAGE_SECONDS.count(stage="content_check", **labels) == 2
+    assert INGEST_STAGE_SECONDS.count(stage="read", **labels) == 1  # Only the non-bulk pass reads.
+    assert INGEST_FILES.get(outcome="indexed", **labels) == 1
+    assert INGEST_FILES.get(outcome="unchanged", **labels) == 1
+    assert INGEST_ENTITIES.get(**labels) == 1
+    assert INGEST_REFERENCES.get(**labels) == 2
+    assert INGEST_PENDING_LINKS.get(**labels) == 2
+    assert INGEST_INFLIGHT.get(queue="bulk") == 0
+
+async def test_metrics_server_serves_text_and_json():
+    INGEST_FILES.inc(outcome="indexed", repo="org/repo@main", language="cpp")
+    server = await start_metrics_server(port=0)
+    port = server.sockets[0].getsockname()[1]
+    try:
+        text = await _get(port, "/metrics")
+        json_body = await _get(port, "/metrics.json")
+        missing = await _get(port, "/nope")
+    finally:
+        server.close()
+        await server.wait_closed()
+
+    assert text.startswith("HTTP/1.1 200") and "application/openmetrics-text" in text
+    assert 'ingest_files_total{language="cpp",outcome="indexed",repo="org/repo@main"} 1' in text
+    snapshot = json.loads(json_body.split("\r\n\r\n", 1)[1])
+    assert snapshot["metrics"]["ingest_files"]["series"] == [{"labels": {"language": "cpp", "outcome": "indexed", "repo": "org/repo@main"}, "value": 1}]
+    assert missing.startswith("HTTP/1.1 404")
+
+async def _get(port: int, path: str) -> str:
+    reader, writer = await asyncio.open_connection("127.0.0.1", port)
+    writer.write(f"GET {path} HTTP/1.1\r\nHost: localhost\r\n\r\n".encode())
+    await writer.drain()
+    response = await reader.read()
+    writer.close()
+    return response.decode()
+
+class _NoDispatch:
+    async def notify_ingestion_activity(self, *args):
+        pass
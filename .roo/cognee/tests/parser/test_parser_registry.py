@@ -0,0 +1,48 @@
+# .roo/cognee/tests/parser/test_parser_registry.py
+import importlib
+import pytest
+import subprocess
+import sys
+from pathlib import Path
+
+from src.parser import parser_registry
+from src.parser.parsers.generic_parser import GenericParser
+
+pytestmark = pytest.mark.asyncio
+
+ROOT = Path(__file__).resolve().parents[2]
+
+async def test_static_table_matches_parser_extensions():
+    by_module = {}
+    for ext, module_name in parser_registry.PARSER_MODULES.items():
+        by_module.setdefault(module_name, set()).add(ext)
+    for module_name, extensions in by_module.items():
+        parser_class = parser_registry._load_parser_module(module_name)
+        assert extensions == set(parser_class.SUPPORTED_EXTENSIONS) - {"generic_fallback"}, module_name
+
+async def test_unknown_extensions_fall_back_to_generic_parser():
+    assert isinstance(parser_registry.get_parser_for_file(Path("notes.unknown")), GenericParser)
+    assert isinstance(parser_registry.get_parser_for_file(Path("README.MD")), GenericParser)
+
+async def test_importing_the_orchestrator_loads_no_grammars():
+    # GenericParser is grammar-free and imported by extraction; every tree-sitter backed parser must wait for a file.
+    probe = ("import sys, src.parser.orchestrator; "
+             "print(sorted(m for m in sys.modules if m.startswith(('tree_sitter', 'src.parser.parsers.')) and not m.endswith(('base_parser', 'generic_parser'))))")
+    result = subprocess.run([sys.executable, "-c", probe], cwd=ROOT, capture_output=True, text=True, check=True)
+    assert result.stdout.strip().splitlines()[-1] == "[]"
+
+async def test_a_critical_module_that_failed_to_load_keeps_failing(monkeypatch):
+    monkeypatch.setattr(parser_registry, "_module_parsers", {})
+    monkeypatch.setattr(parser_registry, "_critical_failures", {})
+    real_import = importlib.import_module
+    def import_module(name):
+        if name.endswith(".cpp_parser"):
+            raise ImportError("no grammar")
+        return real_import(name)
+    monkeypatch.setattr(parser_registry.importlib, "import_module", import_module)
+    for _ in range(2):
+        with pytest.raises(RuntimeError, match="cpp_parser"):
+            parser_registry.get_parser_for_file(Path("widget.cpp"))
+    with pytest.raises(RuntimeError, match="cpp_parser"):
+        parser_registry.prewarm(["cpp"])
+    assert isinstance(parser_registry.get_parser_for_file(Path("notes.txt")), GenericParser)
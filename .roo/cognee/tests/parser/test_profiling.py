@@ -0,0 +1,113 @@
+# .roo/cognee/tests/parser/test_profiling.py
+import pytest
+import json
+import time
+from pathlib import Path
+
+from src.parser import extract_cli, graph_utils, local_graph_backend, orchestrator, profiling
+from src.parser.entities import FileProcessingRequest
+from src.parser.local_graph_backend import LocalGraphBackend
+from src.parser.parsers.base_parser import BaseParser
+from src.parser.profiling import IngestProfiler, FileProfile
+from tests.shared_test_utils import DirectiveParser
+
+pytestmark = pytest.mark.asyncio
+
+@pytest.fixture
+def local_graph(tmp_path: Path, monkeypatch):
+    monkeypatch.setattr(orchestrator, "get_dispatcher", lambda: _NoDispatch())
+    monkeypatch.setattr(graph_utils, "GRAPH_BACKEND", "local")
+    monkeypatch.setattr(local_graph_backend, "_instance", LocalGraphBackend(str(tmp_path / "graph.db")))
+
+def _requests(repo: Path, files: dict):
+    repo.mkdir()
+    for name, content in files.items():
+        (repo / name).write_text(content)
+    return [FileProcessingRequest(absolute_path=str(repo / name), repo_path=str(repo), repo_id="org/repo", branch="main", commit_index=1, is_delete=False) for name in files]
+
+async def test_bulk_profile_records_per_file_costs(tmp_path: Path, monkeypatch, local_graph):
+    monkeypatch.setattr(orchestrator, "get_parser_for_file", lambda path: DirectiveParser())
+    requests = _requests(tmp_path / "repo", {
+        "small.txt": "def app::main\n",
+        "big.txt": "".join(f"def app::f{i}\ncall Missing::g{i}\n" for i in range(200)),
+    })
+    profiler = IngestProfiler(trace_allocations=True)
+    await orchestrator.process_files_bulk(requests, profiler=profiler)
+
+    assert profiling.get_profiler() is None
+    profiles = {p.path: p for p in profiler.files}
+    assert set(profiles) == {"small.txt", "big.txt"}
+    big = profiles["big.txt"]
+    assert big.language == "text" and big.lines == 401
+    assert big.entities == {"FunctionDefinition": 200}
+    assert big.references == {"FUNCTION_CALL": 200}
+    assert big.pending_links == 200
+    assert big.parse_seconds > 0 and big.db_seconds > 0
+    assert set(big.stages) >= {"parse", "chunk", "content_check", "version_counter", "tier1", "adapt", "save"}
+    assert big.alloc_peak_bytes > profiles["small.txt"].alloc_peak_bytes > 0
+
+    report = profiler.report(top=1)
+    assert report["files"] == 2
+    assert [row["path"] for row in report["slowest"]] == ["big.txt"]
+    assert [row["path"] for row in report["heaviest_alloc"]] == ["big.txt"]
+    assert report["by_entity_type"][0]["type"] == "FunctionDefinition" and report["by_entity_type"][0]["count"] == 201
+    assert report["by_language"]["text"]["files"] == 2
+    assert "big.txt" in profiler.format_report()
+
+class _WalkingParser(BaseParser):
+    """Spends its parse time inside a fake AST walk, the way CppParser maintains WALK_STACK."""
+    async def parse(self, source_file_id: str, file_content: str):
+        yield [1]
+        stack = profiling.WALK_STACK
+        for node_type, seconds in (("class_specifier", 0.02), ("function_definition", 0.08)):
+            stack.append(node_type)
+            deadline = time.perf_counter() + seconds
+            while time.perf_counter() < deadline:
+                pass
+        stack.clear()
+
+async def test_stack_sampling_charges_walk_time_to_constructs(tmp_path: Path, monkeypatch, local_graph):
+    monkeypatch.setattr(orchestrator, "get_parser_for_file", lambda path: _WalkingParser())
+    requests = _requests(tmp_path / "repo", {"a.cpp": "int main() {}\n"})
+    profiler = IngestProfiler(sample_stacks=True, sample_interval=0.001)
+    assert profiler.sequential
+    await orchestrator.process_files_bulk(requests, profiler=profiler)
+
+    assert profiling.WALK_STACK is None
+    costs = {row["construct"]: row for row in profiler.construct_costs()}
+    assert costs["function_definition"]["self_samples"] > costs["class_specifier"]["self_samples"] > 0
+    assert costs["class_specifier"]["inclusive_samples"] >= costs["function_definition"]["self_samples"]
+    assert profiler.files[0].samples == sum(profiler.stack_samples.values())
+
+    report_path = tmp_path / "profile.json"
+    profiler.write_report(str(report_path))
+    assert json.loads(report_path.read_text())["by_construct"][0]["construct"] == "function_definition"
+    folded = (tmp_path / "profile.json.folded").read_text().splitlines()
+    assert folded[0].startswith("class_specifier;function_definition ")
+
+async def test_extract_cli_writes_profile_report(tmp_path: Path):
+    repo = tmp_path / "repo"
+    repo.mkdir()
+    (repo / "a.txt").write_text("alpha\n\nbeta\n")
+    (repo / "b.txt").write_text("gamma\n")
+    report_path = tmp_path / "profile.json"
+    args = [str(repo), "--repo-id", "org/repo", "--branch", "main", "--commit-index", "1", "-o", str(tmp_path / "out.ndjson"),
+            "--languages", "text", "-j", "2", "--profile", str(report_path), "--profile-alloc"]
+    assert extract_cli.main(args) == 0
+
+    report = json.loads(report_path.read_text())
+    assert report["files"] == 2
+    assert {row["path"] for row in report["slowest"]} == {"a.txt", "b.txt"}
+    assert all(row["parse_seconds"] > 0 and row["alloc_peak_bytes"] > 0 for row in report["slowest"])
+
+async def test_file_profile_round_trips_through_worker_payload():
+    profile = FileProfile(path="a.cpp", language="cpp", lines=3, ast_nodes=40, pending_links=2)
+    profile.add_stage("parse", 0.5)
+    profile.add_stage("save", 0.25)
+    profile.entities.update(["FunctionDefinition", "FunctionDefinition"])
+    copy = FileProfile.from_dict(profile.to_dict())
+    assert copy == profile and copy.db_seconds == 0.25
+
+class _NoDispatch:
+    async def notify_ingestion_activity(self, *args):
+        pass
@@ -0,0 +1,89 @@
+# .roo/cognee/tests/parser/test_replay.py
+import pytest
+import json
+import shutil
+import subprocess
+from pathlib import Path
+
+from src.parser import graph_utils, local_graph_backend, orchestrator, replay
+from src.parser.entities import FileProcessingRequest
+from src.parser.local_graph_backend import LocalGraphBackend
+from src.parser.replay import ReplayEvent, ReplayHarness, RequestRecorder, load_trace
+from tests.shared_test_utils import DirectiveParser
+
+pytestmark = pytest.mark.asyncio
+
+def request_for(repo: Path, name: str, is_delete: bool = False) -> FileProcessingRequest:
+    return FileProcessingRequest(absolute_path=str(repo / name), repo_path=str(repo), repo_id="org/repo", branch="main", commit_index=1, is_delete=is_delete)
+
+@pytest.fixture
+def directive_parser(monkeypatch):
+    monkeypatch.setattr(orchestrator, "get_parser_for_file", lambda path: DirectiveParser())
+
+async def test_recorder_captures_requests_from_process_single_file(tmp_path: Path, monkeypatch, directive_parser):
+    repo = tmp_path / "repo"
+    repo.mkdir()
+    (repo / "a.txt").write_text("def app::main\n")
+    recorder = RequestRecorder(str(tmp_path / "trace.ndjson"))
+    monkeypatch.setattr(replay, "_recorder", recorder)
+    monkeypatch.setattr(orchestrator, "get_dispatcher", lambda: _NoDispatch())
+    monkeypatch.setattr(graph_utils, "GRAPH_BACKEND", "local")
+    monkeypatch.setattr(local_graph_backend, "_instance", LocalGraphBackend(str(tmp_path / "live.db")))
+
+    assert await orchestrator.process_single_file(request_for(repo, "a.txt"))
+    (repo / "a.txt").unlink()
+    assert await orchestrator.process_single_file(request_for(repo, "a.txt", is_delete=True))
+    recorder.close()
+
+    events = load_trace(str(tmp_path / "trace.ndjson"))
+    assert [(e.request.is_delete, e.content) for e in events] == [(False, "def app::main\n"), (True, None)]
+    assert events[0].offset == 0 and events[1].offset >= 0
+
+async def test_blob_mode_stores_content_in_the_git_object_store(tmp_path: Path):
+    if not shutil.which("git"):
+        pytest.skip("git not available")
+    repo = tmp_path / "repo"
+    repo.mkdir()
+    subprocess.run(["git", "init", "-q", str(repo)], check=True)
+    (repo / "a.txt").write_text("def app::main\n")
+    recorder = RequestRecorder(str(tmp_path / "trace.ndjson"), content_mode="blob")
+    await recorder.record(request_for(repo, "a.txt"))
+    recorder.close()
+
+    (event,) = load_trace(str(tmp_path / "trace.ndjson"))
+    assert event.content is None and len(event.blob) == 40
+    harness = ReplayHarness([event], workdir=str(tmp_path / "work"))
+    assert await harness._content_for(event) == "def app::main\n"
+
+async def test_replay_reports_freshness_coalescing_and_db_ops(tmp_path: Path, directive_parser):
+    repo = tmp_path / "recorded"
+    events = [
+        ReplayEvent(0.0, request_for(repo, "a.txt"), "def app::main\ncall Net::open\n"),
+        ReplayEvent(0.5, request_for(repo, "b.txt"), "def lib::Net::open\n"),
+        ReplayEvent(0.7, request_for(repo, "c.txt"), "def app::other\ncall Missing::thing\n"),
+    ]
+    # 10x: events land 50ms apart, well inside the scaled 0.3s quiescence window, so they coalesce.
+    backend_before = graph_utils.GRAPH_BACKEND
+    harness = ReplayHarness(events, speed=10, workdir=str(tmp_path / "work"), quiescence_seconds=3)
+    report = await harness.run()
+    assert graph_utils.GRAPH_BACKEND == backend_before
+
+    assert report.failures == 0
+    assert len(report.ingest_latency) == 3
+    assert report.links_created == 2
+    assert len(report.link_latency) == 1  # Net::open resolves by suffix in Tier 2.
+    assert report.links_outstanding == 1  # Missing::thing waits for the LLM tier.
+    assert report.enhancement_cycles == 1
+    assert report.timer_resets == 2
+    assert report.max_timers == 1
+    assert report.db_ops["transaction"] == 3
+    assert report.db_ops["save"] >= 3
+    assert report.link_latency[0] >= 0.3  # Not before the scaled quiescence period elapsed.
+
+    summary = report.summary()
+    assert summary["ingest_latency"]["count"] == 3
+    json.dumps(summary)
+
+class _NoDispatch:
+    async def notify_ingestion_activity(self, *args):
+        pass
@@ -0,0 +1,47 @@
+# .roo/cognee/tests/parser/test_sharded_ingest.py
+import pytest
+from pathlib import Path
+
+from src.parser.sharded_ingest import ShardedIngestCoordinator, shard_for_path
+from tests.shared_test_utils import MemoryIslandSink, make_text_repo
+
+pytestmark = pytest.mark.asyncio
+
+async def test_shard_for_path_is_stable_and_in_range():
+    assert shard_for_path("src/a.cpp", 4) == shard_for_path("src/a.cpp", 4)
+    assert {shard_for_path(f"f{i}.cpp", 4) for i in range(200)} == {0, 1, 2, 3}
+
+async def test_sharded_ingest_commits_every_file_in_groups(tmp_path: Path):
+    files = make_text_repo(tmp_path, 20)
+    sink = MemoryIslandSink()
+    coordinator = ShardedIngestCoordinator(sink, num_workers=3, group_commit_size=4)
+    report = await coordinator.run(files, "org/repo", "main", 5)
+
+    committed = [island for group in sink.groups for island in group]
+    assert sorted(i.source_file.relative_path for i in committed) == sorted(rel for _, rel in files)
+    assert all(len(group) <= 4 for group in sink.groups)
+    assert report.committed == 20 and report.commit_groups == len(sink.groups)
+    assert not report.failures
+    for shard, progress in report.shards.items():
+        assert progress.finished
+        assert progress.assigned == sum(1 for _, rel in files if shard_for_path(rel, 3) == shard)
+    assert all(i.text_chunks and i.source_file.id.startswith("org/repo@main|") for i in committed)
+
+async def test_sharded_ingest_reports_read_and_commit_failures(tmp_path: Path):
+    files = make_text_repo(tmp_path, 4) + [(str(tmp_path / "gone.txt"), "gone.txt")]
+    report = await ShardedIngestCoordinator(MemoryIslandSink(fail=True), num_workers=2).run(files, "org/repo", "main", 1)
+
+    reasons = dict(report.failures)
+    assert reasons["gone.txt"].startswith("unreadable")
+    assert all(reasons[rel].startswith("commit failed") for _, rel in files[:4])
+    assert report.committed == 0
+
+async def test_a_failing_file_does_not_fail_its_group(tmp_path: Path):
+    files = make_text_repo(tmp_path, 6)
+    bad = files[2][1]
+    sink = MemoryIslandSink(fail_paths=[bad])
+    report = await ShardedIngestCoordinator(sink, num_workers=1, group_commit_size=6).run(files, "org/repo", "main", 1)
+
+    assert [rel for rel, _ in report.failures] == [bad] and report.failures[0][1].startswith("commit failed")
+    assert report.committed == 5
+    assert sorted(i.source_file.relative_path for g in sink.groups for i in g) == sorted(rel for _, rel in files if rel != bad)
@@ -0,0 +1,78 @@
+# .roo/cognee/tests/parser/test_symbol_index.py
+import pytest
+import weakref
+
+from src.parser import code_indexes, graph_versions
+from src.parser.entities import CodeEntity
+from src.parser.graph_versions import GraphVersions
+from src.parser.symbol_index import SymbolIndex, extract_identifiers, get_symbol_index, normalize_signature
+
+pytestmark = pytest.mark.asyncio
+
+REPO = "org/repo@main"
+
+def entity(path: str, fqn: str, line: int, kind: str = "FunctionDefinition") -> CodeEntity:
+    return CodeEntity(id=f"{REPO}|{path}@1-1|0@1-50|{fqn}@{line}", type=kind, start_line=line, end_line=line + 2, canonical_fqn=fqn, snippet_content="{}")
+
+async def test_lookup_modes_and_signature_filter():
+    index = SymbolIndex()
+    index.add_entities([
+        entity("src/widget.cpp", "app::Widget::resize(int width, int height)", 10),
+        entity("src/widget.cpp", "app::Widget::resize(const Size & size)", 20),
+        entity("src/widget.cpp", "app::Widget", 5, "ClassDefinition"),
+        entity("src/layout.cpp", "app::Layout::resizeAll()", 3),
+        entity("src/box.hpp", "app::Box<Vec<int>>::get()", 7),
+    ])
+
+    assert normalize_signature("(const std::string & name, int n = 3)") == "(const std::string&,int)"
+    assert normalize_signature("(char *s, void)") == "(char*)"
+    assert extract_identifiers("where is `Widget::resize` defined / who overrides it") == ["Widget::resize"]
+    assert extract_identifiers("who calls app::Widget::resize(int, int)?") == ["app::Widget::resize(int, int)"]
+    assert extract_identifiers("how does resizing work") == []
+
+    exact = index.lookup("app::Widget::resize")
+    assert [m["match"] for m in exact] == ["exact", "exact"] and {m["start_line"] for m in exact} == {10, 20}
+    assert [m["start_line"] for m in index.lookup("APP::WIDGET::RESIZE(int w, int h)")] == [10]
+    assert [m["match"] for m in index.lookup("widget::resize(const Size&)")] == ["segment_suffix"]
+    assert [m["canonical_fqn"] for m in index.lookup("Box::get")] == ["app::Box<Vec<int>>::get()"]
+    assert [m["canonical_fqn"] for m in index.lookup("app::Lay")] == ["app::Layout::resizeAll()"]
+    assert [m["match"] for m in index.lookup("resizeA")] == ["name_prefix"]
+    assert index.lookup("Widget::resize", scopes=["org/other"]) == []
+    assert len(index.search("compare `app::Widget` and `Layout::resizeAll`")) == 2
+
+async def test_ingestion_keeps_the_index_current(local_graph):
+    await local_graph.ingest("a.txt", "def app::Net::open\ndef app::Net::close\n")
+    index = get_symbol_index()
+    assert [m["path"] for m in index.lookup("Net::open")] == ["a.txt"]
+
+    await local_graph.ingest("a.txt", "def app::Net::reopen\n")
+    assert index.lookup("Net::open") == [] and len(index) == 1
+
+    # A fresh process finds the saved entities by scanning the graph on first use.
+    fresh = SymbolIndex()
+    await fresh.ensure_seeded()
+    assert [m["canonical_fqn"] for m in fresh.lookup("reopen")] == ["app::Net::reopen"]
+
+    await local_graph.delete("a.txt")
+    assert len(index) == 0
+
+async def test_writes_by_another_process_reseed_the_index(local_graph, monkeypatch):
+    monkeypatch.setattr(graph_versions, "_versions", GraphVersions(poll_seconds=0))
+    await local_graph.ingest("a.txt", "def app::Net::open\n")
+    index = get_symbol_index()
+    await index.ensure_seeded()
+
+    # This process's own writes arrive through the hooks and do not trigger a rescan.
+    await local_graph.ingest("b.txt", "def app::Net::close\n")
+    scans = local_graph.backend.op_counts["find_nodes"]
+    await index.ensure_seeded()
+    assert local_graph.backend.op_counts["find_nodes"] == scans and len(index.lookup("Net::close")) == 1
+
+    # Another process's writes reach neither the hooks nor the seed stamps, only the stored version.
+    monkeypatch.setattr(code_indexes, "on_island_saved", lambda *args: None)
+    monkeypatch.setattr(code_indexes, "on_path_deleted", lambda *args: None)
+    monkeypatch.setattr(graph_versions, "_stamp_sets", weakref.WeakSet())
+    await local_graph.ingest("a.txt", "def app::Net::reopen\n")
+    assert index.lookup("reopen") == []
+    await index.ensure_seeded()
+    assert [m["canonical_fqn"] for m in index.lookup("reopen")] == ["app::Net::reopen"] and index.lookup("Net::open") == []
@@ -0,0 +1,110 @@
+# .roo/cognee/tests/parser/test_trigram_index.py
+import asyncio
+import pytest
+from pathlib import Path
+
+from src.parser import graph_versions
+from src.parser.graph_versions import GraphVersions
+from src.parser.trigram_index import ChunkDoc, RepoTrigramIndex, TrigramIndexes, get_trigram_indexes, required_literals
+
+pytestmark = pytest.mark.asyncio
+
+REPO = "org/repo@main"
+
+def chunk(path: str, index: int, start: int, content: str, entities=()) -> ChunkDoc:
+    return ChunkDoc(f"{REPO}|{path}@1-1|{index}@{start}-{start + content.count(chr(10))}", path, start, content, list(entities))
+
+async def test_substring_and_regex_search_survive_compaction_and_reopen(tmp_path: Path):
+    assert required_literals(r"foo(bar|baz)+qux\(") == ["foo", "ba", "qux("]  # The alternation shares the prefix "ba".
+    assert required_literals(r"(x|y)?z*") == []
+
+    index = RepoTrigramIndex(REPO, str(tmp_path), compact_threshold=2)
+    index.add(chunk("src/net.cpp", 0, 10, "void Socket::open() {\n  connect(host, PORT);\n}\n", [("e1", 10, 12)]))
+    index.add(chunk("src/net.cpp", 1, 20, "void Socket::close() {\n  shutdown(fd);\n}\n", [("e2", 20, 22)]))
+    assert index.needs_compaction and not index.persisted  # The second add reached the threshold.
+    index.compact()
+    assert index.persisted and not index.dirty
+    index.add(chunk("src/main.cpp", 0, 1, "int main() { Socket s; s.open(); }\n"))
+
+    hits = index.search("connect(HOST")
+    assert [(h["path"], h["line"], h["entity_ids"]) for h in hits] == [("src/net.cpp", 11, ["e1"])]
+    assert hits[0]["text"] == "  connect(host, PORT);"
+    assert index.search("connect(HOST", case_sensitive=True) == []
+    assert {(h["path"], h["line"]) for h in index.search(r"Socket::(open|close)\(\)", regex=True)} == {("src/net.cpp", 10), ("src/net.cpp", 20)}
+    assert [h["path"] for h in index.search(r"s\.open", regex=True)] == ["src/main.cpp"]
+    assert len(index.search(r"\w+\(", regex=True, limit=3)) == 3  # No literal: every chunk is scanned.
+
+    index.remove_path("src/net.cpp")
+    assert index.search("Socket::") == [] and len(index) == 1
+    index.compact()
+
+    reopened = RepoTrigramIndex(REPO, str(tmp_path))
+    assert len(reopened) == 1 and [h["line"] for h in reopened.search("s.open()")] == [1]
+
+async def test_ingestion_keeps_the_index_current(tmp_path: Path, local_graph):
+    await local_graph.ingest("a.txt", "def app::Net::open\ncall app::Net::open\n")
+    hits = await get_trigram_indexes().search(["org/repo"], "app::net::open")
+    assert [(h["path"], h["line"]) for h in hits] == [("a.txt", 1), ("a.txt", 2)] and hits[0]["entity_ids"] and not hits[1]["entity_ids"]
+
+    await local_graph.ingest("a.txt", "def app::Net::reopen\n")
+    assert await get_trigram_indexes().search(["org/repo"], "call app") == []
+    assert len(await get_trigram_indexes().search(["org/repo@main"], r"Net::re\w+", regex=True)) == 1
+
+    # A fresh process builds the segment from the graph's TextChunk nodes on first search.
+    fresh = TrigramIndexes(directory=str(tmp_path / "trigram"))
+    assert [h["text"] for h in await fresh.search(["org/repo"], "reopen")] == ["def app::Net::reopen"]
+    assert (tmp_path / "trigram" / "org__repo@main.trg").exists()
+
+    await local_graph.delete("a.txt")
+    assert await get_trigram_indexes().search(["org/repo"], "reopen") == []
+
+async def test_background_compaction_keeps_changes_made_while_it_runs(tmp_path: Path):
+    index = RepoTrigramIndex(REPO, str(tmp_path), compact_threshold=2)
+    index.add(chunk("a.cpp", 0, 1, "int alpha;\n"))
+    index.add(chunk("b.cpp", 0, 1, "int beta;\n"))
+    compaction = asyncio.ensure_future(index.compact_in_background(graph_version=7))
+    await asyncio.sleep(0)  # The snapshot is taken; the segment is being built in a thread.
+    index.add(chunk("a.cpp", 0, 1, "int alpha2;\n"))
+    index.add(chunk("c.cpp", 0, 1, "int gamma;\n"))
+    await compaction
+    assert index.persisted and index.graph_version == 7
+    assert [h["text"] for h in index.search("alpha")] == ["int alpha2;"]
+    assert {h["path"] for h in index.search("int ")} == {"a.cpp", "b.cpp", "c.cpp"} and len(index) == 3
+    index.remove_path("a.cpp")
+    assert index.search("alpha") == []
+
+async def test_a_persisted_segment_is_reused_only_at_the_current_graph_version(tmp_path: Path, local_graph, monkeypatch):
+    monkeypatch.setattr(graph_versions, "_versions", GraphVersions(poll_seconds=0))
+    await local_graph.ingest("a.txt", "def app::Net::open\n")
+    first = TrigramIndexes(directory=str(tmp_path / "trigram"))
+    assert len(await first.search(["org/repo"], "Net::open")) == 1
+
+    reopened = TrigramIndexes(directory=str(tmp_path / "trigram"))
+    assert reopened.get(REPO).graph_version == 1
+    seeded = []
+    monkeypatch.setattr(reopened.get(REPO), "compact", lambda version=None: seeded.append(version))
+    assert len(await reopened.search(["org/repo"], "Net::open")) == 1 and seeded == []
+
+    await local_graph.ingest("b.txt", "def app::Net::close\n")  # Written while no index of that directory was loaded.
+    lagging = TrigramIndexes(directory=str(tmp_path / "trigram"))
+    assert lagging.get(REPO).graph_version == 1
+    assert [h["path"] for h in await lagging.search(["org/repo"], "Net::close")] == ["b.txt"]
+    assert lagging.get(REPO).graph_version == 2
+
+    # An ingest-only process never seeds: neither its compactions nor its exit flush touch the files.
+    ingest_only = TrigramIndexes(directory=str(tmp_path / "trigram"), compact_threshold=1)
+    ingest_only.get(REPO).add(chunk("c.txt", 0, 1, "def app::Net::send\n"))
+    ingest_only._compact_later(ingest_only.get(REPO))
+    ingest_only.flush()
+    assert TrigramIndexes(directory=str(tmp_path / "trigram")).get(REPO).graph_version == 2
+    assert sorted(p.name for p in (tmp_path / "trigram").iterdir()) == ["org__repo@main.json", "org__repo@main.trg"]
+
+async def test_backtracking_prone_regexes_are_refused_and_slow_ones_time_out(local_graph):
+    await local_graph.ingest("a.txt", "aaaa!\n")
+    indexes = TrigramIndexes(regex_timeout_seconds=0)
+    for pattern in (r"(a+)+$", r"(\w+\s*)*x", r"(a|ab)(c|bcd)\1", r"(?:x?y+){2,}", r"(a"):
+        with pytest.raises(ValueError):
+            await indexes.search(["org/repo"], pattern, regex=True)
+    with pytest.raises(TimeoutError):
+        await indexes.search(["org/repo"], r"a{2}!", regex=True)
+    assert len(await TrigramIndexes().search(["org/repo"], r"(ab{2})+|a{2}!", regex=True)) == 1
@@ -1,9 +1,11 @@
 from pathlib import Path
-from typing import List, Optional
+from typing import Iterable, List, Optional
 
 from src.parser.utils import logger
 from src.parser.utils import read_file_content
-from src.parser.entities import CodeEntity, RawSymbolReference
+from src.parser.entities import CodeEntity, RawSymbolReference, ReferenceContext, ImportType
+from src.parser.extraction import FileIsland
+from src.parser.parsers.base_parser import BaseParser
 
 async def load_test_file_content(file_path: Path) -> str:
     """Reads content from a test file faithfully."""
@@ -41,3 +43,51 @@ def find_raw_symbol_references(
         if match:
             found.append(ref)
     return found
+
+class MemoryIslandSink:
+    """IslandSink that keeps committed groups in memory, optionally failing every commit or any group holding `fail_paths`."""
+    def __init__(self, fail: bool = False, fail_paths: Iterable[str] = ()):
+        self.groups: List[List[FileIsland]] = []
+        self.fail = fail
+        self.fail_paths = set(fail_paths)
+
+    async def commit(self, islands: List[FileIsland], redo: Iterable[str] = ()) -> None:
+        if self.fail:
+            raise RuntimeError("db down")
+        if bad := [i.source_file.relative_path for i in islands if i.source_file.relative_path in self.fail_paths]:
+            raise ValueError(f"bad island {bad[0]}")
+        self.groups.append(list(islands))
+
+def make_text_repo(root: Path, count: int) -> List[tuple]:
+    """Creates `count` small text files and returns (absolute_path, relative_path) pairs."""
+    files = []
+    for i in range(count):
+        path = root / f"dir{i % 3}" / f"notes_{i}.txt"
+        path.parent.mkdir(parents=True, exist_ok=True)
+        path.write_text(f"note {i}\n" * (i + 1))
+        files.append((str(path), str(path.relative_to(root))))
+    return files
+
+class DirectiveParser(BaseParser):
+    """
+    Grammar-free stand-in for a language parser: 'def <fqn>' lines define a CodeEntity (a
+    FunctionDefinition; 'virtual <fqn>' marks one virtual, 'pure <fqn>' declares one pure virtual
+    and 'class <fqn>' defines a ClassDefinition), 'call <expr>' / 'inherit <expr>' lines reference one from the closest
+    preceding definition, and 'include <path>' lines are quoted includes made by the file.
+    """
+    async def parse(self, source_file_id: str, file_content: str):
+        lines = file_content.splitlines()
+        yield [1] if lines else []
+        current = None
+        for number, line in enumerate(lines, start=1):
+            kind, _, name = line.partition(" ")
+            if kind in ("def", "virtual", "pure", "class"):
+                current = f"{name}@{number}"
+                entity_type = "ClassDefinition" if kind == "class" else "FunctionDefinition"
+                snippet = f"virtual {name} = 0;" if kind == "pure" else line
+                yield CodeEntity(id=current, type=entity_type, start_line=number, end_line=number, canonical_fqn=name, snippet_content=snippet)
+            elif kind == "include":
+                yield RawSymbolReference(source_entity_id=source_file_id, target_expression=name, reference_type="INCLUDE", context=ReferenceContext(import_type=ImportType.RELATIVE, path_parts=[name]))
+            elif kind in ("call", "inherit") and current:
+                reference_type = "FUNCTION_CALL" if kind == "call" else "INHERITANCE"
+                yield RawSymbolReference(source_entity_id=current, target_expression=name, reference_type=reference_type, context=ReferenceContext(import_type=ImportType.ABSOLUTE, path_parts=[]))
@@ -0,0 +1,67 @@
+# .roo/cognee/tests/test_context_packer.py
+import json
+import pytest
+
+from src.context_packer import ContextPacker
+
+pytestmark = pytest.mark.asyncio
+
+def node(node_id: str, text: str = None, **attributes) -> dict:
+    return {"id": node_id, "attributes": {**({"text": text} if text is not None else {}), **attributes}}
+
+def triplet(score: float, source: dict, edge: str, target: dict) -> dict:
+    return {"score": score, "source_node": source, "edge": {"attributes": {"type": edge}}, "target_node": target}
+
+def lines(start: int, end: int) -> str:
+    return "\n".join(f"line {n}" for n in range(start, end + 1))
+
+async def test_spans_are_sent_once_and_overlaps_merge():
+    chunk = node("org/repo@main|src/a.cpp@1-1|0@10-40", lines(10, 14), type="TextChunk")
+    method = node("org/repo@main|src/a.cpp@1-1|0@10-40|A::run()@12-30", lines(12, 16), type="FunctionDefinition", name="run")
+    caller = node("org/repo@main|src/b.cpp@1-1|0@1-9|main()@1-9", lines(1, 5), name="main")
+    file_a = node("org/repo@main|src/a.cpp@1-1", type="SourceFile")
+    concept = node("concept-1", "A shared description.")
+    triplets = [
+        triplet(0.9, method, "DEFINED_IN", file_a),
+        triplet(0.8, chunk, "CONTAINS", method),
+        triplet(0.7, caller, "CALLS", method),
+        triplet(0.6, concept, "DESCRIBES", caller),
+        triplet(0.5, node("concept-2", "A shared description."), "DESCRIBES", method),
+    ]
+    packer = ContextPacker(token_budget=10_000)
+    packed = packer.pack(triplets, naive_tokens=10_000)
+
+    assert [t["index"] for t in packed.triplets] == [0, 1, 2, 3, 4]
+    by_path = {s["path"]: s for s in packed.sources}
+    assert (by_path["src/a.cpp"]["start_line"], by_path["src/a.cpp"]["end_line"]) == (10, 16)  # 12-16 merged with 10-14.
+    assert by_path["src/a.cpp"]["text"] == lines(10, 16) and by_path["src/b.cpp"]["text"] == lines(1, 5)
+    assert packed.triplets[1]["target"]["block"] == packed.triplets[1]["source"]["block"] == by_path["src/a.cpp"]["block"]
+    assert packed.triplets[4]["source"]["same_text_as"] == "concept-1"
+    assert packed.stats["merged_spans"] == 1 and packed.stats["deduplicated_nodes"] == 5
+    assert packed.stats["saved_tokens"] == 10_000 - packed.stats["packed_tokens"]
+    assert json.loads(packed.to_json())["sources"] == packed.sources
+
+async def test_budget_keeps_the_best_scored_triplets():
+    triplets = [triplet(0.1 * i, node(f"org/repo@main|src/f{i}.cpp@1-1|0@1-50|f{i}()@1-50", "x" * 400 + "\n" + "y" * 400), "DEFINED_IN",
+                        node(f"org/repo@main|src/f{i}.cpp@1-1")) for i in range(10)]
+    packed = ContextPacker(token_budget=1200).pack(triplets)
+    kept = [t["index"] for t in packed.triplets]
+    assert kept == sorted(kept) and 0 < len(kept) < 10 and min(kept) == 10 - len(kept)
+    assert packed.stats["packed_tokens"] <= 1200 and packed.stats["triplets_dropped"] == 10 - len(kept)
+    assert len(packed.sources) == len(kept)  # A dropped triplet leaves none of its text behind.
+    assert len(ContextPacker(token_budget=1).pack(triplets).triplets) == 1
+
+async def test_a_span_bridging_two_blocks_coalesces_them():
+    def entity(name: str, start: int, end: int) -> dict:
+        return node(f"org/repo@main|src/a.cpp@1-1|0@1-40|{name}()@{start}-{end}", lines(start, end), name=name)
+    file_a = node("org/repo@main|src/a.cpp@1-1", type="SourceFile")
+    triplets = [
+        triplet(0.9, entity("top", 1, 4), "DEFINED_IN", file_a),
+        triplet(0.8, entity("bottom", 8, 12), "DEFINED_IN", file_a),
+        triplet(0.7, entity("middle", 4, 8), "DEFINED_IN", file_a),
+        triplet(0.6, entity("after", 13, 14), "DEFINED_IN", file_a),
+    ]
+    packed = ContextPacker(token_budget=10_000).pack(triplets)
+    assert [(s["start_line"], s["end_line"]) for s in packed.sources] == [(1, 14)] and packed.sources[0]["text"] == lines(1, 14)
+    assert {t["source"]["block"] for t in packed.triplets} == {packed.sources[0]["block"]}
+    assert packed.stats["merged_spans"] == 3  # middle extends and absorbs bottom's block; after adjoins.
@@ -0,0 +1,96 @@
+# .roo/cognee/tests/test_git_mirror_cache.py
+import asyncio
+import os
+import subprocess
+import pytest
+from pathlib import Path
+
+from src.git_mirror_cache import GitMirrorCache, GitMirrorError
+
+pytestmark = pytest.mark.asyncio
+
+def git(cwd: Path, *args: str) -> str:
+    return subprocess.run(["git", "-c", "user.name=t", "-c", "user.email=t@t", *args], cwd=cwd, check=True,
+                          capture_output=True, text=True).stdout.strip()
+
+def make_remote(path: Path, files: dict) -> str:
+    path.mkdir()
+    git(path, "init", "-q", "-b", "main")
+    commit(path, files)
+    return f"file://{path}"
+
+def commit(path: Path, files: dict):
+    for name, text in files.items():
+        (path / name).write_text(text)
+    git(path, "add", "-A")
+    git(path, "commit", "-q", "-m", "change")
+
+async def test_clones_once_then_fetches_and_checks_out_each_ref(tmp_path: Path):
+    upstream = tmp_path / "upstream"
+    url = make_remote(upstream, {"a.cpp": "int a;\n"})
+    git(upstream, "tag", "v1")
+    cache = GitMirrorCache(str(tmp_path / "cache"), max_bytes=1 << 30, fetch_ttl_seconds=0, allow_file_urls=True)
+
+    async def read(ref=None):
+        async with cache.checkout(url, ref) as path:
+            return path, sorted(os.listdir(path))
+
+    first, second = await asyncio.gather(read(), read())
+    assert first == second and "a.cpp" in first[1]
+    assert cache.ops["clone"] == 1 and cache.ops["shared"] == 1 and "fetch" not in cache.ops
+
+    commit(upstream, {"b.cpp": "int b;\n"})
+    head, files = await read("main")
+    assert cache.ops["clone"] == 1 and cache.ops["fetch"] == 1 and "b.cpp" in files
+    tag, files = await read("v1")
+    assert tag != head and "b.cpp" not in files
+    assert (await read("v1"))[0] == tag  # Same ref at the same commit: the worktree is reused.
+    async with cache.checkout(url, "main") as held:
+        commit(upstream, {"c.cpp": "int c;\n"})
+        moved, files = await read("main")
+        assert moved != held and "c.cpp" in files and os.path.isdir(held)  # Replaced, but not under its reader.
+    assert not os.path.exists(held)
+    with pytest.raises(GitMirrorError):
+        await read("no-such-branch")
+
+    # A new process keeps using the mirror on disk.
+    reopened = GitMirrorCache(str(tmp_path / "cache"), max_bytes=1 << 30, fetch_ttl_seconds=3600, allow_file_urls=True)
+    async with reopened.checkout(url, "v1") as path:
+        assert path == tag
+    assert reopened.ops == {"fresh": 1}
+
+async def test_least_recently_used_mirrors_are_evicted_unless_in_use(tmp_path: Path):
+    urls = [make_remote(tmp_path / f"r{i}", {"f.cpp": f"int f{i};\n" * 200}) for i in range(3)]
+    cache = GitMirrorCache(str(tmp_path / "cache"), max_bytes=1 << 30, fetch_ttl_seconds=3600, allow_file_urls=True)
+    for url in urls[:2]:
+        async with cache.checkout(url):
+            pass
+    cache.max_bytes = cache.size_bytes() + 1  # Room for two mirrors, not three.
+
+    async with cache.checkout(urls[0]):
+        async with cache.checkout(urls[2]):
+            pass
+    assert cache.ops["evict"] == 1 and sorted(cache._mirrors) == sorted([urls[0], urls[2]])
+
+    cache.max_bytes = 0
+    async with cache.checkout(urls[2]) as path:
+        assert os.path.isdir(path)  # The mirror in use survives even an empty budget.
+    assert await cache.evict() == [urls[2]]
+    assert cache.stats()["mirrors"] == 0 and os.listdir(tmp_path / "cache" / "mirrors") == []
+
+async def test_option_like_urls_and_refs_and_file_urls_are_refused(tmp_path: Path):
+    url = make_remote(tmp_path / "upstream", {"a.cpp": "int a;\n"})
+    cache = GitMirrorCache(str(tmp_path / "cache"), max_bytes=1 << 30, fetch_ttl_seconds=3600, allow_file_urls=True)
+    for ref in ("--output=/tmp/x", "main..HEAD", "a b"):
+        with pytest.raises(GitMirrorError):
+            async with cache.checkout(url, ref):
+                pass
+    async with cache.checkout(url, git(tmp_path / "upstream", "rev-parse", "HEAD")[:12]) as path:
+        assert "a.cpp" in os.listdir(path)
+    with pytest.raises(GitMirrorError, match="Refusing"):
+        async with cache.checkout("--upload-pack=touch /tmp/pwned"):
+            pass
+    with pytest.raises(GitMirrorError, match="GIT_MIRROR_ALLOW_FILE_URLS"):
+        async with GitMirrorCache(str(tmp_path / "other")).checkout(url):
+            pass
+    assert cache.ops["clone"] == 1
@@ -0,0 +1,104 @@
+# .roo/cognee/tests/test_retrieval_cache.py
+import pytest
+import asyncio
+from pathlib import Path
+
+from src.parser import graph_utils, graph_versions, local_graph_backend, orchestrator
+from src.parser.entities import FileProcessingRequest
+from src.parser.graph_versions import GraphVersions, get_graph_versions
+from src.parser.local_graph_backend import LocalGraphBackend
+from src.retrieval_cache import RetrievalCache
+from tests.shared_test_utils import DirectiveParser
+
+pytestmark = pytest.mark.asyncio
+
+class _Compute:
+    def __init__(self, value):
+        self.value, self.calls = value, 0
+
+    async def __call__(self):
+        self.calls += 1
+        await asyncio.sleep(0.01)
+        return self.value
+
+async def test_repeated_queries_hit_until_their_repo_changes():
+    versions = GraphVersions()
+    versions.bump("org/repo@main")
+    versions.bump("org/other@main")
+    cache = RetrievalCache(versions=versions)
+    compute = _Compute({"output": "answer", "relevant_context": []})
+
+    first, hit = await cache.get_or_compute("completion", "Where is  main?", ["org/repo"], 20, compute)
+    assert not hit
+    first["output"] = "mutated by the caller"
+    again, hit = await cache.get_or_compute("completion", "where is main?", ["org/repo"], 20, compute)
+    assert hit and again["output"] == "answer" and compute.calls == 1
+    assert (await cache.get_or_compute("completion", "where is main?", ["org/repo"], 5, compute))[1] is False
+
+    versions.bump("org/other@main")
+    assert (await cache.get_or_compute("completion", "where is main?", ["org/repo"], 20, compute))[1] is True
+    versions.bump("org/repo@main", source="enhancement")
+    assert (await cache.get_or_compute("completion", "where is main?", ["org/repo"], 20, compute))[1] is False
+
+    stats = cache.stats()
+    assert (stats["hits"], stats["misses"], stats["stale"]) == (2, 3, 1)
+    assert stats["hit_rate"] == 0.4 and stats["saved_seconds"] > 0
+
+async def test_unscoped_entries_follow_every_write_and_concurrent_misses_share_work():
+    versions = GraphVersions()
+    cache = RetrievalCache(versions=versions)
+    compute = _Compute([{"score": 1.0}])
+    results = await asyncio.gather(*(cache.get_or_compute("triplets", "q", ["tenant/role/ds"], 20, compute) for _ in range(3)))
+    assert compute.calls == 1 and [hit for _, hit in results] == [False, True, True]
+
+    versions.bump("any/repo@main")
+    assert (await cache.get_or_compute("triplets", "q", ["tenant/role/ds"], 20, compute))[1] is False
+
+    empty = _Compute([])
+    await cache.get_or_compute("triplets", "nothing", None, 20, empty, cacheable=bool)
+    await cache.get_or_compute("triplets", "nothing", None, 20, empty, cacheable=bool)
+    assert empty.calls == 2
+
+async def test_entries_are_per_user():
+    cache = RetrievalCache(versions=GraphVersions())
+    compute = _Compute([{"score": 1.0}])
+    assert (await cache.get_or_compute("triplets", "q", ["org/repo"], 20, compute, principal="alice"))[1] is False
+    assert (await cache.get_or_compute("triplets", "q", ["org/repo"], 20, compute, principal="bob"))[1] is False
+    assert (await cache.get_or_compute("triplets", "q", ["org/repo"], 20, compute, principal="alice"))[1] is True
+    assert compute.calls == 2
+
+async def test_a_cancelled_first_caller_leaves_the_shared_computation_running():
+    cache = RetrievalCache(versions=GraphVersions())
+    compute = _Compute([{"score": 1.0}])
+    first = asyncio.create_task(cache.get_or_compute("triplets", "q", ["org/repo"], 20, compute))
+    await asyncio.sleep(0)
+    waiter = asyncio.create_task(cache.get_or_compute("triplets", "q", ["org/repo"], 20, compute))
+    await asyncio.sleep(0)
+    first.cancel()
+    assert await waiter == ([{"score": 1.0}], True)
+    assert first.cancelled()
+    assert (await cache.get_or_compute("triplets", "q", ["org/repo"], 20, compute))[1] is True
+    assert compute.calls == 1
+
+async def test_committed_files_bump_the_repo_version(tmp_path: Path, monkeypatch):
+    monkeypatch.setattr(orchestrator, "get_parser_for_file", lambda path: DirectiveParser())
+    monkeypatch.setattr(orchestrator, "get_dispatcher", lambda: _NoDispatch())
+    monkeypatch.setattr(graph_utils, "GRAPH_BACKEND", "local")
+    monkeypatch.setattr(local_graph_backend, "_instance", LocalGraphBackend(str(tmp_path / "graph.db")))
+    monkeypatch.setattr(graph_versions, "_versions", None)
+    repo = tmp_path / "repo"
+    repo.mkdir()
+    (repo / "a.txt").write_text("def app::main\n")
+    request = FileProcessingRequest(absolute_path=str(repo / "a.txt"), repo_path=str(repo), repo_id="org/repo", branch="main", commit_index=1, is_delete=False)
+
+    assert await orchestrator.process_single_file(request)
+    assert get_graph_versions().version("org/repo@main") == 1
+    assert await orchestrator.process_single_file(request)  # Unchanged content: no new version.
+    assert get_graph_versions().version("org/repo@main") == 1
+    (repo / "a.txt").unlink()
+    assert await orchestrator.process_single_file(request.model_copy(update={"is_delete": True}))
+    assert get_graph_versions().snapshot(["org/repo"]) == (("org/repo@main", 2),)
+
+class _NoDispatch:
+    async def notify_ingestion_activity(self, *args):
+        pass
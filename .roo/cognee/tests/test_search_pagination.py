@@ -0,0 +1,72 @@
+# .roo/cognee/tests/test_search_pagination.py
+import json
+import pytest
+
+from src.search_pagination import CursorError, SearchPager, decode_cursor, encode_cursor, project, query_fingerprint
+
+pytestmark = pytest.mark.asyncio
+
+def entity(i: int) -> dict:
+    return {"entity_id": f"org/repo@main|src/f{i}.cpp@1-1|0@1-40|ns::f{i}()@{i + 1}-{i + 3}", "canonical_fqn": f"ns::f{i}()",
+            "entity_type": "FunctionDefinition", "snippet_content": "x" * 1000, "noise": list(range(50))}
+
+async def test_pages_follow_cursors_over_one_result_list():
+    calls = []
+
+    async def compute():
+        calls.append(1)
+        return [entity(i) for i in range(45)]
+
+    pager = SearchPager(result_limit=40)
+    key = query_fingerprint("code", "find f")
+    first = json.loads(await pager.render("code", key, compute, page_size=20))
+    assert first["total"] == 40 and first["truncated"] and [r["fqn"] for r in first["results"]][:2] == ["ns::f0()", "ns::f1()"]
+    assert first["results"][0] == {"id": entity(0)["entity_id"], "fqn": "ns::f0()", "type": "FunctionDefinition",
+                                   "location": {"path": "src/f0.cpp", "start_line": 1, "end_line": 3}}
+    assert project({"id": "org/repo@main|src/a.cpp@12-3", "type": "SourceFile"}, ["location"]) == {"location": {"path": "src/a.cpp"}}
+
+    seen, page, pages = [r["id"] for r in first["results"]], first, 1
+    while page["next_cursor"]:
+        page = json.loads(await pager.render("code", key, compute, page["next_cursor"], 20))
+        seen += [r["id"] for r in page["results"]]
+        pages += 1
+    assert pages == 2 and len(set(seen)) == 40 and len(calls) == 1
+
+    with pytest.raises(CursorError):
+        await pager.render("code", query_fingerprint("code", "other"), compute, first["next_cursor"])
+
+    # Snippets are truncated, and the byte budget cuts a page short but always returns one result.
+    nonce, _ = decode_cursor(first["next_cursor"], key)
+    page = json.loads(await pager.render("code", key, compute, encode_cursor(key, 38, nonce), 20, ["fqn", "snippet"], max_bytes=600))
+    assert len(page["results"]) == 1 and set(page["results"][0]) == {"fqn", "snippet"} and len(page["results"][0]["snippet"]) < 1000
+    assert page["offset"] == 38 and page["next_cursor"] == encode_cursor(key, 39, nonce) and len(calls) == 1
+
+async def test_each_first_page_holds_its_own_result_list():
+    batches = iter([[entity(i) for i in range(5)], [entity(i) for i in range(100, 103)]])
+
+    async def compute():
+        return next(batches)
+
+    pager = SearchPager()
+    key = query_fingerprint("code", "find f")
+    mine = json.loads(await pager.render("code", key, compute, page_size=2))
+    theirs = json.loads(await pager.render("code", key, compute, page_size=2))
+    assert not mine["truncated"] and theirs["total"] == 3 and mine["next_cursor"] != theirs["next_cursor"]
+    # The second client's search does not replace the list the first one is paging through.
+    rest = json.loads(await pager.render("code", key, compute, mine["next_cursor"], 10))
+    assert [r["fqn"] for r in rest["results"]] == ["ns::f2()", "ns::f3()", "ns::f4()"]
+
+async def test_triplets_are_projected_and_an_expired_cursor_recomputes():
+    triplet = ({"id": "a", "name": "Widget", "type": "Entity"}, {"relationship_name": "is_a"}, {"id": "b", "name": "Thing"})
+    calls = []
+
+    async def compute():
+        calls.append(1)
+        return [triplet] * 3
+
+    pager = SearchPager(ttl_seconds=0)
+    key = query_fingerprint("insights", "widget")
+    first = json.loads(await pager.render("insights", key, compute, page_size=2, fields=["id", "fqn"]))
+    assert first["results"][0] == {"source": {"id": "a", "fqn": "Widget"}, "relationship": "is_a", "target": {"id": "b", "fqn": "Thing"}}
+    second = json.loads(await pager.render("insights", key, compute, first["next_cursor"], 2))
+    assert len(second["results"]) == 1 and second["next_cursor"] is None and len(calls) == 2
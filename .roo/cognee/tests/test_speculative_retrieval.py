@@ -0,0 +1,60 @@
+# .roo/cognee/tests/test_speculative_retrieval.py
+import asyncio
+import pytest
+
+from src.retrieval_cache import RetrievalCache
+from src.speculative_retrieval import Speculation, named_in, speculation_candidates
+from src.parser.graph_versions import GraphVersions
+
+pytestmark = pytest.mark.asyncio
+
+def triplet(score: float, source: str, target: str) -> dict:
+    return {"score": score, "source_node": {"id": source, "attributes": {"canonical_fqn": source}},
+            "edge": {"attributes": {"type": "CALLS"}}, "target_node": {"id": target, "attributes": {"name": target}}}
+
+async def test_candidates_come_from_the_question_then_the_best_scored_context():
+    context = [triplet(0.2, "app::low()", "src/a.cpp"), triplet(0.9, "app::Parser::parse(int)", "app::lex"), triplet(0.5, "APP::PARSER::PARSE", "app::emit")]
+    assert speculation_candidates("how does `app::run` reach the parser?", context, 4) == ["app::run", "app::Parser::parse", "app::lex", "app::emit"]
+    assert named_in("app::Parser::parse", "callers of parse please") and named_in("app::lex", "what does APP::LEX return")
+    assert not named_in("app::lex", "the lexer tables")
+
+async def test_the_plan_takes_only_the_expansions_it_names():
+    started, cancelled = [], []
+
+    async def expand(name: str):
+        started.append(name)
+        if name == "slow":
+            try:
+                await asyncio.sleep(10)
+            except asyncio.CancelledError:
+                cancelled.append(name)
+                raise
+        if name == "broken":
+            raise RuntimeError("index unavailable")
+        return [triplet(1.0, name, "file")]
+
+    speculation = Speculation(["parse", "emit", "slow", "broken"], expand)
+    await asyncio.sleep(0)  # The planning call would be running here.
+    assert started == ["parse", "emit", "slow", "broken"]
+    taken = await speculation.take("look at parse and broken next", timeout=1.0)
+    assert [t["source_node"]["id"] for t in taken] == ["parse"]
+    await asyncio.sleep(0)
+    assert cancelled == ["slow"] and speculation.tasks == {}
+
+    never = Speculation(["slow"], expand)
+    await asyncio.sleep(0)
+    never.cancel()  # The plan finished without looping.
+    await asyncio.sleep(0)
+    assert cancelled == ["slow", "slow"]
+
+async def test_put_primes_the_phase1_entry_unless_the_graph_moved():
+    versions = GraphVersions()
+    cache = RetrievalCache(versions=versions)
+    before = versions.snapshot(("org/repo",))
+    cache.put("triplets", "Parser", ["org/repo"], 20, [1], before)
+    assert await cache.get_or_compute("triplets", "parser", ["org/repo"], 20, lambda: asyncio.sleep(0, [2])) == ([1], True)
+
+    before = versions.snapshot(("org/repo",))
+    versions.bump("org/repo@main")  # A write landed while the expansion ran.
+    cache.put("triplets", "Lexer", ["org/repo"], 20, [1], before)
+    assert await cache.get_or_compute("triplets", "lexer", ["org/repo"], 20, lambda: asyncio.sleep(0, [2])) == ([2], False)